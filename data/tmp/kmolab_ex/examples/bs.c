@@ -0,0 +1,786 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_pool.h"
+# include "bs.h"
+# include "rk4_stats.h"
+
+/*
+  bs_job passes the lines of one step to the pool threads.
+*/
+typedef struct
+{
+  bs_stepper *s;
+  double h;
+  int line_num;
+  int owner[BS_KMAX];
+} bs_job;
+
+static void bs_assign ( int thread_num, int line_num, int nseq[],
+  int owner[] );
+static double bs_hinit ( bs_stepper *s );
+static void bs_line_task ( int id, int thread_num, void *arg );
+static void bs_midpoint ( bs_stepper *s, double h, int j, double scratch[] );
+static double bs_norm ( int m, double a[], double b[], double y[],
+  double rtol, double atol );
+
+/*
+  Step size controller constants, after Hairer, Norsett and Wanner.
+*/
+static const double bs_fac_min = 0.02;
+static const double bs_fac_max = 4.0;
+static const double bs_safe1 = 0.65;
+static const double bs_safe2 = 0.94;
+
+/******************************************************************************/
+
+int bs_advance ( bs_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_advance takes extrapolation steps until the stepper reaches T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bs_stepper *S: the stepper.
+
+    double T1: the final time.
+
+  Output:
+
+    bs_stepper *S: the advanced stepper.
+
+    int BS_ADVANCE: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  int status;
+
+  while ( s->t < t1 )
+  {
+    status = bs_step ( s, t1 );
+    if ( status != 0 )
+    {
+      return status;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+bs_stepper *bs_create ( void dydt ( double t, double u[], double f[],
+  void *ctx ), void *ctx, int m, double t0, double y0[], double rtol,
+  double atol, rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_create creates a Gragg-Bulirsch-Stoer extrapolation stepper.
+
+  Discussion:
+
+    The workspace holds the solution, its derivative, a copy of one
+    extrapolated value, the BS_KMAX lines of the tableau, and three
+    scratch vectors for each thread that can get a line.
+
+    The initial number of columns follows ODEX: the tighter RTOL, the
+    higher the starting order.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Ernst Hairer, Syvert Norsett, Gerhard Wanner,
+    Solving Ordinary Differential Equations I: Nonstiff Problems,
+    Second Edition, Springer, 1993, section II.9.
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side.
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    double RTOL, ATOL: the relative and absolute error tolerances.
+
+    rk4_pool *POOL: the threads to use, or NULL for the calling thread.
+
+  Output:
+
+    bs_stepper *BS_CREATE: the stepper, or NULL if memory could not be
+    allocated.
+*/
+{
+  int i;
+  int j;
+  int k;
+  int ld;
+  bs_stepper *s;
+  int thread_num;
+
+  s = ( bs_stepper * ) malloc ( sizeof ( bs_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  s->thread_num = rk4_pool_size ( pool );
+  thread_num = s->thread_num;
+  if ( BS_KMAX < thread_num )
+  {
+    thread_num = BS_KMAX;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( ( 3 + BS_KMAX + 3 * thread_num ) * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->dydt = dydt;
+  s->ctx = ctx;
+  s->m = m;
+  s->ld = ld;
+  s->pool = pool;
+  s->rtol = rtol;
+  s->atol = atol;
+  s->hmax = HUGE_VAL;
+  s->t = t0;
+  s->h = 0.0;
+  s->step_num = 0;
+  s->reject_num = 0;
+  s->eval_num = 0;
+  s->y       = s->work;
+  s->f0      = s->work +     ld;
+  s->u       = s->work + 2 * ld;
+  s->table   = s->work + 3 * ld;
+  s->scratch = s->work + ( 3 + BS_KMAX ) * ld;
+
+  for ( j = 0; j < BS_KMAX; j++ )
+  {
+    s->nseq[j] = 2 * ( j + 1 );
+    s->cost[j] = ( j == 0 ) ? 1.0 + s->nseq[0] : s->cost[j-1] + s->nseq[j];
+  }
+/*
+  S->K is the row to aim at; rows 0 to K+1 are computed.
+*/
+  k = ( int ) ( - log10 ( rtol + 1.0E-40 ) * 0.6 + 0.5 );
+  if ( k < 1 )
+  {
+    k = 1;
+  }
+  if ( BS_KMAX - 2 < k )
+  {
+    k = BS_KMAX - 2;
+  }
+  s->k = k;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = y0[i];
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void bs_destroy ( bs_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_destroy frees an extrapolation stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bs_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int bs_observe ( bs_stepper *s, double t1, rk4_observer *obs )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_observe takes extrapolation steps to T1, reporting to an observer.
+
+  Discussion:
+
+    Extrapolation has no cheap dense output, so a step is shortened to
+    end on each requested output time.  The stepsize suggested for the
+    following step is not reduced by this.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bs_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    rk4_observer *OBS: the observer.
+
+  Output:
+
+    bs_stepper *S: the advanced stepper.
+
+    int BS_OBSERVE: 0 if the integration reached T1, 1 if the stepsize
+    became too small, 3 if the observer stopped it.
+*/
+{
+  int k;
+  long int step_num;
+  int status;
+
+  if ( obs->tout_num <= 0 )
+  {
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 3;
+    }
+    step_num = 0;
+    while ( s->t < t1 )
+    {
+      status = bs_step ( s, t1 );
+      if ( status != 0 )
+      {
+        return status;
+      }
+      step_num = step_num + 1;
+      if ( ( 0 < obs->every && step_num % obs->every == 0 ) || t1 <= s->t )
+      {
+        if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+        {
+          return 3;
+        }
+      }
+    }
+    return 0;
+  }
+
+  k = 0;
+  while ( k < obs->tout_num && obs->tout[k] < s->t )
+  {
+    k = k + 1;
+  }
+
+  while ( k < obs->tout_num && obs->tout[k] <= t1 )
+  {
+    while ( s->t < obs->tout[k] )
+    {
+      status = bs_step ( s, obs->tout[k] );
+      if ( status != 0 )
+      {
+        return status;
+      }
+    }
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 3;
+    }
+    k = k + 1;
+  }
+
+  return bs_advance ( s, t1 );
+}
+/******************************************************************************/
+
+int bs_step ( bs_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_step takes one accepted extrapolation step, without passing T1.
+
+  Discussion:
+
+    Rows 0 to K+1 of the tableau are computed together, in parallel.
+    The step is accepted if the error estimate of row K+1 or row K is
+    within tolerance, and the more accurate of T(K+1,K+1) and T(K,K)
+    that passes is kept.
+
+    The next K is the one of K-1, K, K+1 with the least work per unit
+    step, where the work of row J is 1 + NSEQ[0] + ... + NSEQ[J]
+    evaluations, and its step is the optimal step of that row.  After
+    a rejection, the step that is finally accepted may not raise K or
+    the stepsize.
+
+    The step fails if the stepsize falls below 16 EPS |T|, or below
+    16 EPS 1.0E-300 at T = 0.  The bound does not depend on T1, so that
+    a long interval can still start with small steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bs_stepper *S: the stepper.
+
+    double T1: the time not to step past, T1 > S->T.
+
+  Output:
+
+    bs_stepper *S: the advanced stepper.
+
+    int BS_STEP: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  double err[BS_KMAX];
+  double fac;
+  double h;
+  double hmin;
+  double hopt[BS_KMAX];
+  int i;
+  int j;
+  int jhi;
+  int jlo;
+  bs_job job;
+  int k;
+  int l;
+  int last;
+  int ld;
+  int line_num;
+  int m;
+  double r;
+  int reject;
+  double *ta;
+  double *tb;
+  double *ynew;
+  double w;
+  double wmin;
+
+  m = s->m;
+  ld = s->ld;
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+  RK4_STATS_TIC ( RK4_PHASE_RHS );
+  s->dydt ( s->t, s->y, s->f0, s->ctx );
+  RK4_STATS_TOC ( RK4_PHASE_RHS );
+  s->eval_num = s->eval_num + 1;
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 1 );
+
+  if ( s->h == 0.0 )
+  {
+    s->h = bs_hinit ( s );
+  }
+
+  reject = 0;
+
+  for ( ; ; )
+  {
+    k = s->k;
+    line_num = k + 2;
+
+    h = fmin ( s->h, s->hmax );
+    last = 0;
+    if ( t1 - s->t <= h )
+    {
+      h = t1 - s->t;
+      last = 1;
+    }
+
+    hmin = 16.0 * 2.220446049250313E-16 * fmax ( fabs ( s->t ), 1.0E-300 );
+    if ( fabs ( h ) < hmin )
+    {
+      RK4_STATS_TOC ( RK4_PHASE_STEP );
+      return 1;
+    }
+
+    job.s = s;
+    job.h = h;
+    job.line_num = line_num;
+    bs_assign ( s->thread_num, line_num, s->nseq, job.owner );
+    rk4_pool_run ( s->pool, bs_line_task, &job );
+
+    s->eval_num = s->eval_num + ( long int ) s->cost[line_num-1] - 1;
+    RK4_STATS_ADD ( RK4_COUNT_EVAL, ( long int ) s->cost[line_num-1] - 1 );
+/*
+  Extrapolate one row at a time.  After row J, line 0 of the table
+  holds T(J,J) and line 1 holds T(J,J-1), the lower order estimate.
+*/
+    for ( j = 1; j < line_num; j++ )
+    {
+      for ( l = j; 1 <= l; l-- )
+      {
+        r = ( double ) s->nseq[j] / ( double ) s->nseq[l-1];
+        fac = r * r - 1.0;
+        ta = s->table + l * ld;
+        tb = s->table + ( l - 1 ) * ld;
+        for ( i = 0; i < m; i++ )
+        {
+          tb[i] = ta[i] + ( ta[i] - tb[i] ) / fac;
+        }
+      }
+      err[j] = bs_norm ( m, s->table, s->table + ld, s->y, s->rtol, s->atol );
+      if ( j == k )
+      {
+        for ( i = 0; i < m; i++ )
+        {
+          s->u[i] = s->table[i];
+        }
+      }
+    }
+
+/*
+  A NaN or infinite error, from a failed right hand side, shrinks the
+  step as much as the controller allows.
+*/
+    jlo = ( 1 < k ) ? k - 1 : k;
+    for ( j = jlo; j <= k + 1; j++ )
+    {
+      if ( isfinite ( err[j] ) )
+      {
+        fac = bs_safe2 * pow ( bs_safe1 / fmax ( err[j], 1.0E-10 ),
+          1.0 / ( double ) ( 2 * j + 1 ) );
+        fac = fmax ( bs_fac_min, fmin ( bs_fac_max, fac ) );
+      }
+      else
+      {
+        fac = bs_fac_min;
+      }
+      hopt[j] = h * fac;
+    }
+
+    ynew = NULL;
+    if ( err[k+1] <= 1.0 )
+    {
+      ynew = s->table;
+    }
+    else if ( err[k] <= 1.0 )
+    {
+      ynew = s->u;
+    }
+
+    jhi = k;
+    if ( ynew != NULL && !reject && k + 1 <= BS_KMAX - 2 )
+    {
+      jhi = k + 1;
+    }
+    wmin = HUGE_VAL;
+    for ( j = jlo; j <= jhi; j++ )
+    {
+      w = s->cost[j+1] / hopt[j];
+      if ( w < wmin )
+      {
+        wmin = w;
+        s->k = j;
+      }
+    }
+
+    if ( ynew != NULL )
+    {
+      if ( !last )
+      {
+        s->h = reject ? fmin ( hopt[s->k], h ) : hopt[s->k];
+      }
+      for ( i = 0; i < m; i++ )
+      {
+        s->y[i] = ynew[i];
+      }
+      s->t = last ? t1 : s->t + h;
+      s->step_num = s->step_num + 1;
+
+      RK4_STATS_TOC ( RK4_PHASE_STEP );
+      RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+      return 0;
+    }
+
+    reject = 1;
+    s->reject_num = s->reject_num + 1;
+    RK4_STATS_ADD ( RK4_COUNT_REJECT, 1 );
+    s->h = fmin ( hopt[s->k], 0.9 * h );
+  }
+}
+/******************************************************************************/
+
+static void bs_assign ( int thread_num, int line_num, int nseq[],
+  int owner[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_assign spreads the lines of a step over the threads.
+
+  Discussion:
+
+    Line J costs NSEQ[J] evaluations.  Lines are taken longest first,
+    each going to the thread with the least work so far.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int id;
+  int id_min;
+  int j;
+  int load[BS_KMAX];
+
+  if ( line_num < thread_num )
+  {
+    thread_num = line_num;
+  }
+
+  for ( id = 0; id < thread_num; id++ )
+  {
+    load[id] = 0;
+  }
+
+  for ( j = line_num - 1; 0 <= j; j-- )
+  {
+    id_min = 0;
+    for ( id = 1; id < thread_num; id++ )
+    {
+      if ( load[id] < load[id_min] )
+      {
+        id_min = id;
+      }
+    }
+    owner[j] = id_min;
+    load[id_min] = load[id_min] + nseq[j];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static double bs_hinit ( bs_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_hinit guesses a first stepsize from the solution and its derivative.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double d0;
+  double d1;
+  double h0;
+  int i;
+  double sk;
+
+  d0 = 0.0;
+  d1 = 0.0;
+  for ( i = 0; i < s->m; i++ )
+  {
+    sk = s->atol + s->rtol * fabs ( s->y[i] );
+    d0 = d0 + ( s->y[i] / sk ) * ( s->y[i] / sk );
+    d1 = d1 + ( s->f0[i] / sk ) * ( s->f0[i] / sk );
+  }
+  d0 = sqrt ( d0 / s->m );
+  d1 = sqrt ( d1 / s->m );
+
+  if ( d0 < 1.0E-05 || d1 < 1.0E-05 )
+  {
+    h0 = 1.0E-06;
+  }
+  else
+  {
+    h0 = 0.01 * d0 / d1;
+  }
+
+  return fmin ( h0, s->hmax );
+}
+/******************************************************************************/
+
+static void bs_line_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_line_task computes the lines of the tableau owned by one thread.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int j;
+  bs_job *job;
+  bs_stepper *s;
+
+  job = ( bs_job * ) arg;
+  s = job->s;
+
+  for ( j = 0; j < job->line_num; j++ )
+  {
+    if ( job->owner[j] == id )
+    {
+      bs_midpoint ( s, job->h, j, s->scratch + 3 * s->ld * id );
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void bs_midpoint ( bs_stepper *s, double h, int j, double scratch[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_midpoint computes line J of the tableau by the Gragg midpoint rule.
+
+  Discussion:
+
+    With N = NSEQ[J] substeps of size HH = H / N,
+
+      Z0 = Y, Z1 = Y + HH * F0,
+      Z(L+1) = Z(L-1) + 2 HH F ( Z(L) ), L = 1, ..., N-1,
+
+    and the line is the smoothed value ( Z(N-1) + Z(N) + HH F ( Z(N) ) ) / 2,
+    whose error expands in even powers of H.  This takes N evaluations,
+    since F0 = F ( Y ) is shared by all lines.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double *f;
+  double hh;
+  int i;
+  int l;
+  int m;
+  int n;
+  double *tj;
+  double *tmp;
+  double *z0;
+  double *z1;
+
+  m = s->m;
+  n = s->nseq[j];
+  hh = h / ( double ) ( n );
+  z0 = scratch;
+  z1 = scratch + s->ld;
+  f = scratch + 2 * s->ld;
+  tj = s->table + j * s->ld;
+
+  for ( i = 0; i < m; i++ )
+  {
+    z0[i] = s->y[i];
+    z1[i] = s->y[i] + hh * s->f0[i];
+  }
+
+  for ( l = 1; l < n; l++ )
+  {
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt ( s->t + l * hh, z1, f, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+    for ( i = 0; i < m; i++ )
+    {
+      z0[i] = z0[i] + 2.0 * hh * f[i];
+    }
+    tmp = z0;
+    z0 = z1;
+    z1 = tmp;
+  }
+
+  RK4_STATS_TIC ( RK4_PHASE_RHS );
+  s->dydt ( s->t + h, z1, f, s->ctx );
+  RK4_STATS_TOC ( RK4_PHASE_RHS );
+  for ( i = 0; i < m; i++ )
+  {
+    tj[i] = 0.5 * ( z0[i] + z1[i] + hh * f[i] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static double bs_norm ( int m, double a[], double b[], double y[],
+  double rtol, double atol )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bs_norm computes the scaled RMS norm of A - B.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  double sk;
+  double value;
+
+  value = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    sk = atol + rtol * fmax ( fabs ( y[i] ), fabs ( a[i] ) );
+    value = value + ( ( a[i] - b[i] ) / sk ) * ( ( a[i] - b[i] ) / sk );
+  }
+  value = sqrt ( value / m );
+
+  return value;
+}
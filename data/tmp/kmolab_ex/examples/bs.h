@@ -0,0 +1,52 @@
+/*
+  bs_stepper holds the state of an adaptive Gragg-Bulirsch-Stoer
+  extrapolation integration, after ODEX of Hairer and Wanner.
+
+  A step of size H computes the Gragg modified midpoint rule with
+  NSEQ[J] = 2 ( J + 1 ) substeps for lines J = 0, ..., K, and
+  extrapolates them to H = 0 in H^2 with the Aitken-Neville scheme.
+  K, the number of columns, and H are both adapted from the error
+  estimates, to minimize the work per unit step.
+
+  The lines of a step are independent, so they are spread over the
+  threads of POOL, longest first, each thread using its own scratch.
+  DYDT ( T, U, F, CTX ) is then called concurrently and must not
+  modify shared state.  The result does not depend on the number of
+  threads.
+*/
+# define BS_KMAX 9
+
+typedef struct
+{
+  void ( *dydt ) ( double t, double u[], double f[], void *ctx );
+  void *ctx;
+  int m;
+  int ld;
+  rk4_pool *pool;
+  int thread_num;
+  double rtol;
+  double atol;
+  double hmax;
+  double t;
+  double h;
+  int k;
+  int nseq[BS_KMAX];
+  double cost[BS_KMAX];
+  long int step_num;
+  long int reject_num;
+  long int eval_num;
+  double *y;
+  double *f0;
+  double *u;
+  double *table;
+  double *scratch;
+  double *work;
+} bs_stepper;
+
+int bs_advance ( bs_stepper *s, double t1 );
+bs_stepper *bs_create ( void dydt ( double t, double u[], double f[],
+  void *ctx ), void *ctx, int m, double t0, double y0[], double rtol,
+  double atol, rk4_pool *pool );
+void bs_destroy ( bs_stepper *s );
+int bs_observe ( bs_stepper *s, double t1, rk4_observer *obs );
+int bs_step ( bs_stepper *s, double t1 );
@@ -0,0 +1,395 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "dde.h"
+# include "rk4_stats.h"
+
+/******************************************************************************/
+
+int dde_advance ( dde_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    dde_advance takes steps of size DT until the stepper reaches T1.
+
+  Discussion:
+
+    The steps all have the size DT, so T1 is rounded to the nearest
+    whole number of steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    dde_stepper *S: the stepper.
+
+    double T1: the final time.
+
+  Output:
+
+    dde_stepper *S: the advanced stepper.
+
+    int DDE_ADVANCE: 0 on success, 1 if a delayed value older than
+    TAU_MAX was asked for.
+*/
+{
+  long int j;
+  long int n;
+  int status;
+
+  n = ( long int ) floor ( ( t1 - s->t ) / s->dt + 0.5 );
+
+  for ( j = 0; j < n; j++ )
+  {
+    status = dde_step ( s );
+    if ( status != 0 )
+    {
+      return status;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+dde_stepper *dde_create ( void dydt ( double t, double y[], double f[],
+  dde_stepper *s, void *ctx ), double history ( double t, int i, void *ctx ),
+  void *ctx, int m, double t0, double dt, double tau_max )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    dde_create creates a delay differential equation stepper.
+
+  Discussion:
+
+    The ring holds SLOT_NUM = ceil ( TAU_MAX / DT ) + 3 points, enough
+    for a stage at the end of a step to look back TAU_MAX.  The
+    workspace is 2 * SLOT_NUM + 4 vectors of length M.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double Y[], double F[], dde_stepper *S,
+    void *CTX ), evaluates the right hand side, using dde_lag() on S for
+    the delayed values.
+
+    double HISTORY ( double T, int I, void *CTX ), returns component I
+    of the solution at a time T <= T0.
+
+    void *CTX: the context passed to DYDT and HISTORY.
+
+    int M: the number of variables.
+
+    double T0: the initial time.  The initial condition is HISTORY at T0.
+
+    double DT: the stepsize.
+
+    double TAU_MAX: the largest delay.
+
+  Output:
+
+    dde_stepper *DDE_CREATE: the stepper, or NULL if DT or TAU_MAX is
+    not positive, or memory could not be allocated.
+*/
+{
+  int i;
+  int ld;
+  dde_stepper *s;
+  int slot_num;
+
+  if ( dt <= 0.0 || tau_max <= 0.0 )
+  {
+    return NULL;
+  }
+
+  s = ( dde_stepper * ) malloc ( sizeof ( dde_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  slot_num = ( int ) ceil ( tau_max / dt ) + 3;
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( ( 2 * slot_num + 4 ) * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->dydt = dydt;
+  s->history = history;
+  s->ctx = ctx;
+  s->m = m;
+  s->ld = ld;
+  s->t0 = t0;
+  s->dt = dt;
+  s->tau_max = tau_max;
+  s->slot_num = slot_num;
+  s->t = t0;
+  s->step_num = 0;
+  s->known = -1;
+  s->lost = 0;
+  s->ring_y = s->work;
+  s->ring_f = s->work + slot_num * ld;
+  s->k2     = s->work + ( 2 * slot_num     ) * ld;
+  s->k3     = s->work + ( 2 * slot_num + 1 ) * ld;
+  s->k4     = s->work + ( 2 * slot_num + 2 ) * ld;
+  s->u      = s->work + ( 2 * slot_num + 3 ) * ld;
+  s->y = s->ring_y;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = history ( t0, i, ctx );
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void dde_destroy ( dde_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    dde_destroy frees a delay differential equation stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    dde_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+double dde_lag ( dde_stepper *s, double t, int i )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    dde_lag returns component I of the solution at a past time T.
+
+  Discussion:
+
+    Step J, from T0 + J * DT to T0 + ( J + 1 ) * DT, is found directly
+    from T, and its points from J modulo SLOT_NUM.  The value is the
+    cubic Hermite interpolant of the solution and derivative at the two
+    ends of the step.
+
+    While a step is being taken, the derivative at its end is not yet
+    known.  A time past the last complete step, which only a delay
+    shorter than DT can ask for, is extrapolated from that step.
+
+    A time older than the ring sets S->LOST, and the oldest step is
+    used instead.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    dde_stepper *S: the stepper.
+
+    double T: the time.
+
+    int I: the component.
+
+  Output:
+
+    double DDE_LAG: the value of component I at T.
+*/
+{
+  long int a;
+  long int b;
+  double dt;
+  double h00;
+  double h01;
+  double h10;
+  double h11;
+  long int j;
+  long int oldest;
+  double theta;
+  double x;
+
+  if ( t <= s->t0 )
+  {
+    return s->history ( t, i, s->ctx );
+  }
+
+  if ( s->known < 1 )
+  {
+    return s->ring_y[i];
+  }
+
+  dt = s->dt;
+  x = ( t - s->t0 ) / dt;
+  j = ( long int ) floor ( x );
+
+  if ( s->known - 1 < j )
+  {
+    j = s->known - 1;
+  }
+
+  oldest = s->step_num + 1 - s->slot_num;
+  if ( j < oldest )
+  {
+    s->lost = 1;
+    j = oldest;
+  }
+
+  theta = x - ( double ) j;
+  a = ( j % s->slot_num ) * s->ld;
+  b = ( ( j + 1 ) % s->slot_num ) * s->ld;
+
+  h00 = ( 1.0 + 2.0 * theta ) * ( 1.0 - theta ) * ( 1.0 - theta );
+  h10 = theta * ( 1.0 - theta ) * ( 1.0 - theta );
+  h01 = theta * theta * ( 3.0 - 2.0 * theta );
+  h11 = theta * theta * ( theta - 1.0 );
+
+  return h00 * s->ring_y[a+i] + h10 * dt * s->ring_f[a+i]
+       + h01 * s->ring_y[b+i] + h11 * dt * s->ring_f[b+i];
+}
+/******************************************************************************/
+
+int dde_step ( dde_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    dde_step takes one RK4 step of size DT.
+
+  Discussion:
+
+    The first stage is the derivative at the start of the step, which
+    is kept in the ring for interpolation.  The new solution is written
+    into the ring slot of the oldest point, which no stage of this step
+    can reach.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    dde_stepper *S: the stepper.
+
+  Output:
+
+    dde_stepper *S: the advanced stepper.
+
+    int DDE_STEP: 0 on success, 1 if a delayed value older than TAU_MAX
+    was asked for.
+*/
+{
+  double dt;
+  double *f;
+  int i;
+  int ld;
+  int m;
+  long int n;
+  double t;
+  double *y;
+  double *ynew;
+
+  dt = s->dt;
+  ld = s->ld;
+  m = s->m;
+  n = s->step_num;
+  t = s->t;
+  y = s->ring_y + ( n % s->slot_num ) * ld;
+  f = s->ring_f + ( n % s->slot_num ) * ld;
+  ynew = s->ring_y + ( ( n + 1 ) % s->slot_num ) * ld;
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+
+  if ( s->known < n )
+  {
+    s->dydt ( t, y, f, s, s->ctx );
+    s->known = n;
+    RK4_STATS_ADD ( RK4_COUNT_EVAL, 1 );
+  }
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->u[i] = y[i] + dt * f[i] / 2.0;
+  }
+  s->dydt ( t + dt / 2.0, s->u, s->k2, s, s->ctx );
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->u[i] = y[i] + dt * s->k2[i] / 2.0;
+  }
+  s->dydt ( t + dt / 2.0, s->u, s->k3, s, s->ctx );
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->u[i] = y[i] + dt * s->k3[i];
+  }
+  s->dydt ( t + dt, s->u, s->k4, s, s->ctx );
+
+  for ( i = 0; i < m; i++ )
+  {
+    ynew[i] = y[i]
+      + dt * ( f[i] + 2.0 * s->k2[i] + 2.0 * s->k3[i] + s->k4[i] ) / 6.0;
+  }
+
+  RK4_STATS_TOC ( RK4_PHASE_STEP );
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 3 );
+
+  s->step_num = n + 1;
+  s->t = s->t0 + ( double ) ( n + 1 ) * dt;
+  s->y = ynew;
+
+  return s->lost;
+}
@@ -0,0 +1,54 @@
+/*
+  dde_stepper integrates the delay differential equation
+
+    Y'(T) = F ( T, Y(T), Y(T-TAU1), Y(T-TAU2), ... )
+
+  by RK4 with a fixed step DT.  DYDT ( T, Y, F, S, CTX ) reads delayed
+  values through dde_lag ( S, T - TAU, I ); a delay may be constant or
+  depend on T and Y, as long as it lies between DT and TAU_MAX.  For
+  T <= T0 the solution is given by HISTORY ( T, I, CTX ).
+
+  Past steps are kept in a ring of SLOT_NUM points, each with its
+  solution and derivative, so that the cubic Hermite interpolant of any
+  step in the last TAU_MAX is found by index arithmetic.  Memory grows
+  with TAU_MAX / DT, not with the length of the run.
+
+  Where the history or the solution has a jump in a derivative, the
+  order drops unless the jump falls on a step boundary; for a constant
+  delay, making TAU a multiple of DT ensures this.
+*/
+typedef struct dde_stepper dde_stepper;
+
+struct dde_stepper
+{
+  void ( *dydt ) ( double t, double y[], double f[], dde_stepper *s,
+    void *ctx );
+  double ( *history ) ( double t, int i, void *ctx );
+  void *ctx;
+  int m;
+  int ld;
+  double t0;
+  double dt;
+  double tau_max;
+  int slot_num;
+  double t;
+  long int step_num;
+  long int known;
+  int lost;
+  double *y;
+  double *ring_y;
+  double *ring_f;
+  double *k2;
+  double *k3;
+  double *k4;
+  double *u;
+  double *work;
+};
+
+int dde_advance ( dde_stepper *s, double t1 );
+dde_stepper *dde_create ( void dydt ( double t, double y[], double f[],
+  dde_stepper *s, void *ctx ), double history ( double t, int i, void *ctx ),
+  void *ctx, int m, double t0, double dt, double tau_max );
+void dde_destroy ( dde_stepper *s );
+double dde_lag ( dde_stepper *s, double t, int i );
+int dde_step ( dde_stepper *s );
@@ -0,0 +1,2107 @@
+# include <ctype.h>
+# include <math.h>
+# include <stdarg.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include "rk4.h"
+# include "expr.h"
+
+/*
+  Operations.  EXPR_NUM and EXPR_VAR are leaves of the graph and never
+  become instructions.  The functions EXPR_ABS to EXPR_TANH are in the
+  order of their names.
+*/
+# define EXPR_NUM 0
+# define EXPR_VAR 1
+# define EXPR_CONST 2
+# define EXPR_COPY 3
+# define EXPR_ADD 4
+# define EXPR_SUB 5
+# define EXPR_MUL 6
+# define EXPR_DIV 7
+# define EXPR_POW 8
+# define EXPR_AXPBY 9
+# define EXPR_ADDC 10
+# define EXPR_MULC 11
+# define EXPR_CSUB 12
+# define EXPR_CDIV 13
+# define EXPR_POWC 14
+# define EXPR_ABS 15
+# define EXPR_COS 16
+# define EXPR_EXP 17
+# define EXPR_LOG 18
+# define EXPR_SIN 19
+# define EXPR_SQRT 20
+# define EXPR_TANH 21
+
+static char *expr_op_name[EXPR_TANH+1] = {
+  "num", "var", "const", "copy", "add", "sub", "mul", "div", "pow",
+  "axpby", "addc", "mulc", "csub", "cdiv", "powc",
+  "abs", "cos", "exp", "log", "sin", "sqrt", "tanh" };
+
+/*
+  expr_symbol is a name and the graph node it stands for.
+*/
+typedef struct
+{
+  char name[EXPR_NAME_LEN];
+  int node;
+} expr_symbol;
+
+/*
+  expr_parser holds the state of one compilation.  The graph nodes are
+  kept as expr_code with DST unused, and HASH finds a node from its
+  contents, so that each distinct subexpression is made only once.
+  The first M symbols are the states.  DEPTH counts the open parentheses,
+  and NEST the calls of expr_unary() in progress, which bounds the
+  recursion of the parser.
+*/
+typedef struct
+{
+  char *s;
+  int line;
+  int depth;
+  int nest;
+  int failed;
+  char *error;
+  int m;
+  int *root;
+  int sym_num;
+  int sym_max;
+  expr_symbol *sym;
+  int node_num;
+  int node_max;
+  expr_code *node;
+  int hash_max;
+  int *hash;
+} expr_parser;
+
+static double expr_apply ( int op, double x, double y, double c, double d );
+static int expr_arity ( int op );
+static int expr_binary ( expr_parser *ps, int op, int a, int b );
+static void expr_exec ( expr_code *c, double **reg, int n );
+static void expr_fail ( expr_parser *ps, char *format, ... );
+static expr_program *expr_generate ( expr_parser *ps );
+static int expr_hash ( expr_code *n );
+static int expr_intern ( expr_parser *ps, int op, int a, int b, double c,
+  double d );
+static int expr_lin ( expr_parser *ps, int a, double ca, int b, double cb );
+static int expr_lookup ( expr_parser *ps, char *name );
+static int expr_name ( expr_parser *ps, char name[EXPR_NAME_LEN] );
+static int expr_op1 ( expr_parser *ps, int op, int a, double c );
+static void expr_parse ( expr_parser *ps, char *text );
+static int expr_power ( expr_parser *ps );
+static int expr_primary ( expr_parser *ps );
+static int expr_product ( expr_parser *ps );
+static void expr_push ( expr_parser *ps, char *name, int node );
+static void expr_reg_name ( expr_program *p, int r,
+  char name[EXPR_NAME_LEN+1] );
+static void expr_scan ( expr_parser *ps, char *text );
+static void expr_skip ( expr_parser *ps );
+static int expr_sum ( expr_parser *ps );
+static int expr_unary ( expr_parser *ps );
+
+/******************************************************************************/
+
+expr_program *expr_compile ( char *text, char error[EXPR_ERROR_LEN] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_compile compiles the text of an ODE right hand side.
+
+  Discussion:
+
+    A first pass finds the states, so that an intermediate may use a
+    state whose equation comes later.  The second pass builds the graph,
+    and expr_generate() turns it into code.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    char *TEXT: the statements, as described in expr.h.
+
+  Output:
+
+    char ERROR[EXPR_ERROR_LEN]: if the text could not be compiled, a
+    message such as "line 3: unknown name 'q'", and otherwise an empty
+    string.  ERROR may be NULL.
+
+    expr_program *EXPR_COMPILE: the program, or NULL if the text has an
+    error or memory could not be allocated.
+*/
+{
+  expr_program *p;
+  expr_parser ps;
+
+  ps.s = text;
+  ps.line = 1;
+  ps.depth = 0;
+  ps.nest = 0;
+  ps.failed = 0;
+  ps.error = error;
+  ps.m = 0;
+  ps.root = NULL;
+  ps.sym_num = 0;
+  ps.sym_max = 0;
+  ps.sym = NULL;
+  ps.node_num = 0;
+  ps.node_max = 0;
+  ps.node = NULL;
+  ps.hash_max = 0;
+  ps.hash = NULL;
+
+  if ( error != NULL )
+  {
+    error[0] = '\0';
+  }
+
+  p = NULL;
+
+  expr_scan ( &ps, text );
+  if ( !ps.failed )
+  {
+    expr_parse ( &ps, text );
+  }
+  if ( !ps.failed )
+  {
+    p = expr_generate ( &ps );
+  }
+
+  free ( ps.root );
+  free ( ps.sym );
+  free ( ps.node );
+  free ( ps.hash );
+
+  return p;
+}
+/******************************************************************************/
+
+void expr_deriv ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_deriv evaluates a compiled right hand side for one state.
+
+  Discussion:
+
+    This is the right hand side to pass to rk4_ctx(),
+    rk4_stepper_create_ctx() and the other context integrators, with the
+    program as CTX.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T: the time.
+
+    double U[M]: the state.
+
+    void *CTX: the expr_program.
+
+  Output:
+
+    double F[M]: the derivative.
+*/
+{
+  expr_eval ( ( expr_program * ) ctx, t, 1, 1, u, f );
+
+  return;
+}
+/******************************************************************************/
+
+void expr_deriv_batch ( double t, int nens, int m, int ld, double u[],
+  double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_deriv_batch evaluates a compiled right hand side for an ensemble.
+
+  Discussion:
+
+    This is the right hand side to pass to rk4_ensemble_create_ctx(),
+    with the program as CTX.
+
+    If M is not the M of the program, the right hand side cannot be
+    evaluated, and F is set to NaN, so that the integration visibly
+    fails instead of reading or writing past the arrays.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T: the time.
+
+    int NENS: the number of members.
+
+    int M: the number of variables, which should be the M of the program.
+
+    int LD: the leading dimension.
+
+    double U[M*LD]: the states.  Component I of member K is U[I*LD+K].
+
+    void *CTX: the expr_program.
+
+  Output:
+
+    double F[M*LD]: the derivatives, in the same layout.
+*/
+{
+  int i;
+  int k;
+  expr_program *p;
+
+  p = ( expr_program * ) ctx;
+
+  if ( m != p->m )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      for ( k = 0; k < nens; k++ )
+      {
+        f[i*ld+k] = NAN;
+      }
+    }
+    return;
+  }
+
+  expr_eval ( p, t, nens, ld, u, f );
+
+  return;
+}
+/******************************************************************************/
+
+void expr_destroy ( expr_program *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_destroy frees a compiled right hand side.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    expr_program *P: the program.  P may be NULL.
+*/
+{
+  if ( p == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( p->work );
+  free ( p->reg );
+  free ( p->code );
+  free ( p->name );
+  free ( p );
+
+  return;
+}
+/******************************************************************************/
+
+void expr_eval ( expr_program *p, double t, int nens, int ld, double u[],
+  double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_eval evaluates a compiled right hand side for NENS states.
+
+  Discussion:
+
+    The members are taken EXPR_BLOCK at a time.  For each block the
+    state and derivative registers are pointed at the block's part of U
+    and F, and the code is run once, each instruction a loop over the
+    block.  U and F must not overlap.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    expr_program *P: the program.
+
+    double T: the time.
+
+    int NENS: the number of members.
+
+    int LD: the leading dimension.
+
+    double U[M*LD]: the states.  Component I of member K is U[I*LD+K].
+
+  Output:
+
+    double F[M*LD]: the derivatives, in the same layout.
+*/
+{
+  int i;
+  int j;
+  int k;
+  int k0;
+  int m;
+  int n;
+
+  m = p->m;
+
+  if ( p->uses_t )
+  {
+    for ( k = 0; k < EXPR_BLOCK; k++ )
+    {
+      p->reg[0][k] = t;
+    }
+  }
+
+  for ( k0 = 0; k0 < nens; k0 = k0 + EXPR_BLOCK )
+  {
+    n = nens - k0;
+    if ( EXPR_BLOCK < n )
+    {
+      n = EXPR_BLOCK;
+    }
+
+    for ( i = 0; i < m; i++ )
+    {
+      p->reg[1+i] = u + i * ld + k0;
+      p->reg[1+m+i] = f + i * ld + k0;
+    }
+
+    for ( j = 0; j < p->code_num; j++ )
+    {
+      expr_exec ( p->code + j, p->reg, n );
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void expr_print ( expr_program *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_print lists the code of a compiled right hand side.
+
+  Discussion:
+
+    States are shown by name, derivatives with a prime, and temporary
+    registers as $0, $1, and so on.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    expr_program *P: the program.
+*/
+{
+  char a[EXPR_NAME_LEN+1];
+  char b[EXPR_NAME_LEN+1];
+  expr_code *c;
+  char dst[EXPR_NAME_LEN+1];
+  int j;
+
+  printf ( "  %d instructions, %d registers\n", p->code_num, p->reg_num );
+
+  for ( j = 0; j < p->code_num; j++ )
+  {
+    c = p->code + j;
+    expr_reg_name ( p, c->dst, dst );
+    printf ( "  %-6s %s =", expr_op_name[c->op], dst );
+    if ( c->op == EXPR_CONST )
+    {
+      printf ( " %g\n", c->c );
+      continue;
+    }
+    expr_reg_name ( p, c->a, a );
+    printf ( " %s", a );
+    if ( expr_arity ( c->op ) == 2 )
+    {
+      expr_reg_name ( p, c->b, b );
+      printf ( ", %s", b );
+    }
+    if ( c->op == EXPR_AXPBY )
+    {
+      printf ( "; %g, %g", c->c, c->d );
+    }
+    else if ( EXPR_ADDC <= c->op && c->op <= EXPR_POWC )
+    {
+      printf ( "; %g", c->c );
+    }
+    printf ( "\n" );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static double expr_apply ( int op, double x, double y, double c, double d )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_apply applies one operation to scalars, to fold constants.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  switch ( op )
+  {
+    case EXPR_ADD:
+      return x + y;
+    case EXPR_SUB:
+      return x - y;
+    case EXPR_MUL:
+      return x * y;
+    case EXPR_DIV:
+      return x / y;
+    case EXPR_POW:
+      return pow ( x, y );
+    case EXPR_AXPBY:
+      return c * x + d * y;
+    case EXPR_ADDC:
+      return x + c;
+    case EXPR_MULC:
+      return c * x;
+    case EXPR_CSUB:
+      return c - x;
+    case EXPR_CDIV:
+      return c / x;
+    case EXPR_POWC:
+      return pow ( x, c );
+    case EXPR_ABS:
+      return fabs ( x );
+    case EXPR_COS:
+      return cos ( x );
+    case EXPR_EXP:
+      return exp ( x );
+    case EXPR_LOG:
+      return log ( x );
+    case EXPR_SIN:
+      return sin ( x );
+    case EXPR_SQRT:
+      return sqrt ( x );
+    case EXPR_TANH:
+      return tanh ( x );
+  }
+
+  return x;
+}
+/******************************************************************************/
+
+static int expr_arity ( int op )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_arity returns the number of register operands of an operation.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  if ( op == EXPR_NUM || op == EXPR_VAR || op == EXPR_CONST )
+  {
+    return 0;
+  }
+  if ( EXPR_ADD <= op && op <= EXPR_AXPBY )
+  {
+    return 2;
+  }
+  return 1;
+}
+/******************************************************************************/
+
+static int expr_binary ( expr_parser *ps, int op, int a, int b )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_binary makes the node for A OP B, where OP is EXPR_ADD,
+    EXPR_SUB, EXPR_MUL, EXPR_DIV or EXPR_POW.
+
+  Discussion:
+
+    A constant operand becomes part of the instruction.  Constant
+    factors are moved out of products and quotients, where they can
+    merge with other constants or into a sum, and the operands of a
+    product are put in a standard order, so that R * F and F * R are
+    the same node.
+
+    C ^ X becomes EXP ( X * LOG ( C ) ) when C > 0.  Otherwise C is
+    loaded into a register by an EXPR_CONST node, and POW is used, so
+    that ( -2 ) ^ 3 is -8 and 0 ^ 0 is 1, as with C.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double ca;
+  double cb;
+  int k;
+  expr_code na;
+  expr_code nb;
+
+  if ( a < 0 || b < 0 )
+  {
+    return -1;
+  }
+
+  na = ps->node[a];
+  nb = ps->node[b];
+
+  if ( na.op == EXPR_NUM && nb.op == EXPR_NUM )
+  {
+    return expr_intern ( ps, EXPR_NUM, -1, -1,
+      expr_apply ( op, na.c, nb.c, 0.0, 0.0 ), 0.0 );
+  }
+
+  if ( op == EXPR_ADD )
+  {
+    if ( na.op == EXPR_NUM )
+    {
+      return expr_op1 ( ps, EXPR_ADDC, b, na.c );
+    }
+    if ( nb.op == EXPR_NUM )
+    {
+      return expr_op1 ( ps, EXPR_ADDC, a, nb.c );
+    }
+    return expr_lin ( ps, a, 1.0, b, 1.0 );
+  }
+
+  if ( op == EXPR_SUB )
+  {
+    if ( nb.op == EXPR_NUM )
+    {
+      return expr_op1 ( ps, EXPR_ADDC, a, - nb.c );
+    }
+    if ( na.op == EXPR_NUM )
+    {
+      return expr_op1 ( ps, EXPR_CSUB, b, na.c );
+    }
+    return expr_lin ( ps, a, 1.0, b, -1.0 );
+  }
+
+  if ( op == EXPR_POW )
+  {
+    if ( nb.op == EXPR_NUM )
+    {
+      return expr_op1 ( ps, EXPR_POWC, a, nb.c );
+    }
+    if ( na.op == EXPR_NUM && 0.0 < na.c )
+    {
+      return expr_op1 ( ps, EXPR_EXP,
+        expr_op1 ( ps, EXPR_MULC, b, log ( na.c ) ), 0.0 );
+    }
+    if ( na.op == EXPR_NUM )
+    {
+      a = expr_intern ( ps, EXPR_CONST, -1, -1, na.c, 0.0 );
+    }
+    return expr_intern ( ps, EXPR_POW, a, b, 0.0, 0.0 );
+  }
+/*
+  Products and quotients.
+*/
+  if ( op == EXPR_MUL && na.op == EXPR_NUM )
+  {
+    return expr_op1 ( ps, EXPR_MULC, b, na.c );
+  }
+  if ( nb.op == EXPR_NUM )
+  {
+    if ( op == EXPR_MUL )
+    {
+      return expr_op1 ( ps, EXPR_MULC, a, nb.c );
+    }
+    return expr_op1 ( ps, EXPR_MULC, a, 1.0 / nb.c );
+  }
+  if ( na.op == EXPR_NUM )
+  {
+    return expr_op1 ( ps, EXPR_CDIV, b, na.c );
+  }
+
+  ca = 1.0;
+  if ( na.op == EXPR_MULC )
+  {
+    ca = na.c;
+    a = na.a;
+  }
+  cb = 1.0;
+  if ( nb.op == EXPR_MULC )
+  {
+    cb = nb.c;
+    b = nb.a;
+  }
+
+  if ( op == EXPR_DIV )
+  {
+    return expr_op1 ( ps, EXPR_MULC,
+      expr_intern ( ps, EXPR_DIV, a, b, 0.0, 0.0 ), ca / cb );
+  }
+
+  if ( b < a )
+  {
+    k = a;
+    a = b;
+    b = k;
+  }
+  return expr_op1 ( ps, EXPR_MULC,
+    expr_intern ( ps, EXPR_MUL, a, b, 0.0, 0.0 ), ca * cb );
+}
+/******************************************************************************/
+
+static void expr_exec ( expr_code *c, double **reg, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_exec runs one instruction over N members.
+
+  Discussion:
+
+    The destination never shares a register with an operand, so each
+    loop is free to vectorize.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double cc;
+  double dd;
+  int k;
+  double *x;
+  double *y;
+  double *z;
+
+  cc = c->c;
+  dd = c->d;
+  x = reg[c->a < 0 ? 0 : c->a];
+  y = reg[c->b < 0 ? 0 : c->b];
+  z = reg[c->dst];
+
+  switch ( c->op )
+  {
+    case EXPR_CONST:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = cc;
+      }
+      break;
+    case EXPR_COPY:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = x[k];
+      }
+      break;
+    case EXPR_ADD:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = x[k] + y[k];
+      }
+      break;
+    case EXPR_SUB:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = x[k] - y[k];
+      }
+      break;
+    case EXPR_MUL:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = x[k] * y[k];
+      }
+      break;
+    case EXPR_DIV:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = x[k] / y[k];
+      }
+      break;
+    case EXPR_POW:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = pow ( x[k], y[k] );
+      }
+      break;
+    case EXPR_AXPBY:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = cc * x[k] + dd * y[k];
+      }
+      break;
+    case EXPR_ADDC:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = x[k] + cc;
+      }
+      break;
+    case EXPR_MULC:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = cc * x[k];
+      }
+      break;
+    case EXPR_CSUB:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = cc - x[k];
+      }
+      break;
+    case EXPR_CDIV:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = cc / x[k];
+      }
+      break;
+    case EXPR_POWC:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = pow ( x[k], cc );
+      }
+      break;
+    case EXPR_ABS:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = fabs ( x[k] );
+      }
+      break;
+    case EXPR_COS:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = cos ( x[k] );
+      }
+      break;
+    case EXPR_EXP:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = exp ( x[k] );
+      }
+      break;
+    case EXPR_LOG:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = log ( x[k] );
+      }
+      break;
+    case EXPR_SIN:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = sin ( x[k] );
+      }
+      break;
+    case EXPR_SQRT:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = sqrt ( x[k] );
+      }
+      break;
+    case EXPR_TANH:
+      for ( k = 0; k < n; k++ )
+      {
+        z[k] = tanh ( x[k] );
+      }
+      break;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void expr_fail ( expr_parser *ps, char *format, ... )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_fail records the first error of a compilation.
+
+  Discussion:
+
+    The message is prefixed with the line number, unless PS->LINE is 0.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  va_list args;
+  int n;
+
+  if ( ps->failed )
+  {
+    return;
+  }
+  ps->failed = 1;
+
+  if ( ps->error == NULL )
+  {
+    return;
+  }
+
+  n = 0;
+  if ( 0 < ps->line )
+  {
+    n = snprintf ( ps->error, EXPR_ERROR_LEN, "line %d: ", ps->line );
+  }
+
+  va_start ( args, format );
+  vsnprintf ( ps->error + n, EXPR_ERROR_LEN - n, format, args );
+  va_end ( args );
+
+  return;
+}
+/******************************************************************************/
+
+static expr_program *expr_generate ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_generate turns the graph into register code.
+
+  Discussion:
+
+    Registers are numbered as follows: 0 is the time, 1 to M the states,
+    M+1 to 2*M the derivatives, and the rest temporaries.  A node whose
+    only use is as the derivative of state I is computed directly into
+    register M+1+I; any other derivative is copied at the end.
+
+    Nodes are made after their operands, so node order is an order of
+    evaluation.  Nodes not reached from a derivative are dropped.  A
+    temporary is freed after the instruction that uses its value for
+    the last time, but never reused as that instruction's destination.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  expr_code *c;
+  int dst;
+  int free_num;
+  int *free_reg;
+  int i;
+  int j;
+  int m;
+  expr_code *nd;
+  int *out;
+  expr_program *p;
+  int *reg;
+  int temp_num;
+  int *use;
+  int x;
+  int xi;
+
+  m = ps->m;
+  ps->line = 0;
+
+  p = ( expr_program * ) malloc ( sizeof ( expr_program ) );
+  use = ( int * ) calloc ( ps->node_num, sizeof ( int ) );
+  reg = ( int * ) malloc ( ps->node_num * sizeof ( int ) );
+  out = ( int * ) malloc ( ps->node_num * sizeof ( int ) );
+  free_reg = ( int * ) malloc ( ps->node_num * sizeof ( int ) );
+  if ( p != NULL )
+  {
+    p->name = ( char * ) malloc ( m * EXPR_NAME_LEN );
+    p->code = ( expr_code * ) malloc ( ( ps->node_num + m )
+      * sizeof ( expr_code ) );
+    p->reg = NULL;
+    p->work = NULL;
+  }
+
+  if ( p == NULL || use == NULL || reg == NULL || out == NULL
+    || free_reg == NULL || p->name == NULL || p->code == NULL )
+  {
+    expr_fail ( ps, "out of memory" );
+    expr_destroy ( p );
+    free ( use );
+    free ( reg );
+    free ( out );
+    free ( free_reg );
+    return NULL;
+  }
+
+  p->m = m;
+  p->uses_t = 0;
+  p->code_num = 0;
+  for ( i = 0; i < m; i++ )
+  {
+    strcpy ( p->name + i * EXPR_NAME_LEN, ps->sym[i].name );
+  }
+/*
+  Count the uses of every node reached from a derivative.
+*/
+  for ( i = 0; i < m; i++ )
+  {
+    use[ps->root[i]] = use[ps->root[i]] + 1;
+  }
+  for ( j = ps->node_num - 1; 0 <= j; j-- )
+  {
+    nd = ps->node + j;
+    out[j] = -1;
+    if ( use[j] == 0 )
+    {
+      continue;
+    }
+    if ( 1 <= expr_arity ( nd->op ) )
+    {
+      use[nd->a] = use[nd->a] + 1;
+    }
+    if ( expr_arity ( nd->op ) == 2 )
+    {
+      use[nd->b] = use[nd->b] + 1;
+    }
+  }
+  for ( i = 0; i < m; i++ )
+  {
+    j = ps->root[i];
+    if ( use[j] == 1 && 1 <= expr_arity ( ps->node[j].op ) )
+    {
+      out[j] = m + 1 + i;
+    }
+  }
+/*
+  Emit the nodes in order.
+*/
+  free_num = 0;
+  temp_num = 0;
+
+  for ( j = 0; j < ps->node_num; j++ )
+  {
+    nd = ps->node + j;
+    reg[j] = -1;
+    if ( use[j] == 0 || nd->op == EXPR_NUM )
+    {
+      continue;
+    }
+    if ( nd->op == EXPR_VAR )
+    {
+      reg[j] = nd->a;
+      if ( nd->a == 0 )
+      {
+        p->uses_t = 1;
+      }
+      continue;
+    }
+
+    if ( 0 <= out[j] )
+    {
+      dst = out[j];
+    }
+    else if ( 0 < free_num )
+    {
+      free_num = free_num - 1;
+      dst = free_reg[free_num];
+    }
+    else
+    {
+      dst = 2 * m + 1 + temp_num;
+      temp_num = temp_num + 1;
+    }
+
+    c = p->code + p->code_num;
+    p->code_num = p->code_num + 1;
+    c->op = nd->op;
+    c->dst = dst;
+    c->a = -1;
+    if ( 1 <= expr_arity ( nd->op ) )
+    {
+      c->a = reg[nd->a];
+    }
+    c->b = -1;
+    if ( expr_arity ( nd->op ) == 2 )
+    {
+      c->b = reg[nd->b];
+    }
+    c->c = nd->c;
+    c->d = nd->d;
+    reg[j] = dst;
+
+    for ( xi = 0; xi < expr_arity ( nd->op ); xi++ )
+    {
+      x = ( xi == 0 ) ? nd->a : nd->b;
+      use[x] = use[x] - 1;
+      if ( use[x] == 0 && 2 * m < reg[x] )
+      {
+        free_reg[free_num] = reg[x];
+        free_num = free_num + 1;
+      }
+    }
+  }
+/*
+  Derivatives that are constants, states, or shared.
+*/
+  for ( i = 0; i < m; i++ )
+  {
+    j = ps->root[i];
+    if ( out[j] == m + 1 + i )
+    {
+      continue;
+    }
+    c = p->code + p->code_num;
+    p->code_num = p->code_num + 1;
+    c->op = ( ps->node[j].op == EXPR_NUM ) ? EXPR_CONST : EXPR_COPY;
+    c->dst = m + 1 + i;
+    c->a = reg[j];
+    c->b = -1;
+    c->c = ps->node[j].c;
+    c->d = 0.0;
+  }
+
+  free ( use );
+  free ( reg );
+  free ( out );
+  free ( free_reg );
+
+  p->reg_num = 2 * m + 1 + temp_num;
+  p->reg = ( double ** ) malloc ( p->reg_num * sizeof ( double * ) );
+  p->work = r8vec_aligned_new ( ( 1 + temp_num ) * EXPR_BLOCK );
+  if ( p->reg == NULL || p->work == NULL )
+  {
+    expr_fail ( ps, "out of memory" );
+    expr_destroy ( p );
+    return NULL;
+  }
+
+  for ( i = 0; i < p->reg_num; i++ )
+  {
+    p->reg[i] = NULL;
+  }
+  p->reg[0] = p->work;
+  for ( i = 0; i < temp_num; i++ )
+  {
+    p->reg[2*m+1+i] = p->work + ( 1 + i ) * EXPR_BLOCK;
+  }
+
+  return p;
+}
+/******************************************************************************/
+
+static int expr_hash ( expr_code *n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_hash returns a nonnegative hash of the contents of a node.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  unsigned long long int bits;
+  unsigned long long int h;
+
+  h = ( unsigned long long int ) n->op;
+  h = h * 1000003ULL + ( unsigned long long int ) ( n->a + 1 );
+  h = h * 1000003ULL + ( unsigned long long int ) ( n->b + 1 );
+  memcpy ( &bits, &n->c, sizeof ( double ) );
+  h = h * 1000003ULL + bits;
+  memcpy ( &bits, &n->d, sizeof ( double ) );
+  h = h * 1000003ULL + bits;
+  h = h ^ ( h >> 33 );
+  h = h * 0xff51afd7ed558ccdULL;
+  h = h ^ ( h >> 33 );
+
+  return ( int ) ( h & 0x7fffffffULL );
+}
+/******************************************************************************/
+
+static int expr_intern ( expr_parser *ps, int op, int a, int b, double c,
+  double d )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_intern returns the node with the given contents, making it if
+    it does not yet exist.
+
+  Discussion:
+
+    The node table is hashed with open addressing, and kept at most half
+    full.  Constants are compared bit by bit.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int *hash;
+  int hash_max;
+  int i;
+  int j;
+  expr_code key;
+  expr_code *node;
+
+  if ( ps->failed )
+  {
+    return -1;
+  }
+
+  key.op = op;
+  key.dst = -1;
+  key.a = a;
+  key.b = b;
+  key.c = c;
+  key.d = d;
+/*
+  Grow the tables.
+*/
+  if ( ps->node_num == ps->node_max )
+  {
+    j = ( ps->node_max == 0 ) ? 64 : 2 * ps->node_max;
+    node = ( expr_code * ) realloc ( ps->node, j * sizeof ( expr_code ) );
+    if ( node == NULL )
+    {
+      expr_fail ( ps, "out of memory" );
+      return -1;
+    }
+    ps->node = node;
+    ps->node_max = j;
+  }
+
+  if ( ps->hash_max < 2 * ( ps->node_num + 1 ) )
+  {
+    hash_max = ( ps->hash_max == 0 ) ? 128 : 2 * ps->hash_max;
+    hash = ( int * ) malloc ( hash_max * sizeof ( int ) );
+    if ( hash == NULL )
+    {
+      expr_fail ( ps, "out of memory" );
+      return -1;
+    }
+    for ( j = 0; j < hash_max; j++ )
+    {
+      hash[j] = -1;
+    }
+    for ( i = 0; i < ps->node_num; i++ )
+    {
+      j = expr_hash ( ps->node + i ) & ( hash_max - 1 );
+      while ( 0 <= hash[j] )
+      {
+        j = ( j + 1 ) & ( hash_max - 1 );
+      }
+      hash[j] = i;
+    }
+    free ( ps->hash );
+    ps->hash = hash;
+    ps->hash_max = hash_max;
+  }
+/*
+  Look for the node, and add it if it is new.
+*/
+  j = expr_hash ( &key ) & ( ps->hash_max - 1 );
+
+  while ( 0 <= ps->hash[j] )
+  {
+    node = ps->node + ps->hash[j];
+    if ( node->op == op && node->a == a && node->b == b
+      && memcmp ( &node->c, &c, sizeof ( double ) ) == 0
+      && memcmp ( &node->d, &d, sizeof ( double ) ) == 0 )
+    {
+      return ps->hash[j];
+    }
+    j = ( j + 1 ) & ( ps->hash_max - 1 );
+  }
+
+  ps->node[ps->node_num] = key;
+  ps->hash[j] = ps->node_num;
+  ps->node_num = ps->node_num + 1;
+
+  return ps->node_num - 1;
+}
+/******************************************************************************/
+
+static int expr_lin ( expr_parser *ps, int a, double ca, int b, double cb )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_lin makes the node for CA * A + CB * B.
+
+  Discussion:
+
+    Constant factors of A and B are taken into CA and CB, so that a sum
+    of scaled terms is one EXPR_AXPBY instruction.  Plain sums and
+    differences stay EXPR_ADD and EXPR_SUB.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double ck;
+  int k;
+
+  if ( ps->node[a].op == EXPR_MULC )
+  {
+    ca = ca * ps->node[a].c;
+    a = ps->node[a].a;
+  }
+  if ( ps->node[b].op == EXPR_MULC )
+  {
+    cb = cb * ps->node[b].c;
+    b = ps->node[b].a;
+  }
+
+  if ( a == b )
+  {
+    return expr_op1 ( ps, EXPR_MULC, a, ca + cb );
+  }
+
+  if ( b < a )
+  {
+    k = a;
+    a = b;
+    b = k;
+    ck = ca;
+    ca = cb;
+    cb = ck;
+  }
+
+  if ( ca == 1.0 && cb == 1.0 )
+  {
+    return expr_intern ( ps, EXPR_ADD, a, b, 0.0, 0.0 );
+  }
+  if ( ca == 1.0 && cb == -1.0 )
+  {
+    return expr_intern ( ps, EXPR_SUB, a, b, 0.0, 0.0 );
+  }
+  if ( ca == -1.0 && cb == 1.0 )
+  {
+    return expr_intern ( ps, EXPR_SUB, b, a, 0.0, 0.0 );
+  }
+  return expr_intern ( ps, EXPR_AXPBY, a, b, ca, cb );
+}
+/******************************************************************************/
+
+static int expr_lookup ( expr_parser *ps, char *name )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_lookup returns the index of the latest symbol called NAME, or
+    -1 if there is none.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+  for ( i = ps->sym_num - 1; 0 <= i; i-- )
+  {
+    if ( strcmp ( ps->sym[i].name, name ) == 0 )
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+/******************************************************************************/
+
+static int expr_name ( expr_parser *ps, char name[EXPR_NAME_LEN] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_name reads a name, if the text has one at this point.
+
+  Discussion:
+
+    A name is a letter or underscore, followed by letters, digits and
+    underscores.  The return value is 1 if a name was read.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int n;
+
+  if ( !isalpha ( ( unsigned char ) *ps->s ) && *ps->s != '_' )
+  {
+    return 0;
+  }
+
+  n = 0;
+  while ( isalnum ( ( unsigned char ) *ps->s ) || *ps->s == '_' )
+  {
+    if ( n < EXPR_NAME_LEN - 1 )
+    {
+      name[n] = *ps->s;
+    }
+    n = n + 1;
+    ps->s = ps->s + 1;
+  }
+
+  if ( EXPR_NAME_LEN - 1 < n )
+  {
+    name[EXPR_NAME_LEN-1] = '\0';
+    expr_fail ( ps, "name '%s...' is too long", name );
+    return 0;
+  }
+  name[n] = '\0';
+
+  return 1;
+}
+/******************************************************************************/
+
+static int expr_op1 ( expr_parser *ps, int op, int a, double c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_op1 makes the node for an operation with one register operand A
+    and a constant C.
+
+  Discussion:
+
+    A scale of a scale becomes one scale, and small constant powers
+    become products or square roots.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  expr_code na;
+
+  if ( a < 0 )
+  {
+    return -1;
+  }
+
+  na = ps->node[a];
+
+  if ( na.op == EXPR_NUM )
+  {
+    return expr_intern ( ps, EXPR_NUM, -1, -1,
+      expr_apply ( op, na.c, 0.0, c, 0.0 ), 0.0 );
+  }
+
+  if ( op == EXPR_ADDC && c == 0.0 )
+  {
+    return a;
+  }
+
+  if ( op == EXPR_MULC )
+  {
+    if ( na.op == EXPR_MULC )
+    {
+      c = c * na.c;
+      a = na.a;
+    }
+    if ( c == 1.0 )
+    {
+      return a;
+    }
+  }
+
+  if ( op == EXPR_POWC )
+  {
+    if ( c == 1.0 )
+    {
+      return a;
+    }
+    if ( c == 2.0 )
+    {
+      return expr_binary ( ps, EXPR_MUL, a, a );
+    }
+    if ( c == 0.5 )
+    {
+      return expr_op1 ( ps, EXPR_SQRT, a, 0.0 );
+    }
+    if ( c == -1.0 )
+    {
+      return expr_op1 ( ps, EXPR_CDIV, a, 1.0 );
+    }
+  }
+
+  return expr_intern ( ps, op, a, -1, c, 0.0 );
+}
+/******************************************************************************/
+
+static void expr_parse ( expr_parser *ps, char *text )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_parse builds the graph for every statement.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  char name[EXPR_NAME_LEN];
+  int node;
+  int prime;
+
+  ps->root = ( int * ) malloc ( ps->m * sizeof ( int ) );
+  if ( ps->root == NULL )
+  {
+    expr_fail ( ps, "out of memory" );
+    return;
+  }
+
+  for ( i = 0; i < ps->m; i++ )
+  {
+    ps->sym[i].node = expr_intern ( ps, EXPR_VAR, 1 + i, -1, 0.0, 0.0 );
+  }
+
+  ps->s = text;
+  ps->line = 1;
+
+  while ( !ps->failed )
+  {
+    expr_skip ( ps );
+    if ( *ps->s == '\0' )
+    {
+      break;
+    }
+    if ( *ps->s == '\n' || *ps->s == ';' )
+    {
+      if ( *ps->s == '\n' )
+      {
+        ps->line = ps->line + 1;
+      }
+      ps->s = ps->s + 1;
+      continue;
+    }
+
+    if ( !expr_name ( ps, name ) )
+    {
+      expr_fail ( ps, "expected a name" );
+      break;
+    }
+    expr_skip ( ps );
+    prime = ( *ps->s == '\'' );
+    if ( prime )
+    {
+      ps->s = ps->s + 1;
+      expr_skip ( ps );
+    }
+    if ( *ps->s != '=' )
+    {
+      expr_fail ( ps, "expected '=' after '%s%s'", name, prime ? "'" : "" );
+      break;
+    }
+    ps->s = ps->s + 1;
+
+    node = expr_sum ( ps );
+    if ( node < 0 )
+    {
+      break;
+    }
+    expr_skip ( ps );
+    if ( *ps->s != '\0' && *ps->s != '\n' && *ps->s != ';' )
+    {
+      expr_fail ( ps, "unexpected '%c'", *ps->s );
+      break;
+    }
+
+    i = expr_lookup ( ps, name );
+    if ( prime )
+    {
+      ps->root[i] = node;
+    }
+    else if ( 0 <= i && i < ps->m )
+    {
+      expr_fail ( ps, "'%s' is a state", name );
+    }
+    else if ( strcmp ( name, "t" ) == 0 || strcmp ( name, "pi" ) == 0 )
+    {
+      expr_fail ( ps, "'%s' is reserved", name );
+    }
+    else
+    {
+      expr_push ( ps, name, node );
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static int expr_power ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_power parses a primary, optionally raised to a power.
+
+  Discussion:
+
+    The exponent may carry a sign, and ^ groups to the right, so that
+    A ^ B ^ C is A ^ ( B ^ C ) and - A ^ 2 is - ( A ^ 2 ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int a;
+  int b;
+
+  a = expr_primary ( ps );
+  if ( a < 0 )
+  {
+    return -1;
+  }
+
+  expr_skip ( ps );
+  if ( *ps->s != '^' )
+  {
+    return a;
+  }
+  ps->s = ps->s + 1;
+
+  b = expr_unary ( ps );
+
+  return expr_binary ( ps, EXPR_POW, a, b );
+}
+/******************************************************************************/
+
+static int expr_primary ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_primary parses a number, a name, a function call or a
+    parenthesized expression.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int a;
+  int b;
+  char *end;
+  int i;
+  char name[EXPR_NAME_LEN];
+  int op;
+  double value;
+
+  expr_skip ( ps );
+
+  if ( *ps->s == '(' )
+  {
+    ps->depth = ps->depth + 1;
+    ps->s = ps->s + 1;
+    a = expr_sum ( ps );
+    if ( a < 0 )
+    {
+      return -1;
+    }
+    expr_skip ( ps );
+    if ( *ps->s != ')' )
+    {
+      expr_fail ( ps, "expected ')'" );
+      return -1;
+    }
+    ps->depth = ps->depth - 1;
+    ps->s = ps->s + 1;
+    return a;
+  }
+
+  if ( isdigit ( ( unsigned char ) *ps->s ) || *ps->s == '.' )
+  {
+    value = strtod ( ps->s, &end );
+    if ( end == ps->s )
+    {
+      expr_fail ( ps, "bad number" );
+      return -1;
+    }
+    ps->s = end;
+    return expr_intern ( ps, EXPR_NUM, -1, -1, value, 0.0 );
+  }
+
+  if ( expr_name ( ps, name ) )
+  {
+    expr_skip ( ps );
+/*
+  A function call.
+*/
+    if ( *ps->s == '(' )
+    {
+      op = -1;
+      for ( i = EXPR_ABS; i <= EXPR_TANH; i++ )
+      {
+        if ( strcmp ( name, expr_op_name[i] ) == 0 )
+        {
+          op = i;
+        }
+      }
+      if ( strcmp ( name, "pow" ) == 0 )
+      {
+        op = EXPR_POW;
+      }
+      if ( op < 0 )
+      {
+        expr_fail ( ps, "unknown function '%s'", name );
+        return -1;
+      }
+
+      ps->depth = ps->depth + 1;
+      ps->s = ps->s + 1;
+      a = expr_sum ( ps );
+      if ( a < 0 )
+      {
+        return -1;
+      }
+      expr_skip ( ps );
+      if ( op == EXPR_POW )
+      {
+        if ( *ps->s != ',' )
+        {
+          expr_fail ( ps, "expected ','" );
+          return -1;
+        }
+        ps->s = ps->s + 1;
+        b = expr_sum ( ps );
+        if ( b < 0 )
+        {
+          return -1;
+        }
+        expr_skip ( ps );
+      }
+      if ( *ps->s != ')' )
+      {
+        expr_fail ( ps, "expected ')'" );
+        return -1;
+      }
+      ps->depth = ps->depth - 1;
+      ps->s = ps->s + 1;
+
+      if ( op == EXPR_POW )
+      {
+        return expr_binary ( ps, EXPR_POW, a, b );
+      }
+      return expr_op1 ( ps, op, a, 0.0 );
+    }
+/*
+  A name.
+*/
+    if ( strcmp ( name, "t" ) == 0 )
+    {
+      return expr_intern ( ps, EXPR_VAR, 0, -1, 0.0, 0.0 );
+    }
+    if ( strcmp ( name, "pi" ) == 0 )
+    {
+      return expr_intern ( ps, EXPR_NUM, -1, -1, 3.141592653589793, 0.0 );
+    }
+    i = expr_lookup ( ps, name );
+    if ( i < 0 )
+    {
+      expr_fail ( ps, "unknown name '%s'", name );
+      return -1;
+    }
+    return ps->sym[i].node;
+  }
+
+  if ( ps->failed )
+  {
+    return -1;
+  }
+  if ( *ps->s == '\0' )
+  {
+    expr_fail ( ps, "unexpected end of text" );
+  }
+  else if ( *ps->s == '\n' || *ps->s == ';' )
+  {
+    expr_fail ( ps, "unexpected end of statement" );
+  }
+  else
+  {
+    expr_fail ( ps, "unexpected '%c'", *ps->s );
+  }
+
+  return -1;
+}
+/******************************************************************************/
+
+static int expr_product ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_product parses factors joined by * and /.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int a;
+  int b;
+  char op;
+
+  a = expr_unary ( ps );
+
+  while ( 0 <= a )
+  {
+    expr_skip ( ps );
+    op = *ps->s;
+    if ( op != '*' && op != '/' )
+    {
+      break;
+    }
+    ps->s = ps->s + 1;
+    b = expr_unary ( ps );
+    a = expr_binary ( ps, ( op == '*' ) ? EXPR_MUL : EXPR_DIV, a, b );
+  }
+
+  return a;
+}
+/******************************************************************************/
+
+static void expr_push ( expr_parser *ps, char *name, int node )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_push adds a symbol.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int n;
+  expr_symbol *sym;
+
+  if ( ps->sym_num == ps->sym_max )
+  {
+    n = ( ps->sym_max == 0 ) ? 16 : 2 * ps->sym_max;
+    sym = ( expr_symbol * ) realloc ( ps->sym, n * sizeof ( expr_symbol ) );
+    if ( sym == NULL )
+    {
+      expr_fail ( ps, "out of memory" );
+      return;
+    }
+    ps->sym = sym;
+    ps->sym_max = n;
+  }
+
+  strcpy ( ps->sym[ps->sym_num].name, name );
+  ps->sym[ps->sym_num].node = node;
+  ps->sym_num = ps->sym_num + 1;
+
+  return;
+}
+/******************************************************************************/
+
+static void expr_reg_name ( expr_program *p, int r,
+  char name[EXPR_NAME_LEN+1] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_reg_name returns the printed name of register R.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  if ( r == 0 )
+  {
+    strcpy ( name, "t" );
+  }
+  else if ( r <= p->m )
+  {
+    strcpy ( name, p->name + ( r - 1 ) * EXPR_NAME_LEN );
+  }
+  else if ( r <= 2 * p->m )
+  {
+    strcpy ( name, p->name + ( r - p->m - 1 ) * EXPR_NAME_LEN );
+    strcat ( name, "'" );
+  }
+  else
+  {
+    sprintf ( name, "$%d", r - 2 * p->m - 1 );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void expr_scan ( expr_parser *ps, char *text )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_scan finds the states, which are the names followed by a prime
+    at the start of a statement.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  char name[EXPR_NAME_LEN];
+
+  ps->s = text;
+  ps->line = 1;
+
+  while ( !ps->failed )
+  {
+    expr_skip ( ps );
+    if ( expr_name ( ps, name ) )
+    {
+      expr_skip ( ps );
+      if ( *ps->s == '\'' )
+      {
+        if ( strcmp ( name, "t" ) == 0 || strcmp ( name, "pi" ) == 0 )
+        {
+          expr_fail ( ps, "'%s' is reserved", name );
+        }
+        else if ( 0 <= expr_lookup ( ps, name ) )
+        {
+          expr_fail ( ps, "second equation for %s'", name );
+        }
+        else
+        {
+          expr_push ( ps, name, -1 );
+        }
+      }
+    }
+/*
+  Move on to the next statement.
+*/
+    while ( *ps->s != '\0' && *ps->s != '\n' && *ps->s != ';' )
+    {
+      if ( *ps->s == '#' )
+      {
+        expr_skip ( ps );
+      }
+      else
+      {
+        ps->s = ps->s + 1;
+      }
+    }
+    if ( *ps->s == '\0' )
+    {
+      break;
+    }
+    if ( *ps->s == '\n' )
+    {
+      ps->line = ps->line + 1;
+    }
+    ps->s = ps->s + 1;
+  }
+
+  ps->m = ps->sym_num;
+
+  if ( !ps->failed && ps->m == 0 )
+  {
+    ps->line = 0;
+    expr_fail ( ps, "no equations of the form x' = ..." );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void expr_skip ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_skip skips blanks and comments.
+
+  Discussion:
+
+    Inside parentheses, a statement may go on to the next line.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  while ( 1 )
+  {
+    if ( *ps->s == ' ' || *ps->s == '\t' || *ps->s == '\r' )
+    {
+      ps->s = ps->s + 1;
+    }
+    else if ( *ps->s == '#' )
+    {
+      while ( *ps->s != '\0' && *ps->s != '\n' )
+      {
+        ps->s = ps->s + 1;
+      }
+    }
+    else if ( *ps->s == '\n' && 0 < ps->depth )
+    {
+      ps->line = ps->line + 1;
+      ps->s = ps->s + 1;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static int expr_sum ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_sum parses terms joined by + and -.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int a;
+  int b;
+  char op;
+
+  a = expr_product ( ps );
+
+  while ( 0 <= a )
+  {
+    expr_skip ( ps );
+    op = *ps->s;
+    if ( op != '+' && op != '-' )
+    {
+      break;
+    }
+    ps->s = ps->s + 1;
+    b = expr_product ( ps );
+    a = expr_binary ( ps, ( op == '+' ) ? EXPR_ADD : EXPR_SUB, a, b );
+  }
+
+  return a;
+}
+/******************************************************************************/
+
+static int expr_unary ( expr_parser *ps )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    expr_unary parses a power with any number of leading signs.
+
+  Discussion:
+
+    Every recursion of the parser, through a sign, an exponent, a
+    parenthesis or a function argument, passes through here, so the
+    nesting is limited to EXPR_DEPTH_MAX here.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int a;
+
+  if ( EXPR_DEPTH_MAX <= ps->nest )
+  {
+    expr_fail ( ps, "expression nested too deeply" );
+    return -1;
+  }
+  ps->nest = ps->nest + 1;
+
+  expr_skip ( ps );
+
+  if ( *ps->s == '-' )
+  {
+    ps->s = ps->s + 1;
+    a = expr_unary ( ps );
+    a = expr_op1 ( ps, EXPR_MULC, a, -1.0 );
+  }
+  else if ( *ps->s == '+' )
+  {
+    ps->s = ps->s + 1;
+    a = expr_unary ( ps );
+  }
+  else
+  {
+    a = expr_power ( ps );
+  }
+
+  ps->nest = ps->nest - 1;
+
+  return a;
+}
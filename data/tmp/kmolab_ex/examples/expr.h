@@ -0,0 +1,72 @@
+/*
+  expr_program is an ODE right hand side compiled at run time from text,
+  so that a model can be changed without recompiling the program.
+
+  The text is a list of statements, separated by newlines or ';'.  A
+  statement
+
+    X' = EXPRESSION
+
+  gives the derivative of the state X.  The states are numbered in the
+  order of these statements, and every state needs exactly one.  A
+  statement
+
+    NAME = EXPRESSION
+
+  names a constant or an intermediate value, which later statements may
+  use.  An expression is built from numbers, names, the time T, PI, the
+  operators + - * / ^ and parentheses, and the functions ABS, COS, EXP,
+  LOG, SIN, SQRT, TANH and POW ( X, Y ), nested at most EXPR_DEPTH_MAX
+  deep.  '#' starts a comment.  For example, the predator prey model is
+
+    a = 2; b = 0.001; c = 10; d = 0.002
+    r' = a * r - b * r * f
+    f' = - c * f + d * r * f
+
+  The expressions become a graph in which equal subexpressions are
+  shared, constants are folded, and constant factors are gathered, so
+  that B * R * F and D * R * F above both use one product R * F.  The
+  last step may differ from the C expression in the last bit.  The
+  graph is then turned into code for a register machine, where each
+  register holds EXPR_BLOCK ensemble members, so that every instruction
+  is a loop over members that the compiler can vectorize.  Registers
+  are reused as soon as their value is dead.
+
+  A program keeps its registers in its own workspace, so one program
+  must not be evaluated by two threads at once.  Compile one per thread.
+*/
+# define EXPR_BLOCK 256
+# define EXPR_DEPTH_MAX 256
+# define EXPR_ERROR_LEN 128
+# define EXPR_NAME_LEN 32
+
+typedef struct
+{
+  int op;
+  int dst;
+  int a;
+  int b;
+  double c;
+  double d;
+} expr_code;
+
+typedef struct
+{
+  int m;
+  int reg_num;
+  int code_num;
+  int uses_t;
+  char *name;
+  expr_code *code;
+  double **reg;
+  double *work;
+} expr_program;
+
+expr_program *expr_compile ( char *text, char error[EXPR_ERROR_LEN] );
+void expr_deriv ( double t, double u[], double f[], void *ctx );
+void expr_deriv_batch ( double t, int nens, int m, int ld, double u[],
+  double f[], void *ctx );
+void expr_destroy ( expr_program *p );
+void expr_eval ( expr_program *p, double t, int nens, int ld, double u[],
+  double f[] );
+void expr_print ( expr_program *p );
@@ -0,0 +1,527 @@
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "imex.h"
+# include "rk4_stats.h"
+
+/******************************************************************************/
+
+int imex_advance ( imex_stepper *s, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    imex_advance takes N equal IMEX steps from the current time to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    imex_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+
+  Output:
+
+    int IMEX_ADVANCE: 0 on success, 1 if a stage solve failed, in which
+    case S is left at the start of the failed step.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return 0;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    if ( imex_step ( s, dt ) != 0 )
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+imex_stepper *imex_create ( int method, void fe ( double t, double y[],
+  double f[], void *ctx ), void fi ( double t, double y[], double f[],
+  void *ctx ), int solve ( double t, double gh, double r[], double z[],
+  void *ctx ), void *ctx, int m, double t0, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    imex_create creates an additive IMEX Runge-Kutta stepper.
+
+  Discussion:
+
+    The tables are those of Kennedy and Carpenter, 2003.  AE and AI are
+    stored by columns, AE[I+J*6] being the coefficient of stage J in
+    stage I.  Both methods have first stage C = 0 and explicit first
+    implicit stage, and B is the last row of AI.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Christopher Kennedy, Mark Carpenter,
+    Additive Runge-Kutta schemes for convection-diffusion-reaction
+    equations,
+    Applied Numerical Mathematics,
+    Volume 44, Number 1, January 2003, pages 139-181.
+
+  Input:
+
+    int METHOD: IMEX_ARK3 or IMEX_ARK4.
+
+    void FE ( double T, double Y[], double F[], void *CTX ), evaluates
+    the nonstiff part of the right hand side.
+
+    void FI ( double T, double Y[], double F[], void *CTX ), evaluates
+    the stiff part of the right hand side.
+
+    int SOLVE ( double T, double GH, double R[], double Z[], void *CTX ),
+    solves Z - GH * FI ( T, Z ) = R.
+
+    void *CTX: the context passed to FE, FI and SOLVE.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+  Output:
+
+    imex_stepper *IMEX_CREATE: the stepper, or NULL if METHOD is unknown
+    or memory could not be allocated.
+*/
+{
+  double g;
+  int i;
+  int j;
+  int ld;
+  imex_stepper *s;
+  int stage_num;
+
+  if ( method == IMEX_ARK3 )
+  {
+    stage_num = 4;
+  }
+  else if ( method == IMEX_ARK4 )
+  {
+    stage_num = 6;
+  }
+  else
+  {
+    return NULL;
+  }
+
+  s = ( imex_stepper * ) malloc ( sizeof ( imex_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( ( 2 * stage_num + 3 ) * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->fe = fe;
+  s->fi = fi;
+  s->solve = solve;
+  s->ctx = ctx;
+  s->method = method;
+  s->m = m;
+  s->ld = ld;
+  s->stage_num = stage_num;
+  s->t = t0;
+  s->step_num = 0;
+  s->fe_num = 0;
+  s->fi_num = 0;
+  s->solve_num = 0;
+  s->y  = s->work;
+  s->ke = s->work + ld;
+  s->ki = s->work + ( 1 + stage_num ) * ld;
+  s->r  = s->work + ( 1 + 2 * stage_num ) * ld;
+  s->z  = s->work + ( 2 + 2 * stage_num ) * ld;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = y0[i];
+  }
+
+  for ( i = 0; i < 36; i++ )
+  {
+    s->ae[i] = 0.0;
+    s->ai[i] = 0.0;
+  }
+
+  if ( method == IMEX_ARK3 )
+  {
+    g = 1767732205903.0 / 4055673282236.0;
+
+    s->ae[1+0*6] = 1767732205903.0 / 2027836641118.0;
+    s->ae[2+0*6] = 5535828885825.0 / 10492691773637.0;
+    s->ae[2+1*6] = 788022342437.0 / 10882634858940.0;
+    s->ae[3+0*6] = 6485989280629.0 / 16251701735622.0;
+    s->ae[3+1*6] = - 4246266847089.0 / 9704473918619.0;
+    s->ae[3+2*6] = 10755448449292.0 / 10357097424841.0;
+
+    s->ai[1+0*6] = g;
+    s->ai[1+1*6] = g;
+    s->ai[2+0*6] = 2746238789719.0 / 10658868560708.0;
+    s->ai[2+1*6] = - 640167445237.0 / 6845629431997.0;
+    s->ai[2+2*6] = g;
+    s->ai[3+0*6] = 1471266399579.0 / 7840856788654.0;
+    s->ai[3+1*6] = - 4482444167858.0 / 7529755066697.0;
+    s->ai[3+2*6] = 11266239266428.0 / 11593286722821.0;
+    s->ai[3+3*6] = g;
+
+    s->c[0] = 0.0;
+    s->c[1] = 2.0 * g;
+    s->c[2] = 0.6;
+    s->c[3] = 1.0;
+  }
+  else
+  {
+    g = 0.25;
+
+    s->ae[1+0*6] = 0.5;
+    s->ae[2+0*6] = 13861.0 / 62500.0;
+    s->ae[2+1*6] = 6889.0 / 62500.0;
+    s->ae[3+0*6] = - 116923316275.0 / 2393684061468.0;
+    s->ae[3+1*6] = - 2731218467317.0 / 15368042101831.0;
+    s->ae[3+2*6] = 9408046702089.0 / 11113171139209.0;
+    s->ae[4+0*6] = - 451086348788.0 / 2902428689909.0;
+    s->ae[4+1*6] = - 2682348792572.0 / 7519795681897.0;
+    s->ae[4+2*6] = 12662868775082.0 / 11960479115383.0;
+    s->ae[4+3*6] = 3355817975965.0 / 11060851509271.0;
+    s->ae[5+0*6] = 647845179188.0 / 3216320057751.0;
+    s->ae[5+1*6] = 73281519250.0 / 8382639484533.0;
+    s->ae[5+2*6] = 552539513391.0 / 3454668386233.0;
+    s->ae[5+3*6] = 3354512671639.0 / 8306763924573.0;
+    s->ae[5+4*6] = 4040.0 / 17871.0;
+
+    s->ai[1+0*6] = g;
+    s->ai[1+1*6] = g;
+    s->ai[2+0*6] = 8611.0 / 62500.0;
+    s->ai[2+1*6] = - 1743.0 / 31250.0;
+    s->ai[2+2*6] = g;
+    s->ai[3+0*6] = 5012029.0 / 34652500.0;
+    s->ai[3+1*6] = - 654441.0 / 2922500.0;
+    s->ai[3+2*6] = 174375.0 / 388108.0;
+    s->ai[3+3*6] = g;
+    s->ai[4+0*6] = 15267082809.0 / 155376265600.0;
+    s->ai[4+1*6] = - 71443401.0 / 120774400.0;
+    s->ai[4+2*6] = 730878875.0 / 902184768.0;
+    s->ai[4+3*6] = 2285395.0 / 8070912.0;
+    s->ai[4+4*6] = g;
+    s->ai[5+0*6] = 82889.0 / 524892.0;
+    s->ai[5+1*6] = 0.0;
+    s->ai[5+2*6] = 15625.0 / 83664.0;
+    s->ai[5+3*6] = 69875.0 / 102672.0;
+    s->ai[5+4*6] = - 2260.0 / 8211.0;
+    s->ai[5+5*6] = g;
+
+    s->c[0] = 0.0;
+    s->c[1] = 0.5;
+    s->c[2] = 83.0 / 250.0;
+    s->c[3] = 31.0 / 50.0;
+    s->c[4] = 17.0 / 20.0;
+    s->c[5] = 1.0;
+  }
+
+  for ( j = 0; j < stage_num; j++ )
+  {
+    s->b[j] = s->ai[stage_num-1+j*6];
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void imex_destroy ( imex_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    imex_destroy frees an IMEX stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    imex_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int imex_step ( imex_stepper *s, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    imex_step takes one IMEX Runge-Kutta step.
+
+  Discussion:
+
+    Stage I starts from R = Y + DT * sum ( J < I ) ( AE(I,J) KE(J)
+    + AI(I,J) KI(J) ), solves Z - DT * AI(I,I) * FI ( T + C(I) DT, Z ) = R,
+    and sets KE(I) = FE ( T + C(I) DT, Z ) and KI(I) = FI at Z.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    imex_stepper *S: the stepper.
+
+    double DT: the stepsize.
+
+  Output:
+
+    int IMEX_STEP: 0 on success, or 1 if SOLVE failed, in which case S
+    is unchanged.
+*/
+{
+  double gh;
+  int i;
+  int j;
+  int k;
+  int ld;
+  int m;
+  double *r;
+  double tj;
+  double *z;
+
+  m = s->m;
+  ld = s->ld;
+  r = s->r;
+  z = s->z;
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+
+  for ( j = 0; j < s->stage_num; j++ )
+  {
+    tj = s->t + s->c[j] * dt;
+
+    for ( i = 0; i < m; i++ )
+    {
+      r[i] = s->y[i];
+    }
+    for ( k = 0; k < j; k++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        r[i] = r[i] + dt * ( s->ae[j+k*6] * s->ke[i+k*ld]
+          + s->ai[j+k*6] * s->ki[i+k*ld] );
+      }
+    }
+
+    gh = dt * s->ai[j+j*6];
+    if ( gh == 0.0 )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        z[i] = r[i];
+      }
+      s->fi ( tj, z, s->ki + j * ld, s->ctx );
+      s->fi_num = s->fi_num + 1;
+    }
+    else
+    {
+      if ( s->solve ( tj, gh, r, z, s->ctx ) != 0 )
+      {
+        RK4_STATS_TOC ( RK4_PHASE_STEP );
+        return 1;
+      }
+      s->solve_num = s->solve_num + 1;
+      for ( i = 0; i < m; i++ )
+      {
+        s->ki[i+j*ld] = ( z[i] - r[i] ) / gh;
+      }
+    }
+
+    s->fe ( tj, z, s->ke + j * ld, s->ctx );
+    s->fe_num = s->fe_num + 1;
+  }
+
+  for ( j = 0; j < s->stage_num; j++ )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      s->y[i] = s->y[i]
+        + dt * s->b[j] * ( s->ke[i+j*ld] + s->ki[i+j*ld] );
+    }
+  }
+
+  RK4_STATS_TOC ( RK4_PHASE_STEP );
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, s->stage_num + 1 );
+
+  s->t = s->t + dt;
+  s->step_num = s->step_num + 1;
+
+  return 0;
+}
+/******************************************************************************/
+
+int r83_np_fa ( int n, double a[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r83_np_fa factors an R83 matrix without pivoting.
+
+  Discussion:
+
+    The R83 storage format is used for a tridiagonal matrix.  A[0+J*3]
+    holds the superdiagonal entry A(J-1,J), A[1+J*3] the diagonal entry
+    A(J,J), and A[2+J*3] the subdiagonal entry A(J+1,J).
+
+    Because no pivoting is done, the factorization may fail even though
+    the matrix is nonsingular; it cannot fail for the diagonally
+    dominant matrices I - GH * L of a diffusion operator L.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int N, the order of the matrix.
+
+    double A[3*N]: the matrix.
+
+  Output:
+
+    double A[3*N]: the LU factors.
+
+    int R83_NP_FA: 0 on success, or J if the J-th pivot is zero.
+*/
+{
+  int i;
+
+  for ( i = 1; i < n; i++ )
+  {
+    if ( a[1+(i-1)*3] == 0.0 )
+    {
+      return i;
+    }
+    a[2+(i-1)*3] = a[2+(i-1)*3] / a[1+(i-1)*3];
+    a[1+i*3] = a[1+i*3] - a[2+(i-1)*3] * a[0+i*3];
+  }
+
+  if ( a[1+(n-1)*3] == 0.0 )
+  {
+    return n;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void r83_np_sl ( int n, double a_lu[], double b[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r83_np_sl solves a linear system factored by r83_np_fa().
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int N, the order of the matrix.
+
+    double A_LU[3*N]: the factors from r83_np_fa().
+
+    double B[N]: the right hand side.
+
+  Output:
+
+    double B[N]: the solution.
+*/
+{
+  int i;
+
+  for ( i = 1; i < n; i++ )
+  {
+    b[i] = b[i] - a_lu[2+(i-1)*3] * b[i-1];
+  }
+
+  for ( i = n - 1; 0 <= i; i-- )
+  {
+    b[i] = b[i] / a_lu[1+i*3];
+    if ( 0 < i )
+    {
+      b[i-1] = b[i-1] - a_lu[0+i*3] * b[i];
+    }
+  }
+
+  return;
+}
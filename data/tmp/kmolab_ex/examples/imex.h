@@ -0,0 +1,56 @@
+/*
+  imex_stepper integrates Y' = FE ( T, Y ) + FI ( T, Y ), where FI is
+  stiff and FE is not, with an additive Runge-Kutta method of Kennedy
+  and Carpenter: FE is treated explicitly and FI by an ESDIRK method.
+
+  IMEX_ARK3 is ARK3(2)4L[2]SA, of order 3 with 4 stages, and IMEX_ARK4
+  is ARK4(3)6L[2]SA, of order 4 with 6 stages.  Both are L-stable and
+  stiffly accurate in the implicit part.
+
+  Each implicit stage solves Z - GH * FI ( T, Z ) = R for Z, through
+  SOLVE ( T, GH, R, Z, CTX ).  GH is the same for every stage of a step,
+  so for a linear FI = L Y the caller can factor I - GH * L once and
+  keep the factors while GH is unchanged; r83_np_fa() and r83_np_sl()
+  do this for a tridiagonal L.  SOLVE returns nonzero on failure.
+  After the solve, FI at the stage is recovered as ( Z - R ) / GH, so
+  FI itself is only called once per step.
+*/
+# define IMEX_ARK3 0
+# define IMEX_ARK4 1
+
+typedef struct
+{
+  void ( *fe ) ( double t, double y[], double f[], void *ctx );
+  void ( *fi ) ( double t, double y[], double f[], void *ctx );
+  int ( *solve ) ( double t, double gh, double r[], double z[], void *ctx );
+  void *ctx;
+  int method;
+  int m;
+  int ld;
+  int stage_num;
+  double ae[36];
+  double ai[36];
+  double b[6];
+  double c[6];
+  double t;
+  long int step_num;
+  long int fe_num;
+  long int fi_num;
+  long int solve_num;
+  double *y;
+  double *ke;
+  double *ki;
+  double *r;
+  double *z;
+  double *work;
+} imex_stepper;
+
+int imex_advance ( imex_stepper *s, double t1, int n );
+imex_stepper *imex_create ( int method, void fe ( double t, double y[],
+  double f[], void *ctx ), void fi ( double t, double y[], double f[],
+  void *ctx ), int solve ( double t, double gh, double r[], double z[],
+  void *ctx ), void *ctx, int m, double t0, double y0[] );
+void imex_destroy ( imex_stepper *s );
+int imex_step ( imex_stepper *s, double dt );
+int r83_np_fa ( int n, double a[] );
+void r83_np_sl ( int n, double a_lu[], double b[] );
@@ -0,0 +1,404 @@
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "lsrk.h"
+# include "rk4_stats.h"
+
+static void lsrk_step_to ( lsrk_stepper *s, double target, double dt );
+
+/******************************************************************************/
+
+void lsrk_advance ( lsrk_stepper *s, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lsrk_advance takes N equal low storage steps from the current time to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    lsrk_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    lsrk_step ( s, dt );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+lsrk_stepper *lsrk_create ( int method, void dydt ( double t, double u[],
+  double a, double h, double du[], void *ctx ), void *ctx, int m,
+  double t0, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lsrk_create creates a low storage Runge-Kutta stepper.
+
+  Discussion:
+
+    The workspace is two aligned vectors of length M.  For a very large
+    system, pass Y0 = NULL and fill S->Y in place, so that the caller
+    needs no copy of the initial condition either.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    John Williamson,
+    Low-storage Runge-Kutta schemes,
+    Journal of Computational Physics,
+    Volume 35, Number 1, March 1980, pages 48-56.
+
+    Mark Carpenter, Christopher Kennedy,
+    Fourth-order 2N-storage Runge-Kutta schemes,
+    NASA Technical Memorandum 109112, June 1994.
+
+  Input:
+
+    int METHOD: LSRK_WILLIAMSON3 or LSRK_CK4.
+
+    void DYDT ( double T, double U[], double A, double H, double DU[],
+    void *CTX ), sets DU = A * DU + H * F ( T, U ).
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition, or NULL for zero.
+
+  Output:
+
+    lsrk_stepper *LSRK_CREATE: the stepper, or NULL if METHOD is unknown
+    or memory could not be allocated.
+*/
+{
+  int i;
+  int ld;
+  lsrk_stepper *s;
+
+  if ( method != LSRK_WILLIAMSON3 && method != LSRK_CK4 )
+  {
+    return NULL;
+  }
+
+  s = ( lsrk_stepper * ) malloc ( sizeof ( lsrk_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( 2 * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->dydt = dydt;
+  s->ctx = ctx;
+  s->method = method;
+  s->m = m;
+  s->t = t0;
+  s->step_num = 0;
+  s->eval_num = 0;
+  s->y = s->work;
+  s->du = s->work + ld;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = ( y0 == NULL ) ? 0.0 : y0[i];
+    s->du[i] = 0.0;
+  }
+
+  if ( method == LSRK_WILLIAMSON3 )
+  {
+    s->stage_num = 3;
+    s->a[0] = 0.0;
+    s->a[1] = - 5.0 / 9.0;
+    s->a[2] = - 153.0 / 128.0;
+    s->b[0] = 1.0 / 3.0;
+    s->b[1] = 15.0 / 16.0;
+    s->b[2] = 8.0 / 15.0;
+    s->c[0] = 0.0;
+    s->c[1] = 1.0 / 3.0;
+    s->c[2] = 3.0 / 4.0;
+  }
+  else
+  {
+    s->stage_num = 5;
+    s->a[0] = 0.0;
+    s->a[1] = - 567301805773.0 / 1357537059087.0;
+    s->a[2] = - 2404267990393.0 / 2016746695238.0;
+    s->a[3] = - 3550918686646.0 / 2091501179385.0;
+    s->a[4] = - 1275806237668.0 / 842570457699.0;
+    s->b[0] = 1432997174477.0 / 9575080441755.0;
+    s->b[1] = 5161836677717.0 / 13612068292357.0;
+    s->b[2] = 1720146321549.0 / 2090206949498.0;
+    s->b[3] = 3134564353537.0 / 4481467310338.0;
+    s->b[4] = 2277821191437.0 / 14882151754819.0;
+    s->c[0] = 0.0;
+    s->c[1] = 1432997174477.0 / 9575080441755.0;
+    s->c[2] = 2526269341429.0 / 6820363962896.0;
+    s->c[3] = 2006345519317.0 / 3224310063776.0;
+    s->c[4] = 2802321613138.0 / 2924317926251.0;
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void lsrk_destroy ( lsrk_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lsrk_destroy frees a low storage Runge-Kutta stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    lsrk_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int lsrk_observe ( lsrk_stepper *s, double t1, int n, rk4_observer *obs )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lsrk_observe advances a low storage stepper to T1, reporting to an
+    observer.
+
+  Discussion:
+
+    This follows rk4_stepper_observe().  The observer is handed S->Y
+    directly, and must not change it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    lsrk_stepper *S: the stepper.
+
+    double T1: the final time, T1 > S->T.
+
+    int N: the nominal number of steps to take.
+
+    rk4_observer *OBS: the observer.
+
+  Output:
+
+    lsrk_stepper *S: the advanced stepper.
+
+    int LSRK_OBSERVE: 0 if the integration reached T1, 1 if the observer
+    stopped it.
+*/
+{
+  double dt;
+  int j;
+  int k;
+
+  if ( n <= 0 )
+  {
+    return 0;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  if ( obs->tout_num <= 0 )
+  {
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 1;
+    }
+    for ( j = 1; j <= n; j++ )
+    {
+      lsrk_step ( s, dt );
+      if ( ( 0 < obs->every && j % obs->every == 0 ) || j == n )
+      {
+        if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+        {
+          return 1;
+        }
+      }
+    }
+    return 0;
+  }
+
+  k = 0;
+  while ( k < obs->tout_num && obs->tout[k] < s->t )
+  {
+    k = k + 1;
+  }
+
+  while ( k < obs->tout_num && obs->tout[k] <= t1 )
+  {
+    lsrk_step_to ( s, obs->tout[k], dt );
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 1;
+    }
+    k = k + 1;
+  }
+
+  lsrk_step_to ( s, t1, dt );
+
+  return 0;
+}
+/******************************************************************************/
+
+void lsrk_step ( lsrk_stepper *s, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lsrk_step takes one low storage Runge-Kutta step.
+
+  Discussion:
+
+    A(0) = 0, so the register is overwritten by the first stage and its
+    old contents do not matter.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    lsrk_stepper *S: the stepper.
+
+    double DT: the stepsize.
+*/
+{
+  double bj;
+  int i;
+  int j;
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+
+  for ( j = 0; j < s->stage_num; j++ )
+  {
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt ( s->t + s->c[j] * dt, s->y, s->a[j], dt, s->du, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+    bj = s->b[j];
+    for ( i = 0; i < s->m; i++ )
+    {
+      s->y[i] = s->y[i] + bj * s->du[i];
+    }
+  }
+
+  RK4_STATS_TOC ( RK4_PHASE_STEP );
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, s->stage_num );
+
+  s->t = s->t + dt;
+  s->step_num = s->step_num + 1;
+  s->eval_num = s->eval_num + s->stage_num;
+
+  return;
+}
+/******************************************************************************/
+
+static void lsrk_step_to ( lsrk_stepper *s, double target, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lsrk_step_to takes steps of size DT, ending exactly at TARGET.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double h;
+
+  while ( s->t < target )
+  {
+    h = dt;
+    if ( target - s->t <= h * ( 1.0 + 1.0E-08 ) )
+    {
+      h = target - s->t;
+    }
+    lsrk_step ( s, h );
+    if ( h != dt )
+    {
+      s->t = target;
+    }
+  }
+
+  return;
+}
@@ -0,0 +1,50 @@
+/*
+  lsrk_stepper is a low storage explicit Runge-Kutta integrator of the
+  2N form of Williamson, which keeps only two vectors of length M: the
+  solution Y and the register DU.  A step of S stages is
+
+    for each stage I:
+      DU = A(I) * DU + DT * F ( T + C(I) * DT, Y )
+      Y  = Y + B(I) * DU
+
+  To keep the storage at two vectors, the right hand side is given in
+  accumulating form: DYDT ( T, U, A, H, DU, CTX ) must set
+  DU = A * DU + H * F ( T, U ), which a pointwise or stencil right hand
+  side can do in a single pass without a temporary.
+
+  LSRK_WILLIAMSON3 is Williamson's third order method with 3 stages, and
+  LSRK_CK4 is the fourth order method RK4(3)5[2R+]C of Carpenter and
+  Kennedy, with 5 stages.
+
+  Observers receive S->Y itself, so output needs no extra copy of the
+  state.
+*/
+# define LSRK_WILLIAMSON3 0
+# define LSRK_CK4 1
+
+typedef struct
+{
+  void ( *dydt ) ( double t, double u[], double a, double h, double du[],
+    void *ctx );
+  void *ctx;
+  int method;
+  int m;
+  int stage_num;
+  double a[5];
+  double b[5];
+  double c[5];
+  double t;
+  long int step_num;
+  long int eval_num;
+  double *y;
+  double *du;
+  double *work;
+} lsrk_stepper;
+
+void lsrk_advance ( lsrk_stepper *s, double t1, int n );
+lsrk_stepper *lsrk_create ( int method, void dydt ( double t, double u[],
+  double a, double h, double du[], void *ctx ), void *ctx, int m,
+  double t0, double y0[] );
+void lsrk_destroy ( lsrk_stepper *s );
+int lsrk_observe ( lsrk_stepper *s, double t1, int n, rk4_observer *obs );
+void lsrk_step ( lsrk_stepper *s, double dt );
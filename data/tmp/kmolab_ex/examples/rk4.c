@@ -3,7 +3,15 @@
 # include <stdlib.h>
 # include <time.h>
 
+# ifdef _WIN32
+# include <malloc.h>
+# endif
+
 # include "rk4.h"
+# include "rk4_stats.h"
+
+static void rk4_plain_deriv ( double t, double u[], double f[], void *ctx );
+static void rk4_stepper_step_to ( rk4_stepper *s, double target, double dt );
 
 /******************************************************************************/
 
@@ -20,9 +28,15 @@ void rk4 ( void dydt ( double t, double u[], double f[] ), double tspan[2],
 
     This code is distributed under the GNU LGPL license. 
 
+  Discussion:
+
+    The scratch vectors are allocated once for the whole run.  Callers
+    who want to step incrementally should use rk4_stepper_create() and
+    rk4_stepper_step() instead.
+
   Modified:
 
-    22 April 2020
+    18 October 2026
 
   Author:
 
@@ -45,31 +59,63 @@ void rk4 ( void dydt ( double t, double u[], double f[] ), double tspan[2],
 
     double t[n+1], y[(n+1)*m]: the times and solution values.
 */
+{
+  rk4_ctx ( rk4_plain_deriv, ( void * ) &dydt, tspan, y0, n, m, t, y );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ctx ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, double tspan[2], double y0[], int n, int m, double t[],
+  double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ctx is rk4() for a right hand side that takes a context pointer.
+
+  Discussion:
+
+    CTX is passed unchanged to every call of DYDT.  It typically points
+    to the model coefficients, so that one DYDT can serve several runs,
+    possibly in different threads, without global variables.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side of the problem.
+
+    void *CTX: the context passed to DYDT.
+
+    double TSPAN[2]: the initial and final times
+
+    double Y0[M]: the initial condition
+
+    int N: the number of steps to take.
+
+    int M: the number of variables.
+
+  Output:
+
+    double t[n+1], y[(n+1)*m]: the times and solution values.
+*/
 {
   double dt;
-  double *f0;
-  double *f1;
-  double *f2;
-  double *f3;
   int i;
   int j;
-  double t0;
-  double t1;
-  double t2;
-  double t3;
-  double *u0;
-  double *u1;
-  double *u2;
-  double *u3;
-
-  f0 = ( double * ) malloc ( m * sizeof ( double ) );
-  f1 = ( double * ) malloc ( m * sizeof ( double ) );
-  f2 = ( double * ) malloc ( m * sizeof ( double ) );
-  f3 = ( double * ) malloc ( m * sizeof ( double ) );
-  u0 = ( double * ) malloc ( m * sizeof ( double ) );
-  u1 = ( double * ) malloc ( m * sizeof ( double ) );
-  u2 = ( double * ) malloc ( m * sizeof ( double ) );
-  u3 = ( double * ) malloc ( m * sizeof ( double ) );
+  double *work;
+
+  work = ( double * ) malloc ( 5 * m * sizeof ( double ) );
 
   dt = ( tspan[1] - tspan[0] ) / ( double ) ( n );
 
@@ -82,51 +128,802 @@ void rk4 ( void dydt ( double t, double u[], double f[] ), double tspan[2],
 
   for ( j = 0; j < n; j++ )
   {
-    t0 = t[j];
-    for ( i = 0; i < m; i++ )
-    {
-      u0[i] = y[i+j*m];
-    }
-    dydt ( t0, u0, f0 );
+    rk4_step_ctx ( dydt, ctx, m, t[j], dt, y+j*m, y+(j+1)*m, 
+      work, work+m, work+2*m, work+3*m, work+4*m );
+    t[j+1] = t[j] + dt;
+  }
+/*
+  Free memory.
+*/
+  free ( work );
 
-    t1 = t0 + dt / 2.0;
-    for ( i = 0; i < m; i++ )
-    {
-      u1[i] = u0[i] + dt * f0[i] / 2.0;
-    }
-    dydt ( t1, u1, f1 );
+  return;
+}
+/******************************************************************************/
 
-    t2 = t0 + dt / 2.0;
-    for ( i = 0; i < m; i++ )
-    {
-      u2[i] = u0[i] + dt * f1[i] / 2.0;
-    }
-    dydt ( t2, u2, f2 );
+int rk4_observe ( void dydt ( double t, double u[], double f[] ),
+  double tspan[2], double y0[], int n, int m, rk4_observer *obs )
 
-    t3 = t0 + dt;
-    for ( i = 0; i < m; i++ )
-    {
-      u3[i] = u0[i] + dt * f2[i];
-    }
-    dydt ( t3, u3, f3 );
+/******************************************************************************/
+/*
+  Purpose:
 
-    t[j+1] = t[j] + dt;
-    for ( i = 0; i < m; i++ )
-    {
-       y[i+(j+1)*m] = u0[i] + dt * ( f0[i] + 2.0 * f1[i] + 2.0 * f2[i] + f3[i] ) / 6.0;
-    }
+    rk4_observe integrates an ODE with RK4, reporting to an observer.
+
+  Discussion:
+
+    This is rk4() without the T and Y output arrays.  Memory use is
+    proportional to M, not to N*M.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double DYDT ( double T, double U[], double F[] ), evaluates the
+    right hand side of the problem.
+
+    double TSPAN[2]: the initial and final times.
+
+    double Y0[M]: the initial condition.
+
+    int N: the number of steps to take.
+
+    int M: the number of variables.
+
+    rk4_observer *OBS: the observer.
+
+  Output:
+
+    int RK4_OBSERVE: 0 if the integration reached TSPAN[1], 1 if the
+    observer stopped it, 2 if memory could not be allocated.
+*/
+{
+  rk4_stepper *s;
+  int status;
+
+  s = rk4_stepper_create ( dydt, m, tspan[0], y0 );
+  if ( s == NULL )
+  {
+    return 2;
   }
+
+  status = rk4_stepper_observe ( s, tspan[1], n, obs );
+
+  rk4_stepper_destroy ( s );
+
+  return status;
+}
+/******************************************************************************/
+
+int rk4_observer_call ( rk4_observer *obs, double t, int m, double y[] )
+
+/******************************************************************************/
 /*
-  Free memory.
+  Purpose:
+
+    rk4_observer_call reports one solution value to an observer.
+
+  Discussion:
+
+    The integrators call observers through this function, so that the
+    time spent in them is charged to the output phase of rk4_stats.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_observer *OBS: the observer.
+
+    double T: the time.
+
+    int M: the number of variables.
+
+    double Y[M]: the solution at T.
+
+  Output:
+
+    int RK4_OBSERVER_CALL: the value returned by OBS->OBSERVE, nonzero
+    to stop the integration.
+*/
+{
+  int stop;
+
+  RK4_STATS_TIC ( RK4_PHASE_OUTPUT );
+  stop = obs->observe ( t, m, y, obs->data );
+  RK4_STATS_TOC ( RK4_PHASE_OUTPUT );
+
+  return stop;
+}
+/******************************************************************************/
+
+void rk4_step ( void dydt ( double t, double u[], double f[] ), int m,
+  double t0, double dt, double u0[], double u1[], double f0[], double f1[],
+  double f2[], double f3[], double u[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_step takes a single Runge-Kutta fourth order step.
+
+  Discussion:
+
+    U1 may be the same vector as U0, in which case the step is taken
+    in place.  None of the scratch vectors may overlap U0 or U1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double DYDT ( double T, double U[], double F[] ), evaluates the
+    right hand side of the problem.
+
+    int M: the number of variables.
+
+    double T0: the time at the start of the step.
+
+    double DT: the stepsize.
+
+    double U0[M]: the solution at T0.
+
+    double F0[M], F1[M], F2[M], F3[M], U[M]: scratch space.
+
+  Output:
+
+    double U1[M]: the solution at T0+DT.
+*/
+{
+  rk4_step_ctx ( rk4_plain_deriv, ( void * ) &dydt, m, t0, dt, u0, u1, 
+    f0, f1, f2, f3, u );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_step_ctx ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, int m, double t0, double dt, double u0[], double u1[],
+  double f0[], double f1[], double f2[], double f3[], double u[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_step_ctx is rk4_step() for a right hand side with a context pointer.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side of the problem.
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double T0: the time at the start of the step.
+
+    double DT: the stepsize.
+
+    double U0[M]: the solution at T0.
+
+    double F0[M], F1[M], F2[M], F3[M], U[M]: scratch space.
+
+  Output:
+
+    double U1[M]: the solution at T0+DT.
+*/
+{
+  int i;
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+
+  RK4_STATS_TIC ( RK4_PHASE_RHS );
+  dydt ( t0, u0, f0, ctx );
+  RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+  for ( i = 0; i < m; i++ )
+  {
+    u[i] = u0[i] + dt * f0[i] / 2.0;
+  }
+  RK4_STATS_TIC ( RK4_PHASE_RHS );
+  dydt ( t0 + dt / 2.0, u, f1, ctx );
+  RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+  for ( i = 0; i < m; i++ )
+  {
+    u[i] = u0[i] + dt * f1[i] / 2.0;
+  }
+  RK4_STATS_TIC ( RK4_PHASE_RHS );
+  dydt ( t0 + dt / 2.0, u, f2, ctx );
+  RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+  for ( i = 0; i < m; i++ )
+  {
+    u[i] = u0[i] + dt * f2[i];
+  }
+  RK4_STATS_TIC ( RK4_PHASE_RHS );
+  dydt ( t0 + dt, u, f3, ctx );
+  RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+  for ( i = 0; i < m; i++ )
+  {
+    u1[i] = u0[i] + dt * ( f0[i] + 2.0 * f1[i] + 2.0 * f2[i] + f3[i] ) / 6.0;
+  }
+
+  RK4_STATS_TOC ( RK4_PHASE_STEP );
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 4 );
+
+  return;
+}
+/******************************************************************************/
+
+rk4_stepper *rk4_stepper_create ( void dydt ( double t, double u[], double f[] ),
+  int m, double t0, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_create creates an RK4 stepper.
+
+  Discussion:
+
+    The state and the four stage derivatives share one workspace, allocated
+    here and released by rk4_stepper_destroy().  Each vector starts on a
+    RK4_ALIGN byte boundary, so repeated calls to rk4_stepper_step() do no
+    allocation at all.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double DYDT ( double T, double U[], double F[] ), evaluates the
+    right hand side of the problem.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+  Output:
+
+    rk4_stepper *RK4_STEPPER_CREATE: the stepper, or NULL if memory
+    could not be allocated.
+*/
+{
+  rk4_stepper *s;
+
+  s = rk4_stepper_create_ctx ( rk4_plain_deriv, NULL, m, t0, y0 );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+/*
+  The context is the stepper's own copy of the plain function pointer.
 */
-  free ( f0 );
-  free ( f1 );
-  free ( f2 );
-  free ( f3 );
-  free ( u0 );
-  free ( u1 );
-  free ( u2 );
-  free ( u3 );
+  s->dydt = dydt;
+  s->ctx = ( void * ) &s->dydt;
+
+  return s;
+}
+/******************************************************************************/
+
+rk4_stepper *rk4_stepper_create_ctx ( void dydt ( double t, double u[],
+  double f[], void *ctx ), void *ctx, int m, double t0, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_create_ctx creates an RK4 stepper for a right hand side
+    with a context pointer.
+
+  Discussion:
+
+    S->CTX may be changed between steps, for instance to move a reused
+    stepper on to the next point of a parameter sweep.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side of the problem.
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition, or NULL for zero.
+
+  Output:
+
+    rk4_stepper *RK4_STEPPER_CREATE_CTX: the stepper, or NULL if memory
+    could not be allocated.
+*/
+{
+  int ld;
+  rk4_stepper *s;
+
+  s = ( rk4_stepper * ) malloc ( sizeof ( rk4_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+/*
+  Round the leading dimension up to a whole number of alignment blocks.
+*/
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( 6 * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->dydt = NULL;
+  s->dydt_ctx = dydt;
+  s->ctx = ctx;
+  s->m = m;
+  s->ld = ld;
+  s->y  = s->work;
+  s->f0 = s->work +     ld;
+  s->f1 = s->work + 2 * ld;
+  s->f2 = s->work + 3 * ld;
+  s->f3 = s->work + 4 * ld;
+  s->u  = s->work + 5 * ld;
+
+  rk4_stepper_reset ( s, t0, y0 );
+
+  return s;
+}
+/******************************************************************************/
+
+void rk4_stepper_destroy ( rk4_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_destroy frees an RK4 stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int rk4_stepper_observe ( rk4_stepper *s, double t1, int n,
+  rk4_observer *obs )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_observe advances an RK4 stepper to T1, reporting to an observer.
+
+  Discussion:
+
+    The nominal stepsize is ( T1 - S->T ) / N.  When output times are
+    requested, a step that would pass the next output time is shortened
+    to end on it, so each reported value is an RK4 value and not an
+    interpolant.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_stepper *S: the stepper.
+
+    double T1: the final time, T1 > S->T.
+
+    int N: the nominal number of steps to take.
+
+    rk4_observer *OBS: the observer.
+
+  Output:
+
+    rk4_stepper *S: the advanced stepper.
+
+    int RK4_STEPPER_OBSERVE: 0 if the integration reached T1, 1 if the
+    observer stopped it.
+*/
+{
+  double dt;
+  int j;
+  int k;
+
+  if ( n <= 0 )
+  {
+    return 0;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+/*
+  Report at every EVERY-th step.
+*/
+  if ( obs->tout_num <= 0 )
+  {
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 1;
+    }
+    for ( j = 1; j <= n; j++ )
+    {
+      rk4_stepper_step ( s, dt );
+      if ( ( 0 < obs->every && j % obs->every == 0 ) || j == n )
+      {
+        if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+        {
+          return 1;
+        }
+      }
+    }
+    return 0;
+  }
+/*
+  Report at the requested times.
+*/
+  k = 0;
+  while ( k < obs->tout_num && obs->tout[k] < s->t )
+  {
+    k = k + 1;
+  }
+
+  while ( k < obs->tout_num && obs->tout[k] <= t1 )
+  {
+    rk4_stepper_step_to ( s, obs->tout[k], dt );
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 1;
+    }
+    k = k + 1;
+  }
+
+  rk4_stepper_step_to ( s, t1, dt );
+
+  return 0;
+}
+/******************************************************************************/
+
+static void rk4_plain_deriv ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_plain_deriv calls a right hand side that has no context pointer.
+
+  Discussion:
+
+    CTX points to the function pointer itself.  This lets the plain
+    entry points share the code of the context versions.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  void ( **dydt ) ( double t, double u[], double f[] );
+
+  dydt = ( void ( ** ) ( double t, double u[], double f[] ) ) ctx;
+  ( *dydt ) ( t, u, f );
+
+  return;
+}
+/******************************************************************************/
+
+static void rk4_stepper_step_to ( rk4_stepper *s, double target, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_step_to takes steps of size DT, ending exactly at TARGET.
+
+  Discussion:
+
+    The last step is shortened, or stretched by a rounding error, so that
+    it ends on TARGET.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double h;
+
+  while ( s->t < target )
+  {
+    h = dt;
+    if ( target - s->t <= h * ( 1.0 + 1.0E-08 ) )
+    {
+      h = target - s->t;
+    }
+    rk4_stepper_step ( s, h );
+    if ( h != dt )
+    {
+      s->t = target;
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_stepper_reset ( rk4_stepper *s, double t0, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_reset restarts an RK4 stepper from a new initial condition.
+
+  Discussion:
+
+    The workspace is kept, so a parameter sweep can reuse one stepper
+    for every run.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_stepper *S: the stepper.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition, or NULL for zero.
+*/
+{
+  int i;
+
+  s->t = t0;
+  s->step_num = 0;
+  for ( i = 0; i < s->m; i++ )
+  {
+    s->y[i] = ( y0 == NULL ) ? 0.0 : y0[i];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_stepper_step ( rk4_stepper *s, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_step advances an RK4 stepper by one step.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_stepper *S: the stepper.
+
+    double DT: the stepsize.
+
+  Output:
+
+    rk4_stepper *S: S->T and S->Y have been advanced to the end of the step.
+*/
+{
+  rk4_step_ctx ( s->dydt_ctx, s->ctx, s->m, s->t, dt, s->y, s->y, 
+    s->f0, s->f1, s->f2, s->f3, s->u );
+
+  s->t = s->t + dt;
+  s->step_num = s->step_num + 1;
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_stepper_advance ( rk4_stepper *s, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stepper_advance takes N equal steps from the current time to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+
+  Output:
+
+    rk4_stepper *S: S->Y holds the solution at S->T, which is T1 up to
+    rounding.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    rk4_stepper_step ( s, dt );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+double *r8vec_aligned_new ( int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r8vec_aligned_new allocates an R8VEC aligned to RK4_ALIGN bytes.
+
+  Discussion:
+
+    The vector must be released with r8vec_aligned_free(), not free().
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int N: the number of entries.
+
+  Output:
+
+    double *R8VEC_ALIGNED_NEW: the vector, or NULL on failure.
+*/
+{
+  void *a;
+  size_t size;
+
+  size = ( size_t ) n * sizeof ( double );
+  if ( size == 0 )
+  {
+    size = RK4_ALIGN;
+  }
+
+# ifdef _WIN32
+  a = _aligned_malloc ( size, RK4_ALIGN );
+# else
+  if ( posix_memalign ( &a, RK4_ALIGN, size ) != 0 )
+  {
+    a = NULL;
+  }
+# endif
+
+  return ( double * ) a;
+}
+/******************************************************************************/
+
+void r8vec_aligned_free ( double *a )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r8vec_aligned_free frees an R8VEC created by r8vec_aligned_new().
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double *A: the vector.  A may be NULL.
+*/
+{
+# ifdef _WIN32
+  _aligned_free ( a );
+# else
+  free ( a );
+# endif
 
   return;
 }
@@ -1,178 +1,77 @@
-# include <math.h>
-# include <stdio.h>
-# include <stdlib.h>
-# include <time.h>
-
-void rk4 ( void dydt ( double t, double u[], double f[] ), double tspan[2], 
-  double y0[], int n, int m, double t[], double y[] );
-void timestamp ( );
-
-/******************************************************************************/
-
-void rk4 ( void dydt ( double t, double u[], double f[] ), double tspan[2], 
-  double y0[], int n, int m, double t[], double y[] )
-
-/******************************************************************************/
 /*
-  Purpose:
- 
-    rk4 approximates an ODE using a Runge-Kutta fourth order method.
-
-  Licensing:
-
-    This code is distributed under the GNU LGPL license. 
-
-  Modified:
-
-    22 April 2020
-
-  Author:
-
-    John Burkardt
-
-  Input:
-
-    double DYDT ( double T, double U ), a function which evaluates
-    the derivative, or right hand side of the problem.
-
-    double TSPAN[2]: the initial and final times
-
-    double Y0[M]: the initial condition
-
-    int N: the number of steps to take.
-
-    int M: the number of variables.
+  RK4_ALIGN is the byte alignment of every workspace vector.
+*/
+# define RK4_ALIGN 64
 
-  Output:
+/*
+  rk4_stepper holds the state of an RK4 integration that is advanced one
+  step at a time.  All scratch vectors live in a single aligned block
+  which is allocated once by rk4_stepper_create().
 
-    double t[n+1], y[(n+1)*m]: the times and solution values.
+  Steps always go through DYDT_CTX and CTX.  DYDT is only set for a
+  stepper made by rk4_stepper_create().
 */
+typedef struct
 {
-  double dt;
+  void ( *dydt ) ( double t, double u[], double f[] );
+  void ( *dydt_ctx ) ( double t, double u[], double f[], void *ctx );
+  void *ctx;
+  int m;
+  int ld;
+  double t;
+  long int step_num;
+  double *y;
   double *f0;
   double *f1;
   double *f2;
   double *f3;
-  int i;
-  int j;
-  double t0;
-  double t1;
-  double t2;
-  double t3;
-  double *u0;
-  double *u1;
-  double *u2;
-  double *u3;
-
-  f0 = ( double * ) malloc ( m * sizeof ( double ) );
-  f1 = ( double * ) malloc ( m * sizeof ( double ) );
-  f2 = ( double * ) malloc ( m * sizeof ( double ) );
-  f3 = ( double * ) malloc ( m * sizeof ( double ) );
-  u0 = ( double * ) malloc ( m * sizeof ( double ) );
-  u1 = ( double * ) malloc ( m * sizeof ( double ) );
-  u2 = ( double * ) malloc ( m * sizeof ( double ) );
-  u3 = ( double * ) malloc ( m * sizeof ( double ) );
-
-  dt = ( tspan[1] - tspan[0] ) / ( double ) ( n );
-
-  j = 0;
-  t[0] = tspan[0];
-  for ( i = 0; i < m; i++ )
-  {
-    y[i+j*m] = y0[i];
-  }
-
-  for ( j = 0; j < n; j++ )
-  {
-    t0 = t[j];
-    for ( i = 0; i < m; i++ )
-    {
-      u0[i] = y[i+j*m];
-    }
-    dydt ( t0, u0, f0 );
-
-    t1 = t0 + dt / 2.0;
-    for ( i = 0; i < m; i++ )
-    {
-      u1[i] = u0[i] + dt * f0[i] / 2.0;
-    }
-    dydt ( t1, u1, f1 );
+  double *u;
+  double *work;
+} rk4_stepper;
 
-    t2 = t0 + dt / 2.0;
-    for ( i = 0; i < m; i++ )
-    {
-      u2[i] = u0[i] + dt * f1[i] / 2.0;
-    }
-    dydt ( t2, u2, f2 );
-
-    t3 = t0 + dt;
-    for ( i = 0; i < m; i++ )
-    {
-      u3[i] = u0[i] + dt * f2[i];
-    }
-    dydt ( t3, u3, f3 );
-
-    t[j+1] = t[j] + dt;
-    for ( i = 0; i < m; i++ )
-    {
-       y[i+(j+1)*m] = u0[i] + dt * ( f0[i] + 2.0 * f1[i] + 2.0 * f2[i] + f3[i] ) / 6.0;
-    }
-  }
-/*
-  Free memory.
-*/
-  free ( f0 );
-  free ( f1 );
-  free ( f2 );
-  free ( f3 );
-  free ( u0 );
-  free ( u1 );
-  free ( u2 );
-  free ( u3 );
-
-  return;
-}
-/******************************************************************************/
-
-void timestamp ( )
-
-/******************************************************************************/
 /*
-  Purpose:
-
-    TIMESTAMP prints the current YMDHMS date as a time stamp.
-
-  Example:
-
-    31 May 2001 09:45:54 AM
-
-  Licensing:
-
-    This code is distributed under the GNU LGPL license.
-
-  Modified:
-
-    24 September 2003
-
-  Author:
-
-    John Burkardt
+  rk4_observer receives the solution during an integration, so that the
+  caller does not need to store the whole trajectory.
+
+  OBSERVE is called with the time and the current state.  If it returns
+  a nonzero value, the integration stops.  If TOUT_NUM is positive, the
+  solution is reported at the increasing times TOUT[0:TOUT_NUM-1] that
+  lie in the integration interval; otherwise it is reported at the start,
+  after every EVERY steps, and at the end.
 */
+typedef struct
 {
-# define TIME_SIZE 40
-
-  static char time_buffer[TIME_SIZE];
-  const struct tm *tm;
-  time_t now;
-
-  now = time ( NULL );
-  tm = localtime ( &now );
-
-  strftime ( time_buffer, TIME_SIZE, "%d %B %Y %I:%M:%S %p", tm );
-
-  fprintf ( stdout, "%s\n", time_buffer );
-
-  return;
-# undef TIME_SIZE
-}
-
+  int ( *observe ) ( double t, int m, double y[], void *data );
+  void *data;
+  int every;
+  int tout_num;
+  double *tout;
+} rk4_observer;
+
+double *r8vec_aligned_new ( int n );
+void r8vec_aligned_free ( double *a );
+void rk4 ( void dydt ( double t, double u[], double f[] ), double tspan[2],
+  double y0[], int n, int m, double t[], double y[] );
+void rk4_ctx ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, double tspan[2], double y0[], int n, int m, double t[],
+  double y[] );
+int rk4_observe ( void dydt ( double t, double u[], double f[] ),
+  double tspan[2], double y0[], int n, int m, rk4_observer *obs );
+int rk4_observer_call ( rk4_observer *obs, double t, int m, double y[] );
+void rk4_step ( void dydt ( double t, double u[], double f[] ), int m,
+  double t0, double dt, double u0[], double u1[], double f0[], double f1[],
+  double f2[], double f3[], double u[] );
+void rk4_step_ctx ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, int m, double t0, double dt, double u0[], double u1[],
+  double f0[], double f1[], double f2[], double f3[], double u[] );
+void rk4_stepper_advance ( rk4_stepper *s, double t1, int n );
+rk4_stepper *rk4_stepper_create ( void dydt ( double t, double u[], double f[] ),
+  int m, double t0, double y0[] );
+rk4_stepper *rk4_stepper_create_ctx ( void dydt ( double t, double u[],
+  double f[], void *ctx ), void *ctx, int m, double t0, double y0[] );
+void rk4_stepper_destroy ( rk4_stepper *s );
+int rk4_stepper_observe ( rk4_stepper *s, double t1, int n,
+  rk4_observer *obs );
+void rk4_stepper_reset ( rk4_stepper *s, double t0, double y0[] );
+void rk4_stepper_step ( rk4_stepper *s, double dt );
+void timestamp ( );
@@ -0,0 +1,1214 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk45.h"
+# include "rk4_stats.h"
+
+static double rk45_event_root ( rk45_stepper *s, rk45_event *ev, int k );
+static double rk45_hinit ( rk45_stepper *s );
+static double rk45_norm ( int m, double e[], double y0[], double y1[],
+  double rtol, double atol );
+static void rk45_plain_deriv ( double t, double u[], double f[], void *ctx );
+
+/*
+  Dormand-Prince 5(4) coefficients.  E holds the difference between the
+  fifth and fourth order weights, and D the weights of the continuous
+  extension, from Hairer, Norsett and Wanner's DOPRI5.
+*/
+static const double c2 = 1.0 / 5.0;
+static const double c3 = 3.0 / 10.0;
+static const double c4 = 4.0 / 5.0;
+static const double c5 = 8.0 / 9.0;
+static const double a21 = 1.0 / 5.0;
+static const double a31 = 3.0 / 40.0;
+static const double a32 = 9.0 / 40.0;
+static const double a41 = 44.0 / 45.0;
+static const double a42 = -56.0 / 15.0;
+static const double a43 = 32.0 / 9.0;
+static const double a51 = 19372.0 / 6561.0;
+static const double a52 = -25360.0 / 2187.0;
+static const double a53 = 64448.0 / 6561.0;
+static const double a54 = -212.0 / 729.0;
+static const double a61 = 9017.0 / 3168.0;
+static const double a62 = -355.0 / 33.0;
+static const double a63 = 46732.0 / 5247.0;
+static const double a64 = 49.0 / 176.0;
+static const double a65 = -5103.0 / 18656.0;
+static const double a71 = 35.0 / 384.0;
+static const double a73 = 500.0 / 1113.0;
+static const double a74 = 125.0 / 192.0;
+static const double a75 = -2187.0 / 6784.0;
+static const double a76 = 11.0 / 84.0;
+static const double e1 = 71.0 / 57600.0;
+static const double e3 = -71.0 / 16695.0;
+static const double e4 = 71.0 / 1920.0;
+static const double e5 = -17253.0 / 339200.0;
+static const double e6 = 22.0 / 525.0;
+static const double e7 = -1.0 / 40.0;
+static const double d1 = -12715105075.0 / 11282082432.0;
+static const double d3 = 87487479700.0 / 32700410799.0;
+static const double d4 = -10690763975.0 / 1880347072.0;
+static const double d5 = 701980252875.0 / 199316789632.0;
+static const double d6 = -1453857185.0 / 822651844.0;
+static const double d7 = 69997945.0 / 29380423.0;
+
+/*
+  Step size controller constants, after Hairer, Norsett and Wanner.
+*/
+static const double rk45_beta = 0.04;
+static const double rk45_fac_min = 0.2;
+static const double rk45_fac_max = 10.0;
+static const double rk45_safe = 0.9;
+
+/******************************************************************************/
+
+int rk45 ( void dydt ( double t, double u[], double f[] ), double tspan[2],
+  double y0[], int m, double rtol, double atol, double y[], long int *eval_num )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45 approximates an ODE using an adaptive Dormand-Prince 5(4) method.
+
+  Discussion:
+
+    Only the final solution is returned.  Use rk45_create() and
+    rk45_step() to see the intermediate steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double DYDT ( double T, double U[], double F[] ), evaluates the
+    right hand side of the problem.
+
+    double TSPAN[2]: the initial and final times, TSPAN[0] < TSPAN[1].
+
+    double Y0[M]: the initial condition.
+
+    int M: the number of variables.
+
+    double RTOL, ATOL: the relative and absolute error tolerances.
+
+  Output:
+
+    double Y[M]: the solution at TSPAN[1].
+
+    long int *EVAL_NUM: the number of calls to DYDT.  May be NULL.
+
+    int RK45: 0 on success, 1 if the stepsize became too small,
+    2 if memory could not be allocated.
+*/
+{
+  int i;
+  int status;
+  rk45_stepper *s;
+
+  s = rk45_create ( dydt, m, tspan[0], y0, rtol, atol );
+  if ( s == NULL )
+  {
+    return 2;
+  }
+
+  status = rk45_advance ( s, tspan[1] );
+
+  for ( i = 0; i < m; i++ )
+  {
+    y[i] = s->y[i];
+  }
+  if ( eval_num != NULL )
+  {
+    *eval_num = s->eval_num;
+  }
+
+  rk45_destroy ( s );
+
+  return status;
+}
+/******************************************************************************/
+
+rk45_stepper *rk45_create ( void dydt ( double t, double u[], double f[] ),
+  int m, double t0, double y0[], double rtol, double atol )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_create creates an adaptive Dormand-Prince 5(4) stepper.
+
+  Discussion:
+
+    The derivative at T0 is evaluated here.  The initial stepsize is
+    chosen on the first call to rk45_step(), unless S->H has been set.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double DYDT ( double T, double U[], double F[] ), evaluates the
+    right hand side of the problem.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    double RTOL, ATOL: the relative and absolute error tolerances.
+
+  Output:
+
+    rk45_stepper *RK45_CREATE: the stepper, or NULL if memory could not
+    be allocated.
+*/
+{
+  rk45_stepper *s;
+/*
+  The first evaluation, made inside rk45_create_ctx(), reaches DYDT
+  through this argument; later ones through the stepper's own copy.
+*/
+  s = rk45_create_ctx ( rk45_plain_deriv, ( void * ) &dydt, m, t0, y0, rtol,
+    atol );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+  s->dydt = dydt;
+  s->ctx = ( void * ) &s->dydt;
+
+  return s;
+}
+/******************************************************************************/
+
+rk45_stepper *rk45_create_ctx ( void dydt ( double t, double u[], double f[],
+  void *ctx ), void *ctx, int m, double t0, double y0[], double rtol,
+  double atol )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_create_ctx creates an adaptive Dormand-Prince 5(4) stepper for a
+    right hand side with a context pointer.
+
+  Discussion:
+
+    The derivative at T0 is evaluated here.  The initial stepsize is
+    chosen on the first call to rk45_step(), unless S->H has been set.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side of the problem.
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    double RTOL, ATOL: the relative and absolute error tolerances.
+
+  Output:
+
+    rk45_stepper *RK45_CREATE_CTX: the stepper, or NULL if memory could
+    not be allocated.
+*/
+{
+  int i;
+  int ld;
+  rk45_stepper *s;
+
+  s = ( rk45_stepper * ) malloc ( sizeof ( rk45_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( 12 * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->dydt = NULL;
+  s->dydt_ctx = dydt;
+  s->ctx = ctx;
+  s->m = m;
+  s->ld = ld;
+  s->rtol = rtol;
+  s->atol = atol;
+  s->hmax = HUGE_VAL;
+  s->t = t0;
+  s->t_old = t0;
+  s->h = 0.0;
+  s->err_old = 1.0E-04;
+  s->step_num = 0;
+  s->reject_num = 0;
+  s->eval_num = 0;
+  s->y     = s->work;
+  s->y_old = s->work +      ld;
+  s->f_old = s->work +  2 * ld;
+  s->k1    = s->work +  3 * ld;
+  s->k2    = s->work +  4 * ld;
+  s->k3    = s->work +  5 * ld;
+  s->k4    = s->work +  6 * ld;
+  s->k5    = s->work +  7 * ld;
+  s->k6    = s->work +  8 * ld;
+  s->k7    = s->work +  9 * ld;
+  s->u     = s->work + 10 * ld;
+  s->dense = s->work + 11 * ld;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = y0[i];
+    s->y_old[i] = y0[i];
+  }
+
+  dydt ( t0, s->y, s->k1, ctx );
+  s->eval_num = 1;
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 1 );
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->f_old[i] = s->k1[i];
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void rk45_destroy ( rk45_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_destroy frees an adaptive Dormand-Prince 5(4) stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int rk45_step ( rk45_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_step takes one accepted adaptive step, without passing T1.
+
+  Discussion:
+
+    Rejected attempts are retried with a smaller stepsize.  The stepsize
+    for the next step comes from a PI controller on the error norm.
+
+    The step fails if the stepsize falls below 16 EPS |T|, or below
+    16 EPS 1.0E-300 at T = 0.  The bound does not depend on T1, so that
+    a long interval can still start with small steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_stepper *S: the stepper.
+
+    double T1: the time not to step past, T1 > S->T.
+
+  Output:
+
+    rk45_stepper *S: the advanced stepper.
+
+    int RK45_STEP: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  double err;
+  double fac;
+  double fac11;
+  double h;
+  double hmin;
+  int i;
+  int m;
+  int last;
+  double t;
+  double *tmp;
+  double *u;
+  double *y;
+
+  m = s->m;
+  t = s->t;
+  y = s->y;
+  u = s->u;
+
+  if ( s->h == 0.0 )
+  {
+    s->h = rk45_hinit ( s );
+  }
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+
+  for ( ; ; )
+  {
+    h = fmin ( s->h, s->hmax );
+    last = 0;
+    if ( t1 - t <= h )
+    {
+      h = t1 - t;
+      last = 1;
+    }
+
+    hmin = 16.0 * 2.220446049250313E-16 * fmax ( fabs ( t ), 1.0E-300 );
+    if ( fabs ( h ) < hmin )
+    {
+      RK4_STATS_TOC ( RK4_PHASE_STEP );
+      return 1;
+    }
+
+    for ( i = 0; i < m; i++ )
+    {
+      u[i] = y[i] + h * a21 * s->k1[i];
+    }
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt_ctx ( t + c2 * h, u, s->k2, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+    for ( i = 0; i < m; i++ )
+    {
+      u[i] = y[i] + h * ( a31 * s->k1[i] + a32 * s->k2[i] );
+    }
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt_ctx ( t + c3 * h, u, s->k3, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+    for ( i = 0; i < m; i++ )
+    {
+      u[i] = y[i] + h * ( a41 * s->k1[i] + a42 * s->k2[i] + a43 * s->k3[i] );
+    }
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt_ctx ( t + c4 * h, u, s->k4, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+    for ( i = 0; i < m; i++ )
+    {
+      u[i] = y[i] + h * ( a51 * s->k1[i] + a52 * s->k2[i] + a53 * s->k3[i]
+        + a54 * s->k4[i] );
+    }
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt_ctx ( t + c5 * h, u, s->k5, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+    for ( i = 0; i < m; i++ )
+    {
+      u[i] = y[i] + h * ( a61 * s->k1[i] + a62 * s->k2[i] + a63 * s->k3[i]
+        + a64 * s->k4[i] + a65 * s->k5[i] );
+    }
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt_ctx ( t + h, u, s->k6, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+
+    for ( i = 0; i < m; i++ )
+    {
+      u[i] = y[i] + h * ( a71 * s->k1[i] + a73 * s->k3[i] + a74 * s->k4[i]
+        + a75 * s->k5[i] + a76 * s->k6[i] );
+    }
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    s->dydt_ctx ( t + h, u, s->k7, s->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+    s->eval_num = s->eval_num + 6;
+    RK4_STATS_ADD ( RK4_COUNT_EVAL, 6 );
+/*
+  K2 is no longer needed, so it holds the error estimate.
+*/
+    for ( i = 0; i < m; i++ )
+    {
+      s->k2[i] = h * ( e1 * s->k1[i] + e3 * s->k3[i] + e4 * s->k4[i]
+        + e5 * s->k5[i] + e6 * s->k6[i] + e7 * s->k7[i] );
+    }
+    err = rk45_norm ( m, s->k2, y, u, s->rtol, s->atol );
+
+    fac11 = pow ( err, 0.2 - 0.75 * rk45_beta );
+
+    if ( err <= 1.0 )
+    {
+      fac = fac11 / pow ( s->err_old, rk45_beta ) / rk45_safe;
+      fac = fmax ( 1.0 / rk45_fac_max, fmin ( 1.0 / rk45_fac_min, fac ) );
+      s->err_old = fmax ( err, 1.0E-04 );
+      if ( !last )
+      {
+        s->h = h / fac;
+      }
+/*
+  K2 now holds the one term of the dense output that needs the inner
+  stages.  Swap buffers rather than copy: the old solution and derivative
+  are kept for dense output, and K7 becomes the first stage of the next
+  step.
+*/
+      for ( i = 0; i < m; i++ )
+      {
+        s->k2[i] = h * ( d1 * s->k1[i] + d3 * s->k3[i] + d4 * s->k4[i]
+          + d5 * s->k5[i] + d6 * s->k6[i] + d7 * s->k7[i] );
+      }
+      tmp = s->dense;
+      s->dense = s->k2;
+      s->k2 = tmp;
+
+      tmp = s->y_old;
+      s->y_old = s->y;
+      s->y = s->u;
+      s->u = tmp;
+
+      tmp = s->f_old;
+      s->f_old = s->k1;
+      s->k1 = s->k7;
+      s->k7 = tmp;
+
+      s->t_old = t;
+      s->t = last ? t1 : t + h;
+      s->step_num = s->step_num + 1;
+
+      RK4_STATS_TOC ( RK4_PHASE_STEP );
+      RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+      return 0;
+    }
+
+    s->reject_num = s->reject_num + 1;
+    RK4_STATS_ADD ( RK4_COUNT_REJECT, 1 );
+    s->h = h / fmin ( 1.0 / rk45_fac_min, fac11 / rk45_safe );
+  }
+}
+/******************************************************************************/
+
+int rk45_advance ( rk45_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_advance takes adaptive steps until T1 is reached.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_stepper *S: the stepper.
+
+    double T1: the final time.
+
+  Output:
+
+    rk45_stepper *S: the stepper, with S->T = T1 on success.
+
+    int RK45_ADVANCE: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  int status;
+
+  while ( s->t < t1 )
+  {
+    status = rk45_step ( s, t1 );
+    if ( status != 0 )
+    {
+      return status;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void rk45_dense ( rk45_stepper *s, double t, double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_dense interpolates the solution within the last accepted step.
+
+  Discussion:
+
+    The interpolant is the fourth order continuous extension of DOPRI5,
+    in the form given by Hairer, Norsett and Wanner: with THETA the
+    fraction of the step, YDIFF = Y - Y_OLD and B = H * F_OLD - YDIFF,
+
+      Y(THETA) = Y_OLD + THETA * ( YDIFF + ( 1 - THETA ) * ( B
+        + THETA * ( YDIFF - H * K1 - B + ( 1 - THETA ) * DENSE ) ) ),
+
+    where DENSE was formed from the stages when the step was accepted.
+    It needs no extra evaluations of DYDT.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_stepper *S: the stepper.
+
+    double T: the time, S->T_OLD <= T <= S->T.
+
+  Output:
+
+    double Y[M]: the interpolated solution.
+*/
+{
+  double b;
+  double h;
+  int i;
+  double th;
+  double ydiff;
+
+  h = s->t - s->t_old;
+  if ( h == 0.0 )
+  {
+    for ( i = 0; i < s->m; i++ )
+    {
+      y[i] = s->y[i];
+    }
+    return;
+  }
+
+  th = ( t - s->t_old ) / h;
+
+  for ( i = 0; i < s->m; i++ )
+  {
+    ydiff = s->y[i] - s->y_old[i];
+    b = h * s->f_old[i] - ydiff;
+    y[i] = s->y_old[i] + th * ( ydiff + ( 1.0 - th ) * ( b
+      + th * ( ydiff - h * s->k1[i] - b + ( 1.0 - th ) * s->dense[i] ) ) );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+int rk45_event_advance ( rk45_stepper *s, double t1, rk45_event *ev )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_event_advance takes adaptive steps to T1, locating events.
+
+  Discussion:
+
+    After each step, every event function is checked for a sign change
+    between S->T_OLD and S->T.  Event times are then found to rounding
+    level by the Illinois method on G ( T, Y(T) ), where Y(T) comes from
+    rk45_dense(), so the stepsize is not limited by the events.  Only
+    one sign change of each function per step can be found.  Events
+    within a step are reported in order of time.
+
+    At a terminal event the stepper is moved back to the event time:
+    S->Y is the interpolated solution there, and K1 is recomputed, at the
+    cost of one evaluation of DYDT.  The caller may then change S->Y,
+    recompute S->K1 to match, and call again to continue.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    rk45_event *EV: the event functions.
+
+  Output:
+
+    rk45_stepper *S: the advanced stepper.
+
+    rk45_event *EV: the record of the events found.
+
+    int RK45_EVENT_ADVANCE: 0 if the integration reached T1, 1 if the
+    stepsize became too small, 4 if it stopped at a terminal event.
+*/
+{
+  int i;
+  int k;
+  int kmin;
+  int status;
+  int stop;
+  double *tmp;
+  double tmin;
+
+  if ( ev->t_g != s->t )
+  {
+    ev->g ( s->t, s->m, s->y, ev->g_old, ev->data );
+    ev->t_g = s->t;
+  }
+
+  while ( s->t < t1 )
+  {
+    status = rk45_step ( s, t1 );
+    if ( status != 0 )
+    {
+      return status;
+    }
+
+    ev->g ( s->t, s->m, s->y, ev->g_new, ev->data );
+    for ( k = 0; k < ev->event_num; k++ )
+    {
+      ev->t_root[k] = rk45_event_root ( s, ev, k );
+    }
+/*
+  Report the events of this step, earliest first.
+*/
+    for ( ; ; )
+    {
+      kmin = -1;
+      tmin = HUGE_VAL;
+      for ( k = 0; k < ev->event_num; k++ )
+      {
+        if ( ev->t_root[k] < tmin )
+        {
+          kmin = k;
+          tmin = ev->t_root[k];
+        }
+      }
+      if ( kmin < 0 )
+      {
+        break;
+      }
+      ev->t_root[kmin] = HUGE_VAL;
+
+      rk45_dense ( s, tmin, s->u );
+      ev->t_event = tmin;
+      ev->k_event = kmin;
+      ev->event_count[kmin] = ev->event_count[kmin] + 1;
+
+      stop = ev->terminal[kmin];
+      if ( ev->found != NULL )
+      {
+        if ( ev->found ( kmin, tmin, s->m, s->u, ev->data ) )
+        {
+          stop = 1;
+        }
+      }
+
+      if ( stop )
+      {
+        for ( i = 0; i < s->m; i++ )
+        {
+          s->y[i] = s->u[i];
+        }
+        s->t = tmin;
+        s->dydt_ctx ( s->t, s->y, s->k1, s->ctx );
+        s->eval_num = s->eval_num + 1;
+        RK4_STATS_ADD ( RK4_COUNT_EVAL, 1 );
+        ev->g ( s->t, s->m, s->y, ev->g_old, ev->data );
+        ev->t_g = s->t;
+        return 4;
+      }
+    }
+
+    tmp = ev->g_old;
+    ev->g_old = ev->g_new;
+    ev->g_new = tmp;
+    ev->t_g = s->t;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+rk45_event *rk45_event_create ( int event_num, void g ( double t, int m,
+  double y[], double gv[], void *data ), void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_event_create creates a set of event functions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int EVENT_NUM: the number of event functions.
+
+    void G ( double T, int M, double Y[], double GV[], void *DATA ),
+    evaluates the event functions.
+
+    void *DATA: the context passed to G and FOUND.
+
+  Output:
+
+    rk45_event *RK45_EVENT_CREATE: the events, with no FOUND function, all
+    directions 0 and no terminal events, or NULL if memory could not be
+    allocated.
+*/
+{
+  rk45_event *ev;
+
+  ev = ( rk45_event * ) malloc ( sizeof ( rk45_event ) );
+  if ( ev == NULL )
+  {
+    return NULL;
+  }
+
+  ev->direction = ( int * ) calloc ( event_num, sizeof ( int ) );
+  ev->terminal = ( int * ) calloc ( event_num, sizeof ( int ) );
+  ev->event_count = ( long int * ) calloc ( event_num, sizeof ( long int ) );
+  ev->work = ( double * ) malloc ( 4 * event_num * sizeof ( double ) );
+  if ( ev->direction == NULL || ev->terminal == NULL 
+    || ev->event_count == NULL || ev->work == NULL )
+  {
+    free ( ev->direction );
+    free ( ev->terminal );
+    free ( ev->event_count );
+    free ( ev->work );
+    free ( ev );
+    return NULL;
+  }
+
+  ev->event_num = event_num;
+  ev->g = g;
+  ev->found = NULL;
+  ev->data = data;
+  ev->t_event = 0.0;
+  ev->k_event = -1;
+  ev->t_g = NAN;
+  ev->g_old  = ev->work;
+  ev->g_new  = ev->work +     event_num;
+  ev->g_try  = ev->work + 2 * event_num;
+  ev->t_root = ev->work + 3 * event_num;
+
+  return ev;
+}
+/******************************************************************************/
+
+void rk45_event_destroy ( rk45_event *ev )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_event_destroy frees a set of event functions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_event *EV: the events.  EV may be NULL.
+*/
+{
+  if ( ev == NULL )
+  {
+    return;
+  }
+  free ( ev->direction );
+  free ( ev->terminal );
+  free ( ev->event_count );
+  free ( ev->work );
+  free ( ev );
+
+  return;
+}
+/******************************************************************************/
+
+int rk45_observe ( rk45_stepper *s, double t1, rk4_observer *obs )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_observe takes adaptive steps to T1, reporting to an observer.
+
+  Discussion:
+
+    Requested output times do not restrict the stepsize; the solution
+    there is found by rk45_dense().  The work vector S->U is free between
+    steps and holds the interpolated values.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk45_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    rk4_observer *OBS: the observer.
+
+  Output:
+
+    rk45_stepper *S: the advanced stepper.
+
+    int RK45_OBSERVE: 0 if the integration reached T1, 1 if the stepsize
+    became too small, 3 if the observer stopped it.
+*/
+{
+  int k;
+  long int step_num;
+  int status;
+
+  if ( obs->tout_num <= 0 )
+  {
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 3;
+    }
+    step_num = 0;
+    while ( s->t < t1 )
+    {
+      status = rk45_step ( s, t1 );
+      if ( status != 0 )
+      {
+        return status;
+      }
+      step_num = step_num + 1;
+      if ( ( 0 < obs->every && step_num % obs->every == 0 ) || t1 <= s->t )
+      {
+        if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+        {
+          return 3;
+        }
+      }
+    }
+    return 0;
+  }
+
+  k = 0;
+  while ( k < obs->tout_num && obs->tout[k] < s->t )
+  {
+    k = k + 1;
+  }
+  if ( k < obs->tout_num && obs->tout[k] == s->t )
+  {
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 3;
+    }
+    k = k + 1;
+  }
+
+  while ( s->t < t1 )
+  {
+    status = rk45_step ( s, t1 );
+    if ( status != 0 )
+    {
+      return status;
+    }
+    while ( k < obs->tout_num && obs->tout[k] <= s->t && obs->tout[k] <= t1 )
+    {
+      rk45_dense ( s, obs->tout[k], s->u );
+      if ( rk4_observer_call ( obs, obs->tout[k], s->m, s->u ) )
+      {
+        return 3;
+      }
+      k = k + 1;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static double rk45_event_root ( rk45_stepper *s, rk45_event *ev, int k )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_event_root locates event K within the last step.
+
+  Discussion:
+
+    The Illinois variant of regula falsi keeps a bracket [A,B] with the
+    old sign of G at A and the new sign at B, and B is returned, so G
+    has already crossed at the reported time.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    double RK45_EVENT_ROOT: the event time, or HUGE_VAL if event K does
+    not happen in the step.
+*/
+{
+  double a;
+  double b;
+  double c;
+  int down;
+  double ga;
+  double gb;
+  double gc;
+  int it;
+  int side;
+  double tol;
+  int up;
+
+  ga = ev->g_old[k];
+  gb = ev->g_new[k];
+  up = ( ga < 0.0 && 0.0 <= gb );
+  down = ( 0.0 < ga && gb <= 0.0 );
+
+  if ( !( ( up && 0 <= ev->direction[k] ) 
+    || ( down && ev->direction[k] <= 0 ) ) )
+  {
+    return HUGE_VAL;
+  }
+
+  a = s->t_old;
+  b = s->t;
+  tol = 4.0 * 2.220446049250313E-16 * ( fabs ( a ) + fabs ( b ) );
+  side = 0;
+
+  for ( it = 0; it < 100 && tol < b - a; it++ )
+  {
+    c = b - gb * ( b - a ) / ( gb - ga );
+    if ( c <= a || b <= c )
+    {
+      c = 0.5 * ( a + b );
+    }
+    rk45_dense ( s, c, s->u );
+    ev->g ( c, s->m, s->u, ev->g_try, ev->data );
+    gc = ev->g_try[k];
+
+    if ( ( up && 0.0 <= gc ) || ( down && gc <= 0.0 ) )
+    {
+      b = c;
+      gb = gc;
+      if ( side == -1 )
+      {
+        ga = ga / 2.0;
+      }
+      side = -1;
+    }
+    else
+    {
+      a = c;
+      ga = gc;
+      if ( side == 1 )
+      {
+        gb = gb / 2.0;
+      }
+      side = 1;
+    }
+  }
+
+  return b;
+}
+/******************************************************************************/
+
+static double rk45_hinit ( rk45_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_hinit guesses an initial stepsize.
+
+  Discussion:
+
+    This is the starting step algorithm of Hairer, Norsett and Wanner.
+    It costs one extra evaluation of DYDT, which is stored in K2.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double d0;
+  double d1;
+  double d2;
+  double h0;
+  double h1;
+  int i;
+  double sk;
+
+  d0 = 0.0;
+  d1 = 0.0;
+  for ( i = 0; i < s->m; i++ )
+  {
+    sk = s->atol + s->rtol * fabs ( s->y[i] );
+    d0 = d0 + ( s->y[i] / sk ) * ( s->y[i] / sk );
+    d1 = d1 + ( s->k1[i] / sk ) * ( s->k1[i] / sk );
+  }
+  d0 = sqrt ( d0 / s->m );
+  d1 = sqrt ( d1 / s->m );
+
+  if ( d0 < 1.0E-05 || d1 < 1.0E-05 )
+  {
+    h0 = 1.0E-06;
+  }
+  else
+  {
+    h0 = 0.01 * d0 / d1;
+  }
+  h0 = fmin ( h0, s->hmax );
+
+  for ( i = 0; i < s->m; i++ )
+  {
+    s->u[i] = s->y[i] + h0 * s->k1[i];
+  }
+  s->dydt_ctx ( s->t + h0, s->u, s->k2, s->ctx );
+  s->eval_num = s->eval_num + 1;
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 1 );
+
+  d2 = 0.0;
+  for ( i = 0; i < s->m; i++ )
+  {
+    sk = s->atol + s->rtol * fabs ( s->y[i] );
+    d2 = d2 + ( ( s->k2[i] - s->k1[i] ) / sk ) * ( ( s->k2[i] - s->k1[i] ) / sk );
+  }
+  d2 = sqrt ( d2 / s->m ) / h0;
+
+  if ( fmax ( d1, d2 ) <= 1.0E-15 )
+  {
+    h1 = fmax ( 1.0E-06, h0 * 1.0E-03 );
+  }
+  else
+  {
+    h1 = pow ( 0.01 / fmax ( d1, d2 ), 0.2 );
+  }
+
+  return fmin ( fmin ( 100.0 * h0, h1 ), s->hmax );
+}
+/******************************************************************************/
+
+static double rk45_norm ( int m, double e[], double y0[], double y1[],
+  double rtol, double atol )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_norm computes the scaled RMS norm of an error estimate.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  double sk;
+  double value;
+
+  value = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    sk = atol + rtol * fmax ( fabs ( y0[i] ), fabs ( y1[i] ) );
+    value = value + ( e[i] / sk ) * ( e[i] / sk );
+  }
+  value = sqrt ( value / m );
+
+  return value;
+}
+/******************************************************************************/
+
+static void rk45_plain_deriv ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_plain_deriv calls a right hand side that has no context pointer.
+
+  Discussion:
+
+    CTX points to the function pointer itself, as in rk4_plain_deriv().
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  void ( **dydt ) ( double t, double u[], double f[] );
+
+  dydt = ( void ( ** ) ( double t, double u[], double f[] ) ) ctx;
+  ( *dydt ) ( t, u, f );
+
+  return;
+}
@@ -0,0 +1,93 @@
+/*
+  rk45_stepper holds the state of an adaptive Dormand-Prince 5(4)
+  integration.  The last stage of an accepted step is the first stage of
+  the next one, so an accepted step costs six evaluations of DYDT.
+
+  After each accepted step, Y_OLD and F_OLD hold the solution and
+  derivative at T_OLD, the start of the step, while Y and K1 hold them at T.
+  DENSE holds the part of the continuous extension that depends on the
+  inner stages of the step, for rk45_dense().
+
+  Steps always go through DYDT_CTX and CTX.  DYDT is only set for a
+  stepper made by rk45_create().
+*/
+typedef struct
+{
+  void ( *dydt ) ( double t, double u[], double f[] );
+  void ( *dydt_ctx ) ( double t, double u[], double f[], void *ctx );
+  void *ctx;
+  int m;
+  int ld;
+  double rtol;
+  double atol;
+  double hmax;
+  double t;
+  double t_old;
+  double h;
+  double err_old;
+  long int step_num;
+  long int reject_num;
+  long int eval_num;
+  double *y;
+  double *y_old;
+  double *f_old;
+  double *k1;
+  double *k2;
+  double *k3;
+  double *k4;
+  double *k5;
+  double *k6;
+  double *k7;
+  double *u;
+  double *dense;
+  double *work;
+} rk45_stepper;
+
+/*
+  rk45_event describes EVENT_NUM event functions of an rk45 integration.
+
+  G ( T, M, Y, GV, DATA ) sets GV[0:EVENT_NUM-1].  Event K happens where
+  GV[K] changes sign: from negative to nonnegative if DIRECTION[K] = +1,
+  from positive to nonpositive if DIRECTION[K] = -1, either way if 0.
+  Each event found is passed to FOUND, if it is not NULL.  The integration
+  stops at an event if TERMINAL[K] is nonzero or FOUND returns nonzero.
+
+  rk45_event_create() sets DIRECTION and TERMINAL to zero.  T_EVENT and
+  K_EVENT record the last event found, and EVENT_COUNT[K] counts them.
+  G_OLD, G_NEW, G_TRY and T_ROOT point into the workspace WORK.
+*/
+typedef struct
+{
+  int event_num;
+  void ( *g ) ( double t, int m, double y[], double gv[], void *data );
+  int ( *found ) ( int k, double t, int m, double y[], void *data );
+  void *data;
+  int *direction;
+  int *terminal;
+  double t_event;
+  int k_event;
+  long int *event_count;
+  double t_g;
+  double *g_old;
+  double *g_new;
+  double *g_try;
+  double *t_root;
+  double *work;
+} rk45_event;
+
+int rk45 ( void dydt ( double t, double u[], double f[] ), double tspan[2],
+  double y0[], int m, double rtol, double atol, double y[], long int *eval_num );
+int rk45_advance ( rk45_stepper *s, double t1 );
+rk45_stepper *rk45_create ( void dydt ( double t, double u[], double f[] ),
+  int m, double t0, double y0[], double rtol, double atol );
+rk45_stepper *rk45_create_ctx ( void dydt ( double t, double u[], double f[],
+  void *ctx ), void *ctx, int m, double t0, double y0[], double rtol,
+  double atol );
+void rk45_dense ( rk45_stepper *s, double t, double y[] );
+void rk45_destroy ( rk45_stepper *s );
+int rk45_event_advance ( rk45_stepper *s, double t1, rk45_event *ev );
+rk45_event *rk45_event_create ( int event_num, void g ( double t, int m,
+  double y[], double gv[], void *data ), void *data );
+void rk45_event_destroy ( rk45_event *ev );
+int rk45_observe ( rk45_stepper *s, double t1, rk4_observer *obs );
+int rk45_step ( rk45_stepper *s, double t1 );
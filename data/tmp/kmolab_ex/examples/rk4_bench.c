@@ -0,0 +1,1277 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+
+# include <sys/resource.h>
+
+# include "rk4.h"
+# include "rk4_ensemble.h"
+# include "rk45.h"
+# include "rk4_pool.h"
+# include "rk4_par.h"
+# include "rk4_stats.h"
+# include "symplectic.h"
+
+/*
+  bench_out collects the records of one benchmark run.
+*/
+typedef struct
+{
+  FILE *fp;
+  int record_num;
+  int repeat;
+} bench_out;
+
+int main ( int argc, char *argv[] );
+void bench_ensemble ( bench_out *out, int quick );
+void bench_heat ( bench_out *out, int quick, rk4_pool *pool );
+void bench_lorenz ( bench_out *out, int quick );
+void bench_nbody ( bench_out *out, int quick );
+void bench_predator ( bench_out *out, int quick );
+void bench_record ( bench_out *out, char *workload, char *method, int m,
+  long int step_num, long int rhs_num, double seconds, double checksum,
+  double error );
+double bench_rk4 ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, int m, double y0[], double t1, long int n, double *checksum );
+long int bench_maxrss ( );
+void heat_deriv_ctx ( double t, double u[], double f[], void *ctx );
+void heat_deriv_part ( double t, int lo, int hi, double u[], double f[],
+  void *ctx );
+void lorenz_deriv ( double t, double u[], double f[] );
+void lorenz_deriv_ctx ( double t, double u[], double f[], void *ctx );
+void nbody_deriv_ctx ( double t, double u[], double f[], void *ctx );
+void nbody_dpdt ( double t, double q[], double dp[], void *ctx );
+void nbody_dqdt ( double t, double p[], double dq[], void *ctx );
+void predator_deriv ( double t, double u[], double f[] );
+void predator_deriv_batch ( double t, int nens, int m, int ld, double u[],
+  double f[] );
+void predator_deriv_batch_float ( double t, int nens, int m, int ld,
+  float u[], float f[] );
+void predator_deriv_ctx ( double t, double u[], double f[], void *ctx );
+double r8vec_sum ( int n, double a[] );
+double wtime ( );
+
+/******************************************************************************/
+
+int main ( int argc, char *argv[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    MAIN is the main program for rk4_bench.
+
+  Discussion:
+
+    rk4_bench times the ODE integrators on fixed workloads, and writes
+    one JSON document describing the runs.
+
+    Usage:
+
+      rk4_bench [-quick] [-threads T] [-o file.json]
+
+    -quick divides every step count by 10.  -threads sets the pool size
+    for the parallel workloads; the default is one per processor.  The
+    JSON goes to standard output unless -o is given.
+
+    Each timing is the best of three runs.  The workloads and their
+    initial conditions are fixed, and each record includes a checksum of
+    the final state, so results can be compared between releases.
+
+    If the library was built with RK4_STATS, the document ends with the
+    rk4_stats totals for the whole run, which split the time between the
+    right hand side, the stage arithmetic and output.
+
+    Build with, for example:
+
+      gcc -O3 -march=native -pthread -o rk4_bench rk4_bench.c rk4.c
+        rk4_ensemble.c rk45.c rk4_pool.c rk4_par.c rk4_stats.c
+        symplectic.c -lm
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  bench_out out;
+  rk4_pool *pool;
+  int quick;
+  rk4_stats stats;
+  int thread_num;
+
+  out.fp = stdout;
+  out.record_num = 0;
+  out.repeat = 3;
+  quick = 0;
+  thread_num = 0;
+
+  for ( i = 1; i < argc; i++ )
+  {
+    if ( strcmp ( argv[i], "-quick" ) == 0 )
+    {
+      quick = 1;
+    }
+    else if ( strcmp ( argv[i], "-threads" ) == 0 && i + 1 < argc )
+    {
+      i = i + 1;
+      thread_num = atoi ( argv[i] );
+    }
+    else if ( strcmp ( argv[i], "-o" ) == 0 && i + 1 < argc )
+    {
+      i = i + 1;
+      out.fp = fopen ( argv[i], "wt" );
+      if ( out.fp == NULL )
+      {
+        fprintf ( stderr, "\n" );
+        fprintf ( stderr, "rk4_bench - Fatal error!\n" );
+        fprintf ( stderr, "  Could not open \"%s\".\n", argv[i] );
+        exit ( 1 );
+      }
+    }
+    else
+    {
+      fprintf ( stderr, "\n" );
+      fprintf ( stderr, "rk4_bench - Fatal error!\n" );
+      fprintf ( stderr, "  Unknown argument \"%s\".\n", argv[i] );
+      fprintf ( stderr,
+        "  Usage: rk4_bench [-quick] [-threads T] [-o file.json]\n" );
+      exit ( 1 );
+    }
+  }
+
+  pool = rk4_pool_create ( thread_num );
+  rk4_stats_reset ( );
+
+  fprintf ( out.fp, "{\n" );
+  fprintf ( out.fp, "  \"benchmark\": \"rk4_bench\",\n" );
+  fprintf ( out.fp, "  \"format\": 1,\n" );
+  fprintf ( out.fp, "  \"time\": %ld,\n", ( long int ) time ( NULL ) );
+# ifdef __VERSION__
+  fprintf ( out.fp, "  \"compiler\": \"%s\",\n", __VERSION__ );
+# endif
+  fprintf ( out.fp, "  \"quick\": %d,\n", quick );
+  fprintf ( out.fp, "  \"threads\": %d,\n", rk4_pool_size ( pool ) );
+  fprintf ( out.fp, "  \"repeat\": %d,\n", out.repeat );
+  fprintf ( out.fp, "  \"results\": [" );
+
+  bench_predator ( &out, quick );
+  bench_lorenz ( &out, quick );
+  bench_nbody ( &out, quick );
+  bench_heat ( &out, quick, pool );
+  bench_ensemble ( &out, quick );
+
+  fprintf ( out.fp, "\n  ],\n" );
+  rk4_stats_get ( &stats );
+  fprintf ( out.fp, "  \"stats\": " );
+  rk4_stats_json ( out.fp, &stats, "  " );
+  fprintf ( out.fp, "\n}\n" );
+
+  if ( out.fp != stdout )
+  {
+    fclose ( out.fp );
+  }
+  rk4_pool_destroy ( pool );
+
+  return 0;
+}
+/******************************************************************************/
+
+void bench_ensemble ( bench_out *out, int quick )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_ensemble times a predator prey ensemble in each precision.
+
+  Discussion:
+
+    NENS = 4096 members with different initial conditions, M = 2.  The
+    double run is the reference for the error of the float and mixed
+    runs.  STEPS counts member steps, so NS_PER_STEP is per member.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bench_out *OUT: the output.
+
+    int QUICK: nonzero to take fewer steps.
+*/
+{
+  double best;
+  double checksum;
+  rk4_ensemble *e;
+  double error;
+  int i;
+  int k;
+  int m = 2;
+  char *method[3] = { "rk4_double", "rk4_float", "rk4_mixed" };
+  long int n;
+  int nens = 4096;
+  int p;
+  int r;
+  double *ref;
+  double seconds;
+  double t1 = 5.0;
+  double y[2];
+
+  n = quick ? 1000 : 10000;
+  ref = ( double * ) malloc ( nens * m * sizeof ( double ) );
+
+  for ( p = 0; p < 3; p++ )
+  {
+    best = HUGE_VAL;
+    e = NULL;
+    for ( r = 0; r < out->repeat; r++ )
+    {
+      rk4_ensemble_destroy ( e );
+      if ( p == 0 )
+      {
+        e = rk4_ensemble_create ( predator_deriv_batch, m, nens, 0.0 );
+      }
+      else
+      {
+        e = rk4_ensemble_create_float ( predator_deriv_batch_float, m, nens,
+          0.0, ( p == 1 ) ? RK4_ENSEMBLE_FLOAT : RK4_ENSEMBLE_MIXED );
+      }
+      for ( k = 0; k < nens; k++ )
+      {
+        y[0] = 5000.0 + ( double ) ( k % 64 ) * 50.0;
+        y[1] = 100.0 + ( double ) ( k / 64 ) * 5.0;
+        rk4_ensemble_set ( e, k, y );
+      }
+      seconds = wtime ( );
+      rk4_ensemble_advance ( e, t1, n );
+      seconds = wtime ( ) - seconds;
+      best = fmin ( best, seconds );
+    }
+
+    checksum = 0.0;
+    error = 0.0;
+    for ( k = 0; k < nens; k++ )
+    {
+      rk4_ensemble_get ( e, k, y );
+      for ( i = 0; i < m; i++ )
+      {
+        checksum = checksum + y[i];
+        if ( p == 0 )
+        {
+          ref[i+k*m] = y[i];
+        }
+        else
+        {
+          error = fmax ( error, fabs ( y[i] - ref[i+k*m] )
+            / fabs ( ref[i+k*m] ) );
+        }
+      }
+    }
+    rk4_ensemble_destroy ( e );
+
+    bench_record ( out, "ensemble", method[p], m, n * nens, 4 * n * nens,
+      best, checksum, error );
+  }
+
+  free ( ref );
+
+  return;
+}
+/******************************************************************************/
+
+void bench_heat ( bench_out *out, int quick, rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_heat times the 1D heat equation by the method of lines, M = 10^6.
+
+  Discussion:
+
+    The serial RK4 stepper is compared with rk4_par on the pool.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bench_out *OUT: the output.
+
+    int QUICK: nonzero to take fewer steps.
+
+    rk4_pool *POOL: the threads for rk4_par.
+*/
+{
+  double best;
+  double checksum;
+  double dx;
+  int i;
+  int m = 1000000;
+  long int n;
+  rk4_par *p;
+  int r;
+  double seconds;
+  double t1;
+  double *y0;
+
+  n = quick ? 4 : 40;
+  dx = 1.0 / ( double ) ( m + 1 );
+  t1 = 0.5 * dx * dx * n;
+
+  y0 = ( double * ) malloc ( m * sizeof ( double ) );
+  for ( i = 0; i < m; i++ )
+  {
+    y0[i] = sin ( M_PI * ( i + 1 ) * dx );
+  }
+
+  seconds = bench_rk4 ( heat_deriv_ctx, &m, m, y0, t1, n, &checksum );
+  bench_record ( out, "heat", "rk4", m, n, 4 * n, seconds, checksum,
+    -1.0 );
+
+  best = HUGE_VAL;
+  checksum = 0.0;
+  for ( r = 0; r < out->repeat; r++ )
+  {
+    p = rk4_par_create ( heat_deriv_part, &m, m, 0.0, y0, pool );
+    seconds = wtime ( );
+    rk4_par_advance ( p, t1, n );
+    seconds = wtime ( ) - seconds;
+    best = fmin ( best, seconds );
+    checksum = r8vec_sum ( m, p->y );
+    rk4_par_destroy ( p );
+  }
+  bench_record ( out, "heat", "rk4_par", m, n, 4 * n, best, checksum,
+    -1.0 );
+
+  free ( y0 );
+
+  return;
+}
+/******************************************************************************/
+
+void bench_lorenz ( bench_out *out, int quick )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_lorenz times the Lorenz system, M = 3.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bench_out *OUT: the output.
+
+    int QUICK: nonzero to take fewer steps.
+*/
+{
+  double best;
+  double checksum;
+  int m = 3;
+  long int n;
+  int r;
+  rk45_stepper *s;
+  double seconds;
+  double t1 = 20.0;
+  double y0[3] = { 1.0, 1.0, 1.0 };
+
+  n = quick ? 100000 : 1000000;
+
+  seconds = bench_rk4 ( lorenz_deriv_ctx, NULL, m, y0, t1, n, &checksum );
+  bench_record ( out, "lorenz", "rk4", m, n, 4 * n, seconds, checksum,
+    -1.0 );
+
+  best = HUGE_VAL;
+  s = NULL;
+  for ( r = 0; r < out->repeat; r++ )
+  {
+    rk45_destroy ( s );
+    s = rk45_create ( lorenz_deriv, m, 0.0, y0, 1.0E-10, 1.0E-10 );
+    seconds = wtime ( );
+    rk45_advance ( s, t1 );
+    seconds = wtime ( ) - seconds;
+    best = fmin ( best, seconds );
+  }
+  bench_record ( out, "lorenz", "rk45", m, s->step_num, s->eval_num, best,
+    r8vec_sum ( m, s->y ), -1.0 );
+  rk45_destroy ( s );
+
+  return;
+}
+/******************************************************************************/
+
+void bench_nbody ( bench_out *out, int quick )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_nbody times a gravitational N-body system, M = 6 N.
+
+  Discussion:
+
+    N = 128 bodies of unit total mass start at reproducible pseudorandom
+    positions in the unit cube, at rest.  The force is softened.  RK4 is
+    compared with the Yoshida symplectic method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bench_out *OUT: the output.
+
+    int QUICK: nonzero to take fewer steps.
+*/
+{
+  double best;
+  double checksum;
+  int i;
+  int m;
+  long int n;
+  int nb = 128;
+  int r;
+  symp_stepper *s;
+  double seconds;
+  unsigned int seed;
+  double t1 = 1.0;
+  double *y0;
+
+  m = 6 * nb;
+  n = quick ? 100 : 1000;
+
+  y0 = ( double * ) malloc ( m * sizeof ( double ) );
+  seed = 123456789;
+  for ( i = 0; i < 3 * nb; i++ )
+  {
+    seed = 1664525 * seed + 1013904223;
+    y0[i] = ( double ) seed / 4294967296.0;
+    y0[i+3*nb] = 0.0;
+  }
+
+  seconds = bench_rk4 ( nbody_deriv_ctx, &nb, m, y0, t1, n, &checksum );
+  bench_record ( out, "nbody", "rk4", m, n, 4 * n, seconds, checksum,
+    -1.0 );
+
+  best = HUGE_VAL;
+  s = NULL;
+  for ( r = 0; r < out->repeat; r++ )
+  {
+    symp_destroy ( s );
+    s = symp_create ( SYMP_YOSHIDA4, nbody_dqdt, nbody_dpdt, &nb, 3 * nb,
+      0.0, y0, y0 + 3 * nb );
+    seconds = wtime ( );
+    symp_advance ( s, t1, n );
+    seconds = wtime ( ) - seconds;
+    best = fmin ( best, seconds );
+  }
+  bench_record ( out, "nbody", "yoshida4", m, n, s->eval_num, best,
+    r8vec_sum ( m, s->y ), -1.0 );
+  symp_destroy ( s );
+
+  free ( y0 );
+
+  return;
+}
+/******************************************************************************/
+
+void bench_predator ( bench_out *out, int quick )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_predator times the predator prey system, M = 2.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bench_out *OUT: the output.
+
+    int QUICK: nonzero to take fewer steps.
+*/
+{
+  double best;
+  double checksum;
+  int m = 2;
+  long int n;
+  int r;
+  rk45_stepper *s;
+  double seconds;
+  double t1 = 5.0;
+  double y0[2] = { 5000.0, 100.0 };
+
+  n = quick ? 100000 : 1000000;
+
+  seconds = bench_rk4 ( predator_deriv_ctx, NULL, m, y0, t1, n, &checksum );
+  bench_record ( out, "predator", "rk4", m, n, 4 * n, seconds, checksum,
+    -1.0 );
+
+  best = HUGE_VAL;
+  s = NULL;
+  for ( r = 0; r < out->repeat; r++ )
+  {
+    rk45_destroy ( s );
+    s = rk45_create ( predator_deriv, m, 0.0, y0, 1.0E-10, 1.0E-10 );
+    seconds = wtime ( );
+    rk45_advance ( s, t1 );
+    seconds = wtime ( ) - seconds;
+    best = fmin ( best, seconds );
+  }
+  bench_record ( out, "predator", "rk45", m, s->step_num, s->eval_num, best,
+    r8vec_sum ( m, s->y ), -1.0 );
+  rk45_destroy ( s );
+
+  return;
+}
+/******************************************************************************/
+
+void bench_record ( bench_out *out, char *workload, char *method, int m,
+  long int step_num, long int rhs_num, double seconds, double checksum,
+  double error )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_record writes one benchmark result as a JSON object.
+
+  Discussion:
+
+    PROCESS_MAXRSS_KB is the high water mark of the resident set of the
+    whole process so far, not of this workload.  It never decreases
+    from one record to the next, so once a large workload has run, the
+    later records repeat its value.  To measure the memory of one
+    workload, run it alone in its own process.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bench_out *OUT: the output.
+
+    char *WORKLOAD, *METHOD: the names of the workload and method.
+
+    int M: the number of variables.
+
+    long int STEP_NUM, RHS_NUM: the number of steps and of right hand
+    side evaluations.
+
+    double SECONDS: the best time.
+
+    double CHECKSUM: the sum of the final state.
+
+    double ERROR: the maximum relative error, against a reference run,
+    or a negative value if there is none.
+*/
+{
+  fprintf ( out->fp, "%s\n", ( out->record_num == 0 ) ? "" : "," );
+  fprintf ( out->fp, "    {\"workload\": \"%s\", \"method\": \"%s\", "
+    "\"m\": %d,\n", workload, method, m );
+  fprintf ( out->fp, "     \"steps\": %ld, \"rhs_calls\": %ld, "
+    "\"seconds\": %.6e,\n", step_num, rhs_num, seconds );
+  fprintf ( out->fp, "     \"ns_per_step\": %.6e, \"rhs_per_second\": %.6e,\n",
+    1.0E+09 * seconds / ( double ) step_num, ( double ) rhs_num / seconds );
+  fprintf ( out->fp, "     \"process_maxrss_kb\": %ld, \"checksum\": %.17e",
+    bench_maxrss ( ), checksum );
+  if ( 0.0 <= error )
+  {
+    fprintf ( out->fp, ",\n     \"max_rel_error\": %.6e", error );
+  }
+  fprintf ( out->fp, "}" );
+  fflush ( out->fp );
+
+  out->record_num = out->record_num + 1;
+
+  return;
+}
+/******************************************************************************/
+
+double bench_rk4 ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, int m, double y0[], double t1, long int n, double *checksum )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_rk4 times N steps of the RK4 stepper from 0 to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side.
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double Y0[M]: the initial condition.
+
+    double T1: the final time.
+
+    long int N: the number of steps.
+
+  Output:
+
+    double *CHECKSUM: the sum of the final state.
+
+    double BENCH_RK4: the best time of three runs, in seconds.
+*/
+{
+  double best;
+  double dt;
+  long int j;
+  int r;
+  rk4_stepper *s;
+  double seconds;
+
+  s = rk4_stepper_create_ctx ( dydt, ctx, m, 0.0, y0 );
+  dt = t1 / ( double ) ( n );
+
+  best = HUGE_VAL;
+  for ( r = 0; r < 3; r++ )
+  {
+    rk4_stepper_reset ( s, 0.0, y0 );
+    seconds = wtime ( );
+    for ( j = 0; j < n; j++ )
+    {
+      rk4_stepper_step ( s, dt );
+    }
+    seconds = wtime ( ) - seconds;
+    best = fmin ( best, seconds );
+  }
+
+  *checksum = r8vec_sum ( m, s->y );
+  rk4_stepper_destroy ( s );
+
+  return best;
+}
+/******************************************************************************/
+
+long int bench_maxrss ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bench_maxrss returns the peak resident set size of the process.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    long int BENCH_MAXRSS: the peak resident set, in kilobytes, or -1 if
+    it is not available.
+*/
+{
+  struct rusage usage;
+
+  if ( getrusage ( RUSAGE_SELF, &usage ) != 0 )
+  {
+    return -1;
+  }
+# ifdef __APPLE__
+  return ( long int ) usage.ru_maxrss / 1024;
+# else
+  return ( long int ) usage.ru_maxrss;
+# endif
+}
+/******************************************************************************/
+
+void heat_deriv_ctx ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    heat_deriv_ctx evaluates the whole method of lines heat equation.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[M], the nodal values.
+
+    void *CTX, the number of nodes, int M.
+
+  Output:
+
+    double F[M], the value of the derivative, dU/dT.
+*/
+{
+  heat_deriv_part ( t, 0, * ( int * ) ctx, u, f, ctx );
+
+  return;
+}
+/******************************************************************************/
+
+void heat_deriv_part ( double t, int lo, int hi, double u[], double f[],
+  void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    heat_deriv_part evaluates part of the method of lines heat equation.
+
+  Discussion:
+
+    F(I) = ( U(I-1) - 2 U(I) + U(I+1) ) / DX^2, with zero boundary values.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int LO, HI, the range of entries to evaluate.
+
+    double U[M], the nodal values.
+
+    void *CTX, the number of nodes, int M.
+
+  Output:
+
+    double F[M], entries LO to HI-1 of the derivative.
+*/
+{
+  double dx2;
+  int i;
+  int m;
+  double ul;
+  double ur;
+
+  m = * ( int * ) ctx;
+  dx2 = 1.0 / ( double ) ( m + 1 ) / ( double ) ( m + 1 );
+
+  for ( i = lo; i < hi; i++ )
+  {
+    ul = ( 0 < i ) ? u[i-1] : 0.0;
+    ur = ( i < m - 1 ) ? u[i+1] : 0.0;
+    f[i] = ( ul - 2.0 * u[i] + ur ) / dx2;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void lorenz_deriv ( double t, double u[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lorenz_deriv evaluates the Lorenz system.
+
+  Discussion:
+
+    SIGMA = 10, RHO = 28, BETA = 8/3.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[3], the current solution value.
+
+  Output:
+
+    double F[3], the value of the derivative, dU/dT.
+*/
+{
+  f[0] = 10.0 * ( u[1] - u[0] );
+  f[1] = u[0] * ( 28.0 - u[2] ) - u[1];
+  f[2] = u[0] * u[1] - 8.0 / 3.0 * u[2];
+
+  return;
+}
+/******************************************************************************/
+
+void lorenz_deriv_ctx ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    lorenz_deriv_ctx is lorenz_deriv with an unused context.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  lorenz_deriv ( t, u, f );
+
+  return;
+}
+/******************************************************************************/
+
+void nbody_deriv_ctx ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    nbody_deriv_ctx evaluates the N-body system as a first order system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[6*N], the positions and then the velocities.
+
+    void *CTX, the number of bodies, int N.
+
+  Output:
+
+    double F[6*N], the value of the derivative, dU/dT.
+*/
+{
+  int nb;
+
+  nb = * ( int * ) ctx;
+  nbody_dqdt ( t, u + 3 * nb, f, ctx );
+  nbody_dpdt ( t, u, f + 3 * nb, ctx );
+
+  return;
+}
+/******************************************************************************/
+
+void nbody_dpdt ( double t, double q[], double dp[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    nbody_dpdt evaluates the softened gravitational accelerations.
+
+  Discussion:
+
+    Each of the N bodies has mass 1/N, and the softening length is 0.05.
+    Body J is at Q[3*J+0:3*J+2].
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Q[3*N], the positions.
+
+    void *CTX, the number of bodies, int N.
+
+  Output:
+
+    double DP[3*N], the accelerations.
+*/
+{
+  double d[3];
+  int i;
+  int j;
+  int k;
+  double mass;
+  int nb;
+  double r2;
+  double w;
+
+  nb = * ( int * ) ctx;
+  mass = 1.0 / ( double ) nb;
+
+  for ( i = 0; i < 3 * nb; i++ )
+  {
+    dp[i] = 0.0;
+  }
+
+  for ( i = 0; i < nb; i++ )
+  {
+    for ( j = i + 1; j < nb; j++ )
+    {
+      r2 = 0.05 * 0.05;
+      for ( k = 0; k < 3; k++ )
+      {
+        d[k] = q[3*j+k] - q[3*i+k];
+        r2 = r2 + d[k] * d[k];
+      }
+      w = mass / ( r2 * sqrt ( r2 ) );
+      for ( k = 0; k < 3; k++ )
+      {
+        dp[3*i+k] = dp[3*i+k] + w * d[k];
+        dp[3*j+k] = dp[3*j+k] - w * d[k];
+      }
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void nbody_dqdt ( double t, double p[], double dq[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    nbody_dqdt evaluates the N-body velocities.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double P[3*N], the velocities.
+
+    void *CTX, the number of bodies, int N.
+
+  Output:
+
+    double DQ[3*N], the rate of change of the positions.
+*/
+{
+  int i;
+  int nb;
+
+  nb = * ( int * ) ctx;
+  for ( i = 0; i < 3 * nb; i++ )
+  {
+    dq[i] = p[i];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv ( double t, double u[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_deriv evaluates the predator prey system of rk4_test.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[2], the current solution value.
+
+  Output:
+
+    double F[2], the value of the derivative, dU/dT.
+*/
+{
+  double fox;
+  double rab;
+
+  rab = u[0];
+  fox = u[1];
+
+  f[0] =    2.0 * rab - 0.001 * rab * fox;
+  f[1] = - 10.0 * fox + 0.002 * rab * fox;
+
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_batch ( double t, int nens, int m, int ld, double u[],
+  double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_deriv_batch evaluates the predator prey system for an ensemble.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int NENS, the number of members.
+
+    int M, the number of variables.
+
+    int LD, the leading dimension.
+
+    double U[M*LD], the current solution values, by component.
+
+  Output:
+
+    double F[M*LD], the values of the derivative.
+*/
+{
+  double *fox;
+  int k;
+  double *rab;
+
+  rab = u;
+  fox = u + ld;
+
+  for ( k = 0; k < ld; k++ )
+  {
+    f[k]    =   2.0 * rab[k] - 0.001 * rab[k] * fox[k];
+    f[k+ld] = -10.0 * fox[k] + 0.002 * rab[k] * fox[k];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_batch_float ( double t, int nens, int m, int ld,
+  float u[], float f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_deriv_batch_float is predator_deriv_batch in single precision.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int NENS, the number of members.
+
+    int M, the number of variables.
+
+    int LD, the leading dimension.
+
+    float U[M*LD], the current solution values, by component.
+
+  Output:
+
+    float F[M*LD], the values of the derivative.
+*/
+{
+  float *fox;
+  int k;
+  float *rab;
+
+  rab = u;
+  fox = u + ld;
+
+  for ( k = 0; k < ld; k++ )
+  {
+    f[k]    =   2.0f * rab[k] - 0.001f * rab[k] * fox[k];
+    f[k+ld] = -10.0f * fox[k] + 0.002f * rab[k] * fox[k];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_ctx ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_deriv_ctx is predator_deriv with an unused context.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  predator_deriv ( t, u, f );
+
+  return;
+}
+/******************************************************************************/
+
+double r8vec_sum ( int n, double a[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r8vec_sum returns the sum of an R8VEC.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int N, the number of entries.
+
+    double A[N], the vector.
+
+  Output:
+
+    double R8VEC_SUM, the sum of the entries.
+*/
+{
+  int i;
+  double value;
+
+  value = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    value = value + a[i];
+  }
+
+  return value;
+}
+/******************************************************************************/
+
+double wtime ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    wtime returns a reading of the wall clock, in seconds.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    double WTIME, the time in seconds from an arbitrary origin.
+*/
+{
+  struct timespec ts;
+
+  clock_gettime ( CLOCK_MONOTONIC, &ts );
+
+  return ( double ) ts.tv_sec + 1.0E-09 * ( double ) ts.tv_nsec;
+}
@@ -0,0 +1,899 @@
+# include <pthread.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unistd.h>
+
+# include "rk4.h"
+# include "rk45.h"
+# include "rk4_ckpt.h"
+# include "rk4_stats.h"
+
+# define RK4_CKPT_RK4 1
+# define RK4_CKPT_RK45 2
+
+/*
+  rk4_ckpt_state is one saved state: KIND, the scalars DVAL and LVAL, and
+  VEC_NUM vectors of length M stored one after another in VEC.
+*/
+struct rk4_ckpt_state
+{
+  int kind;
+  int m;
+  int vec_num;
+  long int cap;
+  double dval[8];
+  long long int lval[4];
+  double *vec;
+};
+
+/*
+  The caller fills FRONT while the writer thread writes BACK.  PENDING is
+  set when FRONT holds a state that has not been written yet.
+*/
+struct rk4_ckpt
+{
+  char *filename;
+  char *tmpname;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+  pthread_cond_t idle;
+  struct rk4_ckpt_state state[2];
+  struct rk4_ckpt_state *front;
+  struct rk4_ckpt_state *back;
+  int pending;
+  int writing;
+  int quit;
+  int error;
+};
+
+static struct rk4_ckpt_state *rk4_ckpt_begin ( rk4_ckpt *c, int kind, int m,
+  int vec_num );
+static void rk4_ckpt_end ( rk4_ckpt *c );
+static void *rk4_ckpt_main ( void *data );
+static int rk4_ckpt_read ( char *filename, int kind, int m, double dval[8],
+  long long int lval[4], int vec_num, double *vec[] );
+static int rk4_ckpt_run_load ( char *filename, rk4_stepper *s,
+  double tspan[2], long int n );
+static int rk4_ckpt_run_save ( rk4_ckpt *c, rk4_stepper *s, double tspan[2],
+  long int n );
+static int rk4_ckpt_write ( rk4_ckpt *c, struct rk4_ckpt_state *st );
+
+/******************************************************************************/
+
+rk4_ckpt *rk4_ckpt_create ( char *filename )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_create starts a checkpoint writer for one file.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    char *FILENAME: the name of the checkpoint file.
+
+  Output:
+
+    rk4_ckpt *RK4_CKPT_CREATE: the writer, or NULL on failure.
+*/
+{
+  rk4_ckpt *c;
+  int k;
+  size_t len;
+
+  c = ( rk4_ckpt * ) malloc ( sizeof ( rk4_ckpt ) );
+  if ( c == NULL )
+  {
+    return NULL;
+  }
+
+  len = strlen ( filename );
+  c->filename = ( char * ) malloc ( len + 1 );
+  c->tmpname = ( char * ) malloc ( len + 5 );
+  if ( c->filename == NULL || c->tmpname == NULL )
+  {
+    free ( c->filename );
+    free ( c->tmpname );
+    free ( c );
+    return NULL;
+  }
+  strcpy ( c->filename, filename );
+  strcpy ( c->tmpname, filename );
+  strcat ( c->tmpname, ".tmp" );
+
+  for ( k = 0; k < 2; k++ )
+  {
+    c->state[k].cap = 0;
+    c->state[k].vec = NULL;
+  }
+  c->front = c->state;
+  c->back = c->state + 1;
+  c->pending = 0;
+  c->writing = 0;
+  c->quit = 0;
+  c->error = 0;
+
+  pthread_mutex_init ( &c->lock, NULL );
+  pthread_cond_init ( &c->ready, NULL );
+  pthread_cond_init ( &c->idle, NULL );
+
+  if ( pthread_create ( &c->thread, NULL, rk4_ckpt_main, c ) != 0 )
+  {
+    pthread_cond_destroy ( &c->idle );
+    pthread_cond_destroy ( &c->ready );
+    pthread_mutex_destroy ( &c->lock );
+    free ( c->filename );
+    free ( c->tmpname );
+    free ( c );
+    return NULL;
+  }
+
+  return c;
+}
+/******************************************************************************/
+
+int rk4_ckpt_destroy ( rk4_ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_destroy writes any waiting state and stops a checkpoint writer.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ckpt *C: the writer.  C may be NULL.
+
+  Output:
+
+    int RK4_CKPT_DESTROY: 0 if every checkpoint was written, 1 otherwise.
+*/
+{
+  int error;
+
+  if ( c == NULL )
+  {
+    return 0;
+  }
+
+  pthread_mutex_lock ( &c->lock );
+  c->quit = 1;
+  pthread_cond_signal ( &c->ready );
+  pthread_mutex_unlock ( &c->lock );
+
+  pthread_join ( c->thread, NULL );
+
+  error = c->error;
+
+  pthread_cond_destroy ( &c->idle );
+  pthread_cond_destroy ( &c->ready );
+  pthread_mutex_destroy ( &c->lock );
+  free ( c->state[0].vec );
+  free ( c->state[1].vec );
+  free ( c->filename );
+  free ( c->tmpname );
+  free ( c );
+
+  return error;
+}
+/******************************************************************************/
+
+int rk4_ckpt_load ( char *filename, rk4_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_load restores an RK4 stepper from a checkpoint file.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    char *FILENAME: the name of the checkpoint file.
+
+    rk4_stepper *S: a stepper with the same number of variables.
+
+  Output:
+
+    rk4_stepper *S: the saved time, step count and solution.  S is not
+    changed if the file could not be loaded.
+
+    int RK4_CKPT_LOAD: 0 if the state was loaded, 1 if the file is
+    missing, or does not hold an RK4 state of the right size.
+*/
+{
+  double dval[8];
+  long long int lval[4];
+  double *vec[1];
+
+  vec[0] = s->y;
+  if ( rk4_ckpt_read ( filename, RK4_CKPT_RK4, s->m, dval, lval, 1, vec )
+    != 0 )
+  {
+    return 1;
+  }
+
+  s->t = dval[0];
+  s->step_num = ( long int ) lval[0];
+
+  return 0;
+}
+/******************************************************************************/
+
+int rk4_ckpt_run ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, double tspan[2], double y0[], long int n, int m, double y[],
+  char *filename, long int every )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_run takes N RK4 steps, with checkpoints, resuming if it can.
+
+  Discussion:
+
+    If FILENAME holds a checkpoint of this run, the integration continues
+    from it; otherwise it starts from Y0.  The steps are the same as those
+    of rk4_ctx(), so the final solution is bitwise identical to that of an
+    uninterrupted run, however many times the run is resumed.
+
+    TSPAN, N and M are stored in the checkpoint, and a checkpoint that
+    does not match them, or one saved by rk4_ckpt_save(), is ignored.
+    DYDT and CTX cannot be checked, and must be those of the saved run.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side of the problem.
+
+    void *CTX: the context passed to DYDT.
+
+    double TSPAN[2]: the initial and final times.
+
+    double Y0[M]: the initial condition.
+
+    long int N: the number of steps.
+
+    int M: the number of variables.
+
+    char *FILENAME: the name of the checkpoint file.
+
+    long int EVERY: a checkpoint is saved after every EVERY steps, and at
+    the end.  If EVERY <= 0, only at the end.
+
+  Output:
+
+    double Y[M]: the solution at TSPAN[1].
+
+    int RK4_CKPT_RUN: 0 on success, 2 if memory could not be allocated,
+    or 4 if the solution was found but a checkpoint could not be written.
+*/
+{
+  rk4_ckpt *c;
+  double dt;
+  int error;
+  int i;
+  rk4_stepper *s;
+
+  s = rk4_stepper_create_ctx ( dydt, ctx, m, tspan[0], y0 );
+  c = rk4_ckpt_create ( filename );
+  if ( s == NULL || c == NULL )
+  {
+    rk4_stepper_destroy ( s );
+    rk4_ckpt_destroy ( c );
+    return 2;
+  }
+
+  if ( rk4_ckpt_run_load ( filename, s, tspan, n ) != 0 )
+  {
+    rk4_stepper_reset ( s, tspan[0], y0 );
+  }
+
+  dt = ( tspan[1] - tspan[0] ) / ( double ) ( n );
+
+  error = 0;
+  while ( s->step_num < n )
+  {
+    rk4_stepper_step ( s, dt );
+    if ( 0 < every && s->step_num % every == 0 )
+    {
+      error = error | rk4_ckpt_run_save ( c, s, tspan, n );
+    }
+  }
+  error = error | rk4_ckpt_run_save ( c, s, tspan, n );
+
+  for ( i = 0; i < m; i++ )
+  {
+    y[i] = s->y[i];
+  }
+
+  error = error | rk4_ckpt_destroy ( c );
+  rk4_stepper_destroy ( s );
+
+  return ( error == 0 ) ? 0 : 4;
+}
+/******************************************************************************/
+
+int rk4_ckpt_save ( rk4_ckpt *c, rk4_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_save queues the state of an RK4 stepper to be written.
+
+  Discussion:
+
+    The state is copied, and the call returns without waiting for the
+    file to be written.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ckpt *C: the checkpoint writer.
+
+    rk4_stepper *S: the stepper.
+
+  Output:
+
+    int RK4_CKPT_SAVE: 0 if the state was queued, 1 if memory for the
+    copy could not be allocated.
+*/
+{
+  struct rk4_ckpt_state *st;
+
+  st = rk4_ckpt_begin ( c, RK4_CKPT_RK4, s->m, 1 );
+  if ( st == NULL )
+  {
+    return 1;
+  }
+
+  st->dval[0] = s->t;
+  st->lval[0] = s->step_num;
+  memcpy ( st->vec, s->y, s->m * sizeof ( double ) );
+
+  rk4_ckpt_end ( c );
+
+  return 0;
+}
+/******************************************************************************/
+
+int rk4_ckpt_wait ( rk4_ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_wait waits until every queued state has been written.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ckpt *C: the checkpoint writer.
+
+  Output:
+
+    int RK4_CKPT_WAIT: 0 if every checkpoint so far was written, 1 otherwise.
+*/
+{
+  int error;
+
+  pthread_mutex_lock ( &c->lock );
+  while ( c->pending || c->writing )
+  {
+    pthread_cond_wait ( &c->idle, &c->lock );
+  }
+  error = c->error;
+  pthread_mutex_unlock ( &c->lock );
+
+  return error;
+}
+/******************************************************************************/
+
+int rk45_ckpt_load ( char *filename, rk45_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_ckpt_load restores a Dormand-Prince stepper from a checkpoint file.
+
+  Discussion:
+
+    The restored stepper keeps its own DYDT.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    char *FILENAME: the name of the checkpoint file.
+
+    rk45_stepper *S: a stepper with the same number of variables.
+
+  Output:
+
+    rk45_stepper *S: the saved times, controller state, counters, solution
+    and derivatives.  S is not changed if the file could not be loaded.
+
+    int RK45_CKPT_LOAD: 0 if the state was loaded, 1 if the file is
+    missing, or does not hold an RK45 state of the right size.
+*/
+{
+  double dval[8];
+  long long int lval[4];
+  double *vec[5];
+
+  vec[0] = s->y;
+  vec[1] = s->y_old;
+  vec[2] = s->f_old;
+  vec[3] = s->k1;
+  vec[4] = s->dense;
+  if ( rk4_ckpt_read ( filename, RK4_CKPT_RK45, s->m, dval, lval, 5, vec )
+    != 0 )
+  {
+    return 1;
+  }
+
+  s->t = dval[0];
+  s->t_old = dval[1];
+  s->h = dval[2];
+  s->err_old = dval[3];
+  s->hmax = dval[4];
+  s->rtol = dval[5];
+  s->atol = dval[6];
+  s->step_num = ( long int ) lval[0];
+  s->reject_num = ( long int ) lval[1];
+  s->eval_num = ( long int ) lval[2];
+
+  return 0;
+}
+/******************************************************************************/
+
+int rk45_ckpt_save ( rk4_ckpt *c, rk45_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk45_ckpt_save queues the state of a Dormand-Prince stepper to be written.
+
+  Discussion:
+
+    Besides the solution, the step size controller state and the first
+    stage of the next step are saved, so the resumed steps are the same,
+    and so is the data of the last step, so that rk45_dense() still works.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ckpt *C: the checkpoint writer.
+
+    rk45_stepper *S: the stepper.
+
+  Output:
+
+    int RK45_CKPT_SAVE: 0 if the state was queued, 1 if memory for the
+    copy could not be allocated.
+*/
+{
+  int m;
+  struct rk4_ckpt_state *st;
+
+  m = s->m;
+  st = rk4_ckpt_begin ( c, RK4_CKPT_RK45, m, 5 );
+  if ( st == NULL )
+  {
+    return 1;
+  }
+
+  st->dval[0] = s->t;
+  st->dval[1] = s->t_old;
+  st->dval[2] = s->h;
+  st->dval[3] = s->err_old;
+  st->dval[4] = s->hmax;
+  st->dval[5] = s->rtol;
+  st->dval[6] = s->atol;
+  st->lval[0] = s->step_num;
+  st->lval[1] = s->reject_num;
+  st->lval[2] = s->eval_num;
+  memcpy ( st->vec,         s->y,     m * sizeof ( double ) );
+  memcpy ( st->vec +     m, s->y_old, m * sizeof ( double ) );
+  memcpy ( st->vec + 2 * m, s->f_old, m * sizeof ( double ) );
+  memcpy ( st->vec + 3 * m, s->k1,    m * sizeof ( double ) );
+  memcpy ( st->vec + 4 * m, s->dense, m * sizeof ( double ) );
+
+  rk4_ckpt_end ( c );
+
+  return 0;
+}
+/******************************************************************************/
+
+static struct rk4_ckpt_state *rk4_ckpt_begin ( rk4_ckpt *c, int kind, int m,
+  int vec_num )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_begin locks a writer and returns the state to fill.
+
+  Discussion:
+
+    The writer thread only takes the lock to swap the two states, so the
+    caller never waits for the disk.  On success the lock is held until
+    rk4_ckpt_end(); on failure it is released and NULL is returned.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  long int size;
+  struct rk4_ckpt_state *st;
+  double *vec;
+
+  pthread_mutex_lock ( &c->lock );
+
+  st = c->front;
+  size = ( long int ) vec_num * m;
+  if ( st->cap < size )
+  {
+    vec = ( double * ) realloc ( st->vec, size * sizeof ( double ) );
+    if ( vec == NULL )
+    {
+      pthread_mutex_unlock ( &c->lock );
+      return NULL;
+    }
+    st->vec = vec;
+    st->cap = size;
+  }
+
+  memset ( st->dval, 0, sizeof ( st->dval ) );
+  memset ( st->lval, 0, sizeof ( st->lval ) );
+  st->kind = kind;
+  st->m = m;
+  st->vec_num = vec_num;
+
+  return st;
+}
+/******************************************************************************/
+
+static void rk4_ckpt_end ( rk4_ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_end marks the filled state as waiting and unlocks the writer.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  c->pending = 1;
+  pthread_cond_signal ( &c->ready );
+  pthread_mutex_unlock ( &c->lock );
+
+  return;
+}
+/******************************************************************************/
+
+static void *rk4_ckpt_main ( void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_main is the loop run by the writer thread.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4_ckpt *c;
+  int error;
+  struct rk4_ckpt_state *st;
+
+  c = ( rk4_ckpt * ) data;
+
+  pthread_mutex_lock ( &c->lock );
+  for ( ; ; )
+  {
+    while ( !c->pending && !c->quit )
+    {
+      pthread_cond_wait ( &c->ready, &c->lock );
+    }
+    if ( !c->pending )
+    {
+      break;
+    }
+    st = c->front;
+    c->front = c->back;
+    c->back = st;
+    c->pending = 0;
+    c->writing = 1;
+    pthread_mutex_unlock ( &c->lock );
+
+    error = rk4_ckpt_write ( c, st );
+
+    pthread_mutex_lock ( &c->lock );
+    c->writing = 0;
+    c->error = c->error | error;
+    pthread_cond_broadcast ( &c->idle );
+  }
+  pthread_mutex_unlock ( &c->lock );
+
+  return NULL;
+}
+/******************************************************************************/
+
+static int rk4_ckpt_read ( char *filename, int kind, int m, double dval[8],
+  long long int lval[4], int vec_num, double *vec[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_read reads a checkpoint file.
+
+  Discussion:
+
+    The file holds the magic string "RK4CKPT1", the integers KIND, M and
+    VEC_NUM, the double 1.0 to check the byte order, DVAL, LVAL and the
+    vectors, all in the byte order of the machine that wrote it.
+
+    The vectors are read into a buffer, and copied to VEC only once the
+    whole file has been read, so that a short or damaged file leaves VEC
+    as it was.  DVAL and LVAL may be overwritten in any case.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double *buf;
+  int error;
+  int head[3];
+  int k;
+  char magic[8];
+  double one;
+  FILE *fp;
+
+  fp = fopen ( filename, "rb" );
+  if ( fp == NULL )
+  {
+    return 1;
+  }
+
+  error = fread ( magic, 1, 8, fp ) != 8
+    || fread ( head, sizeof ( int ), 3, fp ) != 3
+    || fread ( &one, sizeof ( double ), 1, fp ) != 1
+    || memcmp ( magic, "RK4CKPT1", 8 ) != 0 || one != 1.0
+    || head[0] != kind || head[1] != m || head[2] != vec_num
+    || fread ( dval, sizeof ( double ), 8, fp ) != 8
+    || fread ( lval, sizeof ( long long int ), 4, fp ) != 4;
+
+  buf = NULL;
+  if ( !error )
+  {
+    buf = ( double * ) malloc ( vec_num * m * sizeof ( double ) );
+    error = ( buf == NULL )
+      || fread ( buf, sizeof ( double ), vec_num * m, fp )
+      != ( size_t ) ( vec_num * m );
+  }
+
+  fclose ( fp );
+
+  for ( k = 0; k < vec_num && !error; k++ )
+  {
+    memcpy ( vec[k], buf + k * m, m * sizeof ( double ) );
+  }
+  free ( buf );
+
+  return error;
+}
+/******************************************************************************/
+
+static int rk4_ckpt_run_load ( char *filename, rk4_stepper *s,
+  double tspan[2], long int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_run_load restores an RK4 stepper from a checkpoint of a run.
+
+  Discussion:
+
+    The state is that of rk4_ckpt_load(), and DVAL[1], DVAL[2] and
+    LVAL[1] hold TSPAN[0], TSPAN[1] and N of the run that saved it.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    int RK4_CKPT_RUN_LOAD: 0 if the state was loaded, 1 if the file is
+    missing or damaged, or comes from a different run.  S->Y may be
+    changed in the last case.
+*/
+{
+  double dval[8];
+  long long int lval[4];
+  double *vec[1];
+
+  vec[0] = s->y;
+  if ( rk4_ckpt_read ( filename, RK4_CKPT_RK4, s->m, dval, lval, 1, vec )
+    != 0 )
+  {
+    return 1;
+  }
+
+  if ( dval[1] != tspan[0] || dval[2] != tspan[1] || lval[1] != n
+    || lval[0] < 0 || n < lval[0] )
+  {
+    return 1;
+  }
+
+  s->t = dval[0];
+  s->step_num = ( long int ) lval[0];
+
+  return 0;
+}
+/******************************************************************************/
+
+static int rk4_ckpt_run_save ( rk4_ckpt *c, rk4_stepper *s, double tspan[2],
+  long int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_run_save queues the state of an RK4 run to be written.
+
+  Discussion:
+
+    The state is that of rk4_ckpt_save(), with TSPAN and N added so that
+    rk4_ckpt_run_load() can recognize the run.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  struct rk4_ckpt_state *st;
+
+  st = rk4_ckpt_begin ( c, RK4_CKPT_RK4, s->m, 1 );
+  if ( st == NULL )
+  {
+    return 1;
+  }
+
+  st->dval[0] = s->t;
+  st->dval[1] = tspan[0];
+  st->dval[2] = tspan[1];
+  st->lval[0] = s->step_num;
+  st->lval[1] = n;
+  memcpy ( st->vec, s->y, s->m * sizeof ( double ) );
+
+  rk4_ckpt_end ( c );
+
+  return 0;
+}
+/******************************************************************************/
+
+static int rk4_ckpt_write ( rk4_ckpt *c, struct rk4_ckpt_state *st )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ckpt_write writes one state to the temporary file and renames it.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  size_t count;
+  int error;
+  int head[3];
+  double one = 1.0;
+  FILE *fp;
+
+  fp = fopen ( c->tmpname, "wb" );
+  if ( fp == NULL )
+  {
+    return 1;
+  }
+
+  head[0] = st->kind;
+  head[1] = st->m;
+  head[2] = st->vec_num;
+  count = ( size_t ) st->vec_num * st->m;
+
+  error = fwrite ( "RK4CKPT1", 1, 8, fp ) != 8
+    || fwrite ( head, sizeof ( int ), 3, fp ) != 3
+    || fwrite ( &one, sizeof ( double ), 1, fp ) != 1
+    || fwrite ( st->dval, sizeof ( double ), 8, fp ) != 8
+    || fwrite ( st->lval, sizeof ( long long int ), 4, fp ) != 4
+    || fwrite ( st->vec, sizeof ( double ), count, fp ) != count
+    || fflush ( fp ) != 0
+    || fsync ( fileno ( fp ) ) != 0;
+  error = ( fclose ( fp ) != 0 ) || error;
+/*
+  Only a complete file replaces the previous checkpoint.
+*/
+  if ( error || rename ( c->tmpname, c->filename ) != 0 )
+  {
+    remove ( c->tmpname );
+    return 1;
+  }
+  RK4_STATS_ADD ( RK4_COUNT_BYTE, 8 + 3 * sizeof ( int )
+    + ( 9 + count ) * sizeof ( double ) + 4 * sizeof ( long long int ) );
+
+  return 0;
+}
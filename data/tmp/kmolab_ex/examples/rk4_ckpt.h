@@ -0,0 +1,26 @@
+/*
+  rk4_ckpt saves the state of an integration to a checkpoint file, so that
+  a killed run can be resumed exactly where the last checkpoint left it.
+
+  rk4_ckpt_save() and rk45_ckpt_save() copy the stepper state and return;
+  a background thread writes it to FILENAME.tmp, flushes it to disk and
+  renames it over FILENAME, so the file always holds a whole checkpoint.
+  If a new state is saved while the previous one is still being written,
+  only the newest waiting state is kept.
+
+  rk4_ckpt_load() and rk45_ckpt_load() restore a state into a stepper of
+  the same size.  Every quantity that affects later steps is saved, so
+  the resumed run is bitwise identical to an uninterrupted one.
+*/
+typedef struct rk4_ckpt rk4_ckpt;
+
+rk4_ckpt *rk4_ckpt_create ( char *filename );
+int rk4_ckpt_destroy ( rk4_ckpt *c );
+int rk4_ckpt_load ( char *filename, rk4_stepper *s );
+int rk4_ckpt_run ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, double tspan[2], double y0[], long int n, int m, double y[],
+  char *filename, long int every );
+int rk4_ckpt_save ( rk4_ckpt *c, rk4_stepper *s );
+int rk4_ckpt_wait ( rk4_ckpt *c );
+int rk45_ckpt_load ( char *filename, rk45_stepper *s );
+int rk45_ckpt_save ( rk4_ckpt *c, rk45_stepper *s );
@@ -0,0 +1,918 @@
+# include <stdio.h>
+# include <stdlib.h>
+
+# if defined ( __AVX512F__ ) || defined ( __AVX2__ )
+# include <immintrin.h>
+# endif
+
+# include "rk4.h"
+# include "rk4_ensemble.h"
+
+static void ensemble_axpy ( int n, double a, double x[], double y[],
+  double z[] );
+static void ensemble_axpy_mixed ( int n, double a, float x[], double y[],
+  float z[] );
+static void ensemble_axpy_s ( int n, float a, float x[], float y[],
+  float z[] );
+static void ensemble_combine ( int n, double a, double f0[], double f1[],
+  double f2[], double f3[], double y[] );
+static void ensemble_combine_mixed ( int n, double a, float f0[],
+  float f1[], float f2[], float f3[], double y[] );
+static void ensemble_combine_s ( int n, float a, float f0[], float f1[],
+  float f2[], float f3[], float y[] );
+static void ensemble_plain_deriv ( double t, int nens, int m, int ld,
+  double u[], double f[], void *ctx );
+static void ensemble_round ( int n, double y[], float z[] );
+
+/******************************************************************************/
+
+rk4_ensemble *rk4_ensemble_create ( void dydt ( double t, int nens, int m,
+  int ld, double u[], double f[] ), int m, int nens, double t0 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_create creates an RK4 ensemble integrator.
+
+  Discussion:
+
+    All members start at zero.  Use rk4_ensemble_set() to load the
+    initial conditions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, int NENS, int M, int LD, double U[], double F[] ),
+    evaluates the right hand side for every member.  Component I of
+    member K is U[I*LD+K].
+
+    int M: the number of variables.
+
+    int NENS: the number of ensemble members.
+
+    double T0: the initial time.
+
+  Output:
+
+    rk4_ensemble *RK4_ENSEMBLE_CREATE: the ensemble, or NULL if memory
+    could not be allocated.
+*/
+{
+  rk4_ensemble *e;
+
+  e = rk4_ensemble_create_ctx ( ensemble_plain_deriv, NULL, m, nens, t0 );
+  if ( e == NULL )
+  {
+    return NULL;
+  }
+/*
+  The context is the ensemble's own copy of the plain function pointer.
+*/
+  e->dydt = dydt;
+  e->ctx = ( void * ) &e->dydt;
+
+  return e;
+}
+/******************************************************************************/
+
+rk4_ensemble *rk4_ensemble_create_ctx ( void dydt ( double t, int nens,
+  int m, int ld, double u[], double f[], void *ctx ), void *ctx, int m,
+  int nens, double t0 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_create_ctx creates an RK4 ensemble integrator for a right
+    hand side with a context pointer.
+
+  Discussion:
+
+    All members start at zero.  Use rk4_ensemble_set() to load the
+    initial conditions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, int NENS, int M, int LD, double U[], double F[],
+    void *CTX ), evaluates the right hand side for every member.
+    Component I of member K is U[I*LD+K].
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    int NENS: the number of ensemble members.
+
+    double T0: the initial time.
+
+  Output:
+
+    rk4_ensemble *RK4_ENSEMBLE_CREATE_CTX: the ensemble, or NULL if memory
+    could not be allocated.
+*/
+{
+  rk4_ensemble *e;
+  int i;
+  int ld;
+
+  e = ( rk4_ensemble * ) malloc ( sizeof ( rk4_ensemble ) );
+  if ( e == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( nens + ld - 1 ) / ld ) * ld;
+
+  e->work = r8vec_aligned_new ( 6 * m * ld );
+  if ( e->work == NULL )
+  {
+    free ( e );
+    return NULL;
+  }
+/*
+  Padding lanes are evaluated along with the real members, so keep them
+  at a harmless value.
+*/
+  for ( i = 0; i < 6 * m * ld; i++ )
+  {
+    e->work[i] = 0.0;
+  }
+
+  e->dydt = NULL;
+  e->dydt_ctx = dydt;
+  e->ctx = ctx;
+  e->dydt_s = NULL;
+  e->precision = RK4_ENSEMBLE_DOUBLE;
+  e->m = m;
+  e->nens = nens;
+  e->ld = ld;
+  e->t = t0;
+  e->step_num = 0;
+  e->y  = e->work;
+  e->f0 = e->work +     m * ld;
+  e->f1 = e->work + 2 * m * ld;
+  e->f2 = e->work + 3 * m * ld;
+  e->f3 = e->work + 4 * m * ld;
+  e->u  = e->work + 5 * m * ld;
+  e->ys = NULL;
+  e->f0s = NULL;
+  e->f1s = NULL;
+  e->f2s = NULL;
+  e->f3s = NULL;
+  e->us = NULL;
+
+  return e;
+}
+/******************************************************************************/
+
+rk4_ensemble *rk4_ensemble_create_float ( void dydt ( double t, int nens,
+  int m, int ld, float u[], float f[] ), int m, int nens, double t0,
+  int precision )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_create_float creates a single or mixed precision ensemble.
+
+  Discussion:
+
+    LD is a multiple of RK4_ALIGN / sizeof ( float ), so every float
+    vector, and in mixed mode the double state, starts on an RK4_ALIGN
+    boundary.  All members start at zero.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, int NENS, int M, int LD, float U[], float F[] ),
+    evaluates the right hand side for every member.  Component I of
+    member K is U[I*LD+K].
+
+    int M: the number of variables.
+
+    int NENS: the number of ensemble members.
+
+    double T0: the initial time.
+
+    int PRECISION: RK4_ENSEMBLE_FLOAT or RK4_ENSEMBLE_MIXED.
+
+  Output:
+
+    rk4_ensemble *RK4_ENSEMBLE_CREATE_FLOAT: the ensemble, or NULL if
+    PRECISION is not a float mode or memory could not be allocated.
+*/
+{
+  rk4_ensemble *e;
+  float *fwork;
+  int i;
+  int ld;
+  int size;
+
+  if ( precision != RK4_ENSEMBLE_FLOAT && precision != RK4_ENSEMBLE_MIXED )
+  {
+    return NULL;
+  }
+
+  e = ( rk4_ensemble * ) malloc ( sizeof ( rk4_ensemble ) );
+  if ( e == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( float );
+  ld = ( ( nens + ld - 1 ) / ld ) * ld;
+/*
+  SIZE counts doubles: six float vectors take three, and the mixed
+  state one more.
+*/
+  size = 3 * m * ld;
+  if ( precision == RK4_ENSEMBLE_MIXED )
+  {
+    size = size + m * ld;
+  }
+
+  e->work = r8vec_aligned_new ( size );
+  if ( e->work == NULL )
+  {
+    free ( e );
+    return NULL;
+  }
+  for ( i = 0; i < size; i++ )
+  {
+    e->work[i] = 0.0;
+  }
+
+  e->dydt = NULL;
+  e->dydt_ctx = NULL;
+  e->ctx = NULL;
+  e->dydt_s = dydt;
+  e->precision = precision;
+  e->m = m;
+  e->nens = nens;
+  e->ld = ld;
+  e->t = t0;
+  e->step_num = 0;
+  e->f0 = NULL;
+  e->f1 = NULL;
+  e->f2 = NULL;
+  e->f3 = NULL;
+  e->u = NULL;
+
+  if ( precision == RK4_ENSEMBLE_MIXED )
+  {
+    e->y = e->work;
+    fwork = ( float * ) ( e->work + m * ld );
+  }
+  else
+  {
+    e->y = NULL;
+    fwork = ( float * ) e->work;
+  }
+  e->ys  = fwork;
+  e->f0s = fwork +     m * ld;
+  e->f1s = fwork + 2 * m * ld;
+  e->f2s = fwork + 3 * m * ld;
+  e->f3s = fwork + 4 * m * ld;
+  e->us  = fwork + 5 * m * ld;
+
+  return e;
+}
+/******************************************************************************/
+
+void rk4_ensemble_destroy ( rk4_ensemble *e )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_destroy frees an RK4 ensemble integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ensemble *E: the ensemble.  E may be NULL.
+*/
+{
+  if ( e == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( e->work );
+  free ( e );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ensemble_set ( rk4_ensemble *e, int k, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_set sets the state of one ensemble member.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ensemble *E: the ensemble.
+
+    int K: the member index, 0 <= K < E->NENS.
+
+    double Y0[M]: the state.
+*/
+{
+  int i;
+
+  if ( e->precision == RK4_ENSEMBLE_FLOAT )
+  {
+    for ( i = 0; i < e->m; i++ )
+    {
+      e->ys[i*e->ld+k] = ( float ) y0[i];
+    }
+    return;
+  }
+
+  for ( i = 0; i < e->m; i++ )
+  {
+    e->y[i*e->ld+k] = y0[i];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ensemble_get ( rk4_ensemble *e, int k, double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_get copies out the state of one ensemble member.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ensemble *E: the ensemble.
+
+    int K: the member index, 0 <= K < E->NENS.
+
+  Output:
+
+    double Y[M]: the state.
+*/
+{
+  int i;
+
+  if ( e->precision == RK4_ENSEMBLE_FLOAT )
+  {
+    for ( i = 0; i < e->m; i++ )
+    {
+      y[i] = ( double ) e->ys[i*e->ld+k];
+    }
+    return;
+  }
+
+  for ( i = 0; i < e->m; i++ )
+  {
+    y[i] = e->y[i*e->ld+k];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ensemble_step ( rk4_ensemble *e, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_step advances every ensemble member by one RK4 step.
+
+  Discussion:
+
+    The stage updates run over the whole M*LD block at once, so they
+    vectorize across members regardless of M.
+
+    In mixed precision, each stage input is formed in double from the
+    double state and then rounded to float for DYDT_S.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ensemble *E: the ensemble.
+
+    double DT: the stepsize.
+*/
+{
+  int m;
+  int ld;
+  int n;
+  double t0;
+
+  m = e->m;
+  ld = e->ld;
+  n = m * ld;
+  t0 = e->t;
+
+  if ( e->precision == RK4_ENSEMBLE_FLOAT )
+  {
+    e->dydt_s ( t0, e->nens, m, ld, e->ys, e->f0s );
+
+    ensemble_axpy_s ( n, ( float ) ( dt / 2.0 ), e->f0s, e->ys, e->us );
+    e->dydt_s ( t0 + dt / 2.0, e->nens, m, ld, e->us, e->f1s );
+
+    ensemble_axpy_s ( n, ( float ) ( dt / 2.0 ), e->f1s, e->ys, e->us );
+    e->dydt_s ( t0 + dt / 2.0, e->nens, m, ld, e->us, e->f2s );
+
+    ensemble_axpy_s ( n, ( float ) dt, e->f2s, e->ys, e->us );
+    e->dydt_s ( t0 + dt, e->nens, m, ld, e->us, e->f3s );
+
+    ensemble_combine_s ( n, ( float ) ( dt / 6.0 ), e->f0s, e->f1s, e->f2s,
+      e->f3s, e->ys );
+  }
+  else if ( e->precision == RK4_ENSEMBLE_MIXED )
+  {
+    ensemble_round ( n, e->y, e->ys );
+    e->dydt_s ( t0, e->nens, m, ld, e->ys, e->f0s );
+
+    ensemble_axpy_mixed ( n, dt / 2.0, e->f0s, e->y, e->us );
+    e->dydt_s ( t0 + dt / 2.0, e->nens, m, ld, e->us, e->f1s );
+
+    ensemble_axpy_mixed ( n, dt / 2.0, e->f1s, e->y, e->us );
+    e->dydt_s ( t0 + dt / 2.0, e->nens, m, ld, e->us, e->f2s );
+
+    ensemble_axpy_mixed ( n, dt, e->f2s, e->y, e->us );
+    e->dydt_s ( t0 + dt, e->nens, m, ld, e->us, e->f3s );
+
+    ensemble_combine_mixed ( n, dt / 6.0, e->f0s, e->f1s, e->f2s, e->f3s,
+      e->y );
+  }
+  else
+  {
+    e->dydt_ctx ( t0, e->nens, m, ld, e->y, e->f0, e->ctx );
+
+    ensemble_axpy ( n, dt / 2.0, e->f0, e->y, e->u );
+    e->dydt_ctx ( t0 + dt / 2.0, e->nens, m, ld, e->u, e->f1, e->ctx );
+
+    ensemble_axpy ( n, dt / 2.0, e->f1, e->y, e->u );
+    e->dydt_ctx ( t0 + dt / 2.0, e->nens, m, ld, e->u, e->f2, e->ctx );
+
+    ensemble_axpy ( n, dt, e->f2, e->y, e->u );
+    e->dydt_ctx ( t0 + dt, e->nens, m, ld, e->u, e->f3, e->ctx );
+
+    ensemble_combine ( n, dt / 6.0, e->f0, e->f1, e->f2, e->f3, e->y );
+  }
+
+  e->t = t0 + dt;
+  e->step_num = e->step_num + 1;
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ensemble_advance ( rk4_ensemble *e, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_advance takes N equal steps from the current time to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_ensemble *E: the ensemble.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  dt = ( t1 - e->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    rk4_ensemble_step ( e, dt );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+char *rk4_ensemble_isa ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_ensemble_isa names the instruction set used by the stage kernels.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    char *RK4_ENSEMBLE_ISA: "avx512", "avx2" or "scalar".
+*/
+{
+# if defined ( __AVX512F__ )
+  return "avx512";
+# elif defined ( __AVX2__ )
+  return "avx2";
+# else
+  return "scalar";
+# endif
+}
+/******************************************************************************/
+
+static void ensemble_axpy ( int n, double a, double x[], double y[],
+  double z[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_axpy sets Z = Y + A * X.
+
+  Discussion:
+
+    N is a multiple of RK4_ALIGN / sizeof ( double ) and the vectors are
+    aligned, so no remainder loop is needed for the vector paths.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+# if defined ( __AVX512F__ )
+  __m512d va = _mm512_set1_pd ( a );
+  for ( i = 0; i < n; i = i + 8 )
+  {
+    _mm512_store_pd ( z + i, _mm512_fmadd_pd ( va, _mm512_load_pd ( x + i ),
+      _mm512_load_pd ( y + i ) ) );
+  }
+# elif defined ( __AVX2__ )
+  __m256d va = _mm256_set1_pd ( a );
+  for ( i = 0; i < n; i = i + 4 )
+  {
+#   ifdef __FMA__
+    _mm256_store_pd ( z + i, _mm256_fmadd_pd ( va, _mm256_load_pd ( x + i ),
+      _mm256_load_pd ( y + i ) ) );
+#   else
+    _mm256_store_pd ( z + i, _mm256_add_pd ( _mm256_load_pd ( y + i ),
+      _mm256_mul_pd ( va, _mm256_load_pd ( x + i ) ) ) );
+#   endif
+  }
+# else
+  for ( i = 0; i < n; i++ )
+  {
+    z[i] = y[i] + a * x[i];
+  }
+# endif
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_axpy_mixed ( int n, double a, float x[], double y[],
+  float z[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_axpy_mixed sets Z = Y + A * X, rounded to float.
+
+  Discussion:
+
+    The sum is formed in double.  The loop is left to the compiler,
+    which vectorizes the conversions at -O3.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    z[i] = ( float ) ( y[i] + a * ( double ) x[i] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_axpy_s ( int n, float a, float x[], float y[],
+  float z[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_axpy_s sets Z = Y + A * X in single precision.
+
+  Discussion:
+
+    N is a multiple of RK4_ALIGN / sizeof ( float ) and the vectors are
+    aligned, so no remainder loop is needed for the vector paths.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+# if defined ( __AVX512F__ )
+  __m512 va = _mm512_set1_ps ( a );
+  for ( i = 0; i < n; i = i + 16 )
+  {
+    _mm512_store_ps ( z + i, _mm512_fmadd_ps ( va, _mm512_load_ps ( x + i ),
+      _mm512_load_ps ( y + i ) ) );
+  }
+# elif defined ( __AVX2__ )
+  __m256 va = _mm256_set1_ps ( a );
+  for ( i = 0; i < n; i = i + 8 )
+  {
+#   ifdef __FMA__
+    _mm256_store_ps ( z + i, _mm256_fmadd_ps ( va, _mm256_load_ps ( x + i ),
+      _mm256_load_ps ( y + i ) ) );
+#   else
+    _mm256_store_ps ( z + i, _mm256_add_ps ( _mm256_load_ps ( y + i ),
+      _mm256_mul_ps ( va, _mm256_load_ps ( x + i ) ) ) );
+#   endif
+  }
+# else
+  for ( i = 0; i < n; i++ )
+  {
+    z[i] = y[i] + a * x[i];
+  }
+# endif
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_combine ( int n, double a, double f0[], double f1[],
+  double f2[], double f3[], double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_combine sets Y = Y + A * ( F0 + 2 * ( F1 + F2 ) + F3 ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+# if defined ( __AVX512F__ )
+  __m512d va = _mm512_set1_pd ( a );
+  __m512d two = _mm512_set1_pd ( 2.0 );
+  __m512d s;
+  for ( i = 0; i < n; i = i + 8 )
+  {
+    s = _mm512_add_pd ( _mm512_load_pd ( f1 + i ), _mm512_load_pd ( f2 + i ) );
+    s = _mm512_fmadd_pd ( two, s, _mm512_add_pd ( _mm512_load_pd ( f0 + i ),
+      _mm512_load_pd ( f3 + i ) ) );
+    _mm512_store_pd ( y + i, _mm512_fmadd_pd ( va, s,
+      _mm512_load_pd ( y + i ) ) );
+  }
+# elif defined ( __AVX2__ )
+  __m256d va = _mm256_set1_pd ( a );
+  __m256d two = _mm256_set1_pd ( 2.0 );
+  __m256d s;
+  for ( i = 0; i < n; i = i + 4 )
+  {
+    s = _mm256_add_pd ( _mm256_load_pd ( f1 + i ), _mm256_load_pd ( f2 + i ) );
+    s = _mm256_add_pd ( _mm256_mul_pd ( two, s ),
+      _mm256_add_pd ( _mm256_load_pd ( f0 + i ), _mm256_load_pd ( f3 + i ) ) );
+    _mm256_store_pd ( y + i, _mm256_add_pd ( _mm256_load_pd ( y + i ),
+      _mm256_mul_pd ( va, s ) ) );
+  }
+# else
+  for ( i = 0; i < n; i++ )
+  {
+    y[i] = y[i] + a * ( f0[i] + 2.0 * ( f1[i] + f2[i] ) + f3[i] );
+  }
+# endif
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_combine_mixed ( int n, double a, float f0[],
+  float f1[], float f2[], float f3[], double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_combine_mixed sets Y = Y + A * ( F0 + 2 * ( F1 + F2 ) + F3 ).
+
+  Discussion:
+
+    The float stages are combined and accumulated in double.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    y[i] = y[i] + a * ( ( double ) f0[i] + 2.0 * ( ( double ) f1[i]
+      + ( double ) f2[i] ) + ( double ) f3[i] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_combine_s ( int n, float a, float f0[], float f1[],
+  float f2[], float f3[], float y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_combine_s sets Y = Y + A * ( F0 + 2 * ( F1 + F2 ) + F3 ) in
+    single precision.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+# if defined ( __AVX512F__ )
+  __m512 va = _mm512_set1_ps ( a );
+  __m512 two = _mm512_set1_ps ( 2.0f );
+  __m512 s;
+  for ( i = 0; i < n; i = i + 16 )
+  {
+    s = _mm512_add_ps ( _mm512_load_ps ( f1 + i ), _mm512_load_ps ( f2 + i ) );
+    s = _mm512_fmadd_ps ( two, s, _mm512_add_ps ( _mm512_load_ps ( f0 + i ),
+      _mm512_load_ps ( f3 + i ) ) );
+    _mm512_store_ps ( y + i, _mm512_fmadd_ps ( va, s,
+      _mm512_load_ps ( y + i ) ) );
+  }
+# elif defined ( __AVX2__ )
+  __m256 va = _mm256_set1_ps ( a );
+  __m256 two = _mm256_set1_ps ( 2.0f );
+  __m256 s;
+  for ( i = 0; i < n; i = i + 8 )
+  {
+    s = _mm256_add_ps ( _mm256_load_ps ( f1 + i ), _mm256_load_ps ( f2 + i ) );
+    s = _mm256_add_ps ( _mm256_mul_ps ( two, s ),
+      _mm256_add_ps ( _mm256_load_ps ( f0 + i ), _mm256_load_ps ( f3 + i ) ) );
+    _mm256_store_ps ( y + i, _mm256_add_ps ( _mm256_load_ps ( y + i ),
+      _mm256_mul_ps ( va, s ) ) );
+  }
+# else
+  for ( i = 0; i < n; i++ )
+  {
+    y[i] = y[i] + a * ( f0[i] + 2.0f * ( f1[i] + f2[i] ) + f3[i] );
+  }
+# endif
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_plain_deriv ( double t, int nens, int m, int ld,
+  double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_plain_deriv calls a right hand side that has no context
+    pointer.
+
+  Discussion:
+
+    CTX points to the function pointer itself, as in rk4_plain_deriv().
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  void ( **dydt ) ( double t, int nens, int m, int ld, double u[],
+    double f[] );
+
+  dydt = ( void ( ** ) ( double t, int nens, int m, int ld, double u[],
+    double f[] ) ) ctx;
+  ( *dydt ) ( t, nens, m, ld, u, f );
+
+  return;
+}
+/******************************************************************************/
+
+static void ensemble_round ( int n, double y[], float z[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ensemble_round sets Z = Y, rounded to float.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    z[i] = ( float ) y[i];
+  }
+
+  return;
+}
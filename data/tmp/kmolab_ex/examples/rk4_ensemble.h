@@ -0,0 +1,66 @@
+/*
+  rk4_ensemble advances many trajectories of one ODE together.
+
+  States are stored as a structure of arrays: component I of member K
+  is Y[I*LD+K], where LD is the member count rounded up to a whole
+  number of RK4_ALIGN byte blocks.  The right hand side is evaluated for
+  all members in one call to DYDT, with the same layout for U and F.
+
+  PRECISION selects the arithmetic.  RK4_ENSEMBLE_DOUBLE does everything
+  in double.  RK4_ENSEMBLE_FLOAT keeps the state and stages in float,
+  in YS and F0S to F3S, which doubles the SIMD width and halves the
+  memory traffic.  RK4_ENSEMBLE_MIXED evaluates DYDT_S and keeps the
+  stages in float, but accumulates the state Y in double, so that the
+  small increments of many steps are not lost to rounding.  The float
+  modes are made by rk4_ensemble_create_float(), whose right hand side
+  takes float vectors.
+
+  Double precision steps go through DYDT_CTX and CTX.  DYDT is only set
+  for an ensemble made by rk4_ensemble_create().
+*/
+# define RK4_ENSEMBLE_DOUBLE 0
+# define RK4_ENSEMBLE_FLOAT 1
+# define RK4_ENSEMBLE_MIXED 2
+
+typedef struct
+{
+  void ( *dydt ) ( double t, int nens, int m, int ld, double u[], double f[] );
+  void ( *dydt_ctx ) ( double t, int nens, int m, int ld, double u[],
+    double f[], void *ctx );
+  void *ctx;
+  void ( *dydt_s ) ( double t, int nens, int m, int ld, float u[], float f[] );
+  int precision;
+  int m;
+  int nens;
+  int ld;
+  double t;
+  long int step_num;
+  double *y;
+  double *f0;
+  double *f1;
+  double *f2;
+  double *f3;
+  double *u;
+  double *work;
+  float *ys;
+  float *f0s;
+  float *f1s;
+  float *f2s;
+  float *f3s;
+  float *us;
+} rk4_ensemble;
+
+void rk4_ensemble_advance ( rk4_ensemble *e, double t1, int n );
+rk4_ensemble *rk4_ensemble_create ( void dydt ( double t, int nens, int m,
+  int ld, double u[], double f[] ), int m, int nens, double t0 );
+rk4_ensemble *rk4_ensemble_create_ctx ( void dydt ( double t, int nens,
+  int m, int ld, double u[], double f[], void *ctx ), void *ctx, int m,
+  int nens, double t0 );
+rk4_ensemble *rk4_ensemble_create_float ( void dydt ( double t, int nens,
+  int m, int ld, float u[], float f[] ), int m, int nens, double t0,
+  int precision );
+void rk4_ensemble_destroy ( rk4_ensemble *e );
+void rk4_ensemble_get ( rk4_ensemble *e, int k, double y[] );
+char *rk4_ensemble_isa ( );
+void rk4_ensemble_set ( rk4_ensemble *e, int k, double y0[] );
+void rk4_ensemble_step ( rk4_ensemble *e, double dt );
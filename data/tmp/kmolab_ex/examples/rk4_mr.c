@@ -0,0 +1,371 @@
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_mr.h"
+# include "rk4_stats.h"
+
+static void rk4_mr_slow_at ( rk4_mr *r, double theta, double dt );
+
+/******************************************************************************/
+
+void rk4_mr_advance ( rk4_mr *r, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_mr_advance takes N equal macro steps from the current time to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_mr *R: the integrator.
+
+    double T1: the final time.
+
+    int N: the number of macro steps to take.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  dt = ( t1 - r->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    rk4_mr_step ( r, dt );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+rk4_mr *rk4_mr_create ( void fast ( double t, double yf[], double ys[],
+  double ff[], void *ctx ), void slow ( double t, double yf[], double ys[],
+  double fs[], void *ctx ), void *ctx, int mf, int ms, int sub_num,
+  double t0, double y0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_mr_create creates a multirate RK4 integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void FAST ( double T, double YF[], double YS[], double FF[], void *CTX ),
+    evaluates the derivative of the fast part.
+
+    void SLOW ( double T, double YF[], double YS[], double FS[], void *CTX ),
+    evaluates the derivative of the slow part.
+
+    void *CTX: the context passed to FAST and SLOW.
+
+    int MF, MS: the sizes of the fast and slow parts.
+
+    int SUB_NUM: the number of fast substeps per macro step, at least 1.
+
+    double T0: the initial time.
+
+    double Y0[MF+MS]: the initial condition, fast part first.
+
+  Output:
+
+    rk4_mr *RK4_MR_CREATE: the integrator, or NULL if SUB_NUM < 1 or
+    memory could not be allocated.
+*/
+{
+  int i;
+  int ld;
+  int ldf;
+  int lds;
+  int m;
+  rk4_mr *r;
+
+  if ( sub_num < 1 )
+  {
+    return NULL;
+  }
+
+  r = ( rk4_mr * ) malloc ( sizeof ( rk4_mr ) );
+  if ( r == NULL )
+  {
+    return NULL;
+  }
+
+  m = mf + ms;
+  ld = RK4_ALIGN / sizeof ( double );
+  ldf = ( ( mf + ld - 1 ) / ld ) * ld;
+  lds = ( ( ms + ld - 1 ) / ld ) * ld;
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  r->work = r8vec_aligned_new ( 6 * ld + 5 * ldf + lds );
+  if ( r->work == NULL )
+  {
+    free ( r );
+    return NULL;
+  }
+
+  r->fast = fast;
+  r->slow = slow;
+  r->ctx = ctx;
+  r->mf = mf;
+  r->ms = ms;
+  r->m = m;
+  r->sub_num = sub_num;
+  r->t = t0;
+  r->step_num = 0;
+  r->fast_eval_num = 0;
+  r->slow_eval_num = 0;
+  r->y  = r->work;
+  r->k1 = r->work +     ld;
+  r->k2 = r->work + 2 * ld;
+  r->k3 = r->work + 3 * ld;
+  r->k4 = r->work + 4 * ld;
+  r->u  = r->work + 5 * ld;
+  r->g0 = r->work + 6 * ld;
+  r->g1 = r->work + 6 * ld +     ldf;
+  r->g2 = r->work + 6 * ld + 2 * ldf;
+  r->g3 = r->work + 6 * ld + 3 * ldf;
+  r->v  = r->work + 6 * ld + 4 * ldf;
+  r->w  = r->work + 6 * ld + 5 * ldf;
+  r->yf = r->y;
+  r->ys = r->y + mf;
+
+  for ( i = 0; i < m; i++ )
+  {
+    r->y[i] = y0[i];
+  }
+
+  return r;
+}
+/******************************************************************************/
+
+void rk4_mr_destroy ( rk4_mr *r )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_mr_destroy frees a multirate RK4 integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_mr *R: the integrator.  R may be NULL.
+*/
+{
+  if ( r == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( r->work );
+  free ( r );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_mr_step ( rk4_mr *r, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_mr_step takes one multirate macro step.
+
+  Discussion:
+
+    The macro stages K1 to K4 are kept, so that the slow part can be
+    interpolated at any point of the step.  The slow part of Y is only
+    updated after the fast substeps, which use it as the base of the
+    interpolant.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_mr *R: the integrator.
+
+    double DT: the macro stepsize.
+*/
+{
+  double h;
+  int i;
+  int j;
+  int m;
+  int mf;
+  double t0;
+  double tau;
+  double theta;
+
+  m = r->m;
+  mf = r->mf;
+  t0 = r->t;
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+/*
+  One RK4 step of the whole system.
+*/
+  r->fast ( t0, r->y, r->y + mf, r->k1, r->ctx );
+  r->slow ( t0, r->y, r->y + mf, r->k1 + mf, r->ctx );
+
+  for ( i = 0; i < m; i++ )
+  {
+    r->u[i] = r->y[i] + dt * r->k1[i] / 2.0;
+  }
+  r->fast ( t0 + dt / 2.0, r->u, r->u + mf, r->k2, r->ctx );
+  r->slow ( t0 + dt / 2.0, r->u, r->u + mf, r->k2 + mf, r->ctx );
+
+  for ( i = 0; i < m; i++ )
+  {
+    r->u[i] = r->y[i] + dt * r->k2[i] / 2.0;
+  }
+  r->fast ( t0 + dt / 2.0, r->u, r->u + mf, r->k3, r->ctx );
+  r->slow ( t0 + dt / 2.0, r->u, r->u + mf, r->k3 + mf, r->ctx );
+
+  for ( i = 0; i < m; i++ )
+  {
+    r->u[i] = r->y[i] + dt * r->k3[i];
+  }
+  r->fast ( t0 + dt, r->u, r->u + mf, r->k4, r->ctx );
+  r->slow ( t0 + dt, r->u, r->u + mf, r->k4 + mf, r->ctx );
+/*
+  Redo the fast part with substeps, reading the slow part from the
+  interpolant.  The end of one substep is the start of the next, so
+  the slow part is interpolated only at the substep midpoints.
+*/
+  h = dt / ( double ) ( r->sub_num );
+  rk4_mr_slow_at ( r, 0.0, dt );
+
+  for ( j = 0; j < r->sub_num; j++ )
+  {
+    tau = t0 + j * h;
+    theta = ( double ) j / ( double ) ( r->sub_num );
+
+    r->fast ( tau, r->yf, r->w, r->g0, r->ctx );
+
+    rk4_mr_slow_at ( r, theta + 0.5 / ( double ) ( r->sub_num ), dt );
+    for ( i = 0; i < mf; i++ )
+    {
+      r->v[i] = r->yf[i] + h * r->g0[i] / 2.0;
+    }
+    r->fast ( tau + h / 2.0, r->v, r->w, r->g1, r->ctx );
+
+    for ( i = 0; i < mf; i++ )
+    {
+      r->v[i] = r->yf[i] + h * r->g1[i] / 2.0;
+    }
+    r->fast ( tau + h / 2.0, r->v, r->w, r->g2, r->ctx );
+
+    rk4_mr_slow_at ( r, ( double ) ( j + 1 ) / ( double ) ( r->sub_num ),
+      dt );
+    for ( i = 0; i < mf; i++ )
+    {
+      r->v[i] = r->yf[i] + h * r->g2[i];
+    }
+    r->fast ( tau + h, r->v, r->w, r->g3, r->ctx );
+
+    for ( i = 0; i < mf; i++ )
+    {
+      r->yf[i] = r->yf[i]
+        + h * ( r->g0[i] + 2.0 * r->g1[i] + 2.0 * r->g2[i] + r->g3[i] ) / 6.0;
+    }
+  }
+/*
+  The slow part takes its macro step.
+*/
+  for ( i = mf; i < m; i++ )
+  {
+    r->y[i] = r->y[i]
+      + dt * ( r->k1[i] + 2.0 * r->k2[i] + 2.0 * r->k3[i] + r->k4[i] ) / 6.0;
+  }
+
+  RK4_STATS_TOC ( RK4_PHASE_STEP );
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 8 + 4 * r->sub_num );
+
+  r->t = t0 + dt;
+  r->step_num = r->step_num + 1;
+  r->fast_eval_num = r->fast_eval_num + 4 * ( r->sub_num + 1 );
+  r->slow_eval_num = r->slow_eval_num + 4;
+
+  return;
+}
+/******************************************************************************/
+
+static void rk4_mr_slow_at ( rk4_mr *r, double theta, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_mr_slow_at interpolates the slow part at T + THETA * DT.
+
+  Discussion:
+
+    This is the third order continuous extension of RK4, which needs no
+    evaluations beyond the four stages.  The result is stored in W.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double b1;
+  double b23;
+  double b4;
+  int i;
+  int mf;
+  double t2;
+  double t3;
+
+  mf = r->mf;
+  t2 = theta * theta;
+  t3 = t2 * theta;
+  b1 = theta - 1.5 * t2 + 2.0 * t3 / 3.0;
+  b23 = t2 - 2.0 * t3 / 3.0;
+  b4 = - 0.5 * t2 + 2.0 * t3 / 3.0;
+
+  for ( i = 0; i < r->ms; i++ )
+  {
+    r->w[i] = r->ys[i] + dt * ( b1 * r->k1[mf+i]
+      + b23 * ( r->k2[mf+i] + r->k3[mf+i] ) + b4 * r->k4[mf+i] );
+  }
+
+  return;
+}
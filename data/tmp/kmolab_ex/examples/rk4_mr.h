@@ -0,0 +1,59 @@
+/*
+  rk4_mr is a multirate RK4 integrator for a system with a fast and a
+  slow partition.
+
+  The state Y has the MF fast components first and the MS slow ones
+  after them, YF = Y and YS = Y + MF.  FAST ( T, YF, YS, FF, CTX ) sets
+  the MF derivatives of the fast part, and SLOW ( T, YF, YS, FS, CTX )
+  the MS derivatives of the slow part; each may read both parts.
+
+  A macro step of size DT is a "slowest first" step: one RK4 step of
+  the whole system gives the new slow state, then the fast part is
+  redone with SUB_NUM RK4 substeps of size DT / SUB_NUM, reading the
+  slow part from the cubic dense output of the macro step.  A macro
+  step costs 4 calls of SLOW and 4 * ( SUB_NUM + 1 ) calls of FAST,
+  where single rate RK4 at the small step would make 4 * SUB_NUM of each.
+
+  The macro step must be stable for the coupled system, since the fast
+  part is also advanced by it; the substeps restore the accuracy of
+  the fast part.
+*/
+typedef struct
+{
+  void ( *fast ) ( double t, double yf[], double ys[], double ff[],
+    void *ctx );
+  void ( *slow ) ( double t, double yf[], double ys[], double fs[],
+    void *ctx );
+  void *ctx;
+  int mf;
+  int ms;
+  int m;
+  int sub_num;
+  double t;
+  long int step_num;
+  long int fast_eval_num;
+  long int slow_eval_num;
+  double *y;
+  double *yf;
+  double *ys;
+  double *k1;
+  double *k2;
+  double *k3;
+  double *k4;
+  double *u;
+  double *g0;
+  double *g1;
+  double *g2;
+  double *g3;
+  double *v;
+  double *w;
+  double *work;
+} rk4_mr;
+
+void rk4_mr_advance ( rk4_mr *r, double t1, int n );
+rk4_mr *rk4_mr_create ( void fast ( double t, double yf[], double ys[],
+  double ff[], void *ctx ), void slow ( double t, double yf[], double ys[],
+  double fs[], void *ctx ), void *ctx, int mf, int ms, int sub_num,
+  double t0, double y0[] );
+void rk4_mr_destroy ( rk4_mr *r );
+void rk4_mr_step ( rk4_mr *r, double dt );
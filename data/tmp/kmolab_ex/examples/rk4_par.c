@@ -0,0 +1,385 @@
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_pool.h"
+# include "rk4_par.h"
+# include "rk4_stats.h"
+
+/*
+  rk4_par_job passes the arguments of one call to the pool threads.
+*/
+typedef struct
+{
+  rk4_par *p;
+  double *y0;
+  double dt;
+  int n;
+} rk4_par_job;
+
+static void rk4_par_init_task ( int id, int thread_num, void *arg );
+static void rk4_par_step_task ( int id, int thread_num, void *arg );
+
+/******************************************************************************/
+
+rk4_par *rk4_par_create ( void dydt ( double t, int lo, int hi, double u[],
+  double f[], void *ctx ), void *ctx, int m, double t0, double y0[],
+  rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_par_create creates a parallel RK4 integrator for a large system.
+
+  Discussion:
+
+    The workspace is five vectors of length M.  It is allocated here but
+    first written by the pool threads, each on its own block.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, int LO, int HI, double U[], double F[],
+    void *CTX ), evaluates entries LO to HI-1 of the right hand side.
+
+    void *CTX: the context passed to DYDT.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition, or NULL for zero.
+
+    rk4_pool *POOL: the threads to use, or NULL for the calling thread.
+
+  Output:
+
+    rk4_par *RK4_PAR_CREATE: the integrator, or NULL if memory could not
+    be allocated.
+*/
+{
+  int block;
+  int block_num;
+  int id;
+  int ld;
+  rk4_par_job job;
+  rk4_par *p;
+
+  p = ( rk4_par * ) malloc ( sizeof ( rk4_par ) );
+  if ( p == NULL )
+  {
+    return NULL;
+  }
+
+  p->thread_num = rk4_pool_size ( pool );
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  p->lo = ( int * ) malloc ( ( p->thread_num + 1 ) * sizeof ( int ) );
+  p->work = r8vec_aligned_new ( 5 * ld );
+  if ( p->lo == NULL || p->work == NULL )
+  {
+    free ( p->lo );
+    r8vec_aligned_free ( p->work );
+    free ( p );
+    return NULL;
+  }
+/*
+  Split the M entries into whole cache lines, as evenly as possible,
+  so that no two threads write the same line.
+*/
+  block = RK4_ALIGN / sizeof ( double );
+  block_num = ld / block;
+  for ( id = 0; id <= p->thread_num; id++ )
+  {
+    p->lo[id] = ( int ) ( ( ( long int ) block_num * id ) / p->thread_num )
+      * block;
+    if ( m < p->lo[id] )
+    {
+      p->lo[id] = m;
+    }
+  }
+
+  p->dydt = dydt;
+  p->ctx = ctx;
+  p->m = m;
+  p->pool = pool;
+  p->t = t0;
+  p->step_num = 0;
+  p->y   = p->work;
+  p->acc = p->work +     ld;
+  p->k   = p->work + 2 * ld;
+  p->ua  = p->work + 3 * ld;
+  p->ub  = p->work + 4 * ld;
+
+  job.p = p;
+  job.y0 = y0;
+  rk4_pool_run ( pool, rk4_par_init_task, &job );
+
+  return p;
+}
+/******************************************************************************/
+
+void rk4_par_destroy ( rk4_par *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_par_destroy frees a parallel RK4 integrator.
+
+  Discussion:
+
+    The pool belongs to the caller and is not destroyed.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_par *P: the integrator.  P may be NULL.
+*/
+{
+  if ( p == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( p->work );
+  free ( p->lo );
+  free ( p );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_par_step ( rk4_par *p, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_par_step takes one parallel RK4 step.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_par *P: the integrator.
+
+    double DT: the stepsize.
+*/
+{
+  rk4_par_job job;
+
+  job.p = p;
+  job.dt = dt;
+  job.n = 1;
+  rk4_pool_run ( p->pool, rk4_par_step_task, &job );
+
+  p->t = p->t + dt;
+  p->step_num = p->step_num + 1;
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 4 );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_par_advance ( rk4_par *p, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_par_advance takes N equal parallel RK4 steps to T1.
+
+  Discussion:
+
+    All N steps run inside one pool task, with a barrier after each
+    stage, so the threads are started only once.  The results are
+    identical to those of rk4() with the same steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_par *P: the integrator.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+*/
+{
+  int j;
+  rk4_par_job job;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  job.p = p;
+  job.dt = ( t1 - p->t ) / ( double ) ( n );
+  job.n = n;
+  rk4_pool_run ( p->pool, rk4_par_step_task, &job );
+
+  for ( j = 0; j < n; j++ )
+  {
+    p->t = p->t + job.dt;
+  }
+  p->step_num = p->step_num + n;
+  RK4_STATS_ADD ( RK4_COUNT_STEP, n );
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 4 * n );
+
+  return;
+}
+/******************************************************************************/
+
+static void rk4_par_init_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_par_init_task first touches one thread's block of the workspace.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int hi;
+  int i;
+  rk4_par_job *job;
+  int lo;
+  rk4_par *p;
+
+  job = ( rk4_par_job * ) arg;
+  p = job->p;
+  lo = p->lo[id];
+  hi = p->lo[id+1];
+
+  for ( i = lo; i < hi; i++ )
+  {
+    p->y[i] = ( job->y0 == NULL ) ? 0.0 : job->y0[i];
+    p->acc[i] = 0.0;
+    p->k[i] = 0.0;
+    p->ua[i] = 0.0;
+    p->ub[i] = 0.0;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void rk4_par_step_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_par_step_task takes N RK4 steps on one thread's block.
+
+  Discussion:
+
+    Each stage evaluates this thread's part of K, then makes one fused
+    pass that adds K into the accumulator and forms the next stage
+    input.  Stage inputs alternate between UA and UB, because other
+    threads may still be reading the old input while this thread writes
+    the new one; the barrier then orders the stages.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double dt;
+  int hi;
+  int i;
+  int j;
+  rk4_par_job *job;
+  int lo;
+  rk4_par *p;
+  double t;
+
+  job = ( rk4_par_job * ) arg;
+  p = job->p;
+  dt = job->dt;
+  lo = p->lo[id];
+  hi = p->lo[id+1];
+  t = p->t;
+
+  for ( j = 0; j < job->n; j++ )
+  {
+    RK4_STATS_TIC ( RK4_PHASE_STEP );
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    p->dydt ( t, lo, hi, p->y, p->k, p->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+    for ( i = lo; i < hi; i++ )
+    {
+      p->acc[i] = p->k[i];
+      p->ua[i] = p->y[i] + dt * p->k[i] / 2.0;
+    }
+    rk4_pool_barrier ( p->pool );
+
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    p->dydt ( t + dt / 2.0, lo, hi, p->ua, p->k, p->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+    for ( i = lo; i < hi; i++ )
+    {
+      p->acc[i] = p->acc[i] + 2.0 * p->k[i];
+      p->ub[i] = p->y[i] + dt * p->k[i] / 2.0;
+    }
+    rk4_pool_barrier ( p->pool );
+
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    p->dydt ( t + dt / 2.0, lo, hi, p->ub, p->k, p->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+    for ( i = lo; i < hi; i++ )
+    {
+      p->acc[i] = p->acc[i] + 2.0 * p->k[i];
+      p->ua[i] = p->y[i] + dt * p->k[i];
+    }
+    rk4_pool_barrier ( p->pool );
+
+    RK4_STATS_TIC ( RK4_PHASE_RHS );
+    p->dydt ( t + dt, lo, hi, p->ua, p->k, p->ctx );
+    RK4_STATS_TOC ( RK4_PHASE_RHS );
+    for ( i = lo; i < hi; i++ )
+    {
+      p->y[i] = p->y[i] + dt * ( p->acc[i] + p->k[i] ) / 6.0;
+    }
+    rk4_pool_barrier ( p->pool );
+    RK4_STATS_TOC ( RK4_PHASE_STEP );
+
+    t = t + dt;
+  }
+
+  return;
+}
@@ -0,0 +1,37 @@
+/*
+  rk4_par advances one very large ODE system with RK4 on a thread pool.
+
+  The state is split into one contiguous block per thread, with block
+  boundaries on RK4_ALIGN byte lines.  Thread ID owns entries
+  LO[ID] <= I < LO[ID+1] of every vector: it first touches them, so on a
+  pinned pool they live on its NUMA node, it evaluates that part of the
+  right hand side, and it does the stage arithmetic for them.
+
+  DYDT ( T, LO, HI, U, F, CTX ) must set F[LO:HI-1].  It may read any
+  entry of U, for instance the neighbours of a stencil.
+*/
+typedef struct
+{
+  void ( *dydt ) ( double t, int lo, int hi, double u[], double f[],
+    void *ctx );
+  void *ctx;
+  int m;
+  rk4_pool *pool;
+  int thread_num;
+  int *lo;
+  double t;
+  long int step_num;
+  double *y;
+  double *acc;
+  double *k;
+  double *ua;
+  double *ub;
+  double *work;
+} rk4_par;
+
+void rk4_par_advance ( rk4_par *p, double t1, int n );
+rk4_par *rk4_par_create ( void dydt ( double t, int lo, int hi, double u[],
+  double f[], void *ctx ), void *ctx, int m, double t0, double y0[],
+  rk4_pool *pool );
+void rk4_par_destroy ( rk4_par *p );
+void rk4_par_step ( rk4_par *p, double dt );
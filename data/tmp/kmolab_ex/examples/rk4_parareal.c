@@ -0,0 +1,255 @@
+# include <math.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_pool.h"
+# include "rk4_parareal.h"
+
+/*
+  rk4_parareal_job describes one parallel fine sweep.  Thread ID
+  propagates slices FIRST + ID, FIRST + ID + THREAD_NUM, ... from U with
+  its own stepper S[ID], and writes the results to its own rows of F.
+*/
+typedef struct
+{
+  rk4_stepper **s;
+  double *tb;
+  double *u;
+  double *f;
+  int first;
+  int slice_num;
+  int fine_n;
+  int m;
+} rk4_parareal_job;
+
+static void rk4_parareal_task ( int id, int thread_num, void *arg );
+
+/******************************************************************************/
+
+int rk4_parareal ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, double tspan[2], double y0[], int m, int slice_num,
+  int coarse_n, int fine_n, double tol, int iter_max, rk4_pool *pool,
+  double y[], int *iter_num )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_parareal solves an ODE by the Parareal parallel in time method.
+
+  Discussion:
+
+    TSPAN is cut into SLICE_NUM equal slices.  The coarse propagator G
+    is RK4 with COARSE_N steps per slice, and the fine propagator F is
+    RK4 with FINE_N steps per slice.  After a serial coarse sweep, each
+    iteration propagates every slice with F in parallel, then corrects
+    the slice boundary values serially:
+
+      U(n+1) = G ( U(n) ) + F ( Uold(n) ) - G ( Uold(n) ).
+
+    After iteration K the first K slices agree with the serial fine
+    solution, so at most SLICE_NUM iterations are needed, and slices
+    that have converged are not propagated again.  With P threads and
+    K iterations the speedup over serial RK4 with SLICE_NUM * FINE_N
+    steps is at most about SLICE_NUM / K, when P >= SLICE_NUM and G is
+    much cheaper than F.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side of the problem.
+
+    void *CTX: the context passed to DYDT.  DYDT is called from several
+    threads at once, so it must not modify CTX.
+
+    double TSPAN[2]: the initial and final times.
+
+    double Y0[M]: the initial condition.
+
+    int M: the number of variables.
+
+    int SLICE_NUM: the number of time slices.
+
+    int COARSE_N, FINE_N: the number of coarse and fine steps per slice.
+
+    double TOL: the iteration stops when no boundary value changes by
+    more than TOL * ( 1 + |U| ).
+
+    int ITER_MAX: the maximum number of iterations.
+
+    rk4_pool *POOL: the threads to use.  If POOL is NULL, the fine
+    propagators run in the calling thread.
+
+  Output:
+
+    double Y[(SLICE_NUM+1)*M]: the solution at the slice boundaries,
+    with Y[I+N*M] holding component I at TSPAN[0] + N * H, where H is
+    the slice length.
+
+    int *ITER_NUM: the number of iterations taken.
+
+    int RK4_PARAREAL: 0 if the iteration converged, 1 if it did not
+    converge in ITER_MAX iterations, or 2 if memory could not be
+    allocated.
+*/
+{
+  double change;
+  double *g;
+  int i;
+  int id;
+  int iter;
+  rk4_parareal_job job;
+  int n;
+  rk4_stepper *sc;
+  int status;
+  int thread_num;
+  double unew;
+
+  thread_num = rk4_pool_size ( pool );
+  *iter_num = 0;
+
+  job.s = ( rk4_stepper ** ) calloc ( thread_num, sizeof ( rk4_stepper * ) );
+  job.tb = ( double * ) malloc ( ( slice_num + 1 ) * sizeof ( double ) );
+  job.f = ( double * ) malloc ( slice_num * m * sizeof ( double ) );
+  g = ( double * ) malloc ( slice_num * m * sizeof ( double ) );
+  sc = rk4_stepper_create_ctx ( dydt, ctx, m, tspan[0], y0 );
+
+  status = ( job.s == NULL || job.tb == NULL || job.f == NULL || g == NULL
+    || sc == NULL ) ? 2 : 0;
+  for ( id = 0; id < thread_num && status == 0; id++ )
+  {
+    job.s[id] = rk4_stepper_create_ctx ( dydt, ctx, m, tspan[0], y0 );
+    if ( job.s[id] == NULL )
+    {
+      status = 2;
+    }
+  }
+
+  if ( status == 0 )
+  {
+    for ( n = 0; n <= slice_num; n++ )
+    {
+      job.tb[n] = tspan[0] + ( tspan[1] - tspan[0] ) * n / slice_num;
+    }
+    job.u = y;
+    job.slice_num = slice_num;
+    job.fine_n = fine_n;
+    job.m = m;
+/*
+  The serial coarse sweep gives the first guess.
+*/
+    for ( i = 0; i < m; i++ )
+    {
+      y[i] = y0[i];
+    }
+    for ( n = 0; n < slice_num; n++ )
+    {
+      rk4_stepper_reset ( sc, job.tb[n], y + n * m );
+      rk4_stepper_advance ( sc, job.tb[n+1], coarse_n );
+      for ( i = 0; i < m; i++ )
+      {
+        g[i+n*m] = sc->y[i];
+        y[i+(n+1)*m] = sc->y[i];
+      }
+    }
+
+    status = 1;
+    for ( iter = 0; iter < iter_max && iter < slice_num; iter++ )
+    {
+      job.first = iter;
+      rk4_pool_run ( pool, rk4_parareal_task, &job );
+/*
+  Slice ITER starts from an exact value, so its fine result is final.
+*/
+      change = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        change = fmax ( change, fabs ( job.f[i+iter*m] - y[i+(iter+1)*m] )
+          / ( 1.0 + fabs ( job.f[i+iter*m] ) ) );
+        y[i+(iter+1)*m] = job.f[i+iter*m];
+      }
+      for ( n = iter + 1; n < slice_num; n++ )
+      {
+        rk4_stepper_reset ( sc, job.tb[n], y + n * m );
+        rk4_stepper_advance ( sc, job.tb[n+1], coarse_n );
+        for ( i = 0; i < m; i++ )
+        {
+          unew = sc->y[i] + job.f[i+n*m] - g[i+n*m];
+          change = fmax ( change, fabs ( unew - y[i+(n+1)*m] )
+            / ( 1.0 + fabs ( unew ) ) );
+          g[i+n*m] = sc->y[i];
+          y[i+(n+1)*m] = unew;
+        }
+      }
+
+      *iter_num = iter + 1;
+      if ( change <= tol )
+      {
+        status = 0;
+        break;
+      }
+    }
+    if ( *iter_num == slice_num )
+    {
+      status = 0;
+    }
+  }
+
+  if ( job.s != NULL )
+  {
+    for ( id = 0; id < thread_num; id++ )
+    {
+      rk4_stepper_destroy ( job.s[id] );
+    }
+  }
+  rk4_stepper_destroy ( sc );
+  free ( job.s );
+  free ( job.tb );
+  free ( job.f );
+  free ( g );
+
+  return status;
+}
+/******************************************************************************/
+
+static void rk4_parareal_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_parareal_task applies the fine propagator to one thread's slices.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  rk4_parareal_job *job;
+  int n;
+  rk4_stepper *s;
+
+  job = ( rk4_parareal_job * ) arg;
+  s = job->s[id];
+
+  for ( n = job->first + id; n < job->slice_num; n = n + thread_num )
+  {
+    rk4_stepper_reset ( s, job->tb[n], job->u + n * job->m );
+    rk4_stepper_advance ( s, job->tb[n+1], job->fine_n );
+    for ( i = 0; i < job->m; i++ )
+    {
+      job->f[i+n*job->m] = s->y[i];
+    }
+  }
+
+  return;
+}
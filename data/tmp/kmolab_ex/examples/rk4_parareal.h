@@ -0,0 +1,4 @@
+int rk4_parareal ( void dydt ( double t, double u[], double f[], void *ctx ),
+  void *ctx, double tspan[2], double y0[], int m, int slice_num,
+  int coarse_n, int fine_n, double tol, int iter_max, rk4_pool *pool,
+  double y[], int *iter_num );
@@ -0,0 +1,443 @@
+# ifdef __linux__
+# define _GNU_SOURCE
+# include <sched.h>
+# endif
+
+# include <pthread.h>
+# include <stdlib.h>
+# include <unistd.h>
+
+# include "rk4_pool.h"
+
+struct rk4_pool
+{
+  int thread_num;
+  pthread_t *thread;
+  struct rk4_pool_worker *worker;
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  pthread_cond_t barrier;
+  long int generation;
+  long int barrier_generation;
+  int barrier_count;
+  int busy;
+  int quit;
+  void ( *task ) ( int id, int thread_num, void *arg );
+  void *arg;
+};
+
+struct rk4_pool_worker
+{
+  rk4_pool *pool;
+  int id;
+};
+
+static void *rk4_pool_main ( void *data );
+static void rk4_pool_pin_task ( int id, int thread_num, void *arg );
+
+/******************************************************************************/
+
+void rk4_pool_barrier ( rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_barrier waits until every thread of a pool has reached it.
+
+  Discussion:
+
+    It may only be called from inside a task run by rk4_pool_run(), and
+    then by every thread the same number of times.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_pool *POOL: the pool.  POOL may be NULL.
+*/
+{
+  long int generation;
+
+  if ( pool == NULL || pool->thread_num == 1 )
+  {
+    return;
+  }
+
+  pthread_mutex_lock ( &pool->lock );
+  generation = pool->barrier_generation;
+  pool->barrier_count = pool->barrier_count + 1;
+  if ( pool->barrier_count == pool->thread_num )
+  {
+    pool->barrier_count = 0;
+    pool->barrier_generation = generation + 1;
+    pthread_cond_broadcast ( &pool->barrier );
+  }
+  else
+  {
+    while ( pool->barrier_generation == generation )
+    {
+      pthread_cond_wait ( &pool->barrier, &pool->lock );
+    }
+  }
+  pthread_mutex_unlock ( &pool->lock );
+
+  return;
+}
+/******************************************************************************/
+
+rk4_pool *rk4_pool_create ( int thread_num )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_create starts a pool of threads.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int THREAD_NUM: the number of threads, counting the caller.  If
+    THREAD_NUM <= 0, one thread per online processor is used.
+
+  Output:
+
+    rk4_pool *RK4_POOL_CREATE: the pool, or NULL on failure.
+*/
+{
+  int id;
+  rk4_pool *pool;
+
+  if ( thread_num <= 0 )
+  {
+# ifdef _SC_NPROCESSORS_ONLN
+    thread_num = ( int ) sysconf ( _SC_NPROCESSORS_ONLN );
+# endif
+    if ( thread_num <= 0 )
+    {
+      thread_num = 1;
+    }
+  }
+
+  pool = ( rk4_pool * ) malloc ( sizeof ( rk4_pool ) );
+  if ( pool == NULL )
+  {
+    return NULL;
+  }
+
+  pool->thread_num = thread_num;
+  pool->thread = ( pthread_t * ) malloc ( thread_num * sizeof ( pthread_t ) );
+  pool->worker = ( struct rk4_pool_worker * )
+    malloc ( thread_num * sizeof ( struct rk4_pool_worker ) );
+  pool->generation = 0;
+  pool->barrier_generation = 0;
+  pool->barrier_count = 0;
+  pool->busy = 0;
+  pool->quit = 0;
+  pool->task = NULL;
+  pool->arg = NULL;
+
+  if ( pool->thread == NULL || pool->worker == NULL )
+  {
+    free ( pool->thread );
+    free ( pool->worker );
+    free ( pool );
+    return NULL;
+  }
+
+  pthread_mutex_init ( &pool->lock, NULL );
+  pthread_cond_init ( &pool->start, NULL );
+  pthread_cond_init ( &pool->done, NULL );
+  pthread_cond_init ( &pool->barrier, NULL );
+
+  for ( id = 1; id < thread_num; id++ )
+  {
+    pool->worker[id].pool = pool;
+    pool->worker[id].id = id;
+    if ( pthread_create ( pool->thread + id, NULL, rk4_pool_main,
+      pool->worker + id ) != 0 )
+    {
+/*
+  Run with the threads that did start.
+*/
+      pool->thread_num = id;
+      break;
+    }
+  }
+
+  return pool;
+}
+/******************************************************************************/
+
+void rk4_pool_destroy ( rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_destroy stops the threads of a pool and frees it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_pool *POOL: the pool.  POOL may be NULL.
+*/
+{
+  int id;
+
+  if ( pool == NULL )
+  {
+    return;
+  }
+
+  pthread_mutex_lock ( &pool->lock );
+  pool->quit = 1;
+  pthread_cond_broadcast ( &pool->start );
+  pthread_mutex_unlock ( &pool->lock );
+
+  for ( id = 1; id < pool->thread_num; id++ )
+  {
+    pthread_join ( pool->thread[id], NULL );
+  }
+
+  pthread_cond_destroy ( &pool->barrier );
+  pthread_cond_destroy ( &pool->done );
+  pthread_cond_destroy ( &pool->start );
+  pthread_mutex_destroy ( &pool->lock );
+  free ( pool->thread );
+  free ( pool->worker );
+  free ( pool );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_pool_pin ( rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_pin binds thread ID of a pool to processor ID.
+
+  Discussion:
+
+    With pinned threads, memory first written by a thread stays on that
+    thread's NUMA node.  The calling thread is pinned too, as thread 0.
+    This does nothing except on Linux.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_pool *POOL: the pool.
+*/
+{
+  rk4_pool_run ( pool, rk4_pool_pin_task, NULL );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_pool_run ( rk4_pool *pool, void task ( int id, int thread_num,
+  void *arg ), void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_run runs a task on every thread of a pool and waits for it.
+
+  Discussion:
+
+    If POOL is NULL, TASK ( 0, 1, ARG ) is called in the calling thread.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_pool *POOL: the pool.
+
+    void TASK ( int ID, int THREAD_NUM, void *ARG ): the task.
+
+    void *ARG: the argument passed to every call of TASK.
+*/
+{
+  if ( pool == NULL || pool->thread_num == 1 )
+  {
+    task ( 0, 1, arg );
+    return;
+  }
+
+  pthread_mutex_lock ( &pool->lock );
+  pool->task = task;
+  pool->arg = arg;
+  pool->busy = pool->thread_num - 1;
+  pool->generation = pool->generation + 1;
+  pthread_cond_broadcast ( &pool->start );
+  pthread_mutex_unlock ( &pool->lock );
+
+  task ( 0, pool->thread_num, arg );
+
+  pthread_mutex_lock ( &pool->lock );
+  while ( 0 < pool->busy )
+  {
+    pthread_cond_wait ( &pool->done, &pool->lock );
+  }
+  pthread_mutex_unlock ( &pool->lock );
+
+  return;
+}
+/******************************************************************************/
+
+int rk4_pool_size ( rk4_pool *pool )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_size returns the number of threads in a pool.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_pool *POOL: the pool.  POOL may be NULL.
+
+  Output:
+
+    int RK4_POOL_SIZE: the number of threads, counting the caller.
+*/
+{
+  if ( pool == NULL )
+  {
+    return 1;
+  }
+
+  return pool->thread_num;
+}
+/******************************************************************************/
+
+static void *rk4_pool_main ( void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_main is the loop run by each worker thread.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  void *arg;
+  long int generation;
+  rk4_pool *pool;
+  struct rk4_pool_worker *worker;
+  void ( *task ) ( int id, int thread_num, void *arg );
+
+  worker = ( struct rk4_pool_worker * ) data;
+  pool = worker->pool;
+  generation = 0;
+
+  for ( ; ; )
+  {
+    pthread_mutex_lock ( &pool->lock );
+    while ( pool->generation == generation && !pool->quit )
+    {
+      pthread_cond_wait ( &pool->start, &pool->lock );
+    }
+    if ( pool->quit )
+    {
+      pthread_mutex_unlock ( &pool->lock );
+      break;
+    }
+    generation = pool->generation;
+    task = pool->task;
+    arg = pool->arg;
+    pthread_mutex_unlock ( &pool->lock );
+
+    task ( worker->id, pool->thread_num, arg );
+
+    pthread_mutex_lock ( &pool->lock );
+    pool->busy = pool->busy - 1;
+    if ( pool->busy == 0 )
+    {
+      pthread_cond_signal ( &pool->done );
+    }
+    pthread_mutex_unlock ( &pool->lock );
+  }
+
+  return NULL;
+}
+/******************************************************************************/
+
+static void rk4_pool_pin_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_pool_pin_task binds the calling thread to processor ID.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+# ifdef __linux__
+  cpu_set_t set;
+  long int cpu_num;
+
+  cpu_num = sysconf ( _SC_NPROCESSORS_ONLN );
+  if ( cpu_num <= 0 )
+  {
+    return;
+  }
+  CPU_ZERO ( &set );
+  CPU_SET ( id % cpu_num, &set );
+  sched_setaffinity ( 0, sizeof ( set ), &set );
+# endif
+
+  return;
+}
@@ -0,0 +1,17 @@
+/*
+  rk4_pool is a fixed set of threads that run one task at a time.
+
+  rk4_pool_run() calls TASK ( ID, THREAD_NUM, ARG ) once on every thread,
+  with ID = 0, ..., THREAD_NUM-1, and returns when all calls are done.
+  The calling thread runs ID 0, so a pool of one thread has no workers.
+  Inside a task, rk4_pool_barrier() waits until every thread reaches it.
+*/
+typedef struct rk4_pool rk4_pool;
+
+void rk4_pool_barrier ( rk4_pool *pool );
+rk4_pool *rk4_pool_create ( int thread_num );
+void rk4_pool_destroy ( rk4_pool *pool );
+void rk4_pool_pin ( rk4_pool *pool );
+void rk4_pool_run ( rk4_pool *pool, void task ( int id, int thread_num,
+  void *arg ), void *arg );
+int rk4_pool_size ( rk4_pool *pool );
@@ -0,0 +1,302 @@
+# include <math.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_sens.h"
+
+static void rk4_sens_deriv ( double t, double u[], double f[], void *ctx );
+
+/******************************************************************************/
+
+void rk4_sens_advance ( rk4_sens *sn, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sens_advance takes N equal steps of the augmented system to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_sens *SN: the sensitivity integrator.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+*/
+{
+  rk4_stepper_advance ( sn->stepper, t1, n );
+  sn->t = sn->stepper->t;
+
+  return;
+}
+/******************************************************************************/
+
+rk4_sens *rk4_sens_create ( void dydt ( double t, double y[], double f[],
+  void *p ), void jvp ( double t, double y[], double p[], int np,
+  double s[], double ds[] ), double p[], int np, int m, double t0,
+  double y0[], double s0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sens_create creates an RK4 integrator for a state and its
+    parameter sensitivities.
+
+  Discussion:
+
+    The augmented system is advanced by an ordinary RK4 stepper, so Y
+    is the same, bit for bit, as rk4_ctx() gives with CTX = P.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double Y[], double F[], void *P ), evaluates
+    the right hand side for the parameters P.
+
+    void JVP ( double T, double Y[], double P[], int NP, double S[],
+    double DS[] ), sets DS[I+J*M] to the right hand side of the
+    variational equation for column J of S.  JVP may be NULL.
+
+    double P[NP]: the parameters.  They are not copied.
+
+    int NP: the number of parameters.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    double S0[M*NP]: the initial sensitivities, or NULL for zero, when
+    Y0 does not depend on P.
+
+  Output:
+
+    rk4_sens *RK4_SENS_CREATE: the integrator, or NULL if memory could
+    not be allocated.
+*/
+{
+  int i;
+  rk4_sens *sn;
+
+  sn = ( rk4_sens * ) malloc ( sizeof ( rk4_sens ) );
+  if ( sn == NULL )
+  {
+    return NULL;
+  }
+
+  sn->pw = ( double * ) malloc ( ( np + 2 * m ) * sizeof ( double ) );
+  sn->stepper = rk4_stepper_create_ctx ( rk4_sens_deriv, sn, m * ( 1 + np ),
+    t0, NULL );
+  if ( sn->pw == NULL || sn->stepper == NULL )
+  {
+    free ( sn->pw );
+    rk4_stepper_destroy ( sn->stepper );
+    free ( sn );
+    return NULL;
+  }
+
+  sn->dydt = dydt;
+  sn->jvp = jvp;
+  sn->p = p;
+  sn->m = m;
+  sn->np = np;
+  sn->t = t0;
+  sn->y = sn->stepper->y;
+  sn->s = sn->stepper->y + m;
+  sn->uw = sn->pw + np;
+  sn->fw = sn->pw + np + m;
+
+  for ( i = 0; i < m; i++ )
+  {
+    sn->y[i] = y0[i];
+  }
+  for ( i = 0; i < m * np; i++ )
+  {
+    sn->s[i] = ( s0 == NULL ) ? 0.0 : s0[i];
+  }
+
+  return sn;
+}
+/******************************************************************************/
+
+void rk4_sens_destroy ( rk4_sens *sn )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sens_destroy frees a sensitivity integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_sens *SN: the integrator.  SN may be NULL.
+*/
+{
+  if ( sn == NULL )
+  {
+    return;
+  }
+  rk4_stepper_destroy ( sn->stepper );
+  free ( sn->pw );
+  free ( sn );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_sens_step ( rk4_sens *sn, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sens_step takes one RK4 step of the augmented system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_sens *SN: the sensitivity integrator.
+
+    double DT: the stepsize.
+*/
+{
+  rk4_stepper_step ( sn->stepper, dt );
+  sn->t = sn->stepper->t;
+
+  return;
+}
+/******************************************************************************/
+
+static void rk4_sens_deriv ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sens_deriv evaluates the right hand side of the augmented system.
+
+  Discussion:
+
+    Without a JVP, column J is found by central differences,
+
+      ( F ( Y + E1 * S_J, P ) - F ( Y - E1 * S_J, P ) ) / ( 2 E1 )
+    + ( F ( Y, P + E2 * e_J ) - F ( Y, P - E2 * e_J ) ) / ( 2 E2 ),
+
+    with E1 and E2 scaled to the sizes of Y and S_J, and of P_J.  This
+    costs four evaluations of DYDT per column.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double e1;
+  double e2;
+  int i;
+  int j;
+  int k;
+  int m;
+  double snorm;
+  rk4_sens *sn;
+  double *sj;
+  double ynorm;
+
+  sn = ( rk4_sens * ) ctx;
+  m = sn->m;
+
+  sn->dydt ( t, u, f, sn->p );
+
+  if ( sn->jvp != NULL )
+  {
+    sn->jvp ( t, u, sn->p, sn->np, u + m, f + m );
+    return;
+  }
+
+  ynorm = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    ynorm = fmax ( ynorm, fabs ( u[i] ) );
+  }
+  for ( j = 0; j < sn->np; j++ )
+  {
+    sn->pw[j] = sn->p[j];
+  }
+
+  for ( j = 0; j < sn->np; j++ )
+  {
+    sj = u + m + j * m;
+    for ( i = 0; i < m; i++ )
+    {
+      f[i+m+j*m] = 0.0;
+    }
+
+    snorm = 0.0;
+    for ( i = 0; i < m; i++ )
+    {
+      snorm = fmax ( snorm, fabs ( sj[i] ) );
+    }
+    if ( 0.0 < snorm )
+    {
+      e1 = 6.055454452393343E-06 * ( 1.0 + ynorm ) / snorm;
+      for ( k = -1; k <= 1; k = k + 2 )
+      {
+        for ( i = 0; i < m; i++ )
+        {
+          sn->uw[i] = u[i] + k * e1 * sj[i];
+        }
+        sn->dydt ( t, sn->uw, sn->fw, sn->p );
+        for ( i = 0; i < m; i++ )
+        {
+          f[i+m+j*m] = f[i+m+j*m] + k * sn->fw[i] / ( 2.0 * e1 );
+        }
+      }
+    }
+
+    e2 = 6.055454452393343E-06 * fmax ( 1.0E-03, fabs ( sn->p[j] ) );
+    for ( k = -1; k <= 1; k = k + 2 )
+    {
+      sn->pw[j] = sn->p[j] + k * e2;
+      sn->dydt ( t, u, sn->fw, sn->pw );
+      for ( i = 0; i < m; i++ )
+      {
+        f[i+m+j*m] = f[i+m+j*m] + k * sn->fw[i] / ( 2.0 * e2 );
+      }
+    }
+    sn->pw[j] = sn->p[j];
+  }
+
+  return;
+}
@@ -0,0 +1,40 @@
+/*
+  rk4_sens integrates an ODE dY/dT = F ( T, Y, P ) together with the
+  sensitivities S = dY/dP with respect to its NP parameters P.
+
+  The augmented state is Y followed by the NP columns of S, all stored
+  contiguously, so that column J is S[0:M-1] + J * M and the RK4 stage
+  updates run over all M * ( 1 + NP ) entries in one loop.
+
+  Column J satisfies the variational equation
+
+    dS_J/dT = dF/dY ( T, Y, P ) * S_J + dF/dP_J ( T, Y, P ).
+
+  JVP ( T, Y, P, NP, S, DS ) evaluates the right hand sides for all
+  columns at once.  If it is not given, each column is found from four
+  extra evaluations of DYDT, by central differences along S_J and P_J.
+*/
+typedef struct
+{
+  void ( *dydt ) ( double t, double y[], double f[], void *p );
+  void ( *jvp ) ( double t, double y[], double p[], int np, double s[],
+    double ds[] );
+  double *p;
+  int m;
+  int np;
+  rk4_stepper *stepper;
+  double t;
+  double *y;
+  double *s;
+  double *pw;
+  double *uw;
+  double *fw;
+} rk4_sens;
+
+void rk4_sens_advance ( rk4_sens *sn, double t1, int n );
+rk4_sens *rk4_sens_create ( void dydt ( double t, double y[], double f[],
+  void *p ), void jvp ( double t, double y[], double p[], int np,
+  double s[], double ds[] ), double p[], int np, int m, double t0,
+  double y0[], double s0[] );
+void rk4_sens_destroy ( rk4_sens *sn );
+void rk4_sens_step ( rk4_sens *sn, double dt );
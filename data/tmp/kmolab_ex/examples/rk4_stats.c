@@ -0,0 +1,279 @@
+# include <stdio.h>
+# include <string.h>
+# include <time.h>
+
+# if defined ( RK4_STATS_TSC ) && ( defined ( __x86_64__ ) || defined ( __i386__ ) )
+# include <pthread.h>
+# include <x86intrin.h>
+# define RK4_STATS_USE_TSC
+# endif
+
+# include "rk4_stats.h"
+
+# ifdef RK4_STATS
+
+unsigned long long int rk4_stats_count[RK4_COUNT_NUM];
+unsigned long long int rk4_stats_tick[RK4_PHASE_NUM];
+_Thread_local unsigned long long int rk4_stats_start[RK4_PHASE_NUM];
+
+static double rk4_stats_seconds ( unsigned long long int tick );
+
+# ifdef RK4_STATS_USE_TSC
+static pthread_once_t rk4_stats_once = PTHREAD_ONCE_INIT;
+static double rk4_stats_rate = 1.0E+09;
+static void rk4_stats_calibrate ( );
+# endif
+
+# endif
+
+/******************************************************************************/
+
+void rk4_stats_get ( rk4_stats *st )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stats_get returns the current counts and times.
+
+  Discussion:
+
+    The counters are read one at a time while other threads may still
+    be updating them, so a snapshot taken during a parallel run is only
+    approximately consistent.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    rk4_stats *ST: the statistics.  If the library was built without
+    RK4_STATS, ST->ENABLED is 0 and everything else is zero.
+*/
+{
+  memset ( st, 0, sizeof ( rk4_stats ) );
+
+# ifdef RK4_STATS
+  st->enabled = 1;
+  st->step_num = ( long long int ) __atomic_load_n (
+    &rk4_stats_count[RK4_COUNT_STEP], __ATOMIC_RELAXED );
+  st->eval_num = ( long long int ) __atomic_load_n (
+    &rk4_stats_count[RK4_COUNT_EVAL], __ATOMIC_RELAXED );
+  st->reject_num = ( long long int ) __atomic_load_n (
+    &rk4_stats_count[RK4_COUNT_REJECT], __ATOMIC_RELAXED );
+  st->byte_num = ( long long int ) __atomic_load_n (
+    &rk4_stats_count[RK4_COUNT_BYTE], __ATOMIC_RELAXED );
+  st->step_time = rk4_stats_seconds ( __atomic_load_n (
+    &rk4_stats_tick[RK4_PHASE_STEP], __ATOMIC_RELAXED ) );
+  st->rhs_time = rk4_stats_seconds ( __atomic_load_n (
+    &rk4_stats_tick[RK4_PHASE_RHS], __ATOMIC_RELAXED ) );
+  st->output_time = rk4_stats_seconds ( __atomic_load_n (
+    &rk4_stats_tick[RK4_PHASE_OUTPUT], __ATOMIC_RELAXED ) );
+  st->stage_time = st->step_time - st->rhs_time;
+  if ( st->stage_time < 0.0 )
+  {
+    st->stage_time = 0.0;
+  }
+# endif
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_stats_json ( FILE *fp, rk4_stats *st, char *indent )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stats_json writes statistics as a JSON object.
+
+  Discussion:
+
+    The object is written without a trailing newline, so that it can be
+    embedded as a value in a larger document.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    FILE *FP: the output stream.
+
+    rk4_stats *ST: the statistics.
+
+    char *INDENT: a prefix for each line after the first, or NULL.
+*/
+{
+  if ( indent == NULL )
+  {
+    indent = "";
+  }
+
+  fprintf ( fp, "{\n" );
+  fprintf ( fp, "%s  \"enabled\": %d,\n", indent, st->enabled );
+  fprintf ( fp, "%s  \"steps\": %lld,\n", indent, st->step_num );
+  fprintf ( fp, "%s  \"rhs_calls\": %lld,\n", indent, st->eval_num );
+  fprintf ( fp, "%s  \"rejected\": %lld,\n", indent, st->reject_num );
+  fprintf ( fp, "%s  \"bytes_written\": %lld,\n", indent, st->byte_num );
+  fprintf ( fp, "%s  \"step_seconds\": %.6e,\n", indent, st->step_time );
+  fprintf ( fp, "%s  \"rhs_seconds\": %.6e,\n", indent, st->rhs_time );
+  fprintf ( fp, "%s  \"stage_seconds\": %.6e,\n", indent, st->stage_time );
+  fprintf ( fp, "%s  \"output_seconds\": %.6e\n", indent, st->output_time );
+  fprintf ( fp, "%s}", indent );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_stats_reset ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stats_reset sets all counts and times to zero.
+
+  Discussion:
+
+    It should not be called while an integration is running, since a
+    phase that is open at the reset is then charged to the new totals.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+# ifdef RK4_STATS
+  int k;
+
+  for ( k = 0; k < RK4_COUNT_NUM; k++ )
+  {
+    __atomic_store_n ( &rk4_stats_count[k], 0, __ATOMIC_RELAXED );
+  }
+  for ( k = 0; k < RK4_PHASE_NUM; k++ )
+  {
+    __atomic_store_n ( &rk4_stats_tick[k], 0, __ATOMIC_RELAXED );
+  }
+# endif
+
+  return;
+}
+
+# ifdef RK4_STATS
+/******************************************************************************/
+
+unsigned long long int rk4_stats_clock ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stats_clock reads the clock used by the phase timers.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    unsigned long long int RK4_STATS_CLOCK: the time stamp counter, or
+    the monotonic clock in nanoseconds.
+*/
+{
+# ifdef RK4_STATS_USE_TSC
+  return ( unsigned long long int ) __rdtsc ( );
+# else
+  struct timespec ts;
+
+  clock_gettime ( CLOCK_MONOTONIC, &ts );
+
+  return ( unsigned long long int ) ts.tv_sec * 1000000000ULL
+    + ( unsigned long long int ) ts.tv_nsec;
+# endif
+}
+
+# ifdef RK4_STATS_USE_TSC
+/******************************************************************************/
+
+static void rk4_stats_calibrate ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stats_calibrate measures the rate of the time stamp counter.
+
+  Discussion:
+
+    The counter is compared with the monotonic clock over 20 ms.  This
+    assumes an invariant counter, as on all recent x86 processors.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double s0;
+  double s1;
+  unsigned long long int t0;
+  unsigned long long int t1;
+  struct timespec ts;
+
+  clock_gettime ( CLOCK_MONOTONIC, &ts );
+  s0 = ( double ) ts.tv_sec + 1.0E-09 * ( double ) ts.tv_nsec;
+  t0 = __rdtsc ( );
+  do
+  {
+    clock_gettime ( CLOCK_MONOTONIC, &ts );
+    s1 = ( double ) ts.tv_sec + 1.0E-09 * ( double ) ts.tv_nsec;
+  } while ( s1 - s0 < 0.02 );
+  t1 = __rdtsc ( );
+
+  rk4_stats_rate = ( double ) ( t1 - t0 ) / ( s1 - s0 );
+
+  return;
+}
+# endif
+/******************************************************************************/
+
+static double rk4_stats_seconds ( unsigned long long int tick )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_stats_seconds converts clock ticks to seconds.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+# ifdef RK4_STATS_USE_TSC
+  pthread_once ( &rk4_stats_once, rk4_stats_calibrate );
+
+  return ( double ) tick / rk4_stats_rate;
+# else
+  return 1.0E-09 * ( double ) tick;
+# endif
+}
+# endif
@@ -0,0 +1,72 @@
+/*
+  rk4_stats counts and times the work done by the integrators: steps,
+  right hand side evaluations, rejected steps and bytes written, and the
+  time spent in whole steps, in the right hand side, and in output.  The
+  stage arithmetic is the step time less the right hand side time.
+
+  The hooks are compiled only when the library is built with RK4_STATS
+  defined, for example "gcc -DRK4_STATS ...".  Otherwise they expand to
+  nothing, so the hot loops are unchanged, and rk4_stats_get() reports
+  ENABLED = 0 with zero counts.
+
+  The counts and times are totals over all threads since the last
+  rk4_stats_reset(), so with rk4_par the times may exceed the wall time.
+  Times are read with clock_gettime ( CLOCK_MONOTONIC ), or, if
+  RK4_STATS_TSC is also defined on x86, from the time stamp counter,
+  whose rate is measured once against the monotonic clock.
+*/
+# define RK4_COUNT_STEP 0
+# define RK4_COUNT_EVAL 1
+# define RK4_COUNT_REJECT 2
+# define RK4_COUNT_BYTE 3
+# define RK4_COUNT_NUM 4
+
+# define RK4_PHASE_STEP 0
+# define RK4_PHASE_RHS 1
+# define RK4_PHASE_OUTPUT 2
+# define RK4_PHASE_NUM 3
+
+# ifdef RK4_STATS
+
+extern unsigned long long int rk4_stats_count[RK4_COUNT_NUM];
+extern unsigned long long int rk4_stats_tick[RK4_PHASE_NUM];
+extern _Thread_local unsigned long long int rk4_stats_start[RK4_PHASE_NUM];
+
+unsigned long long int rk4_stats_clock ( );
+
+# define RK4_STATS_ADD( k, n ) \
+  __atomic_fetch_add ( &rk4_stats_count[k], \
+    ( unsigned long long int ) ( n ), __ATOMIC_RELAXED )
+# define RK4_STATS_TIC( k ) \
+  ( rk4_stats_start[k] = rk4_stats_clock ( ) )
+# define RK4_STATS_TOC( k ) \
+  __atomic_fetch_add ( &rk4_stats_tick[k], \
+    rk4_stats_clock ( ) - rk4_stats_start[k], __ATOMIC_RELAXED )
+
+# else
+
+# define RK4_STATS_ADD( k, n ) ( ( void ) 0 )
+# define RK4_STATS_TIC( k ) ( ( void ) 0 )
+# define RK4_STATS_TOC( k ) ( ( void ) 0 )
+
+# endif
+
+/*
+  rk4_stats is a snapshot of the counters, with the times in seconds.
+*/
+typedef struct
+{
+  int enabled;
+  long long int step_num;
+  long long int eval_num;
+  long long int reject_num;
+  long long int byte_num;
+  double step_time;
+  double rhs_time;
+  double stage_time;
+  double output_time;
+} rk4_stats;
+
+void rk4_stats_get ( rk4_stats *st );
+void rk4_stats_json ( FILE *fp, rk4_stats *st, char *indent );
+void rk4_stats_reset ( );
@@ -0,0 +1,170 @@
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_pool.h"
+# include "rk4_sweep.h"
+
+/*
+  rk4_sweep_job describes a sweep to every thread.  It is only read
+  while the sweep runs; each thread writes its own rows of RESULT and
+  its own entry of STATUS.
+*/
+typedef struct
+{
+  void ( *dydt ) ( double t, double u[], double f[], void *ctx );
+  int point_num;
+  char *params;
+  size_t param_size;
+  double *tspan;
+  double *y0;
+  int n;
+  int m;
+  double *result;
+  int *status;
+} rk4_sweep_job;
+
+static void rk4_sweep_task ( int id, int thread_num, void *arg );
+
+/******************************************************************************/
+
+int rk4_sweep ( void dydt ( double t, double u[], double f[], void *ctx ),
+  int point_num, void *params, size_t param_size, double tspan[2],
+  double y0[], int n, int m, rk4_pool *pool, double result[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sweep integrates one ODE for every point of a parameter grid.
+
+  Discussion:
+
+    Point P of the grid is the record of PARAM_SIZE bytes starting at
+    PARAMS + P * PARAM_SIZE.  It is passed to DYDT as the context, so
+    DYDT must not modify it.
+
+    Thread ID takes points ID, ID + THREAD_NUM, ..., with one reused
+    RK4 stepper.  Nothing is shared between threads except the read
+    only inputs, so the results do not depend on the thread count.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[], void *CTX ), evaluates
+    the right hand side for the parameter record CTX.
+
+    int POINT_NUM: the number of grid points.
+
+    void *PARAMS: the parameter records.
+
+    size_t PARAM_SIZE: the size of one record, in bytes.
+
+    double TSPAN[2]: the initial and final times.
+
+    double Y0[M]: the initial condition, shared by all points.
+
+    int N: the number of steps to take.
+
+    int M: the number of variables.
+
+    rk4_pool *POOL: the threads to use.  If POOL is NULL, the sweep runs
+    in the calling thread.
+
+  Output:
+
+    double RESULT[POINT_NUM*M]: the solution at TSPAN[1] for each point,
+    with RESULT[I+P*M] holding component I for point P.
+
+    int RK4_SWEEP: 0 on success, 2 if memory could not be allocated.
+*/
+{
+  rk4_sweep_job job;
+  int id;
+  int status;
+  int thread_num;
+
+  thread_num = rk4_pool_size ( pool );
+
+  job.dydt = dydt;
+  job.point_num = point_num;
+  job.params = ( char * ) params;
+  job.param_size = param_size;
+  job.tspan = tspan;
+  job.y0 = y0;
+  job.n = n;
+  job.m = m;
+  job.result = result;
+  job.status = ( int * ) malloc ( thread_num * sizeof ( int ) );
+  if ( job.status == NULL )
+  {
+    return 2;
+  }
+
+  rk4_pool_run ( pool, rk4_sweep_task, &job );
+
+  status = 0;
+  for ( id = 0; id < thread_num; id++ )
+  {
+    if ( job.status[id] != 0 )
+    {
+      status = job.status[id];
+    }
+  }
+
+  free ( job.status );
+
+  return status;
+}
+/******************************************************************************/
+
+static void rk4_sweep_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_sweep_task integrates the grid points belonging to one thread.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  rk4_sweep_job *job;
+  int p;
+  rk4_stepper *s;
+
+  job = ( rk4_sweep_job * ) arg;
+
+  s = rk4_stepper_create_ctx ( job->dydt, NULL, job->m, job->tspan[0],
+    job->y0 );
+  if ( s == NULL )
+  {
+    job->status[id] = 2;
+    return;
+  }
+
+  for ( p = id; p < job->point_num; p = p + thread_num )
+  {
+    s->ctx = job->params + p * job->param_size;
+    rk4_stepper_reset ( s, job->tspan[0], job->y0 );
+    rk4_stepper_advance ( s, job->tspan[1], job->n );
+    for ( i = 0; i < job->m; i++ )
+    {
+      job->result[i+p*job->m] = s->y[i];
+    }
+  }
+
+  rk4_stepper_destroy ( s );
+  job->status[id] = 0;
+
+  return;
+}
@@ -0,0 +1,3 @@
+int rk4_sweep ( void dydt ( double t, double u[], double f[], void *ctx ),
+  int point_num, void *params, size_t param_size, double tspan[2],
+  double y0[], int n, int m, rk4_pool *pool, double result[] );
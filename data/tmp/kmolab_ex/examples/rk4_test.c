@@ -2,13 +2,118 @@
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
+# include <time.h>
 
 # include "rk4.h"
+# include "rk4_ensemble.h"
+# include "rk45.h"
+# include "rk4_pool.h"
+# include "rk4_sweep.h"
+# include "rk4_par.h"
+# include "rk4_traj.h"
+# include "rk4_ckpt.h"
+# include "symplectic.h"
+# include "rk4_parareal.h"
+# include "rk4_sens.h"
+# include "rk4_stats.h"
+# include "rk4_mr.h"
+# include "imex.h"
+# include "lsrk.h"
+# include "bs.h"
+# include "sde.h"
+# include "dde.h"
+# include "expr.h"
+# include "stiff.h"
+
+/*
+  fisher_ctx describes the method of lines Fisher equation
+  dU/dT = D * d2U/dX2 + R * U * ( 1 - U ) on M interior nodes, with the
+  factored matrix I - GH * L of the last implicit solve.
+*/
+typedef struct
+{
+  int m;
+  double d;
+  double r;
+  double gh;
+  double *lu;
+} fisher_ctx;
 
 int main ( );
 void rk4_predator_test ( );
+void rk4_stepper_test ( );
+void rk4_ensemble_test ( );
+void rk4_ensemble_float_test ( );
+void rk45_predator_test ( );
+void rk4_observer_test ( );
+void rk4_sweep_test ( );
+void stiff_robertson_test ( );
+void rk4_par_heat_test ( );
+void rk4_traj_test ( );
+void rk4_ckpt_test ( );
+void rk45_event_test ( );
+void symp_kepler_test ( );
+void rk4_parareal_test ( );
+void rk4_sens_test ( );
+void rk4_stats_test ( );
+void rk4_mr_test ( );
+void imex_fisher_test ( );
+void lsrk_predator_test ( );
+void bs_kepler_test ( );
+void sde_strong_test ( );
+void sde_predator_test ( );
+void dde_delay_test ( );
+void expr_predator_test ( );
+void fisher_deriv ( double t, double u[], double f[], void *ctx );
+void fisher_fe ( double t, double u[], double f[], void *ctx );
+void fisher_fi ( double t, double u[], double f[], void *ctx );
+int fisher_solve ( double t, double gh, double r[], double z[], void *ctx );
+void gbm_diffusion ( double t, double y[], double g[], void *ctx );
+void gbm_drift ( double t, double y[], double f[], void *ctx );
+void heat_deriv_ctx ( double t, double u[], double f[], void *ctx );
+void heat_deriv_part ( double t, int lo, int hi, double u[], double f[],
+  void *ctx );
+void kepler_deriv ( double t, double y[], double f[] );
+void kepler_deriv_ctx ( double t, double y[], double f[], void *ctx );
+void kepler_dpdt ( double t, double q[], double dp[], void *ctx );
+void kepler_dqdt ( double t, double p[], double dq[], void *ctx );
+int kepler_energy_observe ( double t, int m, double y[], void *data );
+void lag_deriv ( double t, double y[], double f[], dde_stepper *s,
+  void *ctx );
+double lag_history ( double t, int i, void *ctx );
+void log_deriv ( double t, double u[], double f[] );
+void nan_deriv_ctx ( double t, double u[], double f[], void *ctx );
+void nan_late_deriv ( double t, double u[], double f[] );
+void ou_diffusion ( double t, double y[], double g[], void *ctx );
+void ou_drift ( double t, double y[], double f[], void *ctx );
+void predator_delay_deriv ( double t, double y[], double f[], dde_stepper *s,
+  void *ctx );
+double predator_delay_history ( double t, int i, void *ctx );
 void predator_deriv ( double t, double u[], double f[] );
+void predator_deriv_acc ( double t, double u[], double a, double h,
+  double du[], void *ctx );
+void predator_deriv_batch ( double t, int nens, int m, int ld, double u[],
+  double f[] );
+void predator_deriv_batch_float ( double t, int nens, int m, int ld,
+  float u[], float f[] );
+void predator_deriv_ctx ( double t, double u[], double f[], void *ctx );
+void predator_diffusion ( double t, double y[], double g[], void *ctx );
+void predator_event ( double t, int m, double y[], double gv[], void *data );
+int predator_event_found ( int k, double t, int m, double y[], void *data );
 void predator_phase_plot ( int n, int m, double t[], double y[] );
+int predator_print_observe ( double t, int m, double y[], void *data );
+int predator_range_observe ( double t, int m, double y[], void *data );
+void predator_sens ( double t, double y[], double p[], int np, double s[],
+  double ds[] );
+void relax_deriv_ctx ( double t, double y[], double f[], void *ctx );
+void robertson_deriv ( double t, double y[], double f[] );
+void robertson_jac ( double t, double y[], double dfdy[] );
+void twoscale_deriv ( double t, double u[], double f[], void *ctx );
+void twoscale_fast ( double t, double yf[], double ys[], double ff[],
+  void *ctx );
+void twoscale_slow ( double t, double yf[], double ys[], double fs[],
+  void *ctx );
+double wtime ( );
 
 /******************************************************************************/
 
@@ -44,6 +149,29 @@ int main ( )
   printf ( "  Test rk4() .\n" );
 
   rk4_predator_test ( );
+  rk4_stepper_test ( );
+  rk4_ensemble_test ( );
+  rk4_ensemble_float_test ( );
+  rk45_predator_test ( );
+  rk4_observer_test ( );
+  rk4_sweep_test ( );
+  stiff_robertson_test ( );
+  rk4_par_heat_test ( );
+  rk4_traj_test ( );
+  rk4_ckpt_test ( );
+  rk45_event_test ( );
+  symp_kepler_test ( );
+  rk4_parareal_test ( );
+  rk4_sens_test ( );
+  rk4_stats_test ( );
+  rk4_mr_test ( );
+  imex_fisher_test ( );
+  lsrk_predator_test ( );
+  bs_kepler_test ( );
+  sde_strong_test ( );
+  sde_predator_test ( );
+  dde_delay_test ( );
+  expr_predator_test ( );
 /*
   Terminate.
 */
@@ -115,13 +243,13 @@ void rk4_predator_test ( )
 }
 /******************************************************************************/
 
-void predator_deriv ( double t, double y[], double f[] )
+void rk4_stepper_test ( ) 
 
 /******************************************************************************/
 /*
   Purpose:
  
-    predator_deriv returns the right hand side of the predator ODE.
+    rk4_stepper_test compares the RK4 stepper with rk4().
 
   Licensing:
 
@@ -129,48 +257,150 @@ void predator_deriv ( double t, double y[], double f[] )
 
   Modified:
 
-    22 April 2020
+    18 October 2026
+*/
+{
+  double diff;
+  int i;
+  int j;
+  int m = 2;
+  int n = 1000;
+  rk4_stepper *s;
+  double *t;
+  double tspan[2];
+  double *y;
+  double y0[2];
 
-  Author:
+  printf ( "\n" );
+  printf ( "rk4_stepper_test\n" );
+  printf ( "  Step the predator prey ODE with rk4_stepper_step()\n" );
+  printf ( "  and compare with rk4().\n" );
 
-    John Burkardt
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
 
-  Input:
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
 
-    double T, the current time.
+  rk4 ( predator_deriv, tspan, y0, n, m, t, y );
 
-    double Y[M], the current solution value.
+  s = rk4_stepper_create ( predator_deriv, m, tspan[0], y0 );
 
-  Output:
+  diff = 0.0;
+  for ( j = 1; j <= n; j++ )
+  {
+    rk4_stepper_step ( s, ( tspan[1] - tspan[0] ) / ( double ) ( n ) );
+    for ( i = 0; i < m; i++ )
+    {
+      diff = fmax ( diff, fabs ( s->y[i] - y[i+j*m] ) );
+    }
+  }
 
-    double F[M], the value of the derivative, dU/dT.
+  printf ( "\n" );
+  printf ( "  Steps taken = %ld\n", s->step_num );
+  printf ( "  Final time  = %g\n", s->t );
+  printf ( "  Max difference from rk4() = %g\n", diff );
+
+  rk4_stepper_destroy ( s );
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ensemble_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_ensemble_test compares the RK4 ensemble with rk4() member by member.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
 */
 {
-  double dfdt;
-  double drdt;
-  double fox;
-  double rab;
-  
-  rab = y[0];
-  fox = y[1];
+  double diff;
+  rk4_ensemble *e;
+  int i;
+  int k;
+  int m = 2;
+  int n = 1000;
+  int nens = 37;
+  double *t;
+  double tspan[2];
+  double *y;
+  double y0[2];
+  double y1[2];
 
-  drdt =   2.0 * rab - 0.001 * rab * fox;
-  dfdt = -10.0 * fox + 0.002 * rab * fox;
+  printf ( "\n" );
+  printf ( "rk4_ensemble_test\n" );
+  printf ( "  Integrate %d predator prey initial conditions together\n", nens );
+  printf ( "  with rk4_ensemble_step() and compare with rk4().\n" );
+  printf ( "  Stage kernels: %s\n", rk4_ensemble_isa ( ) );
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+
+  e = rk4_ensemble_create ( predator_deriv_batch, m, nens, tspan[0] );
+  for ( k = 0; k < nens; k++ )
+  {
+    y0[0] = 5000.0 + 100.0 * k;
+    y0[1] = 100.0 + 10.0 * k;
+    rk4_ensemble_set ( e, k, y0 );
+  }
+
+  rk4_ensemble_advance ( e, tspan[1], n );
+
+  diff = 0.0;
+  for ( k = 0; k < nens; k++ )
+  {
+    y0[0] = 5000.0 + 100.0 * k;
+    y0[1] = 100.0 + 10.0 * k;
+    rk4 ( predator_deriv, tspan, y0, n, m, t, y );
+    rk4_ensemble_get ( e, k, y1 );
+    for ( i = 0; i < m; i++ )
+    {
+      diff = fmax ( diff, fabs ( y1[i] - y[i+n*m] ) / fabs ( y[i+n*m] ) );
+    }
+  }
+
+  printf ( "\n" );
+  printf ( "  Final time  = %g\n", e->t );
+  printf ( "  Max relative difference from rk4() = %g\n", diff );
+
+  rk4_ensemble_destroy ( e );
+  free ( t );
+  free ( y );
 
-  f[0] = drdt;
-  f[1] = dfdt;
-  
   return;
 }
 /******************************************************************************/
 
-void predator_phase_plot ( int n, int m, double t[], double y[] )
+void rk4_ensemble_float_test ( ) 
 
 /******************************************************************************/
 /*
   Purpose:
+ 
+    rk4_ensemble_float_test compares the float and mixed precision ensembles.
 
-    predator_phase_plot makes a phase plot of the results.
+  Discussion:
+
+    The same predator prey ensemble is run in double, float and mixed
+    precision, with a stepsize small enough that rounding error, not
+    truncation error, separates the results.
 
   Licensing:
 
@@ -178,76 +408,4251 @@ void predator_phase_plot ( int n, int m, double t[], double y[] )
 
   Modified:
 
-    22 April 2020
+    18 October 2026
+*/
+{
+  double diff;
+  rk4_ensemble *e[3];
+  int i;
+  int k;
+  int m = 2;
+  int n = 20000;
+  char *name[3] = { "double", "float", "mixed" };
+  int nens = 37;
+  int p;
+  double tspan[2];
+  double y0[2];
+  double y1[2];
+  double y2[2];
 
-  Author:
+  printf ( "\n" );
+  printf ( "rk4_ensemble_float_test\n" );
+  printf ( "  Integrate %d predator prey initial conditions in double,\n",
+    nens );
+  printf ( "  float and mixed precision, with %d steps.\n", n );
 
-    John Burkardt
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
 
-  Input:
+  e[0] = rk4_ensemble_create ( predator_deriv_batch, m, nens, tspan[0] );
+  e[1] = rk4_ensemble_create_float ( predator_deriv_batch_float, m, nens,
+    tspan[0], RK4_ENSEMBLE_FLOAT );
+  e[2] = rk4_ensemble_create_float ( predator_deriv_batch_float, m, nens,
+    tspan[0], RK4_ENSEMBLE_MIXED );
 
-    int n: the number of steps to take.
+  for ( p = 0; p < 3; p++ )
+  {
+    for ( k = 0; k < nens; k++ )
+    {
+      y0[0] = 5000.0 + 100.0 * k;
+      y0[1] = 100.0 + 10.0 * k;
+      rk4_ensemble_set ( e[p], k, y0 );
+    }
+    rk4_ensemble_advance ( e[p], tspan[1], n );
+  }
 
-    int m: the number of variables.
+  printf ( "\n" );
+  printf ( "  Precision   Max relative difference from double\n" );
+  printf ( "\n" );
+  for ( p = 1; p < 3; p++ )
+  {
+    diff = 0.0;
+    for ( k = 0; k < nens; k++ )
+    {
+      rk4_ensemble_get ( e[0], k, y1 );
+      rk4_ensemble_get ( e[p], k, y2 );
+      for ( i = 0; i < m; i++ )
+      {
+        diff = fmax ( diff, fabs ( y2[i] - y1[i] ) / fabs ( y1[i] ) );
+      }
+    }
+    printf ( "  %-9s   %g\n", name[p], diff );
+  }
 
-    double t[n+1], y[(n+1)*m]: the times and solution values.
+  for ( p = 0; p < 3; p++ )
+  {
+    rk4_ensemble_destroy ( e[p] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk45_predator_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk45_predator_test compares rk45() and rk4() on the predator prey ODE.
+
+  Discussion:
+
+    The dense output of the rk45 stepper is then checked against a
+    fine rk4 solution at every one of its points.  Finally, a NaN right
+    hand side must fail at T = 0, and a long interval must not.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
 */
 {
-  char command_filename[80];
-  FILE *command;
-  char data_filename[80];
-  FILE *data;
-  char header[] = "predator";
-  int j;
+  double err;
+  double err_dense;
+  long int eval_num;
+  int i;
+  int k;
+  int m = 2;
+  int n;
+  int n_ref = 100000;
+  rk45_stepper *s;
+  int status;
+  double *t;
+  double tol;
+  double tspan[2];
+  double *y;
+  double y0[2];
+  double y1[2];
+  double y_ref[2];
 
   printf ( "\n" );
-  printf ( "predator_phase_plot:\n" );
-  printf ( "  Write command and data files that can be used\n" );
-  printf ( "  by gnuplot for a predator-prey phase plot.\n" );
+  printf ( "rk45_predator_test\n" );
+  printf ( "  Compare the error and number of DYDT calls of rk45()\n" );
+  printf ( "  and rk4() on the predator prey ODE.\n" );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  t = ( double * ) malloc ( ( n_ref + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n_ref + 1 ) * m * sizeof ( double ) );
+
+  rk4 ( predator_deriv, tspan, y0, n_ref, m, t, y );
+  for ( i = 0; i < m; i++ )
+  {
+    y_ref[i] = y[i+n_ref*m];
+  }
+
+  printf ( "\n" );
+  printf ( "  Method        Tol/N    DYDT calls    Max relative error\n" );
+  printf ( "\n" );
+
+  for ( n = 1000; n <= 16000; n = n * 4 )
+  {
+    rk4 ( predator_deriv, tspan, y0, n, m, t, y );
+    err = 0.0;
+    for ( i = 0; i < m; i++ )
+    {
+      err = fmax ( err, fabs ( y[i+n*m] - y_ref[i] ) / fabs ( y_ref[i] ) );
+    }
+    printf ( "  rk4    %12d  %12d  %20.6g\n", n, 4 * n, err );
+  }
+
+  for ( tol = 1.0E-06; 1.0E-11 < tol; tol = tol / 100.0 )
+  {
+    status = rk45 ( predator_deriv, tspan, y0, m, tol, tol, y1, &eval_num );
+    err = 0.0;
+    for ( i = 0; i < m; i++ )
+    {
+      err = fmax ( err, fabs ( y1[i] - y_ref[i] ) / fabs ( y_ref[i] ) );
+    }
+    printf ( "  rk45   %12.1e  %12ld  %20.6g", tol, eval_num, err );
+    if ( status != 0 )
+    {
+      printf ( "  (status %d)", status );
+    }
+    printf ( "\n" );
+  }
 /*
-  Create the data file.
+  Dense output at every reference point, against the step end error.
 */
-  strcpy ( data_filename, header );
-  strcat ( data_filename, "_data.txt" );
+  rk4 ( predator_deriv, tspan, y0, n_ref, m, t, y );
 
-  data = fopen ( data_filename, "wt" );
+  printf ( "\n" );
+  printf ( "        Tol    Steps    End error  Dense error\n" );
+  printf ( "\n" );
 
-  for ( j = 0; j <= n; j++ )
+  for ( tol = 1.0E-06; 1.0E-11 < tol; tol = tol / 100.0 )
   {
-    fprintf ( data, "  %g  %g  %g\n", t[j], y[0+j*m], y[1+j*m] );
+    s = rk45_create ( predator_deriv, m, tspan[0], y0, tol, tol );
+    err = 0.0;
+    err_dense = 0.0;
+    k = 1;
+    while ( s->t < tspan[1] )
+    {
+      rk45_step ( s, tspan[1] );
+      for ( ; k <= n_ref && t[k] <= s->t; k++ )
+      {
+        rk45_dense ( s, t[k], y1 );
+        for ( i = 0; i < m; i++ )
+        {
+          err_dense = fmax ( err_dense,
+            fabs ( y1[i] - y[i+k*m] ) / fabs ( y[i+k*m] ) );
+        }
+      }
+    }
+    for ( i = 0; i < m; i++ )
+    {
+      err = fmax ( err, fabs ( s->y[i] - y_ref[i] ) / fabs ( y_ref[i] ) );
+    }
+    printf ( "  %9.1e  %7ld  %11.3e  %11.3e\n", tol, s->step_num, err,
+      err_dense );
+    rk45_destroy ( s );
   }
+/*
+  Every step of a NaN right hand side is rejected.  Starting at T = 0,
+  the stepsize must still reach a positive minimum and fail.
+*/
+  s = rk45_create_ctx ( nan_deriv_ctx, &m, m, 0.0, y0, 1.0E-06, 1.0E-06 );
+  status = rk45_advance ( s, tspan[1] );
+  printf ( "\n" );
+  printf ( "  NaN right hand side: status %d at T = %g after %ld rejections\n",
+    status, s->t, s->reject_num );
+  rk45_destroy ( s );
+/*
+  A long interval must not make the first, small steps fail.
+*/
+  y1[0] = 0.0;
+  s = rk45_create ( log_deriv, 1, 0.0, y1, 1.0E-10, 1.0E-10 );
+  status = rk45_advance ( s, 1.0E+13 );
+  printf ( "  Y' = 1 / ( 1 + T ) to T = 1e13: status %d, %ld steps, "
+    "error %g\n", status, s->step_num,
+    fabs ( s->y[0] - log ( 1.0 + 1.0E+13 ) ) );
+  rk45_destroy ( s );
+
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_observer_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_observer_test collects predator prey statistics with an observer.
+
+  Discussion:
+
+    The range of each population is found from the streamed solution,
+    and compared with the range of the full trajectory stored by rk4().
+    Then the solution is requested at T = 1, 2, ..., 5, from both the
+    fixed step and the adaptive integrators.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
 
-  fclose ( data );
+    18 October 2026
+*/
+{
+  double diff;
+  int i;
+  int j;
+  int m = 2;
+  int n = 1000;
+  rk4_observer obs;
+  double range[6];
+  rk45_stepper *s;
+  double *t;
+  double tout[5] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+  double tspan[2];
+  double *y;
+  double y0[2];
 
   printf ( "\n" );
-  printf ( "  predator_phase_plot: data stored in \"%s\".\n", data_filename );
+  printf ( "rk4_observer_test\n" );
+  printf ( "  Stream the predator prey solution to an observer.\n" );
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  rk4 ( predator_deriv, tspan, y0, n, m, t, y );
+
+  range[0] = 0.0;
+  obs.observe = predator_range_observe;
+  obs.data = range;
+  obs.every = 1;
+  obs.tout_num = 0;
+  obs.tout = NULL;
+
+  rk4_observe ( predator_deriv, tspan, y0, n, m, &obs );
+
+  diff = 0.0;
+  for ( j = 0; j <= n; j++ )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      diff = fmax ( diff, range[2+2*i] - y[i+j*m] );
+      diff = fmax ( diff, y[i+j*m] - range[3+2*i] );
+    }
+  }
+
+  printf ( "\n" );
+  printf ( "  Observer calls = %g\n", range[0] );
+  printf ( "  Prey range     = [ %g, %g ]\n", range[2], range[3] );
+  printf ( "  Predator range = [ %g, %g ]\n", range[4], range[5] );
+  printf ( "  Max excess of stored trajectory over range = %g\n", diff );
 /*
-  Create the command file.
+  Report at requested times.
 */
-  strcpy ( command_filename, header );
-  strcat ( command_filename, "_commands.txt" );
+  obs.observe = predator_print_observe;
+  obs.data = "rk4";
+  obs.every = 0;
+  obs.tout_num = 5;
+  obs.tout = tout;
 
-  command = fopen ( command_filename, "wt" );
+  printf ( "\n" );
+  printf ( "  Solution at output times:\n" );
+  printf ( "\n" );
+  rk4_observe ( predator_deriv, tspan, y0, n, m, &obs );
 
-  fprintf ( command, "# %s\n", command_filename );
-  fprintf ( command, "#\n" );
-  fprintf ( command, "# Usage:\n" );
-  fprintf ( command, "#  gnuplot < %s\n", command_filename );
-  fprintf ( command, "#\n" );
-  fprintf ( command, "set term png\n" );
-  fprintf ( command, "set output '%s.png'\n", header );
-  fprintf ( command, "set xlabel '<-- Prey -->'\n" );
-  fprintf ( command, "set ylabel '<-- Predator -->'\n" );
-  fprintf ( command, "set title 'Predator-prey solution by rk4'\n" );
-  fprintf ( command, "set grid\n" );
-  fprintf ( command, "set style data lines\n" );
-  fprintf ( command, "plot '%s' using 2:3 with lines\n", data_filename );
-  fprintf ( command, "quit\n" );
+  obs.data = "rk45";
+  s = rk45_create ( predator_deriv, m, tspan[0], y0, 1.0E-10, 1.0E-10 );
+  rk45_observe ( s, tspan[1], &obs );
+  rk45_destroy ( s );
 
-  fclose ( command );
+  free ( t );
+  free ( y );
 
-  printf ( "  predator_phase_plot: plot commands stored in \"%s\".\n", 
-    command_filename );
- 
   return;
-}
\ No newline at end of file
+}
+/******************************************************************************/
+
+void rk4_sweep_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_sweep_test sweeps the predator prey coefficients on a thread pool.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double diff;
+  int i;
+  int j;
+  int m = 2;
+  int n = 1000;
+  int p;
+  double param[16*4];
+  int point_num = 16;
+  rk4_pool *pool;
+  double result[16*2];
+  double *t;
+  double tspan[2];
+  double *y;
+  double y0[2];
+
+  printf ( "\n" );
+  printf ( "rk4_sweep_test\n" );
+  printf ( "  Integrate the predator prey ODE for a 4x4 grid of\n" );
+  printf ( "  prey growth and predator death rates, on 4 threads,\n" );
+  printf ( "  and compare with serial calls to rk4_ctx().\n" );
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  for ( j = 0; j < 4; j++ )
+  {
+    for ( i = 0; i < 4; i++ )
+    {
+      p = i + j * 4;
+      param[0+p*4] = 1.5 + 0.25 * i;
+      param[1+p*4] = 0.001;
+      param[2+p*4] = 8.0 + 1.0 * j;
+      param[3+p*4] = 0.002;
+    }
+  }
+
+  pool = rk4_pool_create ( 4 );
+  rk4_sweep ( predator_deriv_ctx, point_num, param, 4 * sizeof ( double ),
+    tspan, y0, n, m, pool, result );
+  rk4_pool_destroy ( pool );
+
+  diff = 0.0;
+  for ( p = 0; p < point_num; p++ )
+  {
+    rk4_ctx ( predator_deriv_ctx, param + p * 4, tspan, y0, n, m, t, y );
+    for ( i = 0; i < m; i++ )
+    {
+      diff = fmax ( diff, fabs ( result[i+p*m] - y[i+n*m] ) );
+    }
+  }
+
+  printf ( "\n" );
+  printf ( "  Alpha = %g, Gamma = %g: Y = ( %g, %g )\n", param[0], param[2],
+    result[0], result[1] );
+  printf ( "  Alpha = %g, Gamma = %g: Y = ( %g, %g )\n", param[60], param[62],
+    result[30], result[31] );
+  printf ( "  Max difference from rk4_ctx() = %g\n", diff );
+
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void stiff_robertson_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    stiff_robertson_test solves the stiff Robertson problem.
+
+  Discussion:
+
+    The reference solution at T = 40 is from Hairer and Wanner.  Then
+    both stiff solvers must stop where the right hand side turns NaN.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  bdf_stepper *b;
+  double err;
+  int i;
+  int m = 3;
+  int n;
+  ros23_stepper *r;
+  int status;
+  double *t;
+  double tspan[2];
+  double *y;
+  double y0[3] = { 1.0, 0.0, 0.0 };
+  double y1[1];
+  double y_ref[3] = { 
+    0.7158270687193772, 9.185534764557238E-06, 0.2841637457458413 };
+
+  printf ( "\n" );
+  printf ( "stiff_robertson_test\n" );
+  printf ( "  Solve the Robertson chemical kinetics problem on [0,40]\n" );
+  printf ( "  with rk4(), ros23 and bdf.\n" );
+  printf ( "\n" );
+  printf ( "  Method             Steps    DYDT calls   LU   Max relative error\n" );
+  printf ( "\n" );
+
+  tspan[0] = 0.0;
+  tspan[1] = 40.0;
+/*
+  RK4 is stable only for DT below about 2.8 / 10^4.
+*/
+  n = 200000;
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+  rk4 ( robertson_deriv, tspan, y0, n, m, t, y );
+  err = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    err = fmax ( err, fabs ( y[i+n*m] - y_ref[i] ) / fabs ( y_ref[i] ) );
+  }
+  printf ( "  rk4              %8d  %12d  %3d  %16.6g\n", n, 4 * n, 0, err );
+  free ( t );
+  free ( y );
+
+  r = ros23_create ( robertson_deriv, robertson_jac, NULL, m, tspan[0], y0, 
+    1.0E-06, 1.0E-10 );
+  ros23_advance ( r, tspan[1] );
+  err = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    err = fmax ( err, fabs ( r->y[i] - y_ref[i] ) / fabs ( y_ref[i] ) );
+  }
+  printf ( "  ros23, exact J   %8ld  %12ld  %3ld  %16.6g\n", r->step_num, 
+    r->eval_num, r->lu_num, err );
+  ros23_destroy ( r );
+
+  b = bdf_create ( robertson_deriv, NULL, NULL, m, tspan[0], y0, 
+    1.0E-06, 1.0E-10 );
+  bdf_advance ( b, tspan[1] );
+  err = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    err = fmax ( err, fabs ( b->y[i] - y_ref[i] ) / fabs ( y_ref[i] ) );
+  }
+  printf ( "  bdf, FD J        %8ld  %12ld  %3ld  %16.6g\n", b->step_num, 
+    b->eval_num, b->lu_num, err );
+  bdf_destroy ( b );
+/*
+  A right hand side that turns NaN at T = 1 must stop there, and a NaN
+  initial value must stop at T = 0.
+*/
+  printf ( "\n" );
+  printf ( "  Method   Y0     Status      T\n" );
+  printf ( "\n" );
+  for ( i = 0; i < 2; i++ )
+  {
+    y1[0] = ( i == 0 ) ? 1.0 : NAN;
+    r = ros23_create ( nan_late_deriv, NULL, NULL, 1, 0.0, y1, 1.0E-06,
+      1.0E-10 );
+    status = ros23_advance ( r, 2.0 );
+    printf ( "  ros23  %4g  %8d  %9.6f\n", y1[0], status, r->t );
+    ros23_destroy ( r );
+    b = bdf_create ( nan_late_deriv, NULL, NULL, 1, 0.0, y1, 1.0E-06,
+      1.0E-10 );
+    status = bdf_advance ( b, 2.0 );
+    printf ( "  bdf    %4g  %8d  %9.6f\n", y1[0], status, b->t );
+    bdf_destroy ( b );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_par_heat_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_par_heat_test solves a method of lines heat equation in parallel.
+
+  Discussion:
+
+    The heat equation u_t = u_xx on [0,1], with u = 0 at both ends and
+    u(x,0) = sin(pi x), is discretized on M interior nodes.  It is solved
+    by rk4_par on 4 threads, and by an rk4_stepper serially.
+
+    The final time is long enough for the solution to decay by about
+    40 percent, so that the comparison with the exact solution
+    exp(-pi^2 t) sin(pi x) tests the integration.  The stepsize is
+    DX^2 / 2, inside the RK4 stability limit of about 0.7 DX^2.  The
+    error left is that of the space discretization, close to
+    pi^4 DX^2 T / 12 times the solution.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double diff;
+  double dx;
+  double err;
+  int i;
+  int m = 200;
+  int n;
+  rk4_par *p;
+  rk4_pool *pool;
+  rk4_stepper *s;
+  double tspan[2];
+  double umid;
+  double *y0;
+
+  printf ( "\n" );
+  printf ( "rk4_par_heat_test\n" );
+  printf ( "  Solve the heat equation on %d nodes with rk4_par\n", m );
+  printf ( "  on 4 threads, and compare with a serial rk4_stepper.\n" );
+
+  dx = 1.0 / ( double ) ( m + 1 );
+  tspan[0] = 0.0;
+  tspan[1] = 0.05;
+  n = ( int ) ceil ( tspan[1] / ( 0.5 * dx * dx ) );
+
+  y0 = ( double * ) malloc ( m * sizeof ( double ) );
+  for ( i = 0; i < m; i++ )
+  {
+    y0[i] = sin ( M_PI * ( i + 1 ) * dx );
+  }
+
+  s = rk4_stepper_create_ctx ( heat_deriv_ctx, &m, m, tspan[0], y0 );
+  rk4_stepper_advance ( s, tspan[1], n );
+
+  pool = rk4_pool_create ( 4 );
+  rk4_pool_pin ( pool );
+  p = rk4_par_create ( heat_deriv_part, &m, m, tspan[0], y0, pool );
+  rk4_par_advance ( p, tspan[1], n );
+
+  diff = 0.0;
+  err = 0.0;
+  umid = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( p->y[i] - s->y[i] ) );
+    err = fmax ( err, fabs ( p->y[i] 
+      - exp ( - M_PI * M_PI * p->t ) * sin ( M_PI * ( i + 1 ) * dx ) ) );
+    umid = fmax ( umid, p->y[i] );
+  }
+
+  printf ( "\n" );
+  printf ( "  Final time = %g, after %d steps\n", p->t, n );
+  printf ( "  Max of U fell from 1 to %g; exp(-pi^2 t) = %g\n", umid,
+    exp ( - M_PI * M_PI * p->t ) );
+  printf ( "  Max difference from rk4_stepper = %g\n", diff );
+  printf ( "  Max error against exp(-pi^2 t) sin(pi x) = %g\n", err );
+
+  rk4_par_destroy ( p );
+  rk4_pool_destroy ( pool );
+  rk4_stepper_destroy ( s );
+  free ( y0 );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_traj_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_traj_test writes the predator prey solution to trajectory files.
+
+  Discussion:
+
+    The solution is streamed by rk4_observe() to a row file and to a
+    column file with chunks of 64 records.  Both are mapped back and
+    compared with the trajectory stored by rk4(); no precision is lost.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double *col;
+  double diff;
+  char *filename[2] = { "predator_row.bin", "predator_col.bin" };
+  int i;
+  int j;
+  int k;
+  int layout[2] = { RK4_TRAJ_ROW, RK4_TRAJ_COL };
+  int m = 2;
+  int n = 1000;
+  char *names[2] = { "prey", "predator" };
+  rk4_observer obs;
+  rk4_traj_reader *r;
+  double *t;
+  double tspan[2];
+  rk4_traj_writer *w;
+  double *y;
+  double y0[2];
+
+  printf ( "\n" );
+  printf ( "rk4_traj_test\n" );
+  printf ( "  Stream the predator prey solution to binary trajectory files\n" );
+  printf ( "  and map them back.\n" );
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  rk4 ( predator_deriv, tspan, y0, n, m, t, y );
+
+  printf ( "\n" );
+  printf ( "  File              Records  Names               Max difference\n" );
+  printf ( "\n" );
+
+  for ( k = 0; k < 2; k++ )
+  {
+    w = rk4_traj_open ( filename[k], m, names, layout[k], 64 );
+    obs.observe = rk4_traj_observe;
+    obs.data = w;
+    obs.every = 1;
+    obs.tout_num = 0;
+    obs.tout = NULL;
+    rk4_observe ( predator_deriv, tspan, y0, n, m, &obs );
+    if ( rk4_traj_close ( w ) != 0 )
+    {
+      printf ( "  Error writing \"%s\".\n", filename[k] );
+      continue;
+    }
+
+    r = rk4_traj_map ( filename[k] );
+    if ( r == NULL )
+    {
+      printf ( "  Error reading \"%s\".\n", filename[k] );
+      continue;
+    }
+
+    diff = 0.0;
+    for ( j = 0; j < r->n; j++ )
+    {
+      diff = fmax ( diff, fabs ( rk4_traj_get ( r, j, 0 ) - t[j] ) );
+      for ( i = 0; i < m; i++ )
+      {
+        diff = fmax ( diff, fabs ( rk4_traj_get ( r, j, i + 1 ) - y[i+j*m] ) );
+      }
+    }
+/*
+  A column file can also be scanned one chunk at a time.
+*/
+    if ( r->layout == RK4_TRAJ_COL )
+    {
+      col = rk4_traj_column ( r, 1, 1 );
+      diff = fmax ( diff, fabs ( col[0] - y[0+r->chunk*m] ) );
+    }
+
+    printf ( "  %-16s  %7ld  %s, %s, %-8s  %g\n", filename[k], r->n,
+      r->names[0], r->names[1], r->names[2], diff );
+
+    rk4_traj_unmap ( r );
+  }
+
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ckpt_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_ckpt_test resumes predator prey integrations from checkpoints.
+
+  Discussion:
+
+    A run of 1000 RK4 steps is stopped after 400 steps and checkpointed.
+    rk4_ckpt_run() must not resume from this stepper checkpoint, and
+    must not resume from its own checkpoint when TSPAN changes.  An RK45
+    integration is checkpointed at T = 2 and continued by a second
+    stepper.  All results should be identical to those of uninterrupted
+    runs.  Loading a truncated checkpoint must fail without changing the
+    stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  char buf[512];
+  rk4_ckpt *ck;
+  double c[4] = { 2.0, 0.001, 10.0, 0.002 };
+  double diff;
+  char filename[] = "predator_ckpt.bin";
+  FILE *fp;
+  int i;
+  int m = 2;
+  long int n = 1000;
+  size_t nbyte;
+  rk45_stepper *r1;
+  rk45_stepper *r2;
+  rk4_stepper *s;
+  double *t;
+  int status;
+  double tspan[2];
+  double tspan2[2];
+  double *y;
+  double y0[2];
+  double y1[2];
+
+  printf ( "\n" );
+  printf ( "rk4_ckpt_test\n" );
+  printf ( "  Resume predator prey integrations from checkpoint files.\n" );
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  rk4_ctx ( predator_deriv_ctx, c, tspan, y0, n, m, t, y );
+/*
+  Take 400 of the 1000 steps, save, and "lose" the stepper.
+*/
+  remove ( filename );
+  s = rk4_stepper_create_ctx ( predator_deriv_ctx, c, m, tspan[0], y0 );
+  for ( i = 0; i < 400; i++ )
+  {
+    rk4_stepper_step ( s, ( tspan[1] - tspan[0] ) / ( double ) ( n ) );
+  }
+  ck = rk4_ckpt_create ( filename );
+  rk4_ckpt_save ( ck, s );
+  rk4_ckpt_destroy ( ck );
+
+  rk4_stepper_reset ( s, tspan[0], y0 );
+  rk4_ckpt_load ( filename, s );
+  printf ( "\n" );
+  printf ( "  RK4 checkpoint holds step %ld, T = %g\n", s->step_num, s->t );
+  rk4_stepper_destroy ( s );
+
+  rk4_ckpt_run ( predator_deriv_ctx, c, tspan, y0, n, m, y1, filename, 100 );
+
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( y1[i] - y[i+n*m] ) );
+  }
+  printf ( "  Max difference of RK4 run from rk4_ctx() = %g\n", diff );
+/*
+  The run left its final state.  The same call on [0,2.5] must start
+  from Y0 rather than return it.
+*/
+  s = rk4_stepper_create_ctx ( predator_deriv_ctx, c, m, tspan[0], y0 );
+  rk4_ckpt_load ( filename, s );
+  printf ( "  RK4 run checkpoint holds step %ld, T = %g\n", s->step_num, s->t );
+  rk4_stepper_destroy ( s );
+
+  tspan2[0] = 0.0;
+  tspan2[1] = 2.5;
+  rk4_ctx ( predator_deriv_ctx, c, tspan2, y0, n, m, t, y );
+  rk4_ckpt_run ( predator_deriv_ctx, c, tspan2, y0, n, m, y1, filename, 100 );
+
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( y1[i] - y[i+n*m] ) );
+  }
+  printf ( "  Max difference of RK4 run on [0,2.5] from rk4_ctx() = %g\n",
+    diff );
+/*
+  RK45, stopped at T = 2.
+*/
+  remove ( filename );
+  r1 = rk45_create ( predator_deriv, m, tspan[0], y0, 1.0E-8, 1.0E-8 );
+  rk45_advance ( r1, 2.0 );
+  ck = rk4_ckpt_create ( filename );
+  rk45_ckpt_save ( ck, r1 );
+  rk4_ckpt_destroy ( ck );
+
+  r2 = rk45_create ( predator_deriv, m, tspan[0], y0, 1.0E-8, 1.0E-8 );
+  rk45_ckpt_load ( filename, r2 );
+
+  rk45_advance ( r1, tspan[1] );
+  rk45_advance ( r2, tspan[1] );
+
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( r1->y[i] - r2->y[i] ) );
+  }
+  printf ( "  RK45 steps, uninterrupted = %ld, resumed = %ld\n",
+    r1->step_num, r2->step_num );
+  printf ( "  Max difference of resumed RK45 run = %g\n", diff );
+/*
+  Cut the last vector short.  The load must fail and leave R1 alone.
+*/
+  fp = fopen ( filename, "rb" );
+  nbyte = fread ( buf, 1, sizeof ( buf ), fp );
+  fclose ( fp );
+  fp = fopen ( filename, "wb" );
+  fwrite ( buf, 1, nbyte - sizeof ( double ), fp );
+  fclose ( fp );
+
+  y1[0] = r1->y[0];
+  y1[1] = r1->y[1];
+  status = rk45_ckpt_load ( filename, r1 );
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( r1->y[i] - y1[i] ) );
+  }
+  printf ( "  Truncated RK45 checkpoint: status %d, T = %g, state change %g\n",
+    status, r1->t, diff );
+
+  rk45_destroy ( r1 );
+  rk45_destroy ( r2 );
+  remove ( filename );
+
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void rk45_event_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk45_event_test locates extrema of the predator prey populations.
+
+  Discussion:
+
+    Prey minima and maxima are found where dR/dT changes sign, as
+    non-terminal events.  The event times from a loose tolerance are
+    compared with those from a tight one.  Then the integration is
+    stopped, as a terminal event, when the foxes first reach 2000.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk45_event *ev;
+  int j;
+  int k;
+  int m = 2;
+  double rec[2][41];
+  rk45_stepper *s;
+  int status;
+  double tol[2] = { 1.0E-06, 1.0E-12 };
+  double tspan[2];
+  double y0[2];
+
+  printf ( "\n" );
+  printf ( "rk45_event_test\n" );
+  printf ( "  Locate prey extrema and stop when foxes reach 2000.\n" );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  for ( k = 0; k < 2; k++ )
+  {
+    rec[k][0] = 0.0;
+    ev = rk45_event_create ( 3, predator_event, rec[k] );
+    ev->found = predator_event_found;
+    ev->direction[0] = +1;
+    ev->direction[1] = -1;
+    s = rk45_create ( predator_deriv, m, tspan[0], y0, tol[k], tol[k] );
+    rk45_event_advance ( s, tspan[1], ev );
+    if ( k == 0 )
+    {
+      printf ( "\n" );
+      printf ( "  Tolerance %g: %ld steps, %ld evaluations.\n", tol[k],
+        s->step_num, s->eval_num );
+    }
+    rk45_destroy ( s );
+    rk45_event_destroy ( ev );
+  }
+
+  printf ( "\n" );
+  printf ( "  Event         T             Prey       Error in T\n" );
+  printf ( "\n" );
+  for ( j = 0; j < ( int ) rec[0][0] && j < ( int ) rec[1][0]; j++ )
+  {
+    printf ( "  %-8s  %12.8f  %12.4f  %10.2e\n", 
+      ( rec[0][1+2*j] < 0.0 ) ? "minimum" : "maximum",
+      fabs ( rec[0][1+2*j] ), rec[0][2+2*j], 
+      fabs ( rec[0][1+2*j] ) - fabs ( rec[1][1+2*j] ) );
+  }
+/*
+  Stop when the foxes reach 2000.
+*/
+  rec[0][0] = 0.0;
+  ev = rk45_event_create ( 3, predator_event, rec[0] );
+  ev->direction[0] = +1;
+  ev->direction[1] = -1;
+  ev->direction[2] = +1;
+  ev->terminal[2] = 1;
+  s = rk45_create ( predator_deriv, m, tspan[0], y0, 1.0E-08, 1.0E-08 );
+  status = rk45_event_advance ( s, tspan[1], ev );
+
+  printf ( "\n" );
+  printf ( "  Terminal event: status %d, T = %.8f, foxes = %.8f\n", status,
+    s->t, s->y[1] );
+
+  rk45_destroy ( s );
+  rk45_event_destroy ( ev );
+
+  return;
+}
+/******************************************************************************/
+
+void symp_kepler_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    symp_kepler_test compares energy errors over many Kepler orbits.
+
+  Discussion:
+
+    The orbit has eccentricity 0.6 and period 2 pi.  It is followed for
+    1000 periods by RK4 and by each symplectic method, and the largest
+    energy error seen at the end of each period is reported.  The
+    energy error of RK4 grows steadily; that of a symplectic method
+    stays bounded.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double e = 0.6;
+  double energy[2];
+  int k;
+  int method;
+  int n;
+  rk4_observer obs;
+  int period_num = 1000;
+  double p0[2];
+  double q0[2];
+  rk4_stepper *r;
+  symp_stepper *s;
+  int step_num[2] = { 400, 100 };
+  double y0[4];
+
+  printf ( "\n" );
+  printf ( "symp_kepler_test\n" );
+  printf ( "  Energy error over %d periods of a Kepler orbit, e = %g.\n",
+    period_num, e );
+
+  q0[0] = 1.0 - e;
+  q0[1] = 0.0;
+  p0[0] = 0.0;
+  p0[1] = sqrt ( ( 1.0 + e ) / ( 1.0 - e ) );
+  y0[0] = q0[0];
+  y0[1] = q0[1];
+  y0[2] = p0[0];
+  y0[3] = p0[1];
+
+  obs.observe = kepler_energy_observe;
+  obs.data = energy;
+  obs.tout_num = 0;
+  obs.tout = NULL;
+
+  printf ( "\n" );
+  printf ( "  Method        Order  Steps/period  Force evals   Max |dH|\n" );
+  printf ( "\n" );
+
+  for ( k = 0; k < 2; k++ )
+  {
+    n = step_num[k] * period_num;
+    obs.every = step_num[k];
+
+    energy[0] = 0.0;
+    energy[1] = 0.0;
+    r = rk4_stepper_create ( kepler_deriv, 4, 0.0, y0 );
+    rk4_stepper_observe ( r, 2.0 * M_PI * period_num, n, &obs );
+    printf ( "  %-12s  %5d  %12d  %11ld  %10.2e\n", "rk4", 4, step_num[k],
+      4 * r->step_num, energy[1] );
+    rk4_stepper_destroy ( r );
+
+    for ( method = SYMP_VERLET; method <= SYMP_FOREST_RUTH; method++ )
+    {
+      energy[0] = 0.0;
+      energy[1] = 0.0;
+      s = symp_create ( method, kepler_dqdt, kepler_dpdt, NULL, 2, 0.0, q0,
+        p0 );
+      symp_observe ( s, 2.0 * M_PI * period_num, n, &obs );
+      printf ( "  %-12s  %5d  %12d  %11ld  %10.2e\n", symp_name ( method ),
+        symp_order ( method ), step_num[k], s->eval_num, energy[1] );
+      symp_destroy ( s );
+    }
+    printf ( "\n" );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_parareal_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_parareal_test solves the predator prey ODE by Parareal.
+
+  Discussion:
+
+    The fine solution is RK4 with 640000 steps over [0,5], cut into 32
+    slices.  The Parareal result and time are compared with those of
+    rk4_ctx() with the same steps.  The measured speedup depends on the
+    number of processors; the iteration count bounds it by 32 / K.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double c[4] = { 2.0, 0.001, 10.0, 0.002 };
+  double diff;
+  int fine_n = 20000;
+  int i;
+  int iter_num;
+  int m = 2;
+  rk4_pool *pool;
+  int slice_num = 32;
+  int status;
+  double *t;
+  double time_par;
+  double time_ser;
+  double tspan[2];
+  double *y;
+  double *yp;
+  double y0[2];
+
+  printf ( "\n" );
+  printf ( "rk4_parareal_test\n" );
+  printf ( "  Solve the predator prey ODE by Parareal and compare with\n" );
+  printf ( "  serial rk4_ctx().\n" );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  t = ( double * ) malloc ( ( slice_num * fine_n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( slice_num * fine_n + 1 ) * m * sizeof ( double ) );
+  yp = ( double * ) malloc ( ( slice_num + 1 ) * m * sizeof ( double ) );
+
+  time_ser = wtime ( );
+  rk4_ctx ( predator_deriv_ctx, c, tspan, y0, slice_num * fine_n, m, t, y );
+  time_ser = wtime ( ) - time_ser;
+
+  pool = rk4_pool_create ( 0 );
+
+  time_par = wtime ( );
+  status = rk4_parareal ( predator_deriv_ctx, c, tspan, y0, m, slice_num,
+    10, fine_n, 1.0E-10, slice_num, pool, yp, &iter_num );
+  time_par = wtime ( ) - time_par;
+
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( yp[i+slice_num*m] - y[i+slice_num*fine_n*m] )
+      / fabs ( y[i+slice_num*fine_n*m] ) );
+  }
+
+  printf ( "\n" );
+  printf ( "  Threads = %d, slices = %d, status = %d\n", 
+    rk4_pool_size ( pool ), slice_num, status );
+  printf ( "  Iterations = %d, speedup bound = %g\n", iter_num,
+    ( double ) slice_num / ( double ) iter_num );
+  printf ( "  Max relative difference from rk4_ctx() = %g\n", diff );
+  printf ( "  Serial time = %g s, Parareal time = %g s, speedup = %g\n",
+    time_ser, time_par, time_ser / time_par );
+
+  rk4_pool_destroy ( pool );
+  free ( t );
+  free ( y );
+  free ( yp );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_sens_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_sens_test finds the sensitivities of the predator prey solution.
+
+  Discussion:
+
+    dY/dC at T = 5 is found for the four coefficients C, with the exact
+    Jacobian vector product and with the difference quotient fallback.
+    Both are compared with central differences of whole rk4_ctx() runs,
+    which need two runs per parameter.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double c[4] = { 2.0, 0.001, 10.0, 0.002 };
+  double cp[4];
+  double d;
+  double diff[2];
+  double h;
+  int i;
+  int j;
+  int k;
+  int m = 2;
+  int n = 10000;
+  int np = 4;
+  rk4_sens *sn[2];
+  double *t;
+  double tspan[2];
+  double *y;
+  double ydiff;
+  double yfd[2][2];
+  double y0[2];
+
+  printf ( "\n" );
+  printf ( "rk4_sens_test\n" );
+  printf ( "  Sensitivities of the predator prey solution to C[0:3].\n" );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  sn[0] = rk4_sens_create ( predator_deriv_ctx, predator_sens, c, np, m,
+    tspan[0], y0, NULL );
+  sn[1] = rk4_sens_create ( predator_deriv_ctx, NULL, c, np, m,
+    tspan[0], y0, NULL );
+  rk4_sens_advance ( sn[0], tspan[1], n );
+  rk4_sens_advance ( sn[1], tspan[1], n );
+
+  rk4_ctx ( predator_deriv_ctx, c, tspan, y0, n, m, t, y );
+  ydiff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    ydiff = fmax ( ydiff, fabs ( sn[0]->y[i] - y[i+n*m] ) );
+  }
+
+  printf ( "\n" );
+  printf ( "  Max difference of Y from rk4_ctx() = %g\n", ydiff );
+  printf ( "\n" );
+  printf ( "   J   dPrey/dC[J]    dFox/dC[J]     JVP error    Fallback error\n" );
+  printf ( "\n" );
+
+  for ( j = 0; j < np; j++ )
+  {
+    for ( k = 0; k < 2; k++ )
+    {
+      for ( i = 0; i < np; i++ )
+      {
+        cp[i] = c[i];
+      }
+      h = 1.0E-05 * c[j];
+      cp[j] = c[j] + ( 2 * k - 1 ) * h;
+      rk4_ctx ( predator_deriv_ctx, cp, tspan, y0, n, m, t, y );
+      yfd[k][0] = y[0+n*m];
+      yfd[k][1] = y[1+n*m];
+    }
+    for ( k = 0; k < 2; k++ )
+    {
+      diff[k] = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        d = ( yfd[1][i] - yfd[0][i] ) / ( 2.0 * h );
+        diff[k] = fmax ( diff[k], fabs ( sn[k]->s[i+j*m] - d ) / fabs ( d ) );
+      }
+    }
+    printf ( "  %2d  %12.4e  %12.4e  %12.2e  %12.2e\n", j, sn[0]->s[0+j*m],
+      sn[0]->s[1+j*m], diff[0], diff[1] );
+  }
+
+  rk4_sens_destroy ( sn[0] );
+  rk4_sens_destroy ( sn[1] );
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_stats_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_stats_test checks the instrumentation counters.
+
+  Discussion:
+
+    The predator prey problem is solved with an RK4 stepper and with
+    rk45, and the counts of rk4_stats are compared with those kept by
+    the steppers.  Unless the library was built with RK4_STATS, the
+    counts are all zero.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double c[4] = { 2.0, 0.001, 10.0, 0.002 };
+  int m = 2;
+  int n = 1000;
+  rk45_stepper *s45;
+  rk4_stepper *s4;
+  rk4_stats stats;
+  double y0[2] = { 5000.0, 100.0 };
+
+  printf ( "\n" );
+  printf ( "rk4_stats_test\n" );
+  printf ( "  Count the work of an RK4 and an RK45 run.\n" );
+
+  rk4_stats_reset ( );
+
+  s4 = rk4_stepper_create_ctx ( predator_deriv_ctx, c, m, 0.0, y0 );
+  rk4_stepper_advance ( s4, 5.0, n );
+  s45 = rk45_create ( predator_deriv, m, 0.0, y0, 1.0E-08, 1.0E-08 );
+  rk45_advance ( s45, 5.0 );
+
+  rk4_stats_get ( &stats );
+
+  printf ( "\n" );
+  printf ( "  Statistics:\n" );
+  printf ( "  " );
+  rk4_stats_json ( stdout, &stats, "  " );
+  printf ( "\n" );
+
+  if ( stats.enabled )
+  {
+    printf ( "\n" );
+    printf ( "  Steps:     %lld counted, %ld taken.\n", stats.step_num,
+      s4->step_num + s45->step_num );
+    printf ( "  RHS calls: %lld counted, %ld made.\n", stats.eval_num,
+      4 * s4->step_num + s45->eval_num );
+    printf ( "  Rejected:  %lld counted, %ld made.\n", stats.reject_num,
+      s45->reject_num );
+  }
+
+  rk4_stepper_destroy ( s4 );
+  rk45_destroy ( s45 );
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_mr_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    rk4_mr_test compares multirate RK4 with single rate RK4.
+
+  Discussion:
+
+    A fast oscillator is coupled to MS slowly decaying components.
+    Single rate RK4 must use the small step for all of them; the
+    multirate integrator uses it only for the oscillator.  Both are
+    compared with a reference run at a ten times smaller step.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double err_mr;
+  double err_sr;
+  int i;
+  int m;
+  int mf = 2;
+  rk4_mr *mr;
+  int ms = 200;
+  int n = 100;
+  int sub_num = 10;
+  double *t;
+  double tspan[2];
+  double *y;
+  double *yref;
+  double *y0;
+
+  printf ( "\n" );
+  printf ( "rk4_mr_test\n" );
+  printf ( "  Multirate RK4 for %d fast and %d slow components.\n", mf, ms );
+
+  m = mf + ms;
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+
+  y0 = ( double * ) malloc ( m * sizeof ( double ) );
+  y0[0] = 1.0;
+  y0[1] = 0.0;
+  for ( i = 0; i < ms; i++ )
+  {
+    y0[mf+i] = 1.0;
+  }
+
+  t = ( double * ) malloc ( ( 10 * n * sub_num + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( 10 * n * sub_num + 1 ) * m * sizeof ( double ) );
+  yref = ( double * ) malloc ( m * sizeof ( double ) );
+
+  rk4_ctx ( twoscale_deriv, &ms, tspan, y0, 10 * n * sub_num, m, t, y );
+  for ( i = 0; i < m; i++ )
+  {
+    yref[i] = y[i+10*n*sub_num*m];
+  }
+
+  rk4_ctx ( twoscale_deriv, &ms, tspan, y0, n * sub_num, m, t, y );
+  err_sr = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    err_sr = fmax ( err_sr, fabs ( y[i+n*sub_num*m] - yref[i] ) );
+  }
+
+  mr = rk4_mr_create ( twoscale_fast, twoscale_slow, &ms, mf, ms, sub_num,
+    tspan[0], y0 );
+  rk4_mr_advance ( mr, tspan[1], n );
+  err_mr = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    err_mr = fmax ( err_mr, fabs ( mr->y[i] - yref[i] ) );
+  }
+
+  printf ( "\n" );
+  printf ( "  Method       Steps   Component evaluations   Max error\n" );
+  printf ( "\n" );
+  printf ( "  Single rate  %5d   %21ld   %9.2e\n", n * sub_num,
+    4L * n * sub_num * m, err_sr );
+  printf ( "  Multirate    %5ld   %21ld   %9.2e\n", mr->step_num,
+    mr->fast_eval_num * mf + mr->slow_eval_num * ms, err_mr );
+
+  rk4_mr_destroy ( mr );
+  free ( t );
+  free ( y );
+  free ( yref );
+  free ( y0 );
+
+  return;
+}
+/******************************************************************************/
+
+void imex_fisher_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    imex_fisher_test solves a stiff reaction diffusion problem with IMEX.
+
+  Discussion:
+
+    The diffusion term of the Fisher equation is treated implicitly,
+    with a tridiagonal solve, and the reaction explicitly.  Explicit RK4
+    would need DT < 2.8 DX^2 / ( 4 D ), about 7E-05, to be stable.  The
+    errors are measured against RK4 at DT = 1E-05.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  fisher_ctx ctx;
+  double dt;
+  double err;
+  double err_old[2];
+  int i;
+  int k;
+  int m = 100;
+  int method;
+  int n;
+  imex_stepper *s;
+  rk4_stepper *sr;
+  double tspan[2];
+  double *y0;
+
+  printf ( "\n" );
+  printf ( "imex_fisher_test\n" );
+  printf ( "  IMEX ARK3 and ARK4 for the Fisher equation, M = %d.\n", m );
+
+  ctx.m = m;
+  ctx.d = 1.0;
+  ctx.r = 10.0;
+  ctx.gh = 0.0;
+  ctx.lu = ( double * ) malloc ( 3 * m * sizeof ( double ) );
+
+  tspan[0] = 0.0;
+  tspan[1] = 0.2;
+
+  y0 = ( double * ) malloc ( m * sizeof ( double ) );
+  for ( i = 0; i < m; i++ )
+  {
+    y0[i] = sin ( M_PI * ( double ) ( i + 1 ) / ( double ) ( m + 1 ) );
+  }
+
+  sr = rk4_stepper_create_ctx ( fisher_deriv, &ctx, m, tspan[0], y0 );
+  rk4_stepper_advance ( sr, tspan[1], 20000 );
+
+  printf ( "\n" );
+  printf ( "  Method     DT       Solves   Max error    Ratio\n" );
+  printf ( "\n" );
+
+  for ( k = 0; k < 2; k++ )
+  {
+    err_old[k] = 0.0;
+  }
+
+  for ( n = 10; n <= 80; n = 2 * n )
+  {
+    dt = ( tspan[1] - tspan[0] ) / ( double ) n;
+    for ( k = 0; k < 2; k++ )
+    {
+      method = ( k == 0 ) ? IMEX_ARK3 : IMEX_ARK4;
+      s = imex_create ( method, fisher_fe, fisher_fi, fisher_solve, &ctx, m,
+        tspan[0], y0 );
+      imex_advance ( s, tspan[1], n );
+      err = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        err = fmax ( err, fabs ( s->y[i] - sr->y[i] ) );
+      }
+      if ( err_old[k] == 0.0 )
+      {
+        printf ( "  %s   %7.4f  %6ld   %10.3e\n",
+          ( k == 0 ) ? "ARK3" : "ARK4", dt, s->solve_num, err );
+      }
+      else
+      {
+        printf ( "  %s   %7.4f  %6ld   %10.3e   %6.2f\n",
+          ( k == 0 ) ? "ARK3" : "ARK4", dt, s->solve_num, err,
+          err_old[k] / err );
+      }
+      err_old[k] = err;
+      imex_destroy ( s );
+    }
+  }
+
+  rk4_stepper_destroy ( sr );
+  free ( ctx.lu );
+  free ( y0 );
+
+  return;
+}
+/******************************************************************************/
+
+void lsrk_predator_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    lsrk_predator_test checks the order of the low storage RK methods.
+
+  Discussion:
+
+    Each method is run with N and 2 N steps on the predator prey ODE,
+    and compared with RK4 at a much smaller step.  Halving the step
+    should divide the error by about 8 for the third order method and
+    16 for the fourth order one.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double err[2];
+  int i;
+  int k;
+  char *label[2] = { "W3", "CK4" };
+  int m = 2;
+  int method;
+  int n = 500;
+  int nref = 20000;
+  rk4_observer obs;
+  lsrk_stepper *s;
+  double *t;
+  double tout[5] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+  double tspan[2];
+  double *y;
+  double y0[2];
+  double yref[2];
+
+  printf ( "\n" );
+  printf ( "lsrk_predator_test\n" );
+  printf ( "  Low storage 2N Runge-Kutta methods on the predator prey ODE.\n" );
+  printf ( "  Each stepper keeps 2 vectors of length M; rk4_stepper keeps 6.\n" );
+
+  tspan[0] = 0.0;
+  tspan[1] = 5.0;
+  y0[0] = 5000.0;
+  y0[1] = 100.0;
+
+  t = ( double * ) malloc ( ( nref + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( nref + 1 ) * m * sizeof ( double ) );
+  rk4 ( predator_deriv, tspan, y0, nref, m, t, y );
+  yref[0] = y[0+nref*m];
+  yref[1] = y[1+nref*m];
+
+  printf ( "\n" );
+  printf ( "  Method  Stages  Error N=%d  Error N=%d   Ratio\n", n, 2 * n );
+  printf ( "\n" );
+
+  for ( method = LSRK_WILLIAMSON3; method <= LSRK_CK4; method++ )
+  {
+    for ( k = 0; k < 2; k++ )
+    {
+      s = lsrk_create ( method, predator_deriv_acc, NULL, m, tspan[0], y0 );
+      lsrk_advance ( s, tspan[1], n << k );
+      err[k] = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        err[k] = fmax ( err[k], fabs ( s->y[i] - yref[i] ) / fabs ( yref[i] ) );
+      }
+      if ( k == 1 )
+      {
+        printf ( "  %-6s  %6d  %11.3e  %12.3e  %6.2f\n", label[method],
+          s->stage_num, err[0], err[1], err[0] / err[1] );
+      }
+      lsrk_destroy ( s );
+    }
+  }
+/*
+  The observer is handed the stepper's own state.
+*/
+  obs.observe = predator_print_observe;
+  obs.data = label[LSRK_CK4];
+  obs.every = 0;
+  obs.tout_num = 5;
+  obs.tout = tout;
+
+  printf ( "\n" );
+  printf ( "  Output at requested times:\n" );
+  printf ( "\n" );
+  s = lsrk_create ( LSRK_CK4, predator_deriv_acc, NULL, m, tspan[0], y0 );
+  lsrk_observe ( s, tspan[1], 2 * n, &obs );
+  lsrk_destroy ( s );
+
+  free ( t );
+  free ( y );
+
+  return;
+}
+/******************************************************************************/
+
+void bs_kepler_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    bs_kepler_test compares extrapolation with Dormand-Prince on an orbit.
+
+  Discussion:
+
+    The Kepler orbit of eccentricity 0.6 is followed for 10 periods, after
+    which the exact solution is the initial condition again.  At tight
+    tolerances the high order of the extrapolation method saves most of
+    the evaluations.  The last run spreads the tableau over a pool of
+    threads, and must give the same result.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double diff;
+  double e = 0.6;
+  double err_bs;
+  double err_rk45;
+  long int eval_num;
+  int i;
+  int k;
+  int m = 4;
+  int period_num = 10;
+  rk4_pool *pool;
+  double rtol[3] = { 1.0E-08, 1.0E-10, 1.0E-12 };
+  bs_stepper *s;
+  bs_stepper *sp;
+  int status;
+  double tspan[2];
+  double y[4];
+  double y0[4];
+
+  printf ( "\n" );
+  printf ( "bs_kepler_test\n" );
+  printf ( "  Bulirsch-Stoer and rk45 over %d Kepler periods, e = %g.\n",
+    period_num, e );
+
+  y0[0] = 1.0 - e;
+  y0[1] = 0.0;
+  y0[2] = 0.0;
+  y0[3] = sqrt ( ( 1.0 + e ) / ( 1.0 - e ) );
+  tspan[0] = 0.0;
+  tspan[1] = 2.0 * M_PI * period_num;
+
+  printf ( "\n" );
+  printf ( "     RTOL    BS evals   BS error  Steps  Rejects"
+    "  rk45 evals  rk45 error\n" );
+  printf ( "\n" );
+
+  for ( k = 0; k < 3; k++ )
+  {
+    s = bs_create ( kepler_deriv_ctx, NULL, m, tspan[0], y0, rtol[k],
+      rtol[k], NULL );
+    bs_advance ( s, tspan[1] );
+    err_bs = 0.0;
+    for ( i = 0; i < m; i++ )
+    {
+      err_bs = fmax ( err_bs, fabs ( s->y[i] - y0[i] ) );
+    }
+
+    rk45 ( kepler_deriv, tspan, y0, m, rtol[k], rtol[k], y, &eval_num );
+    err_rk45 = 0.0;
+    for ( i = 0; i < m; i++ )
+    {
+      err_rk45 = fmax ( err_rk45, fabs ( y[i] - y0[i] ) );
+    }
+
+    printf ( "  %7.0e  %10ld  %9.2e  %5ld  %7ld  %10ld  %10.2e\n", rtol[k],
+      s->eval_num, err_bs, s->step_num, s->reject_num, eval_num, err_rk45 );
+
+    if ( k < 2 )
+    {
+      bs_destroy ( s );
+    }
+  }
+
+  pool = rk4_pool_create ( 3 );
+  sp = bs_create ( kepler_deriv_ctx, NULL, m, tspan[0], y0, rtol[2], rtol[2],
+    pool );
+  bs_advance ( sp, tspan[1] );
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( sp->y[i] - s->y[i] ) );
+  }
+  printf ( "\n" );
+  printf ( "  With %d threads, max difference from 1 thread = %g\n",
+    rk4_pool_size ( pool ), diff );
+
+  bs_destroy ( sp );
+  bs_destroy ( s );
+  rk4_pool_destroy ( pool );
+/*
+  Every step of a NaN right hand side is rejected.  Starting at T = 0,
+  the stepsize must still reach a positive minimum and fail.
+*/
+  s = bs_create ( nan_deriv_ctx, &m, m, 0.0, y0, rtol[0], rtol[0], NULL );
+  status = bs_advance ( s, 1.0 );
+  printf ( "\n" );
+  printf ( "  NaN right hand side: status %d at T = %g after %ld rejections\n",
+    status, s->t, s->reject_num );
+  bs_destroy ( s );
+/*
+  A far T1 must not make the first, short step fail.
+*/
+  y[0] = 0.0;
+  for ( k = 0; k < 2; k++ )
+  {
+    s = bs_create ( relax_deriv_ctx, NULL, 1, 0.0, y, rtol[0], rtol[0],
+      NULL );
+    status = bs_step ( s, ( k == 0 ) ? 10.0 : 1.0E+09 );
+    printf ( "  Stiff relaxation, first step towards T1 = %g: status %d, "
+      "T = %g\n", ( k == 0 ) ? 10.0 : 1.0E+09, status, s->t );
+    bs_destroy ( s );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void sde_strong_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    sde_strong_test measures the strong order of the SDE methods.
+
+  Discussion:
+
+    Each member draws one Brownian path on NF fine steps.  A coarse step
+    of the path sums the fine increments; the integral of W over the
+    coarse step is the sum of the fine integrals plus the fine step
+    times the increments accumulated so far.  The strong error is the
+    mean over members of the error at T = 1.
+
+    Geometric Brownian motion, dY = MU Y dT + SIGMA Y dW, has the exact
+    solution Y0 exp ( ( MU - SIGMA^2 / 2 ) T + SIGMA W(T) ).  The additive
+    problem is compared with SRA on the fine steps.
+
+    Halving the step should divide the error by about 1.4 for Euler,
+    2 for Milstein and 2.8 for SRI and SRA.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  unsigned int ctr[4] = { 0, 0, 0, 0 };
+  double dt;
+  double *dw;
+  double dwc[2];
+  double *dz;
+  double dzc[2];
+  int e;
+  double err[4];
+  double gbm[4] = { 1.5, -0.5, 0.8, 0.3 };
+  double hf;
+  int i;
+  int j;
+  unsigned int key[2] = { 0, 0 };
+  int l;
+  int m = 2;
+  int method;
+  char *name[4] = { "Euler", "Milstein", "SRI", "SRA" };
+  int nens = 1000;
+  int nf = 1024;
+  unsigned int out[4];
+  int problem;
+  int q;
+  int r;
+  sde_stepper *s;
+  unsigned long long int seed = 2026;
+  double wt;
+  double y0[2] = { 1.0, 1.0 };
+  double yref[2];
+
+  printf ( "\n" );
+  printf ( "sde_strong_test\n" );
+  printf ( "  Strong errors at T = 1, mean over %d paths.\n", nens );
+
+  philox4x32 ( ctr, key, out );
+  printf ( "\n" );
+  printf ( "  Philox4x32-10 ( 0, 0 ) = %08x %08x %08x %08x\n",
+    out[0], out[1], out[2], out[3] );
+  printf ( "  Expected                = 6627e8d5 e169c58d bc57ac4c 9b00dbd8\n" );
+
+  hf = 1.0 / ( double ) nf;
+  dw = ( double * ) malloc ( nf * m * sizeof ( double ) );
+  dz = ( double * ) malloc ( nf * m * sizeof ( double ) );
+
+  printf ( "\n" );
+  printf ( "  Problem   Method      N=16       N=32       N=64      N=128"
+    "   Last ratio\n" );
+  printf ( "\n" );
+
+  for ( problem = 0; problem < 2; problem++ )
+  {
+    for ( method = SDE_EULER; method <= SDE_SRA; method++ )
+    {
+      if ( problem == 0 && method == SDE_SRA )
+      {
+        continue;
+      }
+      for ( q = 0; q < 4; q++ )
+      {
+        err[q] = 0.0;
+      }
+      for ( e = 0; e < nens; e++ )
+      {
+        for ( j = 0; j < nf; j++ )
+        {
+          sde_noise ( seed, e, j, m, hf, dw + j * m, dz + j * m );
+        }
+
+        if ( problem == 0 )
+        {
+          for ( i = 0; i < m; i++ )
+          {
+            wt = 0.0;
+            for ( j = 0; j < nf; j++ )
+            {
+              wt = wt + dw[i+j*m];
+            }
+            yref[i] = y0[i] * exp ( ( gbm[i] - 0.5 * gbm[2+i] * gbm[2+i] )
+              + gbm[2+i] * wt );
+          }
+        }
+        else
+        {
+          s = sde_create ( SDE_SRA, ou_drift, ou_diffusion, NULL, m, 0.0, y0,
+            seed, e );
+          for ( j = 0; j < nf; j++ )
+          {
+            sde_step ( s, hf, dw + j * m, dz + j * m );
+          }
+          yref[0] = s->y[0];
+          yref[1] = s->y[1];
+          sde_destroy ( s );
+        }
+
+        for ( q = 0; q < 4; q++ )
+        {
+          r = nf / ( 16 << q );
+          dt = r * hf;
+          if ( problem == 0 )
+          {
+            s = sde_create ( method, gbm_drift, gbm_diffusion, gbm, m, 0.0,
+              y0, seed, e );
+          }
+          else
+          {
+            s = sde_create ( method, ou_drift, ou_diffusion, NULL, m, 0.0,
+              y0, seed, e );
+          }
+          for ( j = 0; j < nf; j = j + r )
+          {
+            for ( i = 0; i < m; i++ )
+            {
+              dwc[i] = 0.0;
+              dzc[i] = 0.0;
+              for ( l = j; l < j + r; l++ )
+              {
+                dzc[i] = dzc[i] + dz[i+l*m] + hf * dwc[i];
+                dwc[i] = dwc[i] + dw[i+l*m];
+              }
+            }
+            sde_step ( s, dt, dwc, dzc );
+          }
+          for ( i = 0; i < m; i++ )
+          {
+            err[q] = err[q] + fabs ( s->y[i] - yref[i] ) / ( double ) ( nens );
+          }
+          sde_destroy ( s );
+        }
+      }
+      printf ( "  %-8s  %-8s  %9.2e  %9.2e  %9.2e  %9.2e  %8.2f\n",
+        ( problem == 0 ) ? "GBM" : "Additive", name[method], err[0], err[1],
+        err[2], err[3], err[2] / err[3] );
+    }
+  }
+
+  free ( dw );
+  free ( dz );
+
+  return;
+}
+/******************************************************************************/
+
+void sde_predator_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    sde_predator_test runs a noisy predator prey ensemble in parallel.
+
+  Discussion:
+
+    Each population gets multiplicative noise of intensity SIGMA.  The
+    ensemble is run on one thread and on a pool of three, and each
+    member must come out bit for bit the same.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double diff;
+  int e;
+  int i;
+  int m = 2;
+  double mean[2];
+  int n = 1000;
+  int nens = 200;
+  rk4_pool *pool;
+  double *result1;
+  double *result3;
+  double param[5] = { 2.0, 0.001, 10.0, 0.002, 0.1 };
+  double sd[2];
+  int status;
+  double tspan[2] = { 0.0, 5.0 };
+  double y0[2] = { 5000.0, 100.0 };
+
+  printf ( "\n" );
+  printf ( "sde_predator_test\n" );
+  printf ( "  SRI ensemble of %d noisy predator prey paths, sigma = %g.\n",
+    nens, param[4] );
+
+  result1 = ( double * ) malloc ( nens * m * sizeof ( double ) );
+  result3 = ( double * ) malloc ( nens * m * sizeof ( double ) );
+
+  sde_ensemble ( SDE_SRI, predator_deriv_ctx, predator_diffusion, param, m,
+    nens, tspan, y0, n, 42, NULL, result1 );
+
+  pool = rk4_pool_create ( 3 );
+  status = sde_ensemble ( SDE_SRI, predator_deriv_ctx, predator_diffusion,
+    param, m, nens, tspan, y0, n, 42, pool, result3 );
+  rk4_pool_destroy ( pool );
+
+  diff = 0.0;
+  for ( i = 0; i < nens * m; i++ )
+  {
+    diff = fmax ( diff, fabs ( result3[i] - result1[i] ) );
+  }
+
+  for ( i = 0; i < m; i++ )
+  {
+    mean[i] = 0.0;
+    sd[i] = 0.0;
+    for ( e = 0; e < nens; e++ )
+    {
+      mean[i] = mean[i] + result1[i+e*m] / ( double ) ( nens );
+    }
+    for ( e = 0; e < nens; e++ )
+    {
+      sd[i] = sd[i] + ( result1[i+e*m] - mean[i] )
+        * ( result1[i+e*m] - mean[i] ) / ( double ) ( nens - 1 );
+    }
+    sd[i] = sqrt ( sd[i] );
+  }
+
+  printf ( "\n" );
+  printf ( "  At T = %g: rabbits %.1f +- %.1f, foxes %.1f +- %.1f\n",
+    tspan[1], mean[0], sd[0], mean[1], sd[1] );
+  printf ( "  Status with 3 threads = %d, max difference from 1 thread = %g\n",
+    status, diff );
+
+  free ( result1 );
+  free ( result3 );
+
+  return;
+}
+/******************************************************************************/
+
+void dde_delay_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    dde_delay_test solves delay equations with constant and state
+    dependent delays.
+
+  Discussion:
+
+    Y'(T) = - Y(T-1), with Y = 1 for T <= 0, has the exact solution
+
+      sum ( 0 <= K <= T + 1 ) ( -1 )^K ( T - K + 1 )^K / K!,
+
+    a polynomial of degree 6 on [5,6].  The delay is a whole number of
+    steps, so RK4 with Hermite interpolation keeps its fourth order.
+
+    In the predator prey model, foxes respond to the rabbit density a
+    lag TAU ago, where TAU shrinks as rabbits become plentiful.  The
+    ring size depends on TAU_MAX / DT only, however long the run.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double err[3];
+  double exact;
+  int k;
+  int n[3] = { 10, 20, 40 };
+  dde_stepper *s;
+  dde_stepper *s2;
+  int status;
+  double t;
+  double tau_max = 0.05;
+  double term;
+
+  printf ( "\n" );
+  printf ( "dde_delay_test\n" );
+  printf ( "  RK4 for delay differential equations.\n" );
+
+  t = 6.0;
+  exact = 0.0;
+  term = 1.0;
+  for ( k = 0; k <= 7; k++ )
+  {
+    if ( 0 < k )
+    {
+      term = - term / ( double ) k;
+    }
+    exact = exact + term * pow ( t - k + 1.0, k );
+  }
+
+  printf ( "\n" );
+  printf ( "  Y'(T) = - Y(T-1), error at T = %g:\n", t );
+  printf ( "\n" );
+  printf ( "  Steps/unit  Slots  Steps    Error      Ratio\n" );
+  printf ( "\n" );
+  for ( k = 0; k < 3; k++ )
+  {
+    s = dde_create ( lag_deriv, lag_history, NULL, 1, 0.0,
+      1.0 / ( double ) n[k], 1.0 );
+    dde_advance ( s, t );
+    err[k] = fabs ( s->y[0] - exact );
+    if ( k == 0 )
+    {
+      printf ( "  %10d  %5d  %5ld  %9.2e\n", n[k], s->slot_num,
+        s->step_num, err[k] );
+    }
+    else
+    {
+      printf ( "  %10d  %5d  %5ld  %9.2e  %6.2f\n", n[k], s->slot_num,
+        s->step_num, err[k], err[k-1] / err[k] );
+    }
+    dde_destroy ( s );
+  }
+
+  printf ( "\n" );
+  printf ( "  Predator prey with a state dependent lag, TAU_MAX = %g:\n",
+    tau_max );
+  printf ( "\n" );
+
+  s = dde_create ( predator_delay_deriv, predator_delay_history, NULL, 2,
+    0.0, 0.001, tau_max );
+  s2 = dde_create ( predator_delay_deriv, predator_delay_history, NULL, 2,
+    0.0, 0.0005, tau_max );
+  for ( k = 1; k <= 5; k++ )
+  {
+    status = dde_advance ( s, ( double ) k );
+    status = status + dde_advance ( s2, ( double ) k );
+    printf ( "  T = %g  R = %12.6f  F = %12.6f  diff DT/2 = %8.2e\n", s->t,
+      s->y[0], s->y[1], fmax ( fabs ( s->y[0] - s2->y[0] ),
+      fabs ( s->y[1] - s2->y[1] ) ) );
+  }
+  printf ( "\n" );
+  printf ( "  %ld steps kept in %d ring slots, status %d.\n", s->step_num,
+    s->slot_num, status );
+
+  dde_destroy ( s );
+  dde_destroy ( s2 );
+
+  return;
+}
+/******************************************************************************/
+
+void expr_predator_test ( ) 
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    expr_predator_test runs the predator prey model compiled from text.
+
+  Discussion:
+
+    The compiled model is checked against the C right hand sides, for
+    one trajectory with rk4_ctx() and for an ensemble, and the ensemble
+    is timed both ways.  Powers of a negative and a zero constant are
+    checked against pow(), and some faulty texts, including deeply
+    nested ones, show the error messages.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  char *bad[4] = {
+    "r' = a * r\n",
+    "a = 2\nr' = a * r -\n",
+    "r' = r; r' = 2 * r\n",
+    "r' = sinh ( r )\n" };
+  double best[2];
+  double diff;
+  rk4_ensemble *e[2];
+  char error[EXPR_ERROR_LEN];
+  double fp[3];
+  int i;
+  int j;
+  int k;
+  int m = 2;
+  int n = 1000;
+  int nens = 4096;
+  char *nest;
+  expr_program *p;
+  char *power = "x' = ( -2 ) ^ y; y' = 0 ^ y; z' = 2 ^ y\n";
+  int r;
+  double seconds;
+  char *text =
+    "# Predator prey.\n"
+    "a = 2; b = 0.001; c = 10; d = 0.002\n"
+    "r' = a * r - b * r * f\n"
+    "f' = - c * f + d * r * f\n";
+  double tspan[2] = { 0.0, 5.0 };
+  double *t;
+  double *y;
+  double y0[2] = { 5000.0, 100.0 };
+  double y1[2];
+  double y2[2];
+  double *ye;
+  double yp[3];
+
+  printf ( "\n" );
+  printf ( "expr_predator_test\n" );
+  printf ( "  A right hand side compiled from text at run time.\n" );
+  printf ( "\n" );
+  printf ( "%s", text );
+  printf ( "\n" );
+
+  p = expr_compile ( text, error );
+  expr_print ( p );
+
+  t = ( double * ) malloc ( ( n + 1 ) * sizeof ( double ) );
+  y = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+  ye = ( double * ) malloc ( ( n + 1 ) * m * sizeof ( double ) );
+
+  rk4 ( predator_deriv, tspan, y0, n, m, t, y );
+  rk4_ctx ( expr_deriv, p, tspan, y0, n, m, t, ye );
+  diff = 0.0;
+  for ( i = 0; i < ( n + 1 ) * m; i++ )
+  {
+    diff = fmax ( diff, fabs ( ye[i] - y[i] ) / fabs ( y[i] ) );
+  }
+  printf ( "\n" );
+  printf ( "  rk4_ctx() max relative difference from C = %g\n", diff );
+/*
+  The ensemble, with the C right hand side and the compiled one.
+*/
+  for ( r = 0; r < 3; r++ )
+  {
+    for ( j = 0; j < 2; j++ )
+    {
+      if ( j == 0 )
+      {
+        e[j] = rk4_ensemble_create ( predator_deriv_batch, m, nens, 0.0 );
+      }
+      else
+      {
+        e[j] = rk4_ensemble_create_ctx ( expr_deriv_batch, p, m, nens, 0.0 );
+      }
+      for ( k = 0; k < nens; k++ )
+      {
+        y1[0] = 5000.0 + 0.25 * k;
+        y1[1] = 100.0 + 0.025 * k;
+        rk4_ensemble_set ( e[j], k, y1 );
+      }
+      seconds = wtime ( );
+      rk4_ensemble_advance ( e[j], 1.0, 200 );
+      seconds = wtime ( ) - seconds;
+      if ( r == 0 || seconds < best[j] )
+      {
+        best[j] = seconds;
+      }
+      if ( r < 2 )
+      {
+        rk4_ensemble_destroy ( e[j] );
+      }
+    }
+  }
+
+  diff = 0.0;
+  for ( k = 0; k < nens; k++ )
+  {
+    rk4_ensemble_get ( e[0], k, y1 );
+    rk4_ensemble_get ( e[1], k, y2 );
+    for ( i = 0; i < m; i++ )
+    {
+      diff = fmax ( diff, fabs ( y2[i] - y1[i] ) / fabs ( y1[i] ) );
+    }
+  }
+  printf ( "\n" );
+  printf ( "  Ensemble of %d, 200 steps:\n", nens );
+  printf ( "  Max relative difference from C = %g\n", diff );
+  printf ( "  C %.2f ns, compiled %.2f ns per member step, ratio %.2f\n",
+    1.0E+09 * best[0] / ( 200.0 * nens ), 1.0E+09 * best[1] / ( 200.0 * nens ),
+    best[1] / best[0] );
+
+  rk4_ensemble_destroy ( e[0] );
+  rk4_ensemble_destroy ( e[1] );
+/*
+  A batch call with the wrong M.
+*/
+  yp[0] = 5000.0;
+  yp[1] = 100.0;
+  yp[2] = 1.0;
+  expr_deriv_batch ( 0.0, 1, 3, 1, yp, fp, p );
+  printf ( "  expr_deriv_batch() with M = 3 gives F = %g, %g, %g\n",
+    fp[0], fp[1], fp[2] );
+  expr_destroy ( p );
+  free ( t );
+  free ( y );
+  free ( ye );
+/*
+  Powers of a constant, which must agree with pow() for any base.
+*/
+  p = expr_compile ( power, error );
+  printf ( "\n" );
+  printf ( "  Powers of constants:\n" );
+  printf ( "\n" );
+  printf ( "     Y    (-2)^Y       0^Y       2^Y\n" );
+  printf ( "\n" );
+  for ( k = 0; k < 4; k++ )
+  {
+    yp[0] = 0.0;
+    yp[1] = ( double ) k;
+    yp[2] = 0.0;
+    expr_deriv ( 0.0, yp, fp, p );
+    printf ( "  %4d  %8g  %8g  %8g\n", k, fp[0], fp[1], fp[2] );
+  }
+  expr_destroy ( p );
+/*
+  Errors.
+*/
+  printf ( "\n" );
+  printf ( "  Faulty texts:\n" );
+  for ( i = 0; i < 4; i++ )
+  {
+    p = expr_compile ( bad[i], error );
+    printf ( "  %s\n", ( p == NULL ) ? error : "compiled" );
+    expr_destroy ( p );
+  }
+/*
+  Deep nesting must fail cleanly, not overflow the stack.
+*/
+  nest = ( char * ) malloc ( 2 * 100000 + 16 );
+  for ( j = 0; j < 3; j++ )
+  {
+    k = ( j == 0 ) ? 200 : 100000;
+    strcpy ( nest, "r' = " );
+    for ( i = 0; i < k; i++ )
+    {
+      nest[5+i] = ( j < 2 ) ? '(' : '-';
+    }
+    nest[5+k] = 'r';
+    for ( i = 0; i < k; i++ )
+    {
+      nest[6+k+i] = ( j < 2 ) ? ')' : ' ';
+    }
+    strcpy ( nest + 6 + 2 * k, "\n" );
+    p = expr_compile ( nest, error );
+    printf ( "  %6d %s: %s\n", k, ( j < 2 ) ? "parentheses" : "signs      ",
+      ( p == NULL ) ? error : "compiled" );
+    expr_destroy ( p );
+  }
+  free ( nest );
+
+  return;
+}
+/******************************************************************************/
+
+void fisher_deriv ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    fisher_deriv evaluates the whole Fisher right hand side.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[M], the nodal values.
+
+    void *CTX, the fisher_ctx.
+
+  Output:
+
+    double F[M], the value of the derivative, dU/dT.
+*/
+{
+  fisher_ctx *c;
+  int i;
+
+  c = ( fisher_ctx * ) ctx;
+  fisher_fi ( t, u, f, ctx );
+  for ( i = 0; i < c->m; i++ )
+  {
+    f[i] = f[i] + c->r * u[i] * ( 1.0 - u[i] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void fisher_fe ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    fisher_fe evaluates the reaction term of the Fisher equation.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[M], the nodal values.
+
+    void *CTX, the fisher_ctx.
+
+  Output:
+
+    double F[M], the reaction term.
+*/
+{
+  fisher_ctx *c;
+  int i;
+
+  c = ( fisher_ctx * ) ctx;
+  for ( i = 0; i < c->m; i++ )
+  {
+    f[i] = c->r * u[i] * ( 1.0 - u[i] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void fisher_fi ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    fisher_fi evaluates the diffusion term of the Fisher equation.
+
+  Discussion:
+
+    L U = D * ( U(I-1) - 2 U(I) + U(I+1) ) / DX^2, with zero boundary
+    values.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[M], the nodal values.
+
+    void *CTX, the fisher_ctx.
+
+  Output:
+
+    double F[M], the diffusion term.
+*/
+{
+  fisher_ctx *c;
+  double dx;
+  int i;
+  double ul;
+  double ur;
+  double w;
+
+  c = ( fisher_ctx * ) ctx;
+  dx = 1.0 / ( double ) ( c->m + 1 );
+  w = c->d / dx / dx;
+
+  for ( i = 0; i < c->m; i++ )
+  {
+    ul = ( 0 < i ) ? u[i-1] : 0.0;
+    ur = ( i < c->m - 1 ) ? u[i+1] : 0.0;
+    f[i] = w * ( ul - 2.0 * u[i] + ur );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+int fisher_solve ( double t, double gh, double r[], double z[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    fisher_solve solves Z - GH * L Z = R for the Fisher diffusion term.
+
+  Discussion:
+
+    I - GH * L is tridiagonal.  Its factors are kept in the context and
+    only recomputed when GH changes, which for an ESDIRK method with a
+    fixed step is only on the first solve.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the stage time.
+
+    double GH, the stepsize times the diagonal coefficient.
+
+    double R[M], the right hand side.
+
+    void *CTX, the fisher_ctx.
+
+  Output:
+
+    double Z[M], the solution.
+
+    int FISHER_SOLVE, 0 on success, nonzero if the factorization failed.
+*/
+{
+  fisher_ctx *c;
+  double dx;
+  int i;
+  double w;
+
+  c = ( fisher_ctx * ) ctx;
+
+  if ( gh != c->gh )
+  {
+    dx = 1.0 / ( double ) ( c->m + 1 );
+    w = gh * c->d / dx / dx;
+    for ( i = 0; i < c->m; i++ )
+    {
+      c->lu[0+i*3] = - w;
+      c->lu[1+i*3] = 1.0 + 2.0 * w;
+      c->lu[2+i*3] = - w;
+    }
+    if ( r83_np_fa ( c->m, c->lu ) != 0 )
+    {
+      c->gh = 0.0;
+      return 1;
+    }
+    c->gh = gh;
+  }
+
+  for ( i = 0; i < c->m; i++ )
+  {
+    z[i] = r[i];
+  }
+  r83_np_sl ( c->m, c->lu, z );
+
+  return 0;
+}
+/******************************************************************************/
+
+void gbm_diffusion ( double t, double y[], double g[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    gbm_diffusion evaluates the diffusion of two geometric Brownian motions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    void *CTX, the parameters MU[2] and SIGMA[2], as double[4].
+
+  Output:
+
+    double G[2], the diffusion.
+*/
+{
+  double *p;
+
+  p = ( double * ) ctx;
+
+  g[0] = p[2] * y[0];
+  g[1] = p[3] * y[1];
+
+  return;
+}
+/******************************************************************************/
+
+void gbm_drift ( double t, double y[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    gbm_drift evaluates the drift of two geometric Brownian motions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    void *CTX, the parameters MU[2] and SIGMA[2], as double[4].
+
+  Output:
+
+    double F[2], the drift.
+*/
+{
+  double *p;
+
+  p = ( double * ) ctx;
+
+  f[0] = p[0] * y[0];
+  f[1] = p[1] * y[1];
+
+  return;
+}
+/******************************************************************************/
+
+void heat_deriv_ctx ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    heat_deriv_ctx evaluates the whole method of lines heat equation.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[M], the nodal values.
+
+    void *CTX, the number of nodes, int M.
+
+  Output:
+
+    double F[M], the value of the derivative, dU/dT.
+*/
+{
+  heat_deriv_part ( t, 0, * ( int * ) ctx, u, f, ctx );
+
+  return;
+}
+/******************************************************************************/
+
+void heat_deriv_part ( double t, int lo, int hi, double u[], double f[],
+  void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    heat_deriv_part evaluates part of the method of lines heat equation.
+
+  Discussion:
+
+    F(I) = ( U(I-1) - 2 U(I) + U(I+1) ) / DX^2, with zero boundary values.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int LO, HI, the range of entries to evaluate.
+
+    double U[M], the nodal values.
+
+    void *CTX, the number of nodes, int M.
+
+  Output:
+
+    double F[M], entries LO to HI-1 of the derivative.
+*/
+{
+  double dx2;
+  int i;
+  int m;
+  double ul;
+  double ur;
+
+  m = * ( int * ) ctx;
+  dx2 = 1.0 / ( double ) ( m + 1 ) / ( double ) ( m + 1 );
+
+  for ( i = lo; i < hi; i++ )
+  {
+    ul = ( 0 < i ) ? u[i-1] : 0.0;
+    ur = ( i < m - 1 ) ? u[i+1] : 0.0;
+    f[i] = ( ul - 2.0 * u[i] + ur ) / dx2;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void kepler_deriv ( double t, double y[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    kepler_deriv evaluates the Kepler problem as a first order system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[4], the positions and momenta.
+
+  Output:
+
+    double F[4], the value of the derivative, dY/dT.
+*/
+{
+  kepler_dqdt ( t, y + 2, f, NULL );
+  kepler_dpdt ( t, y, f + 2, NULL );
+
+  return;
+}
+/******************************************************************************/
+
+void kepler_deriv_ctx ( double t, double y[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    kepler_deriv_ctx evaluates the Kepler problem, with a context argument.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[4], the positions and momenta.
+
+    void *CTX, unused.
+
+  Output:
+
+    double F[4], the value of the derivative, dY/dT.
+*/
+{
+  kepler_deriv ( t, y, f );
+
+  return;
+}
+/******************************************************************************/
+
+void kepler_dpdt ( double t, double q[], double dp[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    kepler_dpdt evaluates the force of the Kepler problem.
+
+  Discussion:
+
+    H = ( P1^2 + P2^2 ) / 2 - 1 / sqrt ( Q1^2 + Q2^2 ).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Q[2], the position.
+
+    void *CTX, unused.
+
+  Output:
+
+    double DP[2], the rate of change of the momentum.
+*/
+{
+  double r3;
+
+  r3 = pow ( q[0] * q[0] + q[1] * q[1], 1.5 );
+  dp[0] = - q[0] / r3;
+  dp[1] = - q[1] / r3;
+
+  return;
+}
+/******************************************************************************/
+
+void kepler_dqdt ( double t, double p[], double dq[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    kepler_dqdt evaluates the velocity of the Kepler problem.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double P[2], the momentum.
+
+    void *CTX, unused.
+
+  Output:
+
+    double DQ[2], the rate of change of the position.
+*/
+{
+  dq[0] = p[0];
+  dq[1] = p[1];
+
+  return;
+}
+/******************************************************************************/
+
+void lag_deriv ( double t, double y[], double f[], dde_stepper *s,
+  void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    lag_deriv evaluates the delay equation Y'(T) = - Y(T-1).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[1], the current solution value.
+
+    dde_stepper *S, the stepper, for the delayed value.
+
+    void *CTX, unused.
+
+  Output:
+
+    double F[1], the value of the derivative.
+*/
+{
+  f[0] = - dde_lag ( s, t - 1.0, 0 );
+
+  return;
+}
+/******************************************************************************/
+
+double lag_history ( double t, int i, void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    lag_history returns the history of the delay equation, Y = 1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, a time before the start.
+
+    int I, the component.
+
+    void *CTX, unused.
+
+  Output:
+
+    double LAG_HISTORY, the value.
+*/
+{
+  return 1.0;
+}
+/******************************************************************************/
+
+void log_deriv ( double t, double u[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    log_deriv evaluates Y' = 1 / ( 1 + T ), whose solution is
+    Y = LOG ( 1 + T ) when Y(0) = 0.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, U[1], the time and state.
+
+  Output:
+
+    double F[1], the derivative.
+*/
+{
+  f[0] = 1.0 / ( 1.0 + t );
+
+  return;
+}
+/******************************************************************************/
+
+void nan_deriv_ctx ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    nan_deriv_ctx is a right hand side that always returns NaN.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, U[M], the time and state, unused.
+
+    void *CTX, points to the int M.
+
+  Output:
+
+    double F[M], all NaN.
+*/
+{
+  int i;
+  int m;
+
+  m = *( int * ) ctx;
+
+  for ( i = 0; i < m; i++ )
+  {
+    f[i] = NAN;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void nan_late_deriv ( double t, double u[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    nan_late_deriv evaluates Y' = - Y for T < 1, and NaN from T = 1 on.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, U[1], the time and state.
+
+  Output:
+
+    double F[1], the derivative.
+*/
+{
+  if ( t < 1.0 )
+  {
+    f[0] = - u[0];
+  }
+  else
+  {
+    f[0] = NAN;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void ou_diffusion ( double t, double y[], double g[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    ou_diffusion evaluates the additive noise of a forced OU process.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    void *CTX, unused.
+
+  Output:
+
+    double G[2], the diffusion, which depends on T only.
+*/
+{
+  g[0] = 0.5 + 0.5 * t;
+  g[1] = 0.2;
+
+  return;
+}
+/******************************************************************************/
+
+void ou_drift ( double t, double y[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    ou_drift evaluates the drift of a forced OU process.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    void *CTX, unused.
+
+  Output:
+
+    double F[2], the drift.
+*/
+{
+  f[0] = - y[0] + sin ( 3.0 * t );
+  f[1] = - 2.0 * y[1] + y[0] * y[0];
+
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv ( double t, double y[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_deriv returns the right hand side of the predator ODE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    22 April 2020
+
+  Author:
+
+    John Burkardt
+
+  Input:
+
+    double T, the current time.
+
+    double Y[M], the current solution value.
+
+  Output:
+
+    double F[M], the value of the derivative, dU/dT.
+*/
+{
+  double dfdt;
+  double drdt;
+  double fox;
+  double rab;
+  
+  rab = y[0];
+  fox = y[1];
+
+  drdt =   2.0 * rab - 0.001 * rab * fox;
+  dfdt = -10.0 * fox + 0.002 * rab * fox;
+
+  f[0] = drdt;
+  f[1] = dfdt;
+  
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_ctx ( double t, double y[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_deriv_ctx evaluates the predator ODE with given coefficients.
+
+  Discussion:
+
+    predator_deriv() is the case CTX = { 2.0, 0.001, 10.0, 0.002 }.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[M], the current solution value.
+
+    void *CTX, the coefficients double C[4], so that
+      dR/dT =   C[0] * R - C[1] * R * F
+      dF/dT = - C[2] * F + C[3] * R * F
+
+  Output:
+
+    double F[M], the value of the derivative, dU/dT.
+*/
+{
+  double *c = ( double * ) ctx;
+  double fox;
+  double rab;
+  
+  rab = y[0];
+  fox = y[1];
+
+  f[0] =   c[0] * rab - c[1] * rab * fox;
+  f[1] = - c[2] * fox + c[3] * rab * fox;
+  
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_acc ( double t, double y[], double a, double h,
+  double du[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_deriv_acc accumulates the predator ODE right hand side.
+
+  Discussion:
+
+    This is the form needed by lsrk_create().
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    double A, H, the scale factors.
+
+    double DU[2], the register.
+
+    void *CTX, unused.
+
+  Output:
+
+    double DU[2], A * DU + H * dY/dT.
+*/
+{
+  double fox;
+  double rab;
+  
+  rab = y[0];
+  fox = y[1];
+
+  du[0] = a * du[0] + h * (   2.0 * rab - 0.001 * rab * fox );
+  du[1] = a * du[1] + h * ( -10.0 * fox + 0.002 * rab * fox );
+  
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_batch ( double t, int nens, int m, int ld, double u[],
+  double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_deriv_batch evaluates the predator ODE for an ensemble.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int NENS, the number of members.
+
+    int M, the number of variables.
+
+    int LD, the leading dimension.
+
+    double U[M*LD], the current solution values, by component.
+
+  Output:
+
+    double F[M*LD], the values of the derivative.
+*/
+{
+  double *fox;
+  int k;
+  double *rab;
+
+  rab = u;
+  fox = u + ld;
+
+  for ( k = 0; k < ld; k++ )
+  {
+    f[k]    =   2.0 * rab[k] - 0.001 * rab[k] * fox[k];
+    f[k+ld] = -10.0 * fox[k] + 0.002 * rab[k] * fox[k];
+  }
+  
+  return;
+}
+/******************************************************************************/
+
+void predator_deriv_batch_float ( double t, int nens, int m, int ld,
+  float u[], float f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_deriv_batch_float is predator_deriv_batch in single precision.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int NENS, the number of members.
+
+    int M, the number of variables.
+
+    int LD, the leading dimension.
+
+    float U[M*LD], the current solution values, by component.
+
+  Output:
+
+    float F[M*LD], the values of the derivative.
+*/
+{
+  float *fox;
+  int k;
+  float *rab;
+
+  rab = u;
+  fox = u + ld;
+
+  for ( k = 0; k < ld; k++ )
+  {
+    f[k]    =   2.0f * rab[k] - 0.001f * rab[k] * fox[k];
+    f[k+ld] = -10.0f * fox[k] + 0.002f * rab[k] * fox[k];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void predator_delay_deriv ( double t, double y[], double f[], dde_stepper *s,
+  void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_delay_deriv evaluates the predator ODE with a lagged response.
+
+  Discussion:
+
+    The foxes grow with the rabbit density a time TAU ago, where
+    TAU = 0.05 / ( 1 + R / 5000 ) depends on the current rabbits R.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    dde_stepper *S, the stepper, for the delayed value.
+
+    void *CTX, unused.
+
+  Output:
+
+    double F[2], the value of the derivative.
+*/
+{
+  double fox;
+  double rab;
+  double rab_lag;
+  double tau;
+
+  rab = y[0];
+  fox = y[1];
+  tau = 0.05 / ( 1.0 + fmax ( rab, 0.0 ) / 5000.0 );
+  rab_lag = dde_lag ( s, t - tau, 0 );
+
+  f[0] =   2.0 * rab - 0.001 * rab * fox;
+  f[1] = -10.0 * fox + 0.002 * rab_lag * fox;
+
+  return;
+}
+/******************************************************************************/
+
+double predator_delay_history ( double t, int i, void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_delay_history returns the constant history of the delayed
+    predator prey model.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, a time before the start.
+
+    int I, the component.
+
+    void *CTX, unused.
+
+  Output:
+
+    double PREDATOR_DELAY_HISTORY, the value.
+*/
+{
+  return ( i == 0 ) ? 5000.0 : 100.0;
+}
+/******************************************************************************/
+
+void predator_diffusion ( double t, double y[], double g[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_diffusion evaluates multiplicative noise for the predator ODE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    void *CTX, the coefficients double C[5] of predator_deriv_ctx(),
+    followed by the noise intensity SIGMA.
+
+  Output:
+
+    double G[2], the diffusion.
+*/
+{
+  double sigma;
+
+  sigma = ( ( double * ) ctx )[4];
+
+  g[0] = sigma * y[0];
+  g[1] = sigma * y[1];
+
+  return;
+}
+/******************************************************************************/
+
+void predator_phase_plot ( int n, int m, double t[], double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_phase_plot makes a phase plot of the results.
+
+  Discussion:
+
+    The data is written as an rk4_traj binary file, which gnuplot reads
+    directly.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Author:
+
+    John Burkardt
+
+  Input:
+
+    int n: the number of steps to take.
+
+    int m: the number of variables.
+
+    double t[n+1], y[(n+1)*m]: the times and solution values.
+*/
+{
+  char command_filename[80];
+  FILE *command;
+  char data_filename[80];
+  rk4_traj_writer *data;
+  char header[] = "predator";
+  int j;
+  char *names[2] = { "prey", "predator" };
+  long int offset;
+
+  printf ( "\n" );
+  printf ( "predator_phase_plot:\n" );
+  printf ( "  Write command and data files that can be used\n" );
+  printf ( "  by gnuplot for a predator-prey phase plot.\n" );
+/*
+  Create the data file.
+*/
+  strcpy ( data_filename, header );
+  strcat ( data_filename, "_data.bin" );
+
+  data = rk4_traj_open ( data_filename, m, names, RK4_TRAJ_ROW, 0 );
+  if ( data == NULL )
+  {
+    printf ( "\n" );
+    printf ( "predator_phase_plot - Warning!\n" );
+    printf ( "  Could not create \"%s\".\n", data_filename );
+    return;
+  }
+
+  for ( j = 0; j <= n; j++ )
+  {
+    rk4_traj_write ( data, t[j], y+j*m );
+  }
+
+  offset = data->offset;
+  rk4_traj_close ( data );
+
+  printf ( "\n" );
+  printf ( "  predator_phase_plot: data stored in \"%s\".\n", data_filename );
+/*
+  Create the command file.
+*/
+  strcpy ( command_filename, header );
+  strcat ( command_filename, "_commands.txt" );
+
+  command = fopen ( command_filename, "wt" );
+
+  fprintf ( command, "# %s\n", command_filename );
+  fprintf ( command, "#\n" );
+  fprintf ( command, "# Usage:\n" );
+  fprintf ( command, "#  gnuplot < %s\n", command_filename );
+  fprintf ( command, "#\n" );
+  fprintf ( command, "set term png\n" );
+  fprintf ( command, "set output '%s.png'\n", header );
+  fprintf ( command, "set xlabel '<-- Prey -->'\n" );
+  fprintf ( command, "set ylabel '<-- Predator -->'\n" );
+  fprintf ( command, "set title 'Predator-prey solution by rk4'\n" );
+  fprintf ( command, "set grid\n" );
+  fprintf ( command, "set style data lines\n" );
+  fprintf ( command, "plot '%s' binary skip=%ld format='%%%ddouble' "
+    "using 2:3 with lines\n", data_filename, offset, m + 1 );
+  fprintf ( command, "quit\n" );
+
+  fclose ( command );
+
+  printf ( "  predator_phase_plot: plot commands stored in \"%s\".\n", 
+    command_filename );
+ 
+  return;
+}
+/******************************************************************************/
+
+void predator_sens ( double t, double y[], double p[], int np, double s[],
+  double ds[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_sens evaluates the predator ODE variational equations.
+
+  Discussion:
+
+    DS_J = dF/dY * S_J + dF/dP_J, for the four coefficients P of
+    predator_deriv_ctx().
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[2], the current solution value.
+
+    double P[4], the coefficients.
+
+    int NP, the number of coefficients, 4.
+
+    double S[2*4], the sensitivities, one column per coefficient.
+
+  Output:
+
+    double DS[2*4], the derivatives of the sensitivities.
+*/
+{
+  double fox;
+  int j;
+  double j11;
+  double j12;
+  double j21;
+  double j22;
+  double rab;
+
+  rab = y[0];
+  fox = y[1];
+
+  j11 =   p[0] - p[1] * fox;
+  j12 = - p[1] * rab;
+  j21 =   p[3] * fox;
+  j22 = - p[2] + p[3] * rab;
+
+  for ( j = 0; j < np; j++ )
+  {
+    ds[0+j*2] = j11 * s[0+j*2] + j12 * s[1+j*2];
+    ds[1+j*2] = j21 * s[0+j*2] + j22 * s[1+j*2];
+  }
+  ds[0+0*2] = ds[0+0*2] + rab;
+  ds[0+1*2] = ds[0+1*2] - rab * fox;
+  ds[1+2*2] = ds[1+2*2] - fox;
+  ds[1+3*2] = ds[1+3*2] + rab * fox;
+
+  return;
+}
+/******************************************************************************/
+
+void relax_deriv_ctx ( double t, double y[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    relax_deriv_ctx evaluates Y' = - 1.0E+04 * ( Y - COS ( T ) ).
+
+  Discussion:
+
+    Y relaxes quickly towards COS ( T ), so the first steps from a Y(0)
+    far from 1 must be short.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, Y[1], the time and state.
+
+    void *CTX, unused.
+
+  Output:
+
+    double F[1], the derivative.
+*/
+{
+  f[0] = - 1.0E+04 * ( y[0] - cos ( t ) );
+
+  return;
+}
+/******************************************************************************/
+void robertson_deriv ( double t, double y[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    robertson_deriv returns the right hand side of the Robertson ODE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[3], the current solution value.
+
+  Output:
+
+    double F[3], the value of the derivative, dU/dT.
+*/
+{
+  f[0] = - 0.04 * y[0] + 1.0E+04 * y[1] * y[2];
+  f[1] =   0.04 * y[0] - 1.0E+04 * y[1] * y[2] - 3.0E+07 * y[1] * y[1];
+  f[2] =                                         3.0E+07 * y[1] * y[1];
+
+  return;
+}
+/******************************************************************************/
+
+void robertson_jac ( double t, double y[], double dfdy[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    robertson_jac returns the Jacobian of the Robertson ODE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double Y[3], the current solution value.
+
+  Output:
+
+    double DFDY[3*3], the Jacobian, DFDY[I+J*3] = dF(I)/dY(J).
+*/
+{
+  dfdy[0+0*3] = - 0.04;
+  dfdy[1+0*3] =   0.04;
+  dfdy[2+0*3] =   0.0;
+
+  dfdy[0+1*3] =   1.0E+04 * y[2];
+  dfdy[1+1*3] = - 1.0E+04 * y[2] - 6.0E+07 * y[1];
+  dfdy[2+1*3] =   6.0E+07 * y[1];
+
+  dfdy[0+2*3] =   1.0E+04 * y[1];
+  dfdy[1+2*3] = - 1.0E+04 * y[1];
+  dfdy[2+2*3] =   0.0;
+
+  return;
+}
+/******************************************************************************/
+
+void predator_event ( double t, int m, double y[], double gv[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_event evaluates the predator prey event functions.
+
+  Discussion:
+
+    GV[0] and GV[1] are both dR/dT, whose upward and downward zero
+    crossings are prey minima and maxima.  GV[2] = F - 2000.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int M, the number of variables.
+
+    double Y[M], the current solution value.
+
+    void *DATA, unused.
+
+  Output:
+
+    double GV[3], the event function values.
+*/
+{
+  double f[2];
+
+  predator_deriv ( t, y, f );
+
+  gv[0] = f[0];
+  gv[1] = f[0];
+  gv[2] = y[1] - 2000.0;
+
+  return;
+}
+/******************************************************************************/
+
+int predator_event_found ( int k, double t, int m, double y[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    predator_event_found records a prey extremum.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int K, the event.
+
+    double T, the event time.
+
+    int M, the number of variables.
+
+    double Y[M], the solution at T.
+
+    void *DATA, double REC[41].  REC[0] counts the records, and each
+    record is the time, negated for a minimum, and the prey.
+
+  Output:
+
+    int PREDATOR_EVENT_FOUND, 0, to continue.
+*/
+{
+  int j;
+  double *rec = ( double * ) data;
+
+  if ( 1 < k )
+  {
+    return 0;
+  }
+
+  j = ( int ) rec[0];
+  if ( j < 20 )
+  {
+    rec[1+2*j] = ( k == 0 ) ? - t : t;
+    rec[2+2*j] = y[0];
+    rec[0] = rec[0] + 1.0;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+int kepler_energy_observe ( double t, int m, double y[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    kepler_energy_observe tracks the energy error of a Kepler orbit.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int M, the number of variables, 4.
+
+    double Y[4], the positions and momenta.
+
+    void *DATA, double ENERGY[2], the initial energy and the largest
+    energy error so far.  ENERGY[0] = 0 on the first call.
+
+  Output:
+
+    int KEPLER_ENERGY_OBSERVE, 0, to continue.
+*/
+{
+  double *energy = ( double * ) data;
+  double h;
+
+  h = 0.5 * ( y[2] * y[2] + y[3] * y[3] ) 
+    - 1.0 / sqrt ( y[0] * y[0] + y[1] * y[1] );
+
+  if ( energy[0] == 0.0 )
+  {
+    energy[0] = h;
+  }
+  energy[1] = fmax ( energy[1], fabs ( h - energy[0] ) );
+
+  return 0;
+}
+/******************************************************************************/
+
+int predator_print_observe ( double t, int m, double y[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_print_observe prints the predator prey solution.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int M, the number of variables.
+
+    double Y[M], the current solution value.
+
+    void *DATA, a label for the output.
+
+  Output:
+
+    int PREDATOR_PRINT_OBSERVE: 0, to continue the integration.
+*/
+{
+  printf ( "  %-6s  %6g  %16.10g  %16.10g\n", ( char * ) data, t, y[0], y[1] );
+
+  return 0;
+}
+/******************************************************************************/
+
+int predator_range_observe ( double t, int m, double y[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    predator_range_observe records the range of the predator prey solution.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    int M, the number of variables.
+
+    double Y[M], the current solution value.
+
+    void *DATA, a double RANGE[2+2*M].  RANGE[0] counts the calls, and
+    should be zero on the first call.
+
+  Output:
+
+    void *DATA: RANGE[1] holds T, RANGE[2+2*I] and RANGE[3+2*I] the
+    minimum and maximum of Y[I] so far.
+
+    int PREDATOR_RANGE_OBSERVE: 0, to continue the integration.
+*/
+{
+  int i;
+  double *range = ( double * ) data;
+
+  if ( range[0] == 0.0 )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      range[2+2*i] = y[i];
+      range[3+2*i] = y[i];
+    }
+  }
+
+  range[0] = range[0] + 1.0;
+  range[1] = t;
+  for ( i = 0; i < m; i++ )
+  {
+    range[2+2*i] = fmin ( range[2+2*i], y[i] );
+    range[3+2*i] = fmax ( range[3+2*i], y[i] );
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void twoscale_deriv ( double t, double u[], double f[], void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    twoscale_deriv evaluates the whole two scale system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double U[2+MS], the oscillator and then the slow components.
+
+    void *CTX, the number of slow components, int MS.
+
+  Output:
+
+    double F[2+MS], the value of the derivative, dU/dT.
+*/
+{
+  twoscale_fast ( t, u, u + 2, f, ctx );
+  twoscale_slow ( t, u, u + 2, f + 2, ctx );
+
+  return;
+}
+/******************************************************************************/
+
+void twoscale_fast ( double t, double yf[], double ys[], double ff[],
+  void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    twoscale_fast evaluates the fast part of the two scale system.
+
+  Discussion:
+
+    An oscillator of frequency 20, driven by the mean of the slow part.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double YF[2], the oscillator position and velocity.
+
+    double YS[MS], the slow components.
+
+    void *CTX, the number of slow components, int MS.
+
+  Output:
+
+    double FF[2], the derivative of the fast part.
+*/
+{
+  int i;
+  int ms;
+  double s;
+
+  ms = * ( int * ) ctx;
+  s = 0.0;
+  for ( i = 0; i < ms; i++ )
+  {
+    s = s + ys[i];
+  }
+
+  ff[0] = yf[1];
+  ff[1] = - 400.0 * yf[0] + s / ( double ) ms;
+
+  return;
+}
+/******************************************************************************/
+
+void twoscale_slow ( double t, double yf[], double ys[], double fs[],
+  void *ctx )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    twoscale_slow evaluates the slow part of the two scale system.
+
+  Discussion:
+
+    Component I decays at rate 0.5 + I / MS and is forced by the
+    oscillator position.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T, the current time.
+
+    double YF[2], the oscillator position and velocity.
+
+    double YS[MS], the slow components.
+
+    void *CTX, the number of slow components, int MS.
+
+  Output:
+
+    double FS[MS], the derivative of the slow part.
+*/
+{
+  int i;
+  int ms;
+
+  ms = * ( int * ) ctx;
+  for ( i = 0; i < ms; i++ )
+  {
+    fs[i] = - ( 0.5 + ( double ) i / ( double ) ms ) * ys[i] + 0.1 * yf[0];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+double wtime ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+ 
+    wtime returns a reading of the wall clock, in seconds.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    double WTIME, the time in seconds from an arbitrary origin.
+*/
+{
+  struct timespec ts;
+
+  clock_gettime ( CLOCK_MONOTONIC, &ts );
+
+  return ( double ) ts.tv_sec + 1.0E-09 * ( double ) ts.tv_nsec;
+}
@@ -0,0 +1,754 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+# ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# endif
+
+# include "rk4_traj.h"
+# include "rk4_stats.h"
+
+# define RK4_TRAJ_HEADER 64
+
+static int rk4_traj_flush ( rk4_traj_writer *w );
+static unsigned long long int rk4_traj_get_u64 ( unsigned char *b );
+static int rk4_traj_little_endian ( );
+static void rk4_traj_put_u64 ( unsigned char *b, unsigned long long int v );
+static void rk4_traj_swap ( double a[], long int n );
+
+/******************************************************************************/
+
+int rk4_traj_close ( rk4_traj_writer *w )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_close writes the last chunk and the record count, and closes
+    a trajectory file.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_traj_writer *W: the writer.  W may be NULL.
+
+  Output:
+
+    int RK4_TRAJ_CLOSE: 0 if the whole file was written, 1 otherwise.
+*/
+{
+  unsigned char b[8];
+  int error;
+
+  if ( w == NULL )
+  {
+    return 0;
+  }
+
+  rk4_traj_flush ( w );
+
+  rk4_traj_put_u64 ( b, ( unsigned long long int ) w->n );
+  if ( fseek ( w->fp, 24, SEEK_SET ) != 0 || fwrite ( b, 1, 8, w->fp ) != 8 )
+  {
+    w->error = 1;
+  }
+  if ( fclose ( w->fp ) != 0 )
+  {
+    w->error = 1;
+  }
+
+  error = w->error;
+  free ( w->buf );
+  free ( w );
+
+  return error;
+}
+/******************************************************************************/
+
+double *rk4_traj_column ( rk4_traj_reader *r, long int c, int i )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_column returns one field of one chunk of a column file.
+
+  Discussion:
+
+    The result points to CHUNK contiguous doubles in the map, for records
+    C*CHUNK onwards.  Entries past the last record are padding.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_traj_reader *R: a reader of an RK4_TRAJ_COL file.
+
+    long int C: the chunk index.
+
+    int I: the field, 0 for the time and 1 to M for the variables.
+
+  Output:
+
+    double *RK4_TRAJ_COLUMN: the field, or NULL for a row file.
+*/
+{
+  if ( r->layout != RK4_TRAJ_COL )
+  {
+    return NULL;
+  }
+
+  return r->data + ( c * ( r->m + 1 ) + i ) * ( long int ) r->chunk;
+}
+/******************************************************************************/
+
+double rk4_traj_get ( rk4_traj_reader *r, long int j, int i )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_get returns one field of one record.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_traj_reader *R: the reader.
+
+    long int J: the record, 0 <= J < N.
+
+    int I: the field, 0 for the time and 1 to M for the variables.
+
+  Output:
+
+    double RK4_TRAJ_GET: the value.
+*/
+{
+  long int c;
+
+  if ( r->layout == RK4_TRAJ_ROW )
+  {
+    return r->data[i+j*( r->m + 1 )];
+  }
+
+  c = j / r->chunk;
+
+  return rk4_traj_column ( r, c, i ) [j-c*r->chunk];
+}
+/******************************************************************************/
+
+rk4_traj_reader *rk4_traj_map ( char *filename )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_map opens a trajectory file for reading.
+
+  Discussion:
+
+    On POSIX systems the file is mapped read only, and the data is used
+    in place.  Elsewhere, or on a big endian host, where the doubles
+    must be swapped, the file is read into memory instead.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    char *FILENAME: the name of the file.
+
+  Output:
+
+    rk4_traj_reader *RK4_TRAJ_MAP: the reader, or NULL if the file could
+    not be read or is not a trajectory file.
+*/
+{
+  unsigned char *b;
+  long int count;
+  FILE *fp;
+  int i;
+  char *name;
+  unsigned long long int names_size;
+  unsigned long long int offset;
+  rk4_traj_reader *r;
+
+  r = ( rk4_traj_reader * ) malloc ( sizeof ( rk4_traj_reader ) );
+  if ( r == NULL )
+  {
+    return NULL;
+  }
+  r->names = NULL;
+  r->base = NULL;
+  r->mapped = 0;
+
+# ifndef _WIN32
+  if ( rk4_traj_little_endian ( ) )
+  {
+    int fd;
+    struct stat st;
+
+    fd = open ( filename, O_RDONLY );
+    if ( fd < 0 )
+    {
+      free ( r );
+      return NULL;
+    }
+    if ( fstat ( fd, &st ) == 0 && RK4_TRAJ_HEADER <= st.st_size )
+    {
+      r->size = ( size_t ) st.st_size;
+      r->base = mmap ( NULL, r->size, PROT_READ, MAP_SHARED, fd, 0 );
+      if ( r->base == MAP_FAILED )
+      {
+        r->base = NULL;
+      }
+      else
+      {
+        r->mapped = 1;
+      }
+    }
+    close ( fd );
+  }
+# endif
+
+  if ( !r->mapped )
+  {
+    fp = fopen ( filename, "rb" );
+    if ( fp != NULL )
+    {
+      fseek ( fp, 0, SEEK_END );
+      r->size = ( size_t ) ftell ( fp );
+      fseek ( fp, 0, SEEK_SET );
+      r->base = malloc ( r->size );
+      if ( r->base != NULL
+        && fread ( r->base, 1, r->size, fp ) != r->size )
+      {
+        free ( r->base );
+        r->base = NULL;
+      }
+      fclose ( fp );
+    }
+  }
+
+  if ( r->base == NULL || r->size < RK4_TRAJ_HEADER )
+  {
+    rk4_traj_unmap ( r );
+    return NULL;
+  }
+
+  b = ( unsigned char * ) r->base;
+  offset = rk4_traj_get_u64 ( b + 40 );
+  names_size = rk4_traj_get_u64 ( b + 48 );
+  r->layout = ( int ) ( b[12] | ( b[13] << 8 ) );
+  r->m = ( int ) rk4_traj_get_u64 ( b + 16 );
+  r->n = ( long int ) rk4_traj_get_u64 ( b + 24 );
+  r->chunk = ( int ) rk4_traj_get_u64 ( b + 32 );
+
+  if ( memcmp ( b, "RK4TRAJ1", 8 ) != 0 || r->m <= 0 || r->chunk <= 0
+    || ( r->layout != RK4_TRAJ_ROW && r->layout != RK4_TRAJ_COL )
+    || r->size < offset || r->size < RK4_TRAJ_HEADER + names_size )
+  {
+    rk4_traj_unmap ( r );
+    return NULL;
+  }
+
+  if ( r->layout == RK4_TRAJ_ROW )
+  {
+    count = r->n * ( r->m + 1 );
+  }
+  else
+  {
+    count = ( ( r->n + r->chunk - 1 ) / r->chunk ) * r->chunk * ( r->m + 1 );
+  }
+  if ( ( r->size - offset ) / sizeof ( double ) < ( size_t ) count )
+  {
+    rk4_traj_unmap ( r );
+    return NULL;
+  }
+  r->data = ( double * ) ( b + offset );
+  if ( !rk4_traj_little_endian ( ) )
+  {
+    rk4_traj_swap ( r->data, count );
+  }
+/*
+  Point at the names, which must all be present.
+*/
+  r->names = ( char ** ) malloc ( ( r->m + 1 ) * sizeof ( char * ) );
+  if ( r->names == NULL )
+  {
+    rk4_traj_unmap ( r );
+    return NULL;
+  }
+  name = ( char * ) ( b + RK4_TRAJ_HEADER );
+  for ( i = 0; i <= r->m; i++ )
+  {
+    if ( ( char * ) ( b + RK4_TRAJ_HEADER + names_size ) <= name
+      || memchr ( name, '\0', ( char * ) ( b + RK4_TRAJ_HEADER + names_size )
+      - name ) == NULL )
+    {
+      rk4_traj_unmap ( r );
+      return NULL;
+    }
+    r->names[i] = name;
+    name = name + strlen ( name ) + 1;
+  }
+
+  return r;
+}
+/******************************************************************************/
+
+int rk4_traj_observe ( double t, int m, double y[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_observe is an rk4_observer function that writes each record.
+
+  Discussion:
+
+    Set OBS.OBSERVE = rk4_traj_observe and OBS.DATA to the writer.  The
+    integration stops if the file cannot be written.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    double T: the time.
+
+    int M: the number of variables.
+
+    double Y[M]: the solution.
+
+    void *DATA: the rk4_traj_writer.
+
+  Output:
+
+    int RK4_TRAJ_OBSERVE: 0 to continue, 1 after a write error.
+*/
+{
+  return rk4_traj_write ( ( rk4_traj_writer * ) data, t, y );
+}
+/******************************************************************************/
+
+rk4_traj_writer *rk4_traj_open ( char *filename, int m, char *names[],
+  int layout, int chunk )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_open creates a trajectory file and writes its header.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    char *FILENAME: the name of the file.
+
+    int M: the number of variables.
+
+    char *NAMES[M]: the names of the variables, or NULL for "y1" to "yM".
+
+    int LAYOUT: RK4_TRAJ_ROW or RK4_TRAJ_COL.
+
+    int CHUNK: the number of records buffered and, in column layout,
+    stored together.  If CHUNK <= 0, 1024 is used.
+
+  Output:
+
+    rk4_traj_writer *RK4_TRAJ_OPEN: the writer, or NULL on failure.
+*/
+{
+  unsigned char b[RK4_TRAJ_HEADER];
+  char dflt[32];
+  int i;
+  size_t len;
+  unsigned long long int names_size;
+  unsigned long long int offset;
+  rk4_traj_writer *w;
+
+  if ( m <= 0 || ( layout != RK4_TRAJ_ROW && layout != RK4_TRAJ_COL ) )
+  {
+    return NULL;
+  }
+  if ( chunk <= 0 )
+  {
+    chunk = 1024;
+  }
+
+  w = ( rk4_traj_writer * ) malloc ( sizeof ( rk4_traj_writer ) );
+  if ( w == NULL )
+  {
+    return NULL;
+  }
+  w->buf = ( double * ) malloc ( ( size_t ) chunk * ( m + 1 )
+    * sizeof ( double ) );
+  w->fp = fopen ( filename, "wb" );
+  if ( w->buf == NULL || w->fp == NULL )
+  {
+    if ( w->fp != NULL )
+    {
+      fclose ( w->fp );
+    }
+    free ( w->buf );
+    free ( w );
+    return NULL;
+  }
+  w->m = m;
+  w->layout = layout;
+  w->chunk = chunk;
+  w->n = 0;
+  w->fill = 0;
+  w->error = 0;
+
+  names_size = 2;
+  for ( i = 0; i < m; i++ )
+  {
+    if ( names == NULL )
+    {
+      sprintf ( dflt, "y%d", i + 1 );
+      names_size = names_size + strlen ( dflt ) + 1;
+    }
+    else
+    {
+      names_size = names_size + strlen ( names[i] ) + 1;
+    }
+  }
+  offset = RK4_TRAJ_HEADER
+    + ( ( names_size + RK4_TRAJ_HEADER - 1 ) / RK4_TRAJ_HEADER )
+    * RK4_TRAJ_HEADER;
+
+  w->offset = ( long int ) offset;
+
+  memset ( b, 0, RK4_TRAJ_HEADER );
+  memcpy ( b, "RK4TRAJ1", 8 );
+  b[8] = 1;
+  b[12] = ( unsigned char ) layout;
+  rk4_traj_put_u64 ( b + 16, ( unsigned long long int ) m );
+  rk4_traj_put_u64 ( b + 24, 0 );
+  rk4_traj_put_u64 ( b + 32, ( unsigned long long int ) chunk );
+  rk4_traj_put_u64 ( b + 40, offset );
+  rk4_traj_put_u64 ( b + 48, names_size );
+  fwrite ( b, 1, RK4_TRAJ_HEADER, w->fp );
+
+  fwrite ( "t", 1, 2, w->fp );
+  for ( i = 0; i < m; i++ )
+  {
+    if ( names == NULL )
+    {
+      sprintf ( dflt, "y%d", i + 1 );
+      fwrite ( dflt, 1, strlen ( dflt ) + 1, w->fp );
+    }
+    else
+    {
+      fwrite ( names[i], 1, strlen ( names[i] ) + 1, w->fp );
+    }
+  }
+  memset ( b, 0, RK4_TRAJ_HEADER );
+  len = ( size_t ) ( offset - RK4_TRAJ_HEADER - names_size );
+  if ( fwrite ( b, 1, len, w->fp ) != len )
+  {
+    w->error = 1;
+  }
+  RK4_STATS_ADD ( RK4_COUNT_BYTE, offset );
+
+  return w;
+}
+/******************************************************************************/
+
+void rk4_traj_unmap ( rk4_traj_reader *r )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_unmap releases a trajectory reader.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_traj_reader *R: the reader.  R may be NULL.
+*/
+{
+  if ( r == NULL )
+  {
+    return;
+  }
+# ifndef _WIN32
+  if ( r->mapped )
+  {
+    munmap ( r->base, r->size );
+  }
+  else
+# endif
+  {
+    free ( r->base );
+  }
+  free ( r->names );
+  free ( r );
+
+  return;
+}
+/******************************************************************************/
+
+int rk4_traj_write ( rk4_traj_writer *w, double t, double y[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_write appends one record to a trajectory file.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    rk4_traj_writer *W: the writer.
+
+    double T: the time.
+
+    double Y[M]: the solution.
+
+  Output:
+
+    int RK4_TRAJ_WRITE: 0 if all records so far were written, 1 otherwise.
+*/
+{
+  int i;
+
+  if ( w->layout == RK4_TRAJ_ROW )
+  {
+    w->buf[w->fill*( w->m + 1 )] = t;
+    memcpy ( w->buf + w->fill * ( w->m + 1 ) + 1, y, w->m * sizeof ( double ) );
+  }
+  else
+  {
+    w->buf[w->fill] = t;
+    for ( i = 0; i < w->m; i++ )
+    {
+      w->buf[w->fill+( i + 1 )*w->chunk] = y[i];
+    }
+  }
+  w->fill = w->fill + 1;
+  w->n = w->n + 1;
+
+  if ( w->fill == w->chunk )
+  {
+    rk4_traj_flush ( w );
+  }
+
+  return w->error;
+}
+/******************************************************************************/
+
+static int rk4_traj_flush ( rk4_traj_writer *w )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_flush writes the buffered records.
+
+  Discussion:
+
+    A partial chunk in column layout is padded with zeros, so that every
+    chunk has the same size.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  long int count;
+  int i;
+
+  if ( w->fill == 0 )
+  {
+    return w->error;
+  }
+
+  if ( w->layout == RK4_TRAJ_ROW )
+  {
+    count = ( long int ) w->fill * ( w->m + 1 );
+  }
+  else
+  {
+    count = ( long int ) w->chunk * ( w->m + 1 );
+    for ( i = 0; i <= w->m; i++ )
+    {
+      memset ( w->buf + i * w->chunk + w->fill, 0,
+        ( w->chunk - w->fill ) * sizeof ( double ) );
+    }
+  }
+
+  if ( !rk4_traj_little_endian ( ) )
+  {
+    rk4_traj_swap ( w->buf, count );
+  }
+  if ( fwrite ( w->buf, sizeof ( double ), count, w->fp ) != ( size_t ) count )
+  {
+    w->error = 1;
+  }
+  RK4_STATS_ADD ( RK4_COUNT_BYTE, count * sizeof ( double ) );
+  w->fill = 0;
+
+  return w->error;
+}
+/******************************************************************************/
+
+static unsigned long long int rk4_traj_get_u64 ( unsigned char *b )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_get_u64 reads a little endian 64 bit integer.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  unsigned long long int v;
+
+  v = 0;
+  for ( i = 7; 0 <= i; i-- )
+  {
+    v = ( v << 8 ) | b[i];
+  }
+
+  return v;
+}
+/******************************************************************************/
+
+static int rk4_traj_little_endian ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_little_endian is 1 if doubles are stored little endian.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double one = 1.0;
+
+  return ( ( unsigned char * ) &one ) [7] == 0x3f;
+}
+/******************************************************************************/
+
+static void rk4_traj_put_u64 ( unsigned char *b, unsigned long long int v )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_put_u64 writes a little endian 64 bit integer.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+
+  for ( i = 0; i < 8; i++ )
+  {
+    b[i] = ( unsigned char ) ( v & 0xff );
+    v = v >> 8;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void rk4_traj_swap ( double a[], long int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4_traj_swap reverses the bytes of each entry of an R8VEC.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  unsigned char *b;
+  long int j;
+  int k;
+  unsigned char s;
+
+  for ( j = 0; j < n; j++ )
+  {
+    b = ( unsigned char * ) ( a + j );
+    for ( k = 0; k < 4; k++ )
+    {
+      s = b[k];
+      b[k] = b[7-k];
+      b[7-k] = s;
+    }
+  }
+
+  return;
+}
@@ -0,0 +1,71 @@
+/*
+  rk4_traj is a binary trajectory file, written record by record and read
+  back through a memory map.
+
+  The file starts with a 64 byte header, all integers little endian:
+
+     0  char magic[8]      "RK4TRAJ1"
+     8  uint32 version     1
+    12  uint32 layout      RK4_TRAJ_ROW or RK4_TRAJ_COL
+    16  uint64 m           the number of variables
+    24  uint64 n           the number of records
+    32  uint64 chunk       the number of records per chunk
+    40  uint64 offset      the byte offset of the data
+    48  uint64 names_size  the bytes of variable names that follow
+    56  uint64 reserved    0
+
+  The names of the M+1 fields, "t" first, follow as NUL terminated
+  strings.  The data starts at OFFSET, a multiple of 64, and is made of
+  little endian doubles.  A record is the time and the M values.
+
+  In RK4_TRAJ_ROW layout the records follow one another, each M+1 doubles.
+  In RK4_TRAJ_COL layout the records are grouped into chunks of CHUNK
+  records; a chunk holds the M+1 fields one after another, each CHUNK
+  doubles long, and the last chunk is padded with zeros.
+*/
+# define RK4_TRAJ_ROW 0
+# define RK4_TRAJ_COL 1
+
+/*
+  rk4_traj_writer buffers one chunk of records before writing it.
+  OFFSET is the byte offset of the data in the file.
+*/
+typedef struct
+{
+  FILE *fp;
+  int m;
+  int layout;
+  int chunk;
+  long int n;
+  long int offset;
+  int fill;
+  int error;
+  double *buf;
+} rk4_traj_writer;
+
+/*
+  rk4_traj_reader holds a mapped trajectory file.  NAMES[0:M] and DATA
+  point into the map, which stays valid until rk4_traj_unmap().
+*/
+typedef struct
+{
+  int m;
+  int layout;
+  int chunk;
+  long int n;
+  char **names;
+  double *data;
+  void *base;
+  size_t size;
+  int mapped;
+} rk4_traj_reader;
+
+int rk4_traj_close ( rk4_traj_writer *w );
+double *rk4_traj_column ( rk4_traj_reader *r, long int c, int i );
+double rk4_traj_get ( rk4_traj_reader *r, long int j, int i );
+rk4_traj_reader *rk4_traj_map ( char *filename );
+int rk4_traj_observe ( double t, int m, double y[], void *data );
+rk4_traj_writer *rk4_traj_open ( char *filename, int m, char *names[],
+  int layout, int chunk );
+void rk4_traj_unmap ( rk4_traj_reader *r );
+int rk4_traj_write ( rk4_traj_writer *w, double t, double y[] );
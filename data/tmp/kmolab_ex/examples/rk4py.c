@@ -0,0 +1,1846 @@
+/*
+  rk4py is a CPython extension module for rk4_stepper, rk4_ensemble and
+  rk45_stepper.
+
+  A right hand side is either the text of an expr_program, or the
+  address of a C function, as an int or as a ctypes function pointer.
+  For cffi, pass int ( ffi.cast ( "uintptr_t", f ) ).  The C signatures
+  are those of the _ctx integrators:
+
+    Stepper, Adaptive:
+      void dydt ( double t, double u[], double f[], void *ctx )
+    Ensemble:
+      void dydt ( double t, int nens, int m, int ld, double u[],
+        double f[], void *ctx )
+
+  with CTX given as an int address, a ctypes object, or None.  Neither
+  form calls into Python during an integration, and the GIL is released
+  while the integrators run.  A ctypes CFUNCTYPE that wraps a Python
+  function also works, since ctypes takes the GIL back for each call,
+  but it is slow, and exceptions raised in it are only printed.
+
+  Arrays pass through the buffer protocol as float64 ('d') without
+  copying.  Initial conditions and output times are read where they
+  lie, and results are written into an OUT buffer when one is given,
+  such as a NumPy array.  Otherwise a new memoryview is returned, which
+  numpy.asarray() wraps without a copy.  Each object is itself a
+  writable buffer on its current state: shape ( M ) for Stepper and
+  Adaptive, and ( M, NENS ) for Ensemble, whose rows are LD apart.
+
+  An object may be used by one thread at a time; a second thread that
+  calls it while it is integrating gets a RuntimeError.
+
+  Build with, for example:
+
+    gcc -O2 -shared -fPIC -pthread $(python3-config --includes)
+      -o rk4py$(python3-config --extension-suffix) rk4py.c rk4.c
+      rk4_ensemble.c rk45.c expr.c -lm
+*/
+# define PY_SSIZE_T_CLEAN
+# include <Python.h>
+
+# include <stdarg.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include "rk4.h"
+# include "rk4_ensemble.h"
+# include "rk45.h"
+# include "expr.h"
+
+/*
+  rk4py_rhs is a right hand side taken from Python.  DERIV and BATCH
+  are set for a function address, or to expr_deriv and
+  expr_deriv_batch with PROGRAM as CTX for a text.  REFS keeps the
+  Python objects behind the addresses alive.
+*/
+typedef struct
+{
+  void ( *deriv ) ( double t, double u[], double f[], void *ctx );
+  void ( *batch ) ( double t, int nens, int m, int ld, double u[],
+    double f[], void *ctx );
+  void *ctx;
+  expr_program *program;
+  PyObject *refs;
+} rk4py_rhs;
+
+/*
+  rk4py_recorder copies observed states into consecutive rows of Y.
+*/
+typedef struct
+{
+  double *y;
+  Py_ssize_t k;
+  Py_ssize_t k_max;
+} rk4py_recorder;
+
+typedef struct
+{
+  PyObject_HEAD
+  rk4_stepper *s;
+  rk4py_rhs rhs;
+  int busy;
+  Py_ssize_t shape[1];
+  Py_ssize_t strides[1];
+} rk4py_stepper;
+
+typedef struct
+{
+  PyObject_HEAD
+  rk4_ensemble *e;
+  rk4py_rhs rhs;
+  int busy;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+} rk4py_ensemble;
+
+typedef struct
+{
+  PyObject_HEAD
+  rk45_stepper *s;
+  rk4py_rhs rhs;
+  int busy;
+  Py_ssize_t shape[1];
+  Py_ssize_t strides[1];
+} rk4py_adaptive;
+
+static PyTypeObject rk4py_adaptive_type;
+static PyTypeObject rk4py_ensemble_type;
+static PyTypeObject rk4py_stepper_type;
+
+static PyObject *rk4py_adaptive_advance ( PyObject *self, PyObject *args );
+static void rk4py_adaptive_dealloc ( PyObject *self );
+static PyObject *rk4py_adaptive_dense ( PyObject *self, PyObject *args,
+  PyObject *kwds );
+static PyObject *rk4py_adaptive_get ( PyObject *self, void *closure );
+static int rk4py_adaptive_getbuffer ( PyObject *self, Py_buffer *view,
+  int flags );
+static int rk4py_adaptive_init ( PyObject *self, PyObject *args,
+  PyObject *kwds );
+static PyObject *rk4py_adaptive_solve ( PyObject *self, PyObject *args,
+  PyObject *kwds );
+static int rk4py_address ( PyObject *obj, void **address );
+static int rk4py_claim ( int *busy );
+static int rk4py_doubles ( PyObject *obj, Py_buffer *view, int writable,
+  char *what );
+static PyObject *rk4py_ensemble_advance ( PyObject *self, PyObject *args );
+static void rk4py_ensemble_dealloc ( PyObject *self );
+static PyObject *rk4py_ensemble_get ( PyObject *self, void *closure );
+static int rk4py_ensemble_getbuffer ( PyObject *self, Py_buffer *view,
+  int flags );
+static int rk4py_ensemble_init ( PyObject *self, PyObject *args,
+  PyObject *kwds );
+static PyObject *rk4py_ensemble_step ( PyObject *self, PyObject *args );
+static PyObject *rk4py_error ( PyObject *type, char *format, ... );
+static int rk4py_export ( PyObject *self, Py_buffer *view, int flags,
+  double *buf, int ndim, Py_ssize_t shape[], Py_ssize_t strides[] );
+static PyObject *rk4py_output ( PyObject *out, Py_ssize_t rows,
+  Py_ssize_t cols, Py_buffer *view );
+static int rk4py_ready ( void *integrator );
+static int rk4py_record ( double t, int m, double y[], void *data );
+static void rk4py_rhs_free ( rk4py_rhs *r );
+static int rk4py_rhs_init ( rk4py_rhs *r, PyObject *rhs, PyObject *ctx,
+  int m );
+static PyObject *rk4py_stepper_advance ( PyObject *self, PyObject *args );
+static void rk4py_stepper_dealloc ( PyObject *self );
+static PyObject *rk4py_stepper_get ( PyObject *self, void *closure );
+static int rk4py_stepper_getbuffer ( PyObject *self, Py_buffer *view,
+  int flags );
+static int rk4py_stepper_init ( PyObject *self, PyObject *args,
+  PyObject *kwds );
+static PyObject *rk4py_stepper_reset ( PyObject *self, PyObject *args );
+static PyObject *rk4py_stepper_step ( PyObject *self, PyObject *args );
+static PyObject *rk4py_stepper_trajectory ( PyObject *self, PyObject *args,
+  PyObject *kwds );
+
+/******************************************************************************/
+
+PyMODINIT_FUNC PyInit_rk4py ( void )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PyInit_rk4py creates the rk4py module.
+
+  Discussion:
+
+    The type objects are filled in here rather than by position, so
+    that they do not depend on the order of the PyTypeObject fields.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    PyObject *PYINIT_RK4PY: the module, or NULL with an exception set.
+*/
+{
+  static PyBufferProcs adaptive_buffer = { rk4py_adaptive_getbuffer, NULL };
+  static PyGetSetDef adaptive_getset[] = {
+    { "t", rk4py_adaptive_get, NULL, "current time", "t" },
+    { "h", rk4py_adaptive_get, NULL, "next stepsize", "h" },
+    { "m", rk4py_adaptive_get, NULL, "number of variables", "m" },
+    { "step_num", rk4py_adaptive_get, NULL, "accepted steps", "step_num" },
+    { "reject_num", rk4py_adaptive_get, NULL, "rejected steps",
+      "reject_num" },
+    { "eval_num", rk4py_adaptive_get, NULL, "right hand side calls",
+      "eval_num" },
+    { NULL } };
+  static PyMethodDef adaptive_methods[] = {
+    { "advance", rk4py_adaptive_advance, METH_VARARGS,
+      "advance(t1): take adaptive steps to T1." },
+    { "dense", ( PyCFunction ) ( void ( * ) ( void ) ) rk4py_adaptive_dense,
+      METH_VARARGS | METH_KEYWORDS,
+      "dense(t, out=None): the interpolant of the last step at T." },
+    { "solve", ( PyCFunction ) ( void ( * ) ( void ) ) rk4py_adaptive_solve,
+      METH_VARARGS | METH_KEYWORDS,
+      "solve(tout, out=None): integrate to the last of the increasing\n"
+      "times TOUT, writing the solution at each into row K of OUT." },
+    { NULL } };
+  static PyBufferProcs ensemble_buffer = { rk4py_ensemble_getbuffer, NULL };
+  static PyGetSetDef ensemble_getset[] = {
+    { "t", rk4py_ensemble_get, NULL, "current time", "t" },
+    { "m", rk4py_ensemble_get, NULL, "number of variables", "m" },
+    { "nens", rk4py_ensemble_get, NULL, "number of members", "nens" },
+    { "step_num", rk4py_ensemble_get, NULL, "steps taken", "step_num" },
+    { NULL } };
+  static PyMethodDef ensemble_methods[] = {
+    { "advance", rk4py_ensemble_advance, METH_VARARGS,
+      "advance(t1, n): take N equal steps to T1." },
+    { "step", rk4py_ensemble_step, METH_VARARGS,
+      "step(dt): take one step of size DT." },
+    { NULL } };
+  static struct PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "rk4py",
+    "RK4, ensemble RK4 and adaptive RK45 integrators.", -1, NULL, NULL,
+    NULL, NULL, NULL };
+  static PyBufferProcs stepper_buffer = { rk4py_stepper_getbuffer, NULL };
+  static PyGetSetDef stepper_getset[] = {
+    { "t", rk4py_stepper_get, NULL, "current time", "t" },
+    { "m", rk4py_stepper_get, NULL, "number of variables", "m" },
+    { "step_num", rk4py_stepper_get, NULL, "steps taken", "step_num" },
+    { NULL } };
+  static PyMethodDef stepper_methods[] = {
+    { "advance", rk4py_stepper_advance, METH_VARARGS,
+      "advance(t1, n): take N equal steps to T1." },
+    { "reset", rk4py_stepper_reset, METH_VARARGS,
+      "reset(t0, y0): restart from Y0 at T0." },
+    { "step", rk4py_stepper_step, METH_VARARGS,
+      "step(dt): take one step of size DT." },
+    { "trajectory",
+      ( PyCFunction ) ( void ( * ) ( void ) ) rk4py_stepper_trajectory,
+      METH_VARARGS | METH_KEYWORDS,
+      "trajectory(t1, n, out=None): take N equal steps to T1, writing\n"
+      "the start and every step into the N+1 rows of OUT." },
+    { NULL } };
+  PyObject *mod;
+
+  rk4py_stepper_type.tp_name = "rk4py.Stepper";
+  rk4py_stepper_type.tp_doc = "Stepper(rhs, y0, t0=0.0, ctx=None): "
+    "a fixed step RK4 integrator.";
+  rk4py_stepper_type.tp_basicsize = sizeof ( rk4py_stepper );
+  rk4py_stepper_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  rk4py_stepper_type.tp_new = PyType_GenericNew;
+  rk4py_stepper_type.tp_init = rk4py_stepper_init;
+  rk4py_stepper_type.tp_dealloc = rk4py_stepper_dealloc;
+  rk4py_stepper_type.tp_methods = stepper_methods;
+  rk4py_stepper_type.tp_getset = stepper_getset;
+  rk4py_stepper_type.tp_as_buffer = &stepper_buffer;
+
+  rk4py_ensemble_type.tp_name = "rk4py.Ensemble";
+  rk4py_ensemble_type.tp_doc = "Ensemble(rhs, y0, t0=0.0, ctx=None): "
+    "RK4 for the NENS rows of Y0, advanced together.";
+  rk4py_ensemble_type.tp_basicsize = sizeof ( rk4py_ensemble );
+  rk4py_ensemble_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  rk4py_ensemble_type.tp_new = PyType_GenericNew;
+  rk4py_ensemble_type.tp_init = rk4py_ensemble_init;
+  rk4py_ensemble_type.tp_dealloc = rk4py_ensemble_dealloc;
+  rk4py_ensemble_type.tp_methods = ensemble_methods;
+  rk4py_ensemble_type.tp_getset = ensemble_getset;
+  rk4py_ensemble_type.tp_as_buffer = &ensemble_buffer;
+
+  rk4py_adaptive_type.tp_name = "rk4py.Adaptive";
+  rk4py_adaptive_type.tp_doc = "Adaptive(rhs, y0, t0=0.0, rtol=1e-6, "
+    "atol=1e-9, ctx=None): an adaptive Dormand-Prince 5(4) integrator.";
+  rk4py_adaptive_type.tp_basicsize = sizeof ( rk4py_adaptive );
+  rk4py_adaptive_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  rk4py_adaptive_type.tp_new = PyType_GenericNew;
+  rk4py_adaptive_type.tp_init = rk4py_adaptive_init;
+  rk4py_adaptive_type.tp_dealloc = rk4py_adaptive_dealloc;
+  rk4py_adaptive_type.tp_methods = adaptive_methods;
+  rk4py_adaptive_type.tp_getset = adaptive_getset;
+  rk4py_adaptive_type.tp_as_buffer = &adaptive_buffer;
+
+  if ( PyType_Ready ( &rk4py_stepper_type ) < 0
+    || PyType_Ready ( &rk4py_ensemble_type ) < 0
+    || PyType_Ready ( &rk4py_adaptive_type ) < 0 )
+  {
+    return NULL;
+  }
+
+  mod = PyModule_Create ( &module );
+  if ( mod == NULL )
+  {
+    return NULL;
+  }
+
+  Py_INCREF ( &rk4py_stepper_type );
+  Py_INCREF ( &rk4py_ensemble_type );
+  Py_INCREF ( &rk4py_adaptive_type );
+  if ( PyModule_AddObject ( mod, "Stepper",
+         ( PyObject * ) &rk4py_stepper_type ) < 0
+    || PyModule_AddObject ( mod, "Ensemble",
+         ( PyObject * ) &rk4py_ensemble_type ) < 0
+    || PyModule_AddObject ( mod, "Adaptive",
+         ( PyObject * ) &rk4py_adaptive_type ) < 0 )
+  {
+    Py_DECREF ( mod );
+    return NULL;
+  }
+
+  return mod;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_adaptive_advance ( PyObject *self, PyObject *args )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_advance implements Adaptive.advance ( t1 ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_adaptive *o;
+  int status;
+  double t1;
+
+  o = ( rk4py_adaptive * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+
+  if ( !PyArg_ParseTuple ( args, "d", &t1 ) || rk4py_claim ( &o->busy ) )
+  {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  status = rk45_advance ( o->s, t1 );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+
+  if ( status != 0 )
+  {
+    rk4py_error ( PyExc_RuntimeError, "stepsize too small at t = %g",
+      o->s->t );
+    return NULL;
+  }
+
+  Py_RETURN_NONE;
+}
+/******************************************************************************/
+
+static void rk4py_adaptive_dealloc ( PyObject *self )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_dealloc frees an Adaptive object.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_adaptive *o;
+
+  o = ( rk4py_adaptive * ) self;
+  rk45_destroy ( o->s );
+  rk4py_rhs_free ( &o->rhs );
+  Py_TYPE ( self )->tp_free ( self );
+
+  return;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_adaptive_dense ( PyObject *self, PyObject *args,
+  PyObject *kwds )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_dense implements Adaptive.dense ( t, out = None ).
+
+  Discussion:
+
+    T must lie in the last step, from S->T_OLD to S->T.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  static char *kwlist[] = { "t", "out", NULL };
+  rk4py_adaptive *o;
+  PyObject *out;
+  PyObject *result;
+  double t;
+  Py_buffer view;
+
+  o = ( rk4py_adaptive * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+  out = Py_None;
+
+  if ( !PyArg_ParseTupleAndKeywords ( args, kwds, "d|O", kwlist, &t, &out ) )
+  {
+    return NULL;
+  }
+
+  if ( !( o->s->t_old <= t && t <= o->s->t ) )
+  {
+    return rk4py_error ( PyExc_ValueError,
+      "t = %g is outside the last step, [%g, %g]", t, o->s->t_old, o->s->t );
+  }
+
+  result = rk4py_output ( out, o->s->m, 0, &view );
+  if ( result == NULL || rk4py_claim ( &o->busy ) )
+  {
+    if ( result != NULL )
+    {
+      PyBuffer_Release ( &view );
+      Py_DECREF ( result );
+    }
+    return NULL;
+  }
+  rk45_dense ( o->s, t, ( double * ) view.buf );
+  o->busy = 0;
+  PyBuffer_Release ( &view );
+
+  return result;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_adaptive_get ( PyObject *self, void *closure )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_get returns the attribute of an Adaptive object named
+    by CLOSURE.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  char *name;
+  rk45_stepper *s;
+
+  name = ( char * ) closure;
+  s = ( ( rk4py_adaptive * ) self )->s;
+
+  if ( s == NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "Adaptive is not initialized" );
+    return NULL;
+  }
+  if ( strcmp ( name, "t" ) == 0 )
+  {
+    return PyFloat_FromDouble ( s->t );
+  }
+  if ( strcmp ( name, "h" ) == 0 )
+  {
+    return PyFloat_FromDouble ( s->h );
+  }
+  if ( strcmp ( name, "m" ) == 0 )
+  {
+    return PyLong_FromLong ( s->m );
+  }
+  if ( strcmp ( name, "step_num" ) == 0 )
+  {
+    return PyLong_FromLong ( s->step_num );
+  }
+  if ( strcmp ( name, "reject_num" ) == 0 )
+  {
+    return PyLong_FromLong ( s->reject_num );
+  }
+  return PyLong_FromLong ( s->eval_num );
+}
+/******************************************************************************/
+
+static int rk4py_adaptive_getbuffer ( PyObject *self, Py_buffer *view,
+  int flags )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_getbuffer exports the state of an Adaptive object.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_adaptive *o;
+
+  o = ( rk4py_adaptive * ) self;
+
+  if ( o->s == NULL )
+  {
+    PyErr_SetString ( PyExc_BufferError, "Adaptive is not initialized" );
+    return -1;
+  }
+
+  return rk4py_export ( self, view, flags, o->s->y, 1, o->shape,
+    o->strides );
+}
+/******************************************************************************/
+
+static int rk4py_adaptive_init ( PyObject *self, PyObject *args,
+  PyObject *kwds )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_init implements Adaptive ( rhs, y0, t0 = 0.0,
+    rtol = 1e-6, atol = 1e-9, ctx = None ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double atol;
+  PyObject *ctx;
+  static char *kwlist[] = { "rhs", "y0", "t0", "rtol", "atol", "ctx",
+    NULL };
+  int m;
+  rk4py_adaptive *o;
+  PyObject *rhs;
+  double rtol;
+  double t0;
+  Py_buffer view;
+  PyObject *y0;
+
+  o = ( rk4py_adaptive * ) self;
+  ctx = Py_None;
+  t0 = 0.0;
+  rtol = 1.0E-06;
+  atol = 1.0E-09;
+
+  if ( o->s != NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "Adaptive is already initialized" );
+    return -1;
+  }
+
+  if ( !PyArg_ParseTupleAndKeywords ( args, kwds, "OO|dddO", kwlist, &rhs,
+    &y0, &t0, &rtol, &atol, &ctx ) )
+  {
+    return -1;
+  }
+
+  if ( rk4py_doubles ( y0, &view, 0, "y0" ) < 0 )
+  {
+    return -1;
+  }
+  m = ( int ) ( view.len / sizeof ( double ) );
+  if ( m == 0 )
+  {
+    PyErr_SetString ( PyExc_ValueError, "y0 is empty" );
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+
+  if ( rk4py_rhs_init ( &o->rhs, rhs, ctx, m ) < 0 )
+  {
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+
+  o->s = rk45_create_ctx ( o->rhs.deriv, o->rhs.ctx, m, t0,
+    ( double * ) view.buf, rtol, atol );
+  PyBuffer_Release ( &view );
+  if ( o->s == NULL )
+  {
+    PyErr_NoMemory ( );
+    rk4py_rhs_free ( &o->rhs );
+    return -1;
+  }
+
+  o->busy = 0;
+  o->shape[0] = m;
+  o->strides[0] = sizeof ( double );
+
+  return 0;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_adaptive_solve ( PyObject *self, PyObject *args,
+  PyObject *kwds )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_adaptive_solve implements Adaptive.solve ( tout, out = None ).
+
+  Discussion:
+
+    The solution at the output times comes from the dense output, so the
+    times do not limit the stepsize.  TOUT must be increasing, and must
+    not start before the current time.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  static char *kwlist[] = { "tout", "out", NULL };
+  Py_ssize_t k;
+  int m;
+  rk4py_adaptive *o;
+  rk4_observer obs;
+  PyObject *out;
+  rk4py_recorder rec;
+  PyObject *result;
+  int status;
+  Py_buffer tview;
+  PyObject *tout;
+  Py_ssize_t tout_num;
+  Py_buffer view;
+
+  o = ( rk4py_adaptive * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+  out = Py_None;
+  m = o->s->m;
+
+  if ( !PyArg_ParseTupleAndKeywords ( args, kwds, "O|O", kwlist, &tout,
+    &out ) )
+  {
+    return NULL;
+  }
+
+  if ( rk4py_doubles ( tout, &tview, 0, "tout" ) < 0 )
+  {
+    return NULL;
+  }
+  tout_num = tview.len / sizeof ( double );
+  if ( tout_num == 0 || INT_MAX < tout_num
+    || ( ( double * ) tview.buf )[0] < o->s->t )
+  {
+    PyErr_SetString ( PyExc_ValueError,
+      "tout must be nonempty and not start before t" );
+    PyBuffer_Release ( &tview );
+    return NULL;
+  }
+  for ( k = 1; k < tout_num; k++ )
+  {
+    if ( !( ( ( double * ) tview.buf )[k-1] < ( ( double * ) tview.buf )[k] ) )
+    {
+      rk4py_error ( PyExc_ValueError, "tout must be increasing, but "
+        "tout[%zd] = %g follows %g", k, ( ( double * ) tview.buf )[k],
+        ( ( double * ) tview.buf )[k-1] );
+      PyBuffer_Release ( &tview );
+      return NULL;
+    }
+  }
+
+  result = rk4py_output ( out, tout_num, m, &view );
+  if ( result == NULL || rk4py_claim ( &o->busy ) )
+  {
+    PyBuffer_Release ( &tview );
+    if ( result != NULL )
+    {
+      PyBuffer_Release ( &view );
+      Py_DECREF ( result );
+    }
+    return NULL;
+  }
+
+  rec.y = ( double * ) view.buf;
+  rec.k = 0;
+  rec.k_max = tout_num;
+  obs.observe = rk4py_record;
+  obs.data = &rec;
+  obs.every = 0;
+  obs.tout_num = ( int ) tout_num;
+  obs.tout = ( double * ) tview.buf;
+
+  Py_BEGIN_ALLOW_THREADS
+  status = rk45_observe ( o->s, obs.tout[tout_num-1], &obs );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+  PyBuffer_Release ( &tview );
+  PyBuffer_Release ( &view );
+
+  if ( status != 0 )
+  {
+    rk4py_error ( PyExc_RuntimeError, "stepsize too small at t = %g",
+      o->s->t );
+    Py_DECREF ( result );
+    return NULL;
+  }
+
+  return result;
+}
+/******************************************************************************/
+
+static int rk4py_address ( PyObject *obj, void **address )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_address gets an address from an int or a ctypes object.
+
+  Discussion:
+
+    Anything that ctypes.cast() accepts, such as a CFUNCTYPE instance,
+    a ctypes pointer or a ctypes array, is converted to c_void_p.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  PyObject *ctypes;
+  PyObject *value;
+  PyObject *voidp;
+  PyObject *voidp_type;
+
+  if ( PyLong_Check ( obj ) )
+  {
+    *address = PyLong_AsVoidPtr ( obj );
+    return PyErr_Occurred ( ) ? -1 : 0;
+  }
+
+  ctypes = PyImport_ImportModule ( "ctypes" );
+  if ( ctypes == NULL )
+  {
+    return -1;
+  }
+  voidp_type = PyObject_GetAttrString ( ctypes, "c_void_p" );
+  if ( voidp_type == NULL )
+  {
+    Py_DECREF ( ctypes );
+    return -1;
+  }
+  voidp = PyObject_CallMethod ( ctypes, "cast", "OO", obj, voidp_type );
+  Py_DECREF ( voidp_type );
+  Py_DECREF ( ctypes );
+  if ( voidp == NULL )
+  {
+    PyErr_Clear ( );
+    PyErr_SetString ( PyExc_TypeError,
+      "expected a str, an int address or a ctypes object" );
+    return -1;
+  }
+  value = PyObject_GetAttrString ( voidp, "value" );
+  Py_DECREF ( voidp );
+  if ( value == NULL )
+  {
+    return -1;
+  }
+
+  *address = ( value == Py_None ) ? NULL : PyLong_AsVoidPtr ( value );
+  Py_DECREF ( value );
+
+  return PyErr_Occurred ( ) ? -1 : 0;
+}
+/******************************************************************************/
+
+static int rk4py_claim ( int *busy )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_claim marks an object as in use by the calling thread.
+
+  Discussion:
+
+    The flag is only read and set while holding the GIL.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  if ( *busy )
+  {
+    PyErr_SetString ( PyExc_RuntimeError,
+      "object is in use by another thread" );
+    return -1;
+  }
+  *busy = 1;
+
+  return 0;
+}
+/******************************************************************************/
+
+static int rk4py_doubles ( PyObject *obj, Py_buffer *view, int writable,
+  char *what )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_doubles gets a C contiguous float64 buffer from OBJ.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int flags;
+  char *format;
+
+  flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+  if ( writable )
+  {
+    flags = flags | PyBUF_WRITABLE;
+  }
+
+  if ( PyObject_GetBuffer ( obj, view, flags ) < 0 )
+  {
+    PyErr_Clear ( );
+    PyErr_Format ( PyExc_TypeError,
+      "%s must be a C contiguous%s buffer of float64", what,
+      writable ? ", writable" : "" );
+    return -1;
+  }
+
+  format = ( view->format == NULL ) ? "B" : view->format;
+  if ( format[0] == '@' || format[0] == '='
+# if PY_LITTLE_ENDIAN
+    || format[0] == '<'
+# else
+    || format[0] == '>'
+# endif
+    )
+  {
+    format = format + 1;
+  }
+
+  if ( strcmp ( format, "d" ) != 0 || view->itemsize != sizeof ( double ) )
+  {
+    PyErr_Format ( PyExc_TypeError, "%s must hold float64, not '%s'", what,
+      ( view->format == NULL ) ? "B" : view->format );
+    PyBuffer_Release ( view );
+    return -1;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_ensemble_advance ( PyObject *self, PyObject *args )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ensemble_advance implements Ensemble.advance ( t1, n ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int n;
+  rk4py_ensemble *o;
+  double t1;
+
+  o = ( rk4py_ensemble * ) self;
+  if ( rk4py_ready ( o->e ) < 0 )
+  {
+    return NULL;
+  }
+
+  if ( !PyArg_ParseTuple ( args, "di", &t1, &n ) || rk4py_claim ( &o->busy ) )
+  {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rk4_ensemble_advance ( o->e, t1, n );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+
+  Py_RETURN_NONE;
+}
+/******************************************************************************/
+
+static void rk4py_ensemble_dealloc ( PyObject *self )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ensemble_dealloc frees an Ensemble object.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_ensemble *o;
+
+  o = ( rk4py_ensemble * ) self;
+  rk4_ensemble_destroy ( o->e );
+  rk4py_rhs_free ( &o->rhs );
+  Py_TYPE ( self )->tp_free ( self );
+
+  return;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_ensemble_get ( PyObject *self, void *closure )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ensemble_get returns the attribute of an Ensemble object named
+    by CLOSURE.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4_ensemble *e;
+  char *name;
+
+  name = ( char * ) closure;
+  e = ( ( rk4py_ensemble * ) self )->e;
+
+  if ( e == NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "Ensemble is not initialized" );
+    return NULL;
+  }
+  if ( strcmp ( name, "t" ) == 0 )
+  {
+    return PyFloat_FromDouble ( e->t );
+  }
+  if ( strcmp ( name, "m" ) == 0 )
+  {
+    return PyLong_FromLong ( e->m );
+  }
+  if ( strcmp ( name, "nens" ) == 0 )
+  {
+    return PyLong_FromLong ( e->nens );
+  }
+  return PyLong_FromLong ( e->step_num );
+}
+/******************************************************************************/
+
+static int rk4py_ensemble_getbuffer ( PyObject *self, Py_buffer *view,
+  int flags )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ensemble_getbuffer exports the states of an Ensemble object.
+
+  Discussion:
+
+    Component I of member K is at [I,K].  The rows are LD apart, so the
+    buffer is only contiguous when NENS is a multiple of
+    RK4_ALIGN / sizeof ( double ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_ensemble *o;
+
+  o = ( rk4py_ensemble * ) self;
+
+  if ( o->e == NULL )
+  {
+    PyErr_SetString ( PyExc_BufferError, "Ensemble is not initialized" );
+    return -1;
+  }
+
+  return rk4py_export ( self, view, flags, o->e->y, 2, o->shape,
+    o->strides );
+}
+/******************************************************************************/
+
+static int rk4py_ensemble_init ( PyObject *self, PyObject *args,
+  PyObject *kwds )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ensemble_init implements Ensemble ( rhs, y0, t0 = 0.0,
+    ctx = None ).
+
+  Discussion:
+
+    Y0 has shape ( NENS, M ), one member per row.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  PyObject *ctx;
+  int i;
+  int k;
+  static char *kwlist[] = { "rhs", "y0", "t0", "ctx", NULL };
+  int m;
+  int nens;
+  rk4py_ensemble *o;
+  PyObject *rhs;
+  double t0;
+  Py_buffer view;
+  double *y;
+  PyObject *y0;
+
+  o = ( rk4py_ensemble * ) self;
+  ctx = Py_None;
+  t0 = 0.0;
+
+  if ( o->e != NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "Ensemble is already initialized" );
+    return -1;
+  }
+
+  if ( !PyArg_ParseTupleAndKeywords ( args, kwds, "OO|dO", kwlist, &rhs,
+    &y0, &t0, &ctx ) )
+  {
+    return -1;
+  }
+
+  if ( rk4py_doubles ( y0, &view, 0, "y0" ) < 0 )
+  {
+    return -1;
+  }
+  if ( view.ndim != 2 || INT_MAX < view.shape[0] || INT_MAX < view.shape[1] )
+  {
+    PyErr_SetString ( PyExc_ValueError, "y0 must have shape (nens, m)" );
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+  nens = ( int ) view.shape[0];
+  m = ( int ) view.shape[1];
+  if ( nens <= 0 || m <= 0 )
+  {
+    PyErr_SetString ( PyExc_ValueError,
+      "y0 must have at least one member and one variable" );
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+
+  if ( rk4py_rhs_init ( &o->rhs, rhs, ctx, m ) < 0 )
+  {
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+
+  o->e = rk4_ensemble_create_ctx ( o->rhs.batch, o->rhs.ctx, m, nens, t0 );
+  if ( o->e == NULL )
+  {
+    PyBuffer_Release ( &view );
+    PyErr_NoMemory ( );
+    rk4py_rhs_free ( &o->rhs );
+    return -1;
+  }
+
+  y = ( double * ) view.buf;
+  for ( k = 0; k < nens; k++ )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      o->e->y[i*o->e->ld+k] = y[k*m+i];
+    }
+  }
+  PyBuffer_Release ( &view );
+
+  o->busy = 0;
+  o->shape[0] = m;
+  o->shape[1] = nens;
+  o->strides[0] = o->e->ld * sizeof ( double );
+  o->strides[1] = sizeof ( double );
+
+  return 0;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_ensemble_step ( PyObject *self, PyObject *args )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ensemble_step implements Ensemble.step ( dt ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double dt;
+  rk4py_ensemble *o;
+
+  o = ( rk4py_ensemble * ) self;
+  if ( rk4py_ready ( o->e ) < 0 )
+  {
+    return NULL;
+  }
+
+  if ( !PyArg_ParseTuple ( args, "d", &dt ) || rk4py_claim ( &o->busy ) )
+  {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rk4_ensemble_step ( o->e, dt );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+
+  Py_RETURN_NONE;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_error ( PyObject *type, char *format, ... )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_error raises an exception with a printf message.
+
+  Discussion:
+
+    PyErr_Format() does not accept floating point conversions such as
+    %g, so the message is formatted here.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  va_list args;
+  char message[256];
+
+  va_start ( args, format );
+  vsnprintf ( message, sizeof ( message ), format, args );
+  va_end ( args );
+
+  PyErr_SetString ( type, message );
+
+  return NULL;
+}
+/******************************************************************************/
+
+static int rk4py_export ( PyObject *self, Py_buffer *view, int flags,
+  double *buf, int ndim, Py_ssize_t shape[], Py_ssize_t strides[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_export fills in a writable float64 view of BUF.
+
+  Discussion:
+
+    SHAPE and STRIDES live in the object, which the view keeps alive.
+    A consumer that does not ask for strides only gets a contiguous
+    array.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int contiguous;
+  int i;
+  Py_ssize_t n;
+
+  contiguous = 1;
+  n = 1;
+  for ( i = ndim - 1; 0 <= i; i-- )
+  {
+    if ( strides[i] != n * ( Py_ssize_t ) sizeof ( double ) )
+    {
+      contiguous = 0;
+    }
+    n = n * shape[i];
+  }
+
+  if ( ( flags & PyBUF_F_CONTIGUOUS ) == PyBUF_F_CONTIGUOUS && 1 < ndim )
+  {
+    PyErr_SetString ( PyExc_BufferError, "the state is stored by rows" );
+    view->obj = NULL;
+    return -1;
+  }
+  if ( !contiguous && ( ( flags & PyBUF_STRIDES ) != PyBUF_STRIDES
+    || ( flags & PyBUF_C_CONTIGUOUS ) == PyBUF_C_CONTIGUOUS
+    || ( flags & PyBUF_ANY_CONTIGUOUS ) == PyBUF_ANY_CONTIGUOUS ) )
+  {
+    PyErr_SetString ( PyExc_BufferError,
+      "the rows are padded; ask for a strided buffer" );
+    view->obj = NULL;
+    return -1;
+  }
+
+  view->obj = self;
+  Py_INCREF ( self );
+  view->buf = ( void * ) buf;
+  view->len = n * sizeof ( double );
+  view->readonly = 0;
+  view->itemsize = sizeof ( double );
+  view->format = ( flags & PyBUF_FORMAT ) ? "d" : NULL;
+  view->ndim = ndim;
+  view->shape = ( flags & PyBUF_ND ) ? shape : NULL;
+  view->strides = ( ( flags & PyBUF_STRIDES ) == PyBUF_STRIDES ) ? strides
+    : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+
+  return 0;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_output ( PyObject *out, Py_ssize_t rows,
+  Py_ssize_t cols, Py_buffer *view )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_output gets the buffer for a result of ROWS by COLS values.
+
+  Discussion:
+
+    If OUT is None, a new zeroed memoryview of shape ( ROWS, COLS ) is
+    made, or of shape ( ROWS ) if COLS is 0.  Otherwise OUT must be a
+    writable float64 buffer with room for the result.  The return value
+    is a new reference to the object whose buffer is VIEW.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  PyObject *bytes;
+  PyObject *mv;
+  Py_ssize_t n;
+  PyObject *result;
+
+  n = ( cols == 0 ) ? rows : rows * cols;
+
+  if ( out == Py_None )
+  {
+    bytes = PyByteArray_FromStringAndSize ( NULL, n * sizeof ( double ) );
+    if ( bytes == NULL )
+    {
+      return NULL;
+    }
+    memset ( PyByteArray_AS_STRING ( bytes ), 0, n * sizeof ( double ) );
+    mv = PyMemoryView_FromObject ( bytes );
+    Py_DECREF ( bytes );
+    if ( mv == NULL )
+    {
+      return NULL;
+    }
+    if ( cols == 0 )
+    {
+      result = PyObject_CallMethod ( mv, "cast", "s", "d" );
+    }
+    else
+    {
+      result = PyObject_CallMethod ( mv, "cast", "s(nn)", "d", rows, cols );
+    }
+    Py_DECREF ( mv );
+  }
+  else
+  {
+    result = out;
+    Py_INCREF ( result );
+  }
+
+  if ( result == NULL )
+  {
+    return NULL;
+  }
+
+  if ( rk4py_doubles ( result, view, 1, "out" ) < 0 )
+  {
+    Py_DECREF ( result );
+    return NULL;
+  }
+  if ( view->len < n * ( Py_ssize_t ) sizeof ( double ) )
+  {
+    PyErr_Format ( PyExc_ValueError, "out must hold at least %zd values",
+      n );
+    PyBuffer_Release ( view );
+    Py_DECREF ( result );
+    return NULL;
+  }
+
+  return result;
+}
+/******************************************************************************/
+
+static int rk4py_ready ( void *integrator )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_ready checks that __init__ has made the integrator.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  if ( integrator == NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "object is not initialized" );
+    return -1;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static int rk4py_record ( double t, int m, double y[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_record is the observer that copies each state into the next
+    row of the output.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_recorder *rec;
+
+  rec = ( rk4py_recorder * ) data;
+
+  if ( rec->k_max <= rec->k )
+  {
+    return 1;
+  }
+  memcpy ( rec->y + rec->k * m, y, m * sizeof ( double ) );
+  rec->k = rec->k + 1;
+
+  return 0;
+}
+/******************************************************************************/
+
+static void rk4py_rhs_free ( rk4py_rhs *r )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_rhs_free releases a right hand side.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  expr_destroy ( r->program );
+  r->program = NULL;
+  Py_CLEAR ( r->refs );
+
+  return;
+}
+/******************************************************************************/
+
+static int rk4py_rhs_init ( rk4py_rhs *r, PyObject *rhs, PyObject *ctx,
+  int m )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_rhs_init sets up a right hand side from a text or an address.
+
+  Discussion:
+
+    M is the number of variables of the initial condition, which a
+    compiled text must match.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  void *address;
+  char error[EXPR_ERROR_LEN];
+  const char *text;
+
+  r->deriv = NULL;
+  r->batch = NULL;
+  r->ctx = NULL;
+  r->program = NULL;
+  r->refs = NULL;
+
+  if ( PyUnicode_Check ( rhs ) )
+  {
+    if ( ctx != Py_None )
+    {
+      PyErr_SetString ( PyExc_ValueError, "ctx is only for C functions" );
+      return -1;
+    }
+    text = PyUnicode_AsUTF8 ( rhs );
+    if ( text == NULL )
+    {
+      return -1;
+    }
+    r->program = expr_compile ( ( char * ) text, error );
+    if ( r->program == NULL )
+    {
+      PyErr_SetString ( PyExc_ValueError, error );
+      return -1;
+    }
+    if ( r->program->m != m )
+    {
+      PyErr_Format ( PyExc_ValueError,
+        "the equations have %d variables, but y0 has %d", r->program->m, m );
+      rk4py_rhs_free ( r );
+      return -1;
+    }
+    r->deriv = expr_deriv;
+    r->batch = expr_deriv_batch;
+    r->ctx = ( void * ) r->program;
+    return 0;
+  }
+
+  if ( rk4py_address ( rhs, &address ) < 0 )
+  {
+    return -1;
+  }
+  if ( address == NULL )
+  {
+    PyErr_SetString ( PyExc_ValueError, "rhs is a null pointer" );
+    return -1;
+  }
+  r->deriv = ( void ( * ) ( double, double *, double *, void * ) ) address;
+  r->batch = ( void ( * ) ( double, int, int, int, double *, double *,
+    void * ) ) address;
+
+  if ( ctx != Py_None && rk4py_address ( ctx, &r->ctx ) < 0 )
+  {
+    return -1;
+  }
+
+  r->refs = PyTuple_Pack ( 2, rhs, ctx );
+
+  return ( r->refs == NULL ) ? -1 : 0;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_stepper_advance ( PyObject *self, PyObject *args )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_advance implements Stepper.advance ( t1, n ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int n;
+  rk4py_stepper *o;
+  double t1;
+
+  o = ( rk4py_stepper * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+
+  if ( !PyArg_ParseTuple ( args, "di", &t1, &n ) || rk4py_claim ( &o->busy ) )
+  {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rk4_stepper_advance ( o->s, t1, n );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+
+  Py_RETURN_NONE;
+}
+/******************************************************************************/
+
+static void rk4py_stepper_dealloc ( PyObject *self )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_dealloc frees a Stepper object.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_stepper *o;
+
+  o = ( rk4py_stepper * ) self;
+  rk4_stepper_destroy ( o->s );
+  rk4py_rhs_free ( &o->rhs );
+  Py_TYPE ( self )->tp_free ( self );
+
+  return;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_stepper_get ( PyObject *self, void *closure )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_get returns the attribute of a Stepper object named by
+    CLOSURE.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  char *name;
+  rk4_stepper *s;
+
+  name = ( char * ) closure;
+  s = ( ( rk4py_stepper * ) self )->s;
+
+  if ( s == NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "Stepper is not initialized" );
+    return NULL;
+  }
+  if ( strcmp ( name, "t" ) == 0 )
+  {
+    return PyFloat_FromDouble ( s->t );
+  }
+  if ( strcmp ( name, "m" ) == 0 )
+  {
+    return PyLong_FromLong ( s->m );
+  }
+  return PyLong_FromLong ( s->step_num );
+}
+/******************************************************************************/
+
+static int rk4py_stepper_getbuffer ( PyObject *self, Py_buffer *view,
+  int flags )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_getbuffer exports the state of a Stepper object.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_stepper *o;
+
+  o = ( rk4py_stepper * ) self;
+
+  if ( o->s == NULL )
+  {
+    PyErr_SetString ( PyExc_BufferError, "Stepper is not initialized" );
+    return -1;
+  }
+
+  return rk4py_export ( self, view, flags, o->s->y, 1, o->shape,
+    o->strides );
+}
+/******************************************************************************/
+
+static int rk4py_stepper_init ( PyObject *self, PyObject *args,
+  PyObject *kwds )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_init implements Stepper ( rhs, y0, t0 = 0.0,
+    ctx = None ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  PyObject *ctx;
+  static char *kwlist[] = { "rhs", "y0", "t0", "ctx", NULL };
+  int m;
+  rk4py_stepper *o;
+  PyObject *rhs;
+  double t0;
+  Py_buffer view;
+  PyObject *y0;
+
+  o = ( rk4py_stepper * ) self;
+  ctx = Py_None;
+  t0 = 0.0;
+
+  if ( o->s != NULL )
+  {
+    PyErr_SetString ( PyExc_RuntimeError, "Stepper is already initialized" );
+    return -1;
+  }
+
+  if ( !PyArg_ParseTupleAndKeywords ( args, kwds, "OO|dO", kwlist, &rhs,
+    &y0, &t0, &ctx ) )
+  {
+    return -1;
+  }
+
+  if ( rk4py_doubles ( y0, &view, 0, "y0" ) < 0 )
+  {
+    return -1;
+  }
+  m = ( int ) ( view.len / sizeof ( double ) );
+  if ( m == 0 )
+  {
+    PyErr_SetString ( PyExc_ValueError, "y0 is empty" );
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+
+  if ( rk4py_rhs_init ( &o->rhs, rhs, ctx, m ) < 0 )
+  {
+    PyBuffer_Release ( &view );
+    return -1;
+  }
+
+  o->s = rk4_stepper_create_ctx ( o->rhs.deriv, o->rhs.ctx, m, t0,
+    ( double * ) view.buf );
+  PyBuffer_Release ( &view );
+  if ( o->s == NULL )
+  {
+    PyErr_NoMemory ( );
+    rk4py_rhs_free ( &o->rhs );
+    return -1;
+  }
+
+  o->busy = 0;
+  o->shape[0] = m;
+  o->strides[0] = sizeof ( double );
+
+  return 0;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_stepper_reset ( PyObject *self, PyObject *args )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_reset implements Stepper.reset ( t0, y0 ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  rk4py_stepper *o;
+  double t0;
+  Py_buffer view;
+  PyObject *y0;
+
+  o = ( rk4py_stepper * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+
+  if ( !PyArg_ParseTuple ( args, "dO", &t0, &y0 ) )
+  {
+    return NULL;
+  }
+  if ( rk4py_doubles ( y0, &view, 0, "y0" ) < 0 )
+  {
+    return NULL;
+  }
+  if ( view.len != o->s->m * ( Py_ssize_t ) sizeof ( double ) )
+  {
+    PyErr_Format ( PyExc_ValueError, "y0 must hold %d values", o->s->m );
+    PyBuffer_Release ( &view );
+    return NULL;
+  }
+  if ( rk4py_claim ( &o->busy ) )
+  {
+    PyBuffer_Release ( &view );
+    return NULL;
+  }
+
+  rk4_stepper_reset ( o->s, t0, ( double * ) view.buf );
+
+  o->busy = 0;
+  PyBuffer_Release ( &view );
+
+  Py_RETURN_NONE;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_stepper_step ( PyObject *self, PyObject *args )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_step implements Stepper.step ( dt ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double dt;
+  rk4py_stepper *o;
+
+  o = ( rk4py_stepper * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+
+  if ( !PyArg_ParseTuple ( args, "d", &dt ) || rk4py_claim ( &o->busy ) )
+  {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rk4_stepper_step ( o->s, dt );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+
+  Py_RETURN_NONE;
+}
+/******************************************************************************/
+
+static PyObject *rk4py_stepper_trajectory ( PyObject *self, PyObject *args,
+  PyObject *kwds )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    rk4py_stepper_trajectory implements Stepper.trajectory ( t1, n,
+    out = None ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  static char *kwlist[] = { "t1", "n", "out", NULL };
+  int n;
+  rk4py_stepper *o;
+  rk4_observer obs;
+  PyObject *out;
+  rk4py_recorder rec;
+  PyObject *result;
+  double t1;
+  Py_buffer view;
+
+  o = ( rk4py_stepper * ) self;
+  if ( rk4py_ready ( o->s ) < 0 )
+  {
+    return NULL;
+  }
+  out = Py_None;
+
+  if ( !PyArg_ParseTupleAndKeywords ( args, kwds, "di|O", kwlist, &t1, &n,
+    &out ) )
+  {
+    return NULL;
+  }
+  if ( n <= 0 )
+  {
+    PyErr_SetString ( PyExc_ValueError, "n must be positive" );
+    return NULL;
+  }
+
+  result = rk4py_output ( out, ( Py_ssize_t ) n + 1, o->s->m, &view );
+  if ( result == NULL )
+  {
+    return NULL;
+  }
+  if ( rk4py_claim ( &o->busy ) )
+  {
+    PyBuffer_Release ( &view );
+    Py_DECREF ( result );
+    return NULL;
+  }
+
+  rec.y = ( double * ) view.buf;
+  rec.k = 0;
+  rec.k_max = ( Py_ssize_t ) n + 1;
+  obs.observe = rk4py_record;
+  obs.data = &rec;
+  obs.every = 1;
+  obs.tout_num = 0;
+  obs.tout = NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  rk4_stepper_observe ( o->s, t1, n, &obs );
+  Py_END_ALLOW_THREADS
+
+  o->busy = 0;
+  PyBuffer_Release ( &view );
+
+  return result;
+}
@@ -0,0 +1,287 @@
+#! /usr/bin/env python3
+#
+def rk4py_test ( ):
+
+#*****************************************************************************80
+#
+## rk4py_test tests the rk4py extension module.
+#
+#  Discussion:
+#
+#    Build the module first, as described at the top of rk4py.c.  The
+#    tests use array.array and memoryview, so NumPy is not needed.
+#
+#  Licensing:
+#
+#    This code is distributed under the GNU LGPL license.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  import platform
+
+  print ( '' )
+  print ( 'rk4py_test:' )
+  print ( '  Python version: %s' % ( platform.python_version ( ) ) )
+  print ( '  Test the rk4py extension module.' )
+
+  rk4py_stepper_test ( )
+  rk4py_ensemble_test ( )
+  rk4py_adaptive_test ( )
+  rk4py_thread_test ( )
+#
+#  Terminate.
+#
+  print ( '' )
+  print ( 'rk4py_test:' )
+  print ( '  Normal end of execution.' )
+  return
+
+def predator_text ( ):
+
+#*****************************************************************************80
+#
+## predator_text returns the predator prey model as text.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  return "a = 2; b = 0.001; c = 10; d = 0.002\n" \
+         "r' = a * r - b * r * f\n" \
+         "f' = - c * f + d * r * f\n"
+
+def predator_cfunc ( ):
+
+#*****************************************************************************80
+#
+## predator_cfunc returns the predator prey model as a C function pointer.
+#
+#  Discussion:
+#
+#    The function is a ctypes callback into Python, with the parameters
+#    in a ctypes array passed as CTX.  It shows the calling convention;
+#    a compiled C function would be passed the same way.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  import ctypes
+
+  deriv_type = ctypes.CFUNCTYPE ( None, ctypes.c_double, \
+    ctypes.POINTER ( ctypes.c_double ), ctypes.POINTER ( ctypes.c_double ), \
+    ctypes.c_void_p )
+
+  def deriv ( t, u, f, ctx ):
+    p = ctypes.cast ( ctx, ctypes.POINTER ( ctypes.c_double ) )
+    f[0] =   p[0] * u[0] - p[1] * u[0] * u[1]
+    f[1] = - p[2] * u[1] + p[3] * u[0] * u[1]
+
+  param = ( ctypes.c_double * 4 ) ( 2.0, 0.001, 10.0, 0.002 )
+
+  return deriv_type ( deriv ), param
+
+def rk4py_stepper_test ( ):
+
+#*****************************************************************************80
+#
+## rk4py_stepper_test compares compiled text with a C function pointer.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  from array import array
+  import rk4py
+
+  print ( '' )
+  print ( 'rk4py_stepper_test:' )
+  print ( '  Stepper with a text and with a ctypes function pointer.' )
+
+  y0 = array ( 'd', [ 5000.0, 100.0 ] )
+  n = 1000
+
+  s1 = rk4py.Stepper ( predator_text ( ), y0 )
+  y1 = s1.trajectory ( 5.0, n )
+
+  deriv, param = predator_cfunc ( )
+  s2 = rk4py.Stepper ( deriv, y0, ctx = param )
+  y2 = memoryview ( bytearray ( 8 * ( n + 1 ) * 2 ) ).cast ( 'd', [ n + 1, 2 ] )
+  s2.trajectory ( 5.0, n, out = y2 )
+
+  diff = 0.0
+  for k in range ( 0, n + 1 ):
+    for i in range ( 0, 2 ):
+      diff = max ( diff, abs ( y1[k,i] - y2[k,i] ) / abs ( y2[k,i] ) )
+
+  print ( '' )
+  print ( '  T = %g, steps = %d' % ( s1.t, s1.step_num ) )
+  print ( '  Final state %14.6f  %14.6f' % ( y1[n,0], y1[n,1] ) )
+  print ( '  Max relative difference = %g' % ( diff ) )
+#
+#  The stepper is a writable view of its own state.
+#
+  state = memoryview ( s1 )
+  state[1] = 0.0
+  s1.advance ( 6.0, 200 )
+  print ( '  With no foxes, R(6) / R(5) = %g, exp(2) = %g' \
+    % ( state[0] / y1[n,0], 7.38905609893065 ) )
+  return
+
+def rk4py_ensemble_test ( ):
+
+#*****************************************************************************80
+#
+## rk4py_ensemble_test advances an ensemble given as a (NENS,M) buffer.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  from array import array
+  import rk4py
+
+  print ( '' )
+  print ( 'rk4py_ensemble_test:' )
+  print ( '  Ensemble from a compiled text, read back without a copy.' )
+
+  nens = 100
+  m = 2
+  y0 = array ( 'd', [ 0.0 ] ) * ( nens * m )
+  for k in range ( 0, nens ):
+    y0[k*m]   = 5000.0 + 100.0 * k
+    y0[k*m+1] = 100.0 + 10.0 * k
+
+  y2 = memoryview ( y0 ).cast ( 'B' ).cast ( 'd', [ nens, m ] )
+  e = rk4py.Ensemble ( predator_text ( ), y2 )
+  e.advance ( 5.0, 1000 )
+  y = memoryview ( e )
+
+  diff = 0.0
+  for k in [ 0, 37, nens - 1 ]:
+    s = rk4py.Stepper ( predator_text ( ), y0[k*m:k*m+m] )
+    s.advance ( 5.0, 1000 )
+    ys = memoryview ( s )
+    for i in range ( 0, m ):
+      diff = max ( diff, abs ( y[i,k] - ys[i] ) / abs ( ys[i] ) )
+
+  print ( '' )
+  print ( '  State shape %s, strides %s' % ( y.shape, y.strides ) )
+  print ( '  Max relative difference from Stepper = %g' % ( diff ) )
+  return
+
+def rk4py_adaptive_test ( ):
+
+#*****************************************************************************80
+#
+## rk4py_adaptive_test solves Y' = - Y with dense output.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  from array import array
+  import ctypes
+  import math
+  import rk4py
+
+  print ( '' )
+  print ( 'rk4py_adaptive_test:' )
+  print ( '  Adaptive RK45 with output at requested times.' )
+
+  tout = array ( 'd', [ 0.5 * k for k in range ( 0, 11 ) ] )
+  a = rk4py.Adaptive ( "y' = - y", array ( 'd', [ 1.0 ] ), rtol = 1.0E-08, \
+    atol = 1.0E-12 )
+  y = a.solve ( tout )
+
+  err = 0.0
+  for k in range ( 0, len ( tout ) ):
+    err = max ( err, abs ( y[k,0] - math.exp ( - tout[k] ) ) )
+
+  print ( '' )
+  print ( '  %d steps, %d rejected, %d evaluations' \
+    % ( a.step_num, a.reject_num, a.eval_num ) )
+  print ( '  Max error at %d output times = %g' % ( len ( tout ), err ) )
+
+  print ( '' )
+  print ( '  Faulty input:' )
+  try:
+    rk4py.Adaptive ( "y' = - z", array ( 'd', [ 1.0 ] ) )
+  except ValueError as error:
+    print ( '  ValueError: %s' % ( error ) )
+  try:
+    rk4py.Stepper ( predator_text ( ), array ( 'd', [ 1.0 ] ) )
+  except ValueError as error:
+    print ( '  ValueError: %s' % ( error ) )
+  try:
+    rk4py.Stepper ( predator_text ( ), array ( 'f', [ 1.0, 2.0 ] ) )
+  except TypeError as error:
+    print ( '  TypeError: %s' % ( error ) )
+  try:
+    a.dense ( 1.0 )
+  except ValueError as error:
+    print ( '  ValueError: %s' % ( error ) )
+  try:
+    b = rk4py.Adaptive ( "y' = - y", array ( 'd', [ 1.0 ] ) )
+    b.solve ( array ( 'd', [ 1.0, 2.0, 2.0 ] ) )
+  except ValueError as error:
+    print ( '  ValueError: %s' % ( error ) )
+  try:
+    rk4py.Ensemble ( predator_text ( ), ( ctypes.c_double * 2 * 0 ) ( ) )
+  except ValueError as error:
+    print ( '  ValueError: %s' % ( error ) )
+  return
+
+def rk4py_thread_test ( ):
+
+#*****************************************************************************80
+#
+## rk4py_thread_test advances ensembles in several Python threads.
+#
+#  Discussion:
+#
+#    The GIL is released during advance(), so on a machine with several
+#    cores the threads run at the same time.  Both runs give the same
+#    result.
+#
+#  Modified:
+#
+#    18 October 2026
+#
+  from array import array
+  import threading
+  import time
+  import rk4py
+
+  print ( '' )
+  print ( 'rk4py_thread_test:' )
+  print ( '  Ensembles advanced in 1 and in 4 Python threads.' )
+
+  nens = 4096
+  m = 2
+  y0 = array ( 'd', [ 5000.0, 100.0 ] ) * nens
+  y0 = memoryview ( y0 ).cast ( 'B' ).cast ( 'd', [ nens, m ] )
+
+  for thread_num in [ 1, 4 ]:
+    ens = [ rk4py.Ensemble ( predator_text ( ), y0 ) for j in range ( 0, 4 ) ]
+    start = time.perf_counter ( )
+    if thread_num == 1:
+      for e in ens:
+        e.advance ( 5.0, 2000 )
+    else:
+      threads = [ threading.Thread ( target = e.advance, \
+        args = ( 5.0, 2000 ) ) for e in ens ]
+      for th in threads:
+        th.start ( )
+      for th in threads:
+        th.join ( )
+    seconds = time.perf_counter ( ) - start
+    y = memoryview ( ens[3] )
+    print ( '  %d threads: %8.4f seconds, R = %14.6f' \
+      % ( thread_num, seconds, y[0,nens-1] ) )
+  return
+
+if ( __name__ == '__main__' ):
+  rk4py_test ( )
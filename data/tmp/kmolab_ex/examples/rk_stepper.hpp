@@ -0,0 +1,253 @@
+//
+//  rk_stepper.hpp: explicit Runge-Kutta steppers built from a constexpr
+//  Butcher tableau.
+//
+//  Discussion:
+//
+//    rk::stepper<TABLEAU, M> takes fixed steps with the explicit method
+//    given by TABLEAU.  Every coefficient is a compile time constant, so
+//    stage combinations with zero coefficients are dropped, the others are
+//    fused into one pass per stage, and a stage whose derivative is never
+//    used is not evaluated.  When the state dimension M is known at compile
+//    time, the state and stages are std::array objects, which a small
+//    system such as the predator prey model keeps in registers.  With
+//    M = rk::dynamic, the dimension is given to the constructor instead.
+//
+//    The right hand side is any callable DYDT ( T, U, F ) with U and F of
+//    type double *, so the C functions written for rk4() can be used as is.
+//
+//    Requires C++17.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+# ifndef RK_STEPPER_HPP
+# define RK_STEPPER_HPP
+
+# include <array>
+# include <cstddef>
+# include <type_traits>
+# include <utility>
+# include <vector>
+
+namespace rk
+{
+//
+//  tableau holds an explicit S stage Butcher tableau.  Only the strictly
+//  lower triangle of A is used.
+//
+template <int S>
+struct tableau
+{
+  static constexpr int stages = S;
+  int order;
+  double c[S];
+  double a[S][S];
+  double b[S];
+};
+
+//
+//  The classical fourth order method, as in rk4().
+//
+inline constexpr tableau<4> rk4 =
+{
+  4,
+  { 0.0, 0.5, 0.5, 1.0 },
+  { { 0.0, 0.0, 0.0, 0.0 },
+    { 0.5, 0.0, 0.0, 0.0 },
+    { 0.0, 0.5, 0.0, 0.0 },
+    { 0.0, 0.0, 1.0, 0.0 } },
+  { 1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0 }
+};
+
+//
+//  Heun's second order method, as in runge_kutta_ex1.c.
+//
+inline constexpr tableau<2> heun =
+{
+  2,
+  { 0.0, 1.0 },
+  { { 0.0, 0.0 },
+    { 1.0, 0.0 } },
+  { 0.5, 0.5 }
+};
+
+//
+//  The strong stability preserving third order method of Shu and Osher.
+//
+inline constexpr tableau<3> ssp_rk3 =
+{
+  3,
+  { 0.0, 1.0, 0.5 },
+  { { 0.0,  0.0,  0.0 },
+    { 1.0,  0.0,  0.0 },
+    { 0.25, 0.25, 0.0 } },
+  { 1.0 / 6.0, 1.0 / 6.0, 2.0 / 3.0 }
+};
+
+//
+//  The fifth order Dormand-Prince method, used here with fixed steps.
+//  Its seventh stage only serves the error estimate, so it is skipped.
+//
+inline constexpr tableau<7> dopri5 =
+{
+  5,
+  { 0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0 },
+  { { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+    { 1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+    { 3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+    { 44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0, 0.0 },
+    { 19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0,
+      0.0, 0.0, 0.0 },
+    { 9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0,
+      -5103.0 / 18656.0, 0.0, 0.0 },
+    { 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0,
+      11.0 / 84.0, 0.0 } },
+  { 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0,
+    11.0 / 84.0, 0.0 }
+};
+
+inline constexpr int dynamic = 0;
+
+//
+//  stage_used is true if the derivative of stage J enters the solution
+//  or a later stage.
+//
+template <const auto &T>
+constexpr bool stage_used ( int j )
+{
+  if ( T.b[j] != 0.0 )
+  {
+    return true;
+  }
+  for ( int i = j + 1; i < T.stages; i++ )
+  {
+    if ( T.a[i][j] != 0.0 )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <const auto &T, int M = dynamic>
+class stepper
+{
+public:
+
+  using state = std::conditional_t < M == dynamic, std::vector<double>,
+    std::array<double, M> >;
+
+  static constexpr int stages = T.stages;
+  static constexpr int order = T.order;
+
+//
+//  The constructor sizes the workspace.  M must be given when the
+//  dimension is dynamic, and is ignored otherwise.
+//
+  explicit stepper ( int m = M )
+  {
+    if constexpr ( M == dynamic )
+    {
+      u.resize ( m );
+      for ( auto &ks : k )
+      {
+        ks.resize ( m );
+      }
+    }
+    else
+    {
+      ( void ) m;
+    }
+  }
+
+//
+//  step advances Y from T to T + H.
+//
+  template <class F>
+  void step ( F &&dydt, double t, double h, state &y )
+  {
+    step_stages ( dydt, t, h, y, std::make_integer_sequence<int, T.stages> ( ) );
+  }
+
+//
+//  integrate takes N equal steps from T0 to T1, as rk4() does.
+//
+  template <class F>
+  void integrate ( F &&dydt, double t0, double t1, int n, state &y )
+  {
+    double dt = ( t1 - t0 ) / ( double ) ( n );
+    double t = t0;
+
+    for ( int j = 0; j < n; j++ )
+    {
+      step ( dydt, t, dt, y );
+      t = t + dt;
+    }
+  }
+
+  int size ( ) const
+  {
+    return ( int ) u.size ( );
+  }
+
+private:
+
+  state u;
+  std::array<state, T.stages> k;
+
+//
+//  stage computes U = Y + H * sum ( A(I,J) * K(J) ) and K(I) = F ( U ).
+//
+  template <int I, class F, int... J>
+  void stage ( F &dydt, double t, double h, state &y,
+    std::integer_sequence<int, J...> )
+  {
+    if constexpr ( stage_used<T> ( I ) )
+    {
+      const int m = size ( );
+
+      if constexpr ( I == 0 )
+      {
+        dydt ( t, y.data ( ), k[0].data ( ) );
+      }
+      else
+      {
+        for ( int i = 0; i < m; i++ )
+        {
+          double ui = y[i];
+          ( ( T.a[I][J] != 0.0 ? ( void ) ( ui += ( h * T.a[I][J] ) * k[J][i] )
+            : ( void ) 0 ), ... );
+          u[i] = ui;
+        }
+        dydt ( t + T.c[I] * h, u.data ( ), k[I].data ( ) );
+      }
+    }
+  }
+
+  template <class F, int... I>
+  void step_stages ( F &dydt, double t, double h, state &y,
+    std::integer_sequence<int, I...> seq )
+  {
+    ( stage<I> ( dydt, t, h, y, std::make_integer_sequence<int, I> ( ) ), ... );
+
+    const int m = size ( );
+    for ( int i = 0; i < m; i++ )
+    {
+      double yi = y[i];
+      ( ( T.b[I] != 0.0 ? ( void ) ( yi += ( h * T.b[I] ) * k[I][i] )
+        : ( void ) 0 ), ... );
+      y[i] = yi;
+    }
+    ( void ) seq;
+  }
+};
+
+}
+
+# endif
@@ -0,0 +1,259 @@
+# include <cmath>
+# include <cstdio>
+# include <cstdlib>
+
+extern "C"
+{
+# include "rk4.h"
+}
+# include "rk_stepper.hpp"
+
+using namespace std;
+
+int main ( );
+void rk_stepper_heun_test ( );
+void rk_stepper_order_test ( );
+void rk_stepper_rk4_test ( );
+void predator_deriv ( double t, double y[], double f[] );
+
+//****************************************************************************80
+
+int main ( )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    MAIN is the main program for rk_stepper_test.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+{
+  timestamp ( );
+  printf ( "\n" );
+  printf ( "rk_stepper_test:\n" );
+  printf ( "  C++ version\n" );
+  printf ( "  Test the tableau driven steppers in rk_stepper.hpp.\n" );
+
+  rk_stepper_rk4_test ( );
+  rk_stepper_heun_test ( );
+  rk_stepper_order_test ( );
+//
+//  Terminate.
+//
+  printf ( "\n" );
+  printf ( "rk_stepper_test:\n" );
+  printf ( "  Normal end of execution.\n" );
+  printf ( "\n" );
+  timestamp ( );
+
+  return 0;
+}
+//****************************************************************************80
+
+void rk_stepper_rk4_test ( )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    rk_stepper_rk4_test compares rk::stepper<rk::rk4,2> with rk4().
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+{
+  double diff;
+  int i;
+  int m = 2;
+  int n = 1000;
+  rk::stepper<rk::rk4, 2> s;
+  rk::stepper<rk::rk4, 2>::state ys = { 5000.0, 100.0 };
+  double *t;
+  double tspan[2] = { 0.0, 5.0 };
+  double *y;
+  double y0[2] = { 5000.0, 100.0 };
+
+  printf ( "\n" );
+  printf ( "rk_stepper_rk4_test\n" );
+  printf ( "  Solve the predator prey ODE with a fixed size RK4 stepper\n" );
+  printf ( "  and compare with rk4().\n" );
+
+  t = new double[n+1];
+  y = new double[(n+1)*m];
+
+  rk4 ( predator_deriv, tspan, y0, n, m, t, y );
+  s.integrate ( predator_deriv, tspan[0], tspan[1], n, ys );
+
+  diff = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    diff = fmax ( diff, fabs ( ys[i] - y[i+n*m] ) / fabs ( y[i+n*m] ) );
+  }
+
+  printf ( "\n" );
+  printf ( "  Final Y = ( %g, %g )\n", ys[0], ys[1] );
+  printf ( "  Max relative difference from rk4() = %g\n", diff );
+
+  delete [] t;
+  delete [] y;
+
+  return;
+}
+//****************************************************************************80
+
+void rk_stepper_heun_test ( )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    rk_stepper_heun_test repeats runge_kutta_ex1.c with rk::heun.
+//
+//  Discussion:
+//
+//    The ODE is dy/dx = y - x, y(0) = 2, with stepsize 0.05.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+{
+  double h = 0.05;
+  int j;
+  rk::stepper<rk::heun, 1> s;
+  rk::stepper<rk::heun, 1>::state y = { 2.0 };
+  auto f = [] ( double x, double u[], double fu[] ) { fu[0] = u[0] - x; };
+
+  printf ( "\n" );
+  printf ( "rk_stepper_heun_test\n" );
+  printf ( "  Heun's method for dy/dx = y - x, as in runge_kutta_ex1.c.\n" );
+  printf ( "\n" );
+
+  for ( j = 0; j < 2; j++ )
+  {
+    s.step ( f, j * h, h, y );
+    printf ( "  y(%.4f) = %.3f\n", ( j + 1 ) * h, y[0] );
+  }
+
+  return;
+}
+//****************************************************************************80
+
+void rk_stepper_order_test ( )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    rk_stepper_order_test estimates the order of each tableau.
+//
+//  Discussion:
+//
+//    The predator prey ODE is solved with N and 2N steps, against a
+//    reference from rk::dopri5 with many steps.  The dynamic dimension
+//    steppers are used here.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+{
+  int m = 2;
+  int n = 2000;
+  double e1;
+  double e2;
+  vector<double> ref = { 5000.0, 100.0 };
+  vector<double> y;
+
+  printf ( "\n" );
+  printf ( "rk_stepper_order_test\n" );
+  printf ( "  Observed order of each tableau on the predator prey ODE.\n" );
+  printf ( "\n" );
+  printf ( "  Tableau   Stages  Order  Error(N)      Error(2N)     Observed\n" );
+  printf ( "\n" );
+
+  rk::stepper<rk::dopri5> sr ( m );
+  sr.integrate ( predator_deriv, 0.0, 5.0, 100000, ref );
+
+  auto report = [&] ( const char *name, auto &s )
+  {
+    y = { 5000.0, 100.0 };
+    s.integrate ( predator_deriv, 0.0, 5.0, n, y );
+    e1 = fabs ( y[0] - ref[0] ) / ref[0];
+    y = { 5000.0, 100.0 };
+    s.integrate ( predator_deriv, 0.0, 5.0, 2 * n, y );
+    e2 = fabs ( y[0] - ref[0] ) / ref[0];
+    printf ( "  %-8s  %6d  %5d  %12.4e  %12.4e  %8.2f\n", name, s.stages,
+      s.order, e1, e2, log2 ( e1 / e2 ) );
+  };
+
+  rk::stepper<rk::heun> s2 ( m );
+  rk::stepper<rk::ssp_rk3> s3 ( m );
+  rk::stepper<rk::rk4> s4 ( m );
+  rk::stepper<rk::dopri5> s5 ( m );
+
+  report ( "heun", s2 );
+  report ( "ssp_rk3", s3 );
+  report ( "rk4", s4 );
+  n = 200;
+  report ( "dopri5", s5 );
+
+  return;
+}
+//****************************************************************************80
+
+void predator_deriv ( double t, double y[], double f[] )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    predator_deriv returns the right hand side of the predator ODE.
+//
+//  Licensing:
+//
+//    This code is distributed under the GNU LGPL license.
+//
+//  Modified:
+//
+//    18 October 2026
+//
+//  Input:
+//
+//    double T, the current time.
+//
+//    double Y[2], the current solution value.
+//
+//  Output:
+//
+//    double F[2], the value of the derivative, dU/dT.
+//
+{
+  double rab = y[0];
+  double fox = y[1];
+
+  f[0] =   2.0 * rab - 0.001 * rab * fox;
+  f[1] = -10.0 * fox + 0.002 * rab * fox;
+
+  return;
+}
@@ -0,0 +1,903 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "rk4_pool.h"
+# include "sde.h"
+# include "rk4_stats.h"
+
+/*
+  sde_ensemble_job describes an ensemble run to every thread.  It is only
+  read while the run goes on; each thread writes its own rows of RESULT
+  and its own entry of STATUS.
+*/
+typedef struct
+{
+  int method;
+  void ( *drift ) ( double t, double y[], double f[], void *ctx );
+  void ( *diffusion ) ( double t, double y[], double g[], void *ctx );
+  void *ctx;
+  int m;
+  int nens;
+  double *tspan;
+  double *y0;
+  int n;
+  unsigned long long int seed;
+  double *result;
+  int *status;
+} sde_ensemble_job;
+
+static void sde_ensemble_task ( int id, int thread_num, void *arg );
+static void sde_step_sra ( sde_stepper *s, double dt, double dw[],
+  double dz[] );
+static void sde_step_sri ( sde_stepper *s, double dt, double dw[],
+  double dz[] );
+
+/*
+  The SRIW1 tableau of Roessler, stored by rows: H0 of stage L uses
+  A0[L][J] and B0[L][J], H1 uses A1[L][J] and B1[L][J].
+*/
+static const double sri_c0[4] = { 0.0, 0.75, 0.0, 0.0 };
+static const double sri_c1[4] = { 0.0, 0.25, 1.0, 0.25 };
+static const double sri_a0[4][4] = {
+  { 0.0, 0.0, 0.0, 0.0 },
+  { 0.75, 0.0, 0.0, 0.0 },
+  { 0.0, 0.0, 0.0, 0.0 },
+  { 0.0, 0.0, 0.0, 0.0 } };
+static const double sri_a1[4][4] = {
+  { 0.0, 0.0, 0.0, 0.0 },
+  { 0.25, 0.0, 0.0, 0.0 },
+  { 1.0, 0.0, 0.0, 0.0 },
+  { 0.0, 0.0, 0.25, 0.0 } };
+static const double sri_b0[4][4] = {
+  { 0.0, 0.0, 0.0, 0.0 },
+  { 1.5, 0.0, 0.0, 0.0 },
+  { 0.0, 0.0, 0.0, 0.0 },
+  { 0.0, 0.0, 0.0, 0.0 } };
+static const double sri_b1[4][4] = {
+  { 0.0, 0.0, 0.0, 0.0 },
+  { 0.5, 0.0, 0.0, 0.0 },
+  { -1.0, 0.0, 0.0, 0.0 },
+  { -5.0, 3.0, 0.5, 0.0 } };
+static const double sri_alpha[4] = { 1.0 / 3.0, 2.0 / 3.0, 0.0, 0.0 };
+static const double sri_beta1[4] = { -1.0, 4.0 / 3.0, 2.0 / 3.0, 0.0 };
+static const double sri_beta2[4] = { -1.0, 4.0 / 3.0, -1.0 / 3.0, 0.0 };
+static const double sri_beta3[4] = { 2.0, -4.0 / 3.0, -2.0 / 3.0, 0.0 };
+static const double sri_beta4[4] = { -2.0, 5.0 / 3.0, -2.0 / 3.0, 1.0 };
+
+/******************************************************************************/
+
+void philox4x32 ( unsigned int ctr[4], unsigned int key[2],
+  unsigned int out[4] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    philox4x32 applies the Philox4x32-10 counter based generator.
+
+  Discussion:
+
+    Ten rounds of multiplication and key mixing turn the counter into
+    128 random bits.  Distinct counters under one key give independent
+    outputs, so any number of the stream can be had directly.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    John Salmon, Mark Moraes, Ron Dror, David Shaw,
+    Parallel random numbers: as easy as 1, 2, 3,
+    Proceedings of the International Conference for High Performance
+    Computing, Networking, Storage and Analysis, 2011.
+
+  Input:
+
+    unsigned int CTR[4]: the counter.
+
+    unsigned int KEY[2]: the key.
+
+  Output:
+
+    unsigned int OUT[4]: the random bits.
+*/
+{
+  unsigned int c[4];
+  unsigned int k[2];
+  unsigned long long int p0;
+  unsigned long long int p1;
+  int r;
+
+  c[0] = ctr[0];
+  c[1] = ctr[1];
+  c[2] = ctr[2];
+  c[3] = ctr[3];
+  k[0] = key[0];
+  k[1] = key[1];
+
+  for ( r = 0; r < 10; r++ )
+  {
+    if ( 0 < r )
+    {
+      k[0] = k[0] + 0x9E3779B9U;
+      k[1] = k[1] + 0xBB67AE85U;
+    }
+    p0 = ( unsigned long long int ) 0xD2511F53U * c[0];
+    p1 = ( unsigned long long int ) 0xCD9E8D57U * c[2];
+    c[0] = ( unsigned int ) ( p1 >> 32 ) ^ c[1] ^ k[0];
+    c[1] = ( unsigned int ) p1;
+    c[2] = ( unsigned int ) ( p0 >> 32 ) ^ c[3] ^ k[1];
+    c[3] = ( unsigned int ) p0;
+  }
+
+  out[0] = c[0];
+  out[1] = c[1];
+  out[2] = c[2];
+  out[3] = c[3];
+
+  return;
+}
+/******************************************************************************/
+
+void sde_advance ( sde_stepper *s, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_advance takes N equal steps to T1 along the stepper's own path.
+
+  Discussion:
+
+    The increments of step J are those of sde_noise() for the stepper's
+    SEED and MEMBER, with J counted by S->STEP_NUM, so a run split into
+    several calls follows the same path as a single call.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    sde_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    sde_noise ( s->seed, s->member, s->step_num, s->m, dt, s->dw,
+      ( s->method == SDE_SRI || s->method == SDE_SRA ) ? s->dz : NULL );
+    sde_step ( s, dt, s->dw, s->dz );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+sde_stepper *sde_create ( int method, void drift ( double t, double y[],
+  double f[], void *ctx ), void diffusion ( double t, double y[], double g[],
+  void *ctx ), void *ctx, int m, double t0, double y0[],
+  unsigned long long int seed, int member )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_create creates an SDE stepper.
+
+  Discussion:
+
+    The workspace holds Y, the increments, four drift and four diffusion
+    stage values, and two stage inputs.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Peter Kloeden, Eckhard Platen,
+    Numerical Solution of Stochastic Differential Equations,
+    Springer, 1992, section 11.1.
+
+    Andreas Roessler,
+    Runge-Kutta methods for the strong approximation of solutions of
+    stochastic differential equations,
+    SIAM Journal on Numerical Analysis,
+    Volume 48, Number 3, 2010, pages 922-952.
+
+  Input:
+
+    int METHOD: SDE_EULER, SDE_MILSTEIN, SDE_SRI or SDE_SRA.
+
+    void DRIFT ( double T, double Y[], double F[], void *CTX ), evaluates
+    the drift.
+
+    void DIFFUSION ( double T, double Y[], double G[], void *CTX ),
+    evaluates the diagonal diffusion.
+
+    void *CTX: the context passed to DRIFT and DIFFUSION.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    unsigned long long int SEED: the key of the noise.
+
+    int MEMBER: the ensemble member whose path sde_advance() follows.
+
+  Output:
+
+    sde_stepper *SDE_CREATE: the stepper, or NULL if METHOD is unknown
+    or memory could not be allocated.
+*/
+{
+  int ld;
+  sde_stepper *s;
+
+  if ( method < SDE_EULER || SDE_SRA < method )
+  {
+    return NULL;
+  }
+
+  s = ( sde_stepper * ) malloc ( sizeof ( sde_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( 13 * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->drift = drift;
+  s->diffusion = diffusion;
+  s->ctx = ctx;
+  s->method = method;
+  s->m = m;
+  s->ld = ld;
+  s->seed = seed;
+  s->y  = s->work;
+  s->dw = s->work +      ld;
+  s->dz = s->work +  2 * ld;
+  s->f  = s->work +  3 * ld;
+  s->g  = s->work +  7 * ld;
+  s->h0 = s->work + 11 * ld;
+  s->h1 = s->work + 12 * ld;
+
+  sde_reset ( s, t0, y0, member );
+
+  return s;
+}
+/******************************************************************************/
+
+void sde_destroy ( sde_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_destroy frees an SDE stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    sde_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int sde_ensemble ( int method, void drift ( double t, double y[], double f[],
+  void *ctx ), void diffusion ( double t, double y[], double g[], void *ctx ),
+  void *ctx, int m, int nens, double tspan[2], double y0[], int n,
+  unsigned long long int seed, rk4_pool *pool, double result[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_ensemble integrates NENS independent paths of one SDE in parallel.
+
+  Discussion:
+
+    This follows rk4_sweep().  Thread ID takes members ID, ID + THREAD_NUM,
+    ..., with one reused stepper.  Member E follows the path of
+    sde_noise() for SEED and E, so the results do not depend on the
+    thread count.  DRIFT and DIFFUSION are called concurrently with the
+    shared CTX, which they must not modify.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int METHOD: SDE_EULER, SDE_MILSTEIN, SDE_SRI or SDE_SRA.
+
+    void DRIFT ( double T, double Y[], double F[], void *CTX ), evaluates
+    the drift.
+
+    void DIFFUSION ( double T, double Y[], double G[], void *CTX ),
+    evaluates the diagonal diffusion.
+
+    void *CTX: the context passed to DRIFT and DIFFUSION.
+
+    int M: the number of variables.
+
+    int NENS: the number of members.
+
+    double TSPAN[2]: the initial and final times.
+
+    double Y0[M]: the initial condition, shared by all members.
+
+    int N: the number of steps to take.
+
+    unsigned long long int SEED: the key of the noise.
+
+    rk4_pool *POOL: the threads to use.  If POOL is NULL, the ensemble
+    runs in the calling thread.
+
+  Output:
+
+    double RESULT[NENS*M]: the solution at TSPAN[1] for each member,
+    with RESULT[I+E*M] holding component I for member E.
+
+    int SDE_ENSEMBLE: 0 on success, 1 if METHOD is unknown, 2 if memory
+    could not be allocated.
+*/
+{
+  int id;
+  sde_ensemble_job job;
+  int status;
+  int thread_num;
+
+  if ( method < SDE_EULER || SDE_SRA < method )
+  {
+    return 1;
+  }
+
+  thread_num = rk4_pool_size ( pool );
+
+  job.method = method;
+  job.drift = drift;
+  job.diffusion = diffusion;
+  job.ctx = ctx;
+  job.m = m;
+  job.nens = nens;
+  job.tspan = tspan;
+  job.y0 = y0;
+  job.n = n;
+  job.seed = seed;
+  job.result = result;
+  job.status = ( int * ) malloc ( thread_num * sizeof ( int ) );
+  if ( job.status == NULL )
+  {
+    return 2;
+  }
+
+  rk4_pool_run ( pool, sde_ensemble_task, &job );
+
+  status = 0;
+  for ( id = 0; id < thread_num; id++ )
+  {
+    if ( job.status[id] != 0 )
+    {
+      status = job.status[id];
+    }
+  }
+  free ( job.status );
+
+  return status;
+}
+/******************************************************************************/
+
+void sde_noise ( unsigned long long int seed, int member, long int step,
+  int m, double dt, double dw[], double dz[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_noise draws the Wiener increments of one step of one member.
+
+  Discussion:
+
+    Component I uses the Philox counter ( I, STEP low, STEP high, MEMBER )
+    under the key SEED.  The 128 bits become two uniforms of 53 bits and,
+    by the Box-Muller transform, two standard normals X1 and X2.  Then
+
+      DW[I] = sqrt ( DT ) X1,
+      DZ[I] = DT * ( DW[I] + sqrt ( DT ) X2 / sqrt ( 3 ) ) / 2,
+
+    which have the joint distribution of the increment of W and the
+    integral of W over the step.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    unsigned long long int SEED: the key.
+
+    int MEMBER: the ensemble member.
+
+    long int STEP: the step index.
+
+    int M: the number of components.
+
+    double DT: the stepsize.
+
+  Output:
+
+    double DW[M]: the increments of W.
+
+    double DZ[M]: the integrals of W, if DZ is not NULL.
+*/
+{
+  unsigned long long int a;
+  unsigned long long int b;
+  unsigned int ctr[4];
+  int i;
+  unsigned int key[2];
+  unsigned int out[4];
+  double r;
+  double sq;
+  double u1;
+  double u2;
+  double x1;
+  double x2;
+
+  key[0] = ( unsigned int ) seed;
+  key[1] = ( unsigned int ) ( seed >> 32 );
+  sq = sqrt ( dt );
+
+  for ( i = 0; i < m; i++ )
+  {
+    ctr[0] = ( unsigned int ) i;
+    ctr[1] = ( unsigned int ) ( ( unsigned long long int ) step );
+    ctr[2] = ( unsigned int ) ( ( unsigned long long int ) step >> 32 );
+    ctr[3] = ( unsigned int ) member;
+    philox4x32 ( ctr, key, out );
+
+    a = ( ( ( unsigned long long int ) out[0] << 32 ) | out[1] ) >> 11;
+    b = ( ( ( unsigned long long int ) out[2] << 32 ) | out[3] ) >> 11;
+    u1 = ( ( double ) a + 0.5 ) / 9007199254740992.0;
+    u2 = ( double ) b / 9007199254740992.0;
+
+    r = sqrt ( - 2.0 * log ( u1 ) );
+    x1 = r * cos ( 2.0 * M_PI * u2 );
+    x2 = r * sin ( 2.0 * M_PI * u2 );
+
+    dw[i] = sq * x1;
+    if ( dz != NULL )
+    {
+      dz[i] = dt * ( dw[i] + sq * x2 / sqrt ( 3.0 ) ) / 2.0;
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void sde_reset ( sde_stepper *s, double t0, double y0[], int member )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_reset restarts an SDE stepper on the path of another member.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    sde_stepper *S: the stepper.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    int MEMBER: the ensemble member whose path sde_advance() follows.
+*/
+{
+  int i;
+
+  s->member = member;
+  s->t = t0;
+  s->step_num = 0;
+  s->drift_num = 0;
+  s->diffusion_num = 0;
+
+  for ( i = 0; i < s->m; i++ )
+  {
+    s->y[i] = y0[i];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void sde_step ( sde_stepper *s, double dt, double dw[], double dz[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_step takes one SDE step with given increments.
+
+  Discussion:
+
+    The derivative free Milstein method replaces the derivative of G by
+    a difference:
+
+      H = Y + F DT + G sqrt ( DT ),
+      Y = Y + F DT + G DW + ( G ( H ) - G ) ( DW^2 - DT ) / ( 2 sqrt ( DT ) ).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    sde_stepper *S: the stepper.
+
+    double DT: the stepsize.
+
+    double DW[M]: the increments of W over the step.
+
+    double DZ[M]: the integrals of W over the step.  Only SDE_SRI and
+    SDE_SRA use DZ; otherwise it may be NULL.
+*/
+{
+  double *f;
+  double *g;
+  double *g1;
+  int i;
+  double sq;
+  double t;
+  double *y;
+
+  f = s->f;
+  g = s->g;
+  g1 = s->g + s->ld;
+  t = s->t;
+  y = s->y;
+  sq = sqrt ( dt );
+
+  RK4_STATS_TIC ( RK4_PHASE_STEP );
+
+  if ( s->method == SDE_EULER )
+  {
+    s->drift ( t, y, f, s->ctx );
+    s->diffusion ( t, y, g, s->ctx );
+    for ( i = 0; i < s->m; i++ )
+    {
+      y[i] = y[i] + f[i] * dt + g[i] * dw[i];
+    }
+    s->drift_num = s->drift_num + 1;
+    s->diffusion_num = s->diffusion_num + 1;
+    RK4_STATS_ADD ( RK4_COUNT_EVAL, 2 );
+  }
+  else if ( s->method == SDE_MILSTEIN )
+  {
+    s->drift ( t, y, f, s->ctx );
+    s->diffusion ( t, y, g, s->ctx );
+    for ( i = 0; i < s->m; i++ )
+    {
+      s->h0[i] = y[i] + f[i] * dt + g[i] * sq;
+    }
+    s->diffusion ( t, s->h0, g1, s->ctx );
+    for ( i = 0; i < s->m; i++ )
+    {
+      y[i] = y[i] + f[i] * dt + g[i] * dw[i]
+        + ( g1[i] - g[i] ) * ( dw[i] * dw[i] - dt ) / ( 2.0 * sq );
+    }
+    s->drift_num = s->drift_num + 1;
+    s->diffusion_num = s->diffusion_num + 2;
+    RK4_STATS_ADD ( RK4_COUNT_EVAL, 3 );
+  }
+  else if ( s->method == SDE_SRI )
+  {
+    sde_step_sri ( s, dt, dw, dz );
+  }
+  else
+  {
+    sde_step_sra ( s, dt, dw, dz );
+  }
+
+  RK4_STATS_TOC ( RK4_PHASE_STEP );
+  RK4_STATS_ADD ( RK4_COUNT_STEP, 1 );
+
+  s->t = t + dt;
+  s->step_num = s->step_num + 1;
+
+  return;
+}
+/******************************************************************************/
+
+static void sde_ensemble_task ( int id, int thread_num, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_ensemble_task integrates the members belonging to one thread.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int e;
+  int i;
+  sde_ensemble_job *job;
+  sde_stepper *s;
+
+  job = ( sde_ensemble_job * ) arg;
+
+  s = sde_create ( job->method, job->drift, job->diffusion, job->ctx, job->m,
+    job->tspan[0], job->y0, job->seed, id );
+  if ( s == NULL )
+  {
+    job->status[id] = 2;
+    return;
+  }
+
+  for ( e = id; e < job->nens; e = e + thread_num )
+  {
+    sde_reset ( s, job->tspan[0], job->y0, e );
+    sde_advance ( s, job->tspan[1], job->n );
+    for ( i = 0; i < job->m; i++ )
+    {
+      job->result[i+e*job->m] = s->y[i];
+    }
+  }
+
+  sde_destroy ( s );
+  job->status[id] = 0;
+
+  return;
+}
+/******************************************************************************/
+
+static void sde_step_sra ( sde_stepper *s, double dt, double dw[],
+  double dz[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_step_sra takes one SRA1 step for additive noise.
+
+  Discussion:
+
+    With G0 = G ( T + DT ) and G1 = G ( T ),
+
+      H = Y + 3/4 F ( T, Y ) DT + 3/2 G0 DZ / DT,
+      Y = Y + ( F ( T, Y ) / 3 + 2 F ( T + 3/4 DT, H ) / 3 ) DT
+            + G0 ( DW - DZ / DT ) + G1 DZ / DT.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double *f0;
+  double *f1;
+  double *g0;
+  double *g1;
+  int i;
+  double i10;
+  double t;
+  double *y;
+
+  f0 = s->f;
+  f1 = s->f + s->ld;
+  g0 = s->g;
+  g1 = s->g + s->ld;
+  t = s->t;
+  y = s->y;
+
+  s->drift ( t, y, f0, s->ctx );
+  s->diffusion ( t + dt, y, g0, s->ctx );
+  s->diffusion ( t, y, g1, s->ctx );
+
+  for ( i = 0; i < s->m; i++ )
+  {
+    s->h0[i] = y[i] + 0.75 * f0[i] * dt + 1.5 * g0[i] * dz[i] / dt;
+  }
+  s->drift ( t + 0.75 * dt, s->h0, f1, s->ctx );
+
+  for ( i = 0; i < s->m; i++ )
+  {
+    i10 = dz[i] / dt;
+    y[i] = y[i] + ( f0[i] + 2.0 * f1[i] ) * dt / 3.0
+      + g0[i] * ( dw[i] - i10 ) + g1[i] * i10;
+  }
+
+  s->drift_num = s->drift_num + 2;
+  s->diffusion_num = s->diffusion_num + 2;
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 4 );
+
+  return;
+}
+/******************************************************************************/
+
+static void sde_step_sri ( sde_stepper *s, double dt, double dw[],
+  double dz[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    sde_step_sri takes one SRIW1 step.
+
+  Discussion:
+
+    Stage L has the drift input H0 and the diffusion input H1,
+
+      H0 = Y + sum A0[L][J] F(J) DT + sum B0[L][J] G(J) I10,
+      H1 = Y + sum A1[L][J] F(J) DT + sum B1[L][J] G(J) sqrt ( DT ),
+
+    with F(J) and G(J) the drift at H0 and diffusion at H1 of stage J,
+    and the step is
+
+      Y = Y + sum ALPHA[L] F(L) DT
+            + sum ( BETA1[L] I1 + BETA2[L] I11 + BETA3[L] I10
+            + BETA4[L] I111 ) G(L),
+
+    where I1 = DW, I11 = ( DW^2 - DT ) / ( 2 sqrt ( DT ) ),
+    I10 = DZ / DT and I111 = ( DW^3 - 3 DW DT ) / ( 6 DT ).
+
+    Stages 2 and 3 have H0 = Y at time T, so their drift is F(0) and
+    is not evaluated again.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double a;
+  double b;
+  double *f;
+  double *g;
+  int i;
+  double i1;
+  double i10;
+  double i11;
+  double i111;
+  int j;
+  int l;
+  int ld;
+  double sq;
+  double t;
+  double *y;
+
+  f = s->f;
+  g = s->g;
+  ld = s->ld;
+  t = s->t;
+  y = s->y;
+  sq = sqrt ( dt );
+
+  for ( l = 0; l < 4; l++ )
+  {
+    for ( i = 0; i < s->m; i++ )
+    {
+      a = y[i];
+      b = y[i];
+      for ( j = 0; j < l; j++ )
+      {
+        a = a + sri_a0[l][j] * f[i+j*ld] * dt
+          + sri_b0[l][j] * g[i+j*ld] * dz[i] / dt;
+        b = b + sri_a1[l][j] * f[i+j*ld] * dt
+          + sri_b1[l][j] * g[i+j*ld] * sq;
+      }
+      s->h0[i] = a;
+      s->h1[i] = b;
+    }
+    if ( l < 2 )
+    {
+      s->drift ( t + sri_c0[l] * dt, s->h0, f + l * ld, s->ctx );
+    }
+    else
+    {
+      for ( i = 0; i < s->m; i++ )
+      {
+        f[i+l*ld] = f[i];
+      }
+    }
+    s->diffusion ( t + sri_c1[l] * dt, s->h1, g + l * ld, s->ctx );
+  }
+
+  for ( i = 0; i < s->m; i++ )
+  {
+    i1 = dw[i];
+    i11 = ( dw[i] * dw[i] - dt ) / ( 2.0 * sq );
+    i10 = dz[i] / dt;
+    i111 = ( dw[i] * dw[i] * dw[i] - 3.0 * dw[i] * dt ) / ( 6.0 * dt );
+    for ( l = 0; l < 4; l++ )
+    {
+      y[i] = y[i] + sri_alpha[l] * f[i+l*ld] * dt
+        + ( sri_beta1[l] * i1 + sri_beta2[l] * i11 + sri_beta3[l] * i10
+        + sri_beta4[l] * i111 ) * g[i+l*ld];
+    }
+  }
+
+  s->drift_num = s->drift_num + 2;
+  s->diffusion_num = s->diffusion_num + 4;
+  RK4_STATS_ADD ( RK4_COUNT_EVAL, 6 );
+
+  return;
+}
@@ -0,0 +1,72 @@
+/*
+  sde_stepper integrates the Ito SDE
+
+    dY = F ( T, Y ) dT + G ( T, Y ) dW
+
+  with diagonal noise: component I of Y is driven by its own Wiener
+  process W(I), with intensity G(I).  DRIFT ( T, Y, F, CTX ) sets F[M]
+  and DIFFUSION ( T, Y, G, CTX ) sets G[M].
+
+  SDE_EULER is Euler-Maruyama, of strong order 1/2.
+  SDE_MILSTEIN is the derivative free Milstein method of Kloeden and
+  Platen, of strong order 1.
+  SDE_SRI is SRIW1 of Roessler, of strong order 3/2.
+  SDE_SRA is SRA1 of Roessler, of strong order 3/2 for additive noise,
+  where G does not depend on Y.
+
+  The orders of SDE_MILSTEIN and SDE_SRI need G(I) to depend on Y(I)
+  only, besides T.
+
+  The increments of a step are DW[I] = W(I) ( T + DT ) - W(I) ( T ) and
+  DZ[I], the integral of W(I) ( S ) - W(I) ( T ) over the step, which
+  only SDE_SRI and SDE_SRA use.  sde_noise() draws them from the
+  counter based generator Philox4x32-10, keyed by SEED, with the
+  component, the step index and the ensemble MEMBER as the counter.
+  Every number is thus a function of those four values alone, and a
+  member's path does not depend on how members are spread over threads.
+*/
+# define SDE_EULER 0
+# define SDE_MILSTEIN 1
+# define SDE_SRI 2
+# define SDE_SRA 3
+
+typedef struct
+{
+  void ( *drift ) ( double t, double y[], double f[], void *ctx );
+  void ( *diffusion ) ( double t, double y[], double g[], void *ctx );
+  void *ctx;
+  int method;
+  int m;
+  int ld;
+  unsigned long long int seed;
+  int member;
+  double t;
+  long int step_num;
+  long int drift_num;
+  long int diffusion_num;
+  double *y;
+  double *dw;
+  double *dz;
+  double *f;
+  double *g;
+  double *h0;
+  double *h1;
+  double *work;
+} sde_stepper;
+
+void philox4x32 ( unsigned int ctr[4], unsigned int key[2],
+  unsigned int out[4] );
+void sde_advance ( sde_stepper *s, double t1, int n );
+sde_stepper *sde_create ( int method, void drift ( double t, double y[],
+  double f[], void *ctx ), void diffusion ( double t, double y[], double g[],
+  void *ctx ), void *ctx, int m, double t0, double y0[],
+  unsigned long long int seed, int member );
+void sde_destroy ( sde_stepper *s );
+int sde_ensemble ( int method, void drift ( double t, double y[], double f[],
+  void *ctx ), void diffusion ( double t, double y[], double g[], void *ctx ),
+  void *ctx, int m, int nens, double tspan[2], double y0[], int n,
+  unsigned long long int seed, rk4_pool *pool, double result[] );
+void sde_noise ( unsigned long long int seed, int member, long int step,
+  int m, double dt, double dw[], double dz[] );
+void sde_reset ( sde_stepper *s, double t0, double y0[], int member );
+void sde_step ( sde_stepper *s, double dt, double dw[], double dz[] );
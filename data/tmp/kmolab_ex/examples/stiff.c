@@ -0,0 +1,1632 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "stiff.h"
+
+# define BDF_MAX_ORDER 5
+# define BDF_NEWTON_MAXITER 4
+
+static void bdf_change_d ( bdf_stepper *s, double factor );
+static void bdf_compute_r ( int order, double factor, double r[] );
+static int bdf_newton ( bdf_stepper *s, double t_new, double c,
+  int *iter_num );
+static double stiff_hinit ( void dydt ( double t, double u[], double f[] ),
+  int m, double t, double y[], double f[], double rtol, double atol,
+  int order, double u[], double f1[] );
+static double stiff_norm ( int m, double e[], double scale[] );
+
+static const double r8_epsilon = 2.220446049250313E-16;
+
+/******************************************************************************/
+
+int stiff_jac_init ( stiff_jac *jac, void dydt ( double t, double u[],
+  double f[] ), void jac_fn ( double t, double u[], double dfdy[] ),
+  int pattern[], int m )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    stiff_jac_init sets up the evaluation of a Jacobian.
+
+  Discussion:
+
+    If JAC_FN is NULL and PATTERN is given, the columns are colored
+    greedily: each column takes the lowest color not yet used by a
+    column sharing one of its nonzero rows.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[] ), the right hand side.
+
+    void JAC_FN ( double T, double U[], double DFDY[] ), the Jacobian,
+    or NULL to use finite differences.
+
+    int PATTERN[M*M], nonzero where DFDY[I+J*M] may be nonzero, or NULL
+    if the Jacobian is dense.  PATTERN is copied.
+
+    int M: the number of variables.
+
+  Output:
+
+    stiff_jac *JAC: the Jacobian evaluator.
+
+    int STIFF_JAC_INIT: 0 on success, 2 if memory could not be allocated.
+*/
+{
+  int c;
+  int i;
+  int j;
+  int ok;
+  int *used;
+
+  jac->dydt = dydt;
+  jac->jac = jac_fn;
+  jac->m = m;
+  jac->pattern = NULL;
+  jac->color = NULL;
+  jac->color_num = 0;
+  jac->eval_num = 0;
+  jac->jac_num = 0;
+  jac->fp = NULL;
+  jac->yp = NULL;
+
+  if ( jac_fn != NULL )
+  {
+    return 0;
+  }
+
+  jac->fp = ( double * ) malloc ( m * sizeof ( double ) );
+  jac->yp = ( double * ) malloc ( m * sizeof ( double ) );
+  jac->color = ( int * ) malloc ( m * sizeof ( int ) );
+  if ( jac->fp == NULL || jac->yp == NULL || jac->color == NULL )
+  {
+    stiff_jac_free ( jac );
+    return 2;
+  }
+
+  if ( pattern == NULL )
+  {
+    for ( j = 0; j < m; j++ )
+    {
+      jac->color[j] = j;
+    }
+    jac->color_num = m;
+    return 0;
+  }
+
+  jac->pattern = ( int * ) malloc ( m * m * sizeof ( int ) );
+  used = ( int * ) calloc ( m * m, sizeof ( int ) );
+  if ( jac->pattern == NULL || used == NULL )
+  {
+    free ( used );
+    stiff_jac_free ( jac );
+    return 2;
+  }
+  for ( i = 0; i < m * m; i++ )
+  {
+    jac->pattern[i] = ( pattern[i] != 0 );
+  }
+/*
+  USED[I+C*M] is 1 if a column of color C has a nonzero in row I.
+*/
+  for ( j = 0; j < m; j++ )
+  {
+    for ( c = 0; ; c++ )
+    {
+      ok = 1;
+      for ( i = 0; i < m; i++ )
+      {
+        if ( jac->pattern[i+j*m] && used[i+c*m] )
+        {
+          ok = 0;
+          break;
+        }
+      }
+      if ( ok )
+      {
+        break;
+      }
+    }
+    jac->color[j] = c;
+    for ( i = 0; i < m; i++ )
+    {
+      if ( jac->pattern[i+j*m] )
+      {
+        used[i+c*m] = 1;
+      }
+    }
+    if ( jac->color_num < c + 1 )
+    {
+      jac->color_num = c + 1;
+    }
+  }
+
+  free ( used );
+
+  return 0;
+}
+/******************************************************************************/
+
+void stiff_jac_free ( stiff_jac *jac )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    stiff_jac_free frees the memory of a Jacobian evaluator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    stiff_jac *JAC: the Jacobian evaluator.
+*/
+{
+  free ( jac->pattern );
+  free ( jac->color );
+  free ( jac->fp );
+  free ( jac->yp );
+  jac->pattern = NULL;
+  jac->color = NULL;
+  jac->fp = NULL;
+  jac->yp = NULL;
+
+  return;
+}
+/******************************************************************************/
+
+void stiff_jac_eval ( stiff_jac *jac, double t, double y[], double f[],
+  double dfdy[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    stiff_jac_eval evaluates a Jacobian.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    stiff_jac *JAC: the Jacobian evaluator.
+
+    double T: the time.
+
+    double Y[M]: the state.
+
+    double F[M]: the right hand side at T and Y.
+
+  Output:
+
+    double DFDY[M*M]: the Jacobian, with DFDY[I+J*M] = dF(I)/dY(J).
+*/
+{
+  int c;
+  double del;
+  int i;
+  int j;
+  int m;
+
+  jac->jac_num = jac->jac_num + 1;
+
+  if ( jac->jac != NULL )
+  {
+    jac->jac ( t, y, dfdy );
+    return;
+  }
+
+  m = jac->m;
+
+  for ( c = 0; c < jac->color_num; c++ )
+  {
+    for ( j = 0; j < m; j++ )
+    {
+      jac->yp[j] = y[j];
+      if ( jac->color[j] == c )
+      {
+        jac->yp[j] = y[j] + sqrt ( r8_epsilon ) * fmax ( 1.0, fabs ( y[j] ) );
+      }
+    }
+
+    jac->dydt ( t, jac->yp, jac->fp );
+    jac->eval_num = jac->eval_num + 1;
+
+    for ( j = 0; j < m; j++ )
+    {
+      if ( jac->color[j] != c )
+      {
+        continue;
+      }
+/*
+  Divide by the increment actually stored, not the one intended.
+*/
+      del = jac->yp[j] - y[j];
+      for ( i = 0; i < m; i++ )
+      {
+        if ( jac->pattern == NULL || jac->pattern[i+j*m] )
+        {
+          dfdy[i+j*m] = ( jac->fp[i] - f[i] ) / del;
+        }
+        else
+        {
+          dfdy[i+j*m] = 0.0;
+        }
+      }
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+ros23_stepper *ros23_create ( void dydt ( double t, double u[], double f[] ),
+  void jac ( double t, double u[], double dfdy[] ), int pattern[], int m,
+  double t0, double y0[], double rtol, double atol )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ros23_create creates a Rosenbrock 2(3) stepper for stiff problems.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[] ), the right hand side.
+
+    void JAC ( double T, double U[], double DFDY[] ), the Jacobian, or
+    NULL to use finite differences.
+
+    int PATTERN[M*M], the sparsity pattern of the Jacobian, or NULL.
+    Only used for finite differences.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    double RTOL, ATOL: the relative and absolute error tolerances.
+
+  Output:
+
+    ros23_stepper *ROS23_CREATE: the stepper, or NULL if memory could not
+    be allocated.
+*/
+{
+  int i;
+  int ld;
+  ros23_stepper *s;
+
+  s = ( ros23_stepper * ) malloc ( sizeof ( ros23_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+  if ( stiff_jac_init ( &s->jac, dydt, jac, pattern, m ) != 0 )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( 9 * ld + 2 * m * m );
+  s->pivot = ( int * ) malloc ( m * sizeof ( int ) );
+  if ( s->work == NULL || s->pivot == NULL )
+  {
+    r8vec_aligned_free ( s->work );
+    free ( s->pivot );
+    stiff_jac_free ( &s->jac );
+    free ( s );
+    return NULL;
+  }
+
+  s->m = m;
+  s->rtol = rtol;
+  s->atol = atol;
+  s->hmax = HUGE_VAL;
+  s->t = t0;
+  s->h = 0.0;
+  s->step_num = 0;
+  s->reject_num = 0;
+  s->eval_num = 0;
+  s->lu_num = 0;
+  s->y     = s->work;
+  s->y_new = s->work +     ld;
+  s->f0    = s->work + 2 * ld;
+  s->f1    = s->work + 3 * ld;
+  s->f2    = s->work + 4 * ld;
+  s->k1    = s->work + 5 * ld;
+  s->k2    = s->work + 6 * ld;
+  s->k3    = s->work + 7 * ld;
+  s->dfdt  = s->work + 8 * ld;
+  s->dfdy  = s->work + 9 * ld;
+  s->w     = s->work + 9 * ld + m * m;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = y0[i];
+  }
+  dydt ( t0, s->y, s->f0 );
+  s->eval_num = 1;
+
+  return s;
+}
+/******************************************************************************/
+
+void ros23_destroy ( ros23_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ros23_destroy frees a Rosenbrock 2(3) stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    ros23_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  stiff_jac_free ( &s->jac );
+  r8vec_aligned_free ( s->work );
+  free ( s->pivot );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int ros23_step ( ros23_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ros23_step takes one accepted Rosenbrock 2(3) step, without passing T1.
+
+  Discussion:
+
+    The formula is that of the MATLAB solver ode23s:
+
+      W  = I - H * D * J,  D = 1 / ( 2 + sqrt ( 2 ) )
+      W K1 = F0 + H * D * dF/dT
+      W ( K2 - K1 ) = F ( T + H/2, Y + H/2 K1 ) - K1
+      YNEW = Y + H * K2
+      W K3 = F2 - E32 ( K2 - F1 ) - 2 ( K1 - F0 ) + H * D * dF/dT
+
+    and the error estimate is H/6 ( K1 - 2 K2 + K3 ).  The Jacobian is
+    evaluated once per step; after a rejection only W is refactored.
+    The derivative at the end of an accepted step is the F0 of the next.
+
+    The minimum stepsize is 16 EPS |T|, or 16 EPS 1.0E-300 at T = 0.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    ros23_stepper *S: the stepper.
+
+    double T1: the time not to step past, T1 > S->T.
+
+  Output:
+
+    ros23_stepper *S: the advanced stepper.
+
+    int ROS23_STEP: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  double d;
+  double e32;
+  double err;
+  double fac;
+  double h;
+  double hmin;
+  int i;
+  int j;
+  int jac_current;
+  long int jac_eval_num;
+  int last;
+  int m;
+  double sk;
+  double t;
+  double tdel;
+  double *tmp;
+
+  m = s->m;
+  t = s->t;
+  d = 1.0 / ( 2.0 + sqrt ( 2.0 ) );
+  e32 = 6.0 + sqrt ( 2.0 );
+
+  if ( s->h == 0.0 )
+  {
+    s->h = stiff_hinit ( s->jac.dydt, m, t, s->y, s->f0, s->rtol, s->atol, 2,
+      s->y_new, s->f1 );
+    s->eval_num = s->eval_num + 1;
+  }
+
+  jac_current = 0;
+
+  for ( ; ; )
+  {
+    h = fmin ( s->h, s->hmax );
+    last = 0;
+    if ( t1 - t <= h )
+    {
+      h = t1 - t;
+      last = 1;
+    }
+
+    hmin = 16.0 * r8_epsilon * fmax ( fabs ( t ), 1.0E-300 );
+    if ( h < hmin )
+    {
+      return 1;
+    }
+
+    if ( !jac_current )
+    {
+      tdel = ( t + fmin ( sqrt ( r8_epsilon ) * fmax ( fabs ( t ),
+        fabs ( t + h ) ), h ) ) - t;
+      if ( tdel == 0.0 )
+      {
+        tdel = sqrt ( r8_epsilon ) * h;
+      }
+      s->jac.dydt ( t + tdel, s->y, s->f1 );
+      for ( i = 0; i < m; i++ )
+      {
+        s->dfdt[i] = ( s->f1[i] - s->f0[i] ) / tdel;
+      }
+      jac_eval_num = s->jac.eval_num;
+      stiff_jac_eval ( &s->jac, t, s->y, s->f0, s->dfdy );
+      s->eval_num = s->eval_num + 1 + ( s->jac.eval_num - jac_eval_num );
+      jac_current = 1;
+    }
+
+    for ( j = 0; j < m; j++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        s->w[i+j*m] = - h * d * s->dfdy[i+j*m];
+      }
+      s->w[j+j*m] = s->w[j+j*m] + 1.0;
+    }
+    s->lu_num = s->lu_num + 1;
+    if ( r8ge_fa ( m, s->w, s->pivot ) != 0 )
+    {
+      s->reject_num = s->reject_num + 1;
+      s->h = 0.5 * h;
+      continue;
+    }
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->k1[i] = s->f0[i] + h * d * s->dfdt[i];
+    }
+    r8ge_sl ( m, s->w, s->pivot, s->k1 );
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->y_new[i] = s->y[i] + 0.5 * h * s->k1[i];
+    }
+    s->jac.dydt ( t + 0.5 * h, s->y_new, s->f1 );
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->k2[i] = s->f1[i] - s->k1[i];
+    }
+    r8ge_sl ( m, s->w, s->pivot, s->k2 );
+    for ( i = 0; i < m; i++ )
+    {
+      s->k2[i] = s->k2[i] + s->k1[i];
+      s->y_new[i] = s->y[i] + h * s->k2[i];
+    }
+    s->jac.dydt ( t + h, s->y_new, s->f2 );
+    s->eval_num = s->eval_num + 2;
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->k3[i] = s->f2[i] - e32 * ( s->k2[i] - s->f1[i] )
+        - 2.0 * ( s->k1[i] - s->f0[i] ) + h * d * s->dfdt[i];
+    }
+    r8ge_sl ( m, s->w, s->pivot, s->k3 );
+
+    err = 0.0;
+    for ( i = 0; i < m; i++ )
+    {
+      sk = s->atol + s->rtol * fmax ( fabs ( s->y[i] ), fabs ( s->y_new[i] ) );
+      s->k3[i] = ( h / 6.0 ) * ( s->k1[i] - 2.0 * s->k2[i] + s->k3[i] ) / sk;
+      err = err + s->k3[i] * s->k3[i];
+    }
+    err = sqrt ( err / m );
+
+/*
+  A NaN or infinite error, from a failed right hand side, is rejected
+  and shrinks the step by the largest allowed factor.
+*/
+    if ( !( err <= 1.0 ) )
+    {
+      s->reject_num = s->reject_num + 1;
+      if ( isfinite ( err ) )
+      {
+        fac = fmax ( 0.2, 0.8 * pow ( err, -1.0 / 3.0 ) );
+      }
+      else
+      {
+        fac = 0.2;
+      }
+      s->h = h * fac;
+      continue;
+    }
+
+    if ( err == 0.0 )
+    {
+      fac = 5.0;
+    }
+    else
+    {
+      fac = fmin ( 5.0, 0.8 * pow ( err, -1.0 / 3.0 ) );
+    }
+    if ( !last )
+    {
+      s->h = h * fac;
+    }
+
+    tmp = s->y;
+    s->y = s->y_new;
+    s->y_new = tmp;
+
+    tmp = s->f0;
+    s->f0 = s->f2;
+    s->f2 = tmp;
+
+    s->t = last ? t1 : t + h;
+    s->step_num = s->step_num + 1;
+
+    return 0;
+  }
+}
+/******************************************************************************/
+
+int ros23_advance ( ros23_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ros23_advance takes Rosenbrock 2(3) steps until T1 is reached.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    ros23_stepper *S: the stepper.
+
+    double T1: the final time.
+
+  Output:
+
+    int ROS23_ADVANCE: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  int status;
+
+  while ( s->t < t1 )
+  {
+    status = ros23_step ( s, t1 );
+    if ( status != 0 )
+    {
+      return status;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+bdf_stepper *bdf_create ( void dydt ( double t, double u[], double f[] ),
+  void jac ( double t, double u[], double dfdy[] ), int pattern[], int m,
+  double t0, double y0[], double rtol, double atol )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_create creates a variable order BDF stepper for stiff problems.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    void DYDT ( double T, double U[], double F[] ), the right hand side.
+
+    void JAC ( double T, double U[], double DFDY[] ), the Jacobian, or
+    NULL to use finite differences.
+
+    int PATTERN[M*M], the sparsity pattern of the Jacobian, or NULL.
+    Only used for finite differences.
+
+    int M: the number of variables.
+
+    double T0: the initial time.
+
+    double Y0[M]: the initial condition.
+
+    double RTOL, ATOL: the relative and absolute error tolerances.
+
+  Output:
+
+    bdf_stepper *BDF_CREATE: the stepper, or NULL if memory could not be
+    allocated.
+*/
+{
+  int i;
+  int ld;
+  bdf_stepper *s;
+
+  s = ( bdf_stepper * ) malloc ( sizeof ( bdf_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+  if ( stiff_jac_init ( &s->jac, dydt, jac, pattern, m ) != 0 )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld = ( ( m + ld - 1 ) / ld ) * ld;
+/*
+  D has rows 0 to BDF_MAX_ORDER+2, DTMP rows 0 to BDF_MAX_ORDER.
+*/
+  s->work = r8vec_aligned_new ( ( 2 * BDF_MAX_ORDER + 11 ) * ld + 2 * m * m );
+  s->pivot = ( int * ) malloc ( m * sizeof ( int ) );
+  if ( s->work == NULL || s->pivot == NULL )
+  {
+    r8vec_aligned_free ( s->work );
+    free ( s->pivot );
+    stiff_jac_free ( &s->jac );
+    free ( s );
+    return NULL;
+  }
+
+  s->m = m;
+  s->rtol = rtol;
+  s->atol = atol;
+  s->hmax = HUGE_VAL;
+  s->newton_tol = fmax ( 10.0 * r8_epsilon / rtol, fmin ( 0.03, sqrt ( rtol ) ) );
+  s->t = t0;
+  s->h = 0.0;
+  s->order = 1;
+  s->equal_step_num = 0;
+  s->lu_valid = 0;
+  s->step_num = 0;
+  s->reject_num = 0;
+  s->eval_num = 0;
+  s->lu_num = 0;
+  s->d         = s->work;
+  s->dtmp      = s->work + (     BDF_MAX_ORDER + 3 ) * ld;
+  s->y_predict = s->work + ( 2 * BDF_MAX_ORDER + 4 ) * ld;
+  s->y_new     = s->work + ( 2 * BDF_MAX_ORDER + 5 ) * ld;
+  s->psi       = s->work + ( 2 * BDF_MAX_ORDER + 6 ) * ld;
+  s->dd        = s->work + ( 2 * BDF_MAX_ORDER + 7 ) * ld;
+  s->f         = s->work + ( 2 * BDF_MAX_ORDER + 8 ) * ld;
+  s->dy        = s->work + ( 2 * BDF_MAX_ORDER + 9 ) * ld;
+  s->scale     = s->work + ( 2 * BDF_MAX_ORDER + 10 ) * ld;
+  s->dfdy      = s->work + ( 2 * BDF_MAX_ORDER + 11 ) * ld;
+  s->w         = s->dfdy + m * m;
+/*
+  Row 0 of D is the solution; the other rows are set on the first step.
+*/
+  s->y = s->d;
+  for ( i = 0; i < m; i++ )
+  {
+    s->y[i] = y0[i];
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void bdf_destroy ( bdf_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_destroy frees a BDF stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bdf_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  stiff_jac_free ( &s->jac );
+  r8vec_aligned_free ( s->work );
+  free ( s->pivot );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+int bdf_step ( bdf_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_step takes one accepted BDF step, without passing T1.
+
+  Discussion:
+
+    This follows the quasi-constant step BDF of Shampine and Reichelt,
+    as used in the SciPy solver BDF, with the plain BDF coefficients.
+    After ORDER+1 steps of equal size, the errors of orders ORDER-1,
+    ORDER and ORDER+1 are compared to choose the next order and stepsize.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bdf_stepper *S: the stepper.
+
+    double T1: the time not to step past, T1 > S->T.
+
+  Output:
+
+    bdf_stepper *S: the advanced stepper.
+
+    int BDF_STEP: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  double alpha;
+  double c;
+  int converged;
+  double err;
+  double err_m;
+  double err_p;
+  double fac;
+  double fac_m;
+  double fac_p;
+  double gamma[BDF_MAX_ORDER+1];
+  double h;
+  double hmin;
+  int i;
+  int iter_num;
+  int jac_current;
+  long int jac_eval_num;
+  int k;
+  int m;
+  int order;
+  double *row;
+  double safety;
+  double t;
+  double t_new;
+
+  m = s->m;
+  t = s->t;
+
+  gamma[0] = 0.0;
+  for ( k = 1; k <= BDF_MAX_ORDER; k++ )
+  {
+    gamma[k] = gamma[k-1] + 1.0 / ( double ) k;
+  }
+/*
+  On the first step, choose H and set the first difference, H * F.
+*/
+  if ( s->h == 0.0 )
+  {
+    s->jac.dydt ( t, s->y, s->f );
+    s->h = stiff_hinit ( s->jac.dydt, m, t, s->y, s->f, s->rtol, s->atol, 1,
+      s->y_new, s->dy );
+    s->h = fmin ( s->h, s->hmax );
+    s->eval_num = s->eval_num + 2;
+    for ( i = 0; i < m; i++ )
+    {
+      s->d[i+m] = s->h * s->f[i];
+    }
+    jac_eval_num = s->jac.eval_num;
+    stiff_jac_eval ( &s->jac, t, s->y, s->f, s->dfdy );
+    s->eval_num = s->eval_num + ( s->jac.eval_num - jac_eval_num );
+  }
+
+  hmin = 10.0 * r8_epsilon * fmax ( fabs ( t ), 1.0E-300 );
+  if ( s->hmax < s->h )
+  {
+    bdf_change_d ( s, s->hmax / s->h );
+    s->h = s->hmax;
+    s->equal_step_num = 0;
+    s->lu_valid = 0;
+  }
+
+  order = s->order;
+  jac_current = 0;
+
+  for ( ; ; )
+  {
+    if ( s->h < hmin )
+    {
+      return 1;
+    }
+
+    h = s->h;
+    t_new = t + h;
+    if ( t1 < t_new )
+    {
+      t_new = t1;
+      bdf_change_d ( s, ( t_new - t ) / h );
+      s->equal_step_num = 0;
+      s->lu_valid = 0;
+      h = t_new - t;
+      s->h = h;
+    }
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->y_predict[i] = 0.0;
+      s->psi[i] = 0.0;
+    }
+    for ( k = 0; k <= order; k++ )
+    {
+      row = s->d + k * m;
+      for ( i = 0; i < m; i++ )
+      {
+        s->y_predict[i] = s->y_predict[i] + row[i];
+        s->psi[i] = s->psi[i] + gamma[k] * row[i];
+      }
+    }
+    alpha = gamma[order];
+    for ( i = 0; i < m; i++ )
+    {
+      s->psi[i] = s->psi[i] / alpha;
+      s->scale[i] = s->atol + s->rtol * fabs ( s->y_predict[i] );
+    }
+    c = h / alpha;
+
+    for ( ; ; )
+    {
+      if ( !s->lu_valid )
+      {
+        for ( k = 0; k < m * m; k++ )
+        {
+          s->w[k] = - c * s->dfdy[k];
+        }
+        for ( k = 0; k < m; k++ )
+        {
+          s->w[k+k*m] = s->w[k+k*m] + 1.0;
+        }
+        s->lu_num = s->lu_num + 1;
+        s->lu_valid = ( r8ge_fa ( m, s->w, s->pivot ) == 0 );
+      }
+
+      converged = s->lu_valid && bdf_newton ( s, t_new, c, &iter_num );
+
+      if ( converged || jac_current )
+      {
+        break;
+      }
+/*
+  The Newton iteration failed with an old Jacobian.  Renew it and retry.
+*/
+      s->jac.dydt ( t_new, s->y_predict, s->f );
+      jac_eval_num = s->jac.eval_num;
+      stiff_jac_eval ( &s->jac, t_new, s->y_predict, s->f, s->dfdy );
+      s->eval_num = s->eval_num + 1 + ( s->jac.eval_num - jac_eval_num );
+      s->lu_valid = 0;
+      jac_current = 1;
+    }
+
+    if ( !converged )
+    {
+      s->reject_num = s->reject_num + 1;
+      bdf_change_d ( s, 0.5 );
+      s->h = 0.5 * h;
+      s->equal_step_num = 0;
+      s->lu_valid = 0;
+      continue;
+    }
+
+    safety = 0.9 * ( 2 * BDF_NEWTON_MAXITER + 1 )
+      / ( double ) ( 2 * BDF_NEWTON_MAXITER + iter_num );
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->scale[i] = s->atol + s->rtol * fabs ( s->y_new[i] );
+      s->dy[i] = s->dd[i] / ( double ) ( order + 1 );
+    }
+    err = stiff_norm ( m, s->dy, s->scale );
+
+    if ( 1.0 < err )
+    {
+      s->reject_num = s->reject_num + 1;
+      fac = fmax ( 0.2, safety * pow ( err, -1.0 / ( order + 1 ) ) );
+      bdf_change_d ( s, fac );
+      s->h = h * fac;
+      s->equal_step_num = 0;
+      s->lu_valid = 0;
+      continue;
+    }
+
+    break;
+  }
+/*
+  Accept the step and update the differences:
+    D[ORDER+2] = DD - D[ORDER+1], D[ORDER+1] = DD, D[K] += D[K+1].
+*/
+  s->step_num = s->step_num + 1;
+  s->equal_step_num = s->equal_step_num + 1;
+  s->t = t_new;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->d[i+(order+2)*m] = s->dd[i] - s->d[i+(order+1)*m];
+    s->d[i+(order+1)*m] = s->dd[i];
+  }
+  for ( k = order; 0 <= k; k-- )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      s->d[i+k*m] = s->d[i+k*m] + s->d[i+(k+1)*m];
+    }
+  }
+
+  if ( s->equal_step_num < order + 1 || t1 <= s->t )
+  {
+    return 0;
+  }
+/*
+  Choose the order and stepsize for the next steps.
+*/
+  fac_m = 0.0;
+  if ( 1 < order )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      s->dy[i] = s->d[i+order*m] / ( double ) order;
+    }
+    err_m = stiff_norm ( m, s->dy, s->scale );
+    fac_m = ( err_m == 0.0 ) ? HUGE_VAL : pow ( err_m, -1.0 / order );
+  }
+
+  fac_p = 0.0;
+  if ( order < BDF_MAX_ORDER )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      s->dy[i] = s->d[i+(order+2)*m] / ( double ) ( order + 2 );
+    }
+    err_p = stiff_norm ( m, s->dy, s->scale );
+    fac_p = ( err_p == 0.0 ) ? HUGE_VAL : pow ( err_p, -1.0 / ( order + 2 ) );
+  }
+
+  fac = ( err == 0.0 ) ? HUGE_VAL : pow ( err, -1.0 / ( order + 1 ) );
+
+  if ( fac < fac_m && fac_p <= fac_m )
+  {
+    order = order - 1;
+    fac = fac_m;
+  }
+  else if ( fac < fac_p )
+  {
+    order = order + 1;
+    fac = fac_p;
+  }
+  s->order = order;
+
+  fac = fmin ( 10.0, safety * fac );
+  bdf_change_d ( s, fac );
+  s->h = s->h * fac;
+  s->equal_step_num = 0;
+  s->lu_valid = 0;
+
+  return 0;
+}
+/******************************************************************************/
+
+int bdf_advance ( bdf_stepper *s, double t1 )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_advance takes BDF steps until T1 is reached.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    bdf_stepper *S: the stepper.
+
+    double T1: the final time.
+
+  Output:
+
+    int BDF_ADVANCE: 0 on success, 1 if the stepsize became too small.
+*/
+{
+  int status;
+
+  while ( s->t < t1 )
+  {
+    status = bdf_step ( s, t1 );
+    if ( status != 0 )
+    {
+      return status;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static int bdf_newton ( bdf_stepper *s, double t_new, double c,
+  int *iter_num )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_newton solves the BDF corrector equation by simplified Newton.
+
+  Discussion:
+
+    On return, S->Y_NEW holds the corrected solution and S->DD its
+    difference from the prediction.  The iteration gives up as soon as
+    its observed rate shows that it cannot reach the tolerance in
+    BDF_NEWTON_MAXITER iterations.
+
+  Modified:
+
+    18 October 2026
+
+  Output:
+
+    int *ITER_NUM: the number of iterations.
+
+    int BDF_NEWTON: 1 if the iteration converged.
+*/
+{
+  int i;
+  int k;
+  int m;
+  double rate;
+  double dy_norm;
+  double dy_norm_old;
+
+  m = s->m;
+  dy_norm_old = -1.0;
+
+  for ( i = 0; i < m; i++ )
+  {
+    s->y_new[i] = s->y_predict[i];
+    s->dd[i] = 0.0;
+  }
+
+  for ( k = 0; k < BDF_NEWTON_MAXITER; k++ )
+  {
+    *iter_num = k + 1;
+
+    s->jac.dydt ( t_new, s->y_new, s->f );
+    s->eval_num = s->eval_num + 1;
+
+    for ( i = 0; i < m; i++ )
+    {
+      if ( !isfinite ( s->f[i] ) )
+      {
+        return 0;
+      }
+      s->dy[i] = c * s->f[i] - s->psi[i] - s->dd[i];
+    }
+    r8ge_sl ( m, s->w, s->pivot, s->dy );
+    dy_norm = stiff_norm ( m, s->dy, s->scale );
+
+    rate = -1.0;
+    if ( 0.0 <= dy_norm_old )
+    {
+      rate = dy_norm / dy_norm_old;
+      if ( 1.0 <= rate || pow ( rate, BDF_NEWTON_MAXITER - k )
+        / ( 1.0 - rate ) * dy_norm > s->newton_tol )
+      {
+        return 0;
+      }
+    }
+
+    for ( i = 0; i < m; i++ )
+    {
+      s->y_new[i] = s->y_new[i] + s->dy[i];
+      s->dd[i] = s->dd[i] + s->dy[i];
+    }
+
+    if ( dy_norm == 0.0 ||
+      ( 0.0 <= rate && rate / ( 1.0 - rate ) * dy_norm < s->newton_tol ) )
+    {
+      return 1;
+    }
+    dy_norm_old = dy_norm;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static void bdf_change_d ( bdf_stepper *s, double factor )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_change_d rescales the backward differences for a new stepsize.
+
+  Discussion:
+
+    For the stepsize ratio FACTOR, rows 0 to ORDER of D are replaced by
+    ( R * U )' * D, where R = bdf_compute_r ( ORDER, FACTOR ) and
+    U = bdf_compute_r ( ORDER, 1 ).
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  int j;
+  int k;
+  int m;
+  int n;
+  double r[(BDF_MAX_ORDER+1)*(BDF_MAX_ORDER+1)];
+  double ru[(BDF_MAX_ORDER+1)*(BDF_MAX_ORDER+1)];
+  double u[(BDF_MAX_ORDER+1)*(BDF_MAX_ORDER+1)];
+  double v;
+
+  m = s->m;
+  n = s->order + 1;
+
+  bdf_compute_r ( s->order, factor, r );
+  bdf_compute_r ( s->order, 1.0, u );
+
+  for ( i = 0; i < n; i++ )
+  {
+    for ( j = 0; j < n; j++ )
+    {
+      v = 0.0;
+      for ( k = 0; k < n; k++ )
+      {
+        v = v + r[i+k*n] * u[k+j*n];
+      }
+      ru[i+j*n] = v;
+    }
+  }
+
+  for ( i = 0; i < n * m; i++ )
+  {
+    s->dtmp[i] = s->d[i];
+  }
+  for ( j = 0; j < n; j++ )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      v = 0.0;
+      for ( k = 0; k < n; k++ )
+      {
+        v = v + ru[k+j*n] * s->dtmp[i+k*m];
+      }
+      s->d[i+j*m] = v;
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void bdf_compute_r ( int order, double factor, double r[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    bdf_compute_r computes the difference transformation matrix.
+
+  Discussion:
+
+    R is the (ORDER+1) by (ORDER+1) matrix of column products
+      R(I,J) = prod ( 1 <= L <= I ) ( L - 1 - FACTOR * J ) / L
+    with R(0,J) = 1 and R(I,0) = 0 for I > 0.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  int j;
+  int n;
+
+  n = order + 1;
+
+  for ( j = 0; j < n; j++ )
+  {
+    r[0+j*n] = 1.0;
+    for ( i = 1; i < n; i++ )
+    {
+      if ( j == 0 )
+      {
+        r[i+j*n] = 0.0;
+      }
+      else
+      {
+        r[i+j*n] = r[i-1+j*n] * ( i - 1 - factor * j ) / ( double ) i;
+      }
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+int r8ge_fa ( int n, double a[], int pivot[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r8ge_fa performs a LINPACK-style PLU factorization of an R8GE matrix.
+
+  Discussion:
+
+    The R8GE storage format is used for a general M by N matrix.  A storage
+    space is made for each entry.  The two dimensional logical
+    array can be thought of as a vector of M*N entries, starting with
+    the M entries in the column 1, then the M entries in column 2
+    and so on.  Considered as a vector, the entry A(I,J) is then stored
+    in vector location I+(J-1)*M.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int N, the order of the matrix.
+
+    double A[N*N], the matrix to be factored.
+
+  Output:
+
+    double A[N*N], information about the factorization,
+    for use by r8ge_sl().
+
+    int PIVOT[N], the pivot vector.
+
+    int R8GE_FA, singularity flag.
+    0, no singularity detected.
+    nonzero, the factorization failed on the R8GE_FA-th step.
+*/
+{
+  int i;
+  int j;
+  int k;
+  int l;
+  double t;
+
+  for ( k = 1; k <= n - 1; k++ )
+  {
+/*
+  Find L, the index of the pivot row.
+*/
+    l = k;
+    for ( i = k + 1; i <= n; i++ )
+    {
+      if ( fabs ( a[l-1+(k-1)*n] ) < fabs ( a[i-1+(k-1)*n] ) )
+      {
+        l = i;
+      }
+    }
+    pivot[k-1] = l;
+
+    if ( a[l-1+(k-1)*n] == 0.0 )
+    {
+      return k;
+    }
+/*
+  Interchange rows L and K if necessary.
+*/
+    if ( l != k )
+    {
+      t = a[l-1+(k-1)*n];
+      a[l-1+(k-1)*n] = a[k-1+(k-1)*n];
+      a[k-1+(k-1)*n] = t;
+    }
+/*
+  Normalize the values that lie below the pivot entry A(K,K).
+*/
+    for ( i = k + 1; i <= n; i++ )
+    {
+      a[i-1+(k-1)*n] = - a[i-1+(k-1)*n] / a[k-1+(k-1)*n];
+    }
+/*
+  Row elimination with column indexing.
+*/
+    for ( j = k + 1; j <= n; j++ )
+    {
+      if ( l != k )
+      {
+        t = a[l-1+(j-1)*n];
+        a[l-1+(j-1)*n] = a[k-1+(j-1)*n];
+        a[k-1+(j-1)*n] = t;
+      }
+      for ( i = k + 1; i <= n; i++ )
+      {
+        a[i-1+(j-1)*n] = a[i-1+(j-1)*n] + a[i-1+(k-1)*n] * a[k-1+(j-1)*n];
+      }
+    }
+  }
+
+  pivot[n-1] = n;
+
+  if ( a[n-1+(n-1)*n] == 0.0 )
+  {
+    return n;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void r8ge_sl ( int n, double a_lu[], int pivot[], double b[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    r8ge_sl solves a system factored by r8ge_fa().
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int N, the order of the matrix.
+
+    double A_LU[N*N], the LU factors from r8ge_fa().
+
+    int PIVOT[N], the pivot vector from r8ge_fa().
+
+    double B[N], the right hand side.
+
+  Output:
+
+    double B[N], the solution.
+*/
+{
+  int i;
+  int k;
+  int l;
+  double t;
+/*
+  Solve PL * Y = B.
+*/
+  for ( k = 1; k <= n - 1; k++ )
+  {
+    l = pivot[k-1];
+    if ( l != k )
+    {
+      t = b[l-1];
+      b[l-1] = b[k-1];
+      b[k-1] = t;
+    }
+    for ( i = k + 1; i <= n; i++ )
+    {
+      b[i-1] = b[i-1] + a_lu[i-1+(k-1)*n] * b[k-1];
+    }
+  }
+/*
+  Solve U * X = Y.
+*/
+  for ( k = n; 1 <= k; k-- )
+  {
+    b[k-1] = b[k-1] / a_lu[k-1+(k-1)*n];
+    for ( i = 1; i <= k - 1; i++ )
+    {
+      b[i-1] = b[i-1] - a_lu[i-1+(k-1)*n] * b[k-1];
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static double stiff_hinit ( void dydt ( double t, double u[], double f[] ),
+  int m, double t, double y[], double f[], double rtol, double atol,
+  int order, double u[], double f1[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    stiff_hinit guesses an initial stepsize for a method of given order.
+
+  Discussion:
+
+    This is the starting step algorithm of Hairer, Norsett and Wanner,
+    which costs one evaluation of DYDT.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double d0;
+  double d1;
+  double d2;
+  double h0;
+  double h1;
+  int i;
+  double sk;
+
+  d0 = 0.0;
+  d1 = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    sk = atol + rtol * fabs ( y[i] );
+    d0 = d0 + ( y[i] / sk ) * ( y[i] / sk );
+    d1 = d1 + ( f[i] / sk ) * ( f[i] / sk );
+  }
+  d0 = sqrt ( d0 / m );
+  d1 = sqrt ( d1 / m );
+
+  if ( d0 < 1.0E-05 || d1 < 1.0E-05 )
+  {
+    h0 = 1.0E-06;
+  }
+  else
+  {
+    h0 = 0.01 * d0 / d1;
+  }
+
+  for ( i = 0; i < m; i++ )
+  {
+    u[i] = y[i] + h0 * f[i];
+  }
+  dydt ( t + h0, u, f1 );
+
+  d2 = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    sk = atol + rtol * fabs ( y[i] );
+    d2 = d2 + ( ( f1[i] - f[i] ) / sk ) * ( ( f1[i] - f[i] ) / sk );
+  }
+  d2 = sqrt ( d2 / m ) / h0;
+
+  if ( fmax ( d1, d2 ) <= 1.0E-15 )
+  {
+    h1 = fmax ( 1.0E-06, h0 * 1.0E-03 );
+  }
+  else
+  {
+    h1 = pow ( 0.01 / fmax ( d1, d2 ), 1.0 / ( order + 1 ) );
+  }
+
+  return fmin ( 100.0 * h0, h1 );
+}
+/******************************************************************************/
+
+static double stiff_norm ( int m, double e[], double scale[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    stiff_norm computes the RMS norm of E / SCALE.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  int i;
+  double value;
+
+  value = 0.0;
+  for ( i = 0; i < m; i++ )
+  {
+    value = value + ( e[i] / scale[i] ) * ( e[i] / scale[i] );
+  }
+  value = sqrt ( value / m );
+
+  return value;
+}
@@ -0,0 +1,118 @@
+/*
+  stiff_jac evaluates the Jacobian DFDY[I+J*M] = dF(I)/dY(J) of a right
+  hand side, either with a user function JAC or by finite differences.
+
+  For finite differences, PATTERN[I+J*M] may mark the entries that can be
+  nonzero.  Columns with no common nonzero row get the same color and are
+  perturbed together, so one Jacobian costs COLOR_NUM calls of DYDT.
+  Without a pattern, every column has its own color.
+*/
+typedef struct
+{
+  void ( *dydt ) ( double t, double u[], double f[] );
+  void ( *jac ) ( double t, double u[], double dfdy[] );
+  int m;
+  int *pattern;
+  int *color;
+  int color_num;
+  long int eval_num;
+  long int jac_num;
+  double *fp;
+  double *yp;
+} stiff_jac;
+
+/*
+  ros23_stepper holds the state of a linearly implicit Rosenbrock
+  integration, using the second order formula with third order error
+  estimate of Shampine and Reichelt.  One LU factorization of
+  W = I - H * D * J serves all three stages of a step.
+*/
+typedef struct
+{
+  stiff_jac jac;
+  int m;
+  double rtol;
+  double atol;
+  double hmax;
+  double t;
+  double h;
+  long int step_num;
+  long int reject_num;
+  long int eval_num;
+  long int lu_num;
+  double *y;
+  double *y_new;
+  double *f0;
+  double *f1;
+  double *f2;
+  double *k1;
+  double *k2;
+  double *k3;
+  double *dfdt;
+  double *dfdy;
+  double *w;
+  int *pivot;
+  double *work;
+} ros23_stepper;
+
+/*
+  bdf_stepper holds the state of a variable order, variable step BDF
+  integration of orders 1 to 5.  The solution history is kept as the
+  backward differences D[K*M+I] of the interpolating polynomial, in
+  units of the current stepsize; Y is row 0 of D.  The Jacobian and the
+  LU factors of the Newton matrix are kept between steps, and only
+  renewed when the Newton iteration fails or the stepsize changes.
+*/
+typedef struct
+{
+  stiff_jac jac;
+  int m;
+  double rtol;
+  double atol;
+  double hmax;
+  double newton_tol;
+  double t;
+  double h;
+  int order;
+  int equal_step_num;
+  int lu_valid;
+  long int step_num;
+  long int reject_num;
+  long int eval_num;
+  long int lu_num;
+  double *y;
+  double *d;
+  double *y_predict;
+  double *y_new;
+  double *psi;
+  double *dd;
+  double *f;
+  double *dy;
+  double *scale;
+  double *dtmp;
+  double *dfdy;
+  double *w;
+  int *pivot;
+  double *work;
+} bdf_stepper;
+
+int bdf_advance ( bdf_stepper *s, double t1 );
+bdf_stepper *bdf_create ( void dydt ( double t, double u[], double f[] ),
+  void jac ( double t, double u[], double dfdy[] ), int pattern[], int m,
+  double t0, double y0[], double rtol, double atol );
+void bdf_destroy ( bdf_stepper *s );
+int bdf_step ( bdf_stepper *s, double t1 );
+int r8ge_fa ( int n, double a[], int pivot[] );
+void r8ge_sl ( int n, double a_lu[], int pivot[], double b[] );
+int ros23_advance ( ros23_stepper *s, double t1 );
+ros23_stepper *ros23_create ( void dydt ( double t, double u[], double f[] ),
+  void jac ( double t, double u[], double dfdy[] ), int pattern[], int m,
+  double t0, double y0[], double rtol, double atol );
+void ros23_destroy ( ros23_stepper *s );
+int ros23_step ( ros23_stepper *s, double t1 );
+void stiff_jac_eval ( stiff_jac *jac, double t, double y[], double f[],
+  double dfdy[] );
+void stiff_jac_free ( stiff_jac *jac );
+int stiff_jac_init ( stiff_jac *jac, void dydt ( double t, double u[],
+  double f[] ), void jac_fn ( double t, double u[], double dfdy[] ),
+  int pattern[], int m );
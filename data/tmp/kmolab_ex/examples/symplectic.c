@@ -0,0 +1,529 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "rk4.h"
+# include "symplectic.h"
+
+static void symp_step_to ( symp_stepper *s, double target, double dt );
+
+/******************************************************************************/
+
+void symp_advance ( symp_stepper *s, double t1, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_advance takes N equal symplectic steps from the current time to T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    symp_stepper *S: the stepper.
+
+    double T1: the final time.
+
+    int N: the number of steps to take.
+*/
+{
+  double dt;
+  int j;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  for ( j = 0; j < n; j++ )
+  {
+    symp_step ( s, dt );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+symp_stepper *symp_create ( int method, void dqdt ( double t, double p[],
+  double dq[], void *ctx ), void dpdt ( double t, double q[], double dp[],
+  void *ctx ), void *ctx, int n, double t0, double q0[], double p0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_create creates a symplectic stepper.
+
+  Discussion:
+
+    Each method is a sequence of Verlet substeps with weights W, which
+    sum to 1.  The Yoshida weights make the odd order error terms of the
+    composition cancel.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int METHOD: SYMP_VERLET, SYMP_YOSHIDA4, SYMP_YOSHIDA6 or
+    SYMP_FOREST_RUTH.
+
+    void DQDT ( double T, double P[], double DQ[], void *CTX ), evaluates
+    the rate of change of the positions.
+
+    void DPDT ( double T, double Q[], double DP[], void *CTX ), evaluates
+    the rate of change of the momenta.
+
+    void *CTX: the context passed to DQDT and DPDT.
+
+    int N: the number of positions.
+
+    double T0: the initial time.
+
+    double Q0[N], P0[N]: the initial positions and momenta.
+
+  Output:
+
+    symp_stepper *SYMP_CREATE: the stepper, or NULL if METHOD is unknown
+    or memory could not be allocated.
+*/
+{
+  int i;
+  int ld;
+  int ld2;
+  symp_stepper *s;
+  double x0;
+  double x1;
+
+  if ( method < SYMP_VERLET || SYMP_FOREST_RUTH < method )
+  {
+    return NULL;
+  }
+
+  s = ( symp_stepper * ) malloc ( sizeof ( symp_stepper ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+
+  ld = RK4_ALIGN / sizeof ( double );
+  ld2 = ( ( 2 * n + ld - 1 ) / ld ) * ld;
+  ld = ( ( n + ld - 1 ) / ld ) * ld;
+
+  s->work = r8vec_aligned_new ( ld2 + 2 * ld );
+  if ( s->work == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+
+  s->dqdt = dqdt;
+  s->dpdt = dpdt;
+  s->ctx = ctx;
+  s->method = method;
+  s->n = n;
+  s->m = 2 * n;
+  s->t = t0;
+  s->step_num = 0;
+  s->eval_num = 0;
+  s->valid = 0;
+  s->y = s->work;
+  s->q = s->work;
+  s->p = s->work + n;
+  s->f = s->work + ld2;
+  s->g = s->work + ld2 + ld;
+
+  for ( i = 0; i < n; i++ )
+  {
+    s->q[i] = q0[i];
+    s->p[i] = p0[i];
+  }
+
+  if ( method == SYMP_VERLET )
+  {
+    s->stage_num = 1;
+    s->w[0] = 1.0;
+  }
+  else if ( method == SYMP_YOSHIDA6 )
+  {
+    s->stage_num = 7;
+    s->w[0] =  0.784513610477560;
+    s->w[1] =  0.235573213359357;
+    s->w[2] = -1.17767998417887;
+    s->w[3] = 1.0 - 2.0 * ( s->w[0] + s->w[1] + s->w[2] );
+    s->w[4] = s->w[2];
+    s->w[5] = s->w[1];
+    s->w[6] = s->w[0];
+  }
+  else
+  {
+    x1 = 1.0 / ( 2.0 - cbrt ( 2.0 ) );
+    x0 = - cbrt ( 2.0 ) * x1;
+    s->stage_num = 3;
+    s->w[0] = x1;
+    s->w[1] = x0;
+    s->w[2] = x1;
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void symp_destroy ( symp_stepper *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_destroy frees a symplectic stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    symp_stepper *S: the stepper.  S may be NULL.
+*/
+{
+  if ( s == NULL )
+  {
+    return;
+  }
+  r8vec_aligned_free ( s->work );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+char *symp_name ( int method )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_name returns the name of a symplectic method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int METHOD: the method.
+
+  Output:
+
+    char *SYMP_NAME: the name, or "unknown".
+*/
+{
+  switch ( method )
+  {
+    case SYMP_VERLET:
+      return "verlet";
+    case SYMP_YOSHIDA4:
+      return "yoshida4";
+    case SYMP_YOSHIDA6:
+      return "yoshida6";
+    case SYMP_FOREST_RUTH:
+      return "forest_ruth";
+  }
+
+  return "unknown";
+}
+/******************************************************************************/
+
+int symp_observe ( symp_stepper *s, double t1, int n, rk4_observer *obs )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_observe advances a symplectic stepper to T1, reporting to an
+    observer.
+
+  Discussion:
+
+    This follows rk4_stepper_observe().  The observer receives the state
+    Y = ( Q, P ), with M = 2 N.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    symp_stepper *S: the stepper.
+
+    double T1: the final time, T1 > S->T.
+
+    int N: the nominal number of steps to take.
+
+    rk4_observer *OBS: the observer.
+
+  Output:
+
+    symp_stepper *S: the advanced stepper.
+
+    int SYMP_OBSERVE: 0 if the integration reached T1, 1 if the observer
+    stopped it.
+*/
+{
+  double dt;
+  int j;
+  int k;
+
+  if ( n <= 0 )
+  {
+    return 0;
+  }
+
+  dt = ( t1 - s->t ) / ( double ) ( n );
+
+  if ( obs->tout_num <= 0 )
+  {
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 1;
+    }
+    for ( j = 1; j <= n; j++ )
+    {
+      symp_step ( s, dt );
+      if ( ( 0 < obs->every && j % obs->every == 0 ) || j == n )
+      {
+        if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+        {
+          return 1;
+        }
+      }
+    }
+    return 0;
+  }
+
+  k = 0;
+  while ( k < obs->tout_num && obs->tout[k] < s->t )
+  {
+    k = k + 1;
+  }
+
+  while ( k < obs->tout_num && obs->tout[k] <= t1 )
+  {
+    symp_step_to ( s, obs->tout[k], dt );
+    if ( rk4_observer_call ( obs, s->t, s->m, s->y ) )
+    {
+      return 1;
+    }
+    k = k + 1;
+  }
+
+  symp_step_to ( s, t1, dt );
+
+  return 0;
+}
+/******************************************************************************/
+
+int symp_order ( int method )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_order returns the order of a symplectic method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    int METHOD: the method.
+
+  Output:
+
+    int SYMP_ORDER: the order, or 0 for an unknown method.
+*/
+{
+  switch ( method )
+  {
+    case SYMP_VERLET:
+      return 2;
+    case SYMP_YOSHIDA4:
+    case SYMP_FOREST_RUTH:
+      return 4;
+    case SYMP_YOSHIDA6:
+      return 6;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void symp_step ( symp_stepper *s, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_step takes one symplectic step.
+
+  Discussion:
+
+    Velocity Verlet substeps are a half kick of P, a drift of Q, and a
+    half kick of P.  Position Verlet substeps are a half drift, a kick
+    and a half drift.  The last evaluation of a substep is kept in F and
+    reused by the next one, so a step of STAGE_NUM substeps costs
+    STAGE_NUM evaluations each of DQDT and DPDT.  EVAL_NUM counts the
+    evaluations of DPDT.
+
+    If the caller changes S->Y between steps, it must set S->VALID = 0.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Input:
+
+    symp_stepper *S: the stepper.
+
+    double DT: the stepsize.
+*/
+{
+  double c;
+  int i;
+  int j;
+  int n;
+  double tau;
+
+  n = s->n;
+  tau = s->t;
+
+  if ( s->method != SYMP_FOREST_RUTH )
+  {
+    if ( !s->valid )
+    {
+      s->dpdt ( tau, s->q, s->f, s->ctx );
+      s->eval_num = s->eval_num + 1;
+    }
+    for ( j = 0; j < s->stage_num; j++ )
+    {
+      c = s->w[j] * dt;
+      for ( i = 0; i < n; i++ )
+      {
+        s->p[i] = s->p[i] + 0.5 * c * s->f[i];
+      }
+      s->dqdt ( tau, s->p, s->g, s->ctx );
+      for ( i = 0; i < n; i++ )
+      {
+        s->q[i] = s->q[i] + c * s->g[i];
+      }
+      tau = tau + c;
+      s->dpdt ( tau, s->q, s->f, s->ctx );
+      for ( i = 0; i < n; i++ )
+      {
+        s->p[i] = s->p[i] + 0.5 * c * s->f[i];
+      }
+    }
+  }
+  else
+  {
+    if ( !s->valid )
+    {
+      s->dqdt ( tau, s->p, s->f, s->ctx );
+    }
+    for ( j = 0; j < s->stage_num; j++ )
+    {
+      c = s->w[j] * dt;
+      for ( i = 0; i < n; i++ )
+      {
+        s->q[i] = s->q[i] + 0.5 * c * s->f[i];
+      }
+      tau = tau + 0.5 * c;
+      s->dpdt ( tau, s->q, s->g, s->ctx );
+      for ( i = 0; i < n; i++ )
+      {
+        s->p[i] = s->p[i] + c * s->g[i];
+      }
+      s->dqdt ( tau, s->p, s->f, s->ctx );
+      for ( i = 0; i < n; i++ )
+      {
+        s->q[i] = s->q[i] + 0.5 * c * s->f[i];
+      }
+      tau = tau + 0.5 * c;
+    }
+  }
+  s->eval_num = s->eval_num + s->stage_num;
+  s->valid = 1;
+
+  s->t = s->t + dt;
+  s->step_num = s->step_num + 1;
+
+  return;
+}
+/******************************************************************************/
+
+static void symp_step_to ( symp_stepper *s, double target, double dt )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    symp_step_to takes steps of size DT, ending exactly at TARGET.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double h;
+
+  while ( s->t < target )
+  {
+    h = dt;
+    if ( target - s->t <= h * ( 1.0 + 1.0E-08 ) )
+    {
+      h = target - s->t;
+    }
+    symp_step ( s, h );
+    if ( h != dt )
+    {
+      s->t = target;
+    }
+  }
+
+  return;
+}
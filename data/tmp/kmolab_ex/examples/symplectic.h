@@ -0,0 +1,55 @@
+/*
+  Symplectic methods for a separable Hamiltonian H ( Q, P ) = T ( P ) + V ( Q ).
+
+  DQDT ( T, P, DQ, CTX ) sets DQ = dQ/dT, which depends only on P, and
+  DPDT ( T, Q, DP, CTX ) sets DP = dP/dT, which depends only on Q.
+
+  SYMP_VERLET is velocity Verlet, of order 2.  SYMP_YOSHIDA4 and
+  SYMP_YOSHIDA6 are Yoshida's compositions of it, of orders 4 and 6.
+  SYMP_FOREST_RUTH is the Forest-Ruth method of order 4, which uses the
+  same weights as SYMP_YOSHIDA4 but composes position Verlet, so that it
+  evaluates DQDT more often than DPDT.
+*/
+# define SYMP_VERLET 0
+# define SYMP_YOSHIDA4 1
+# define SYMP_YOSHIDA6 2
+# define SYMP_FOREST_RUTH 3
+
+/*
+  symp_stepper holds the state of a symplectic integration.  Y is the
+  state ( Q, P ) of length M = 2 N, with Q = Y and P = Y + N, so it can be
+  passed to an rk4_observer.  F holds DPDT, or DQDT for SYMP_FOREST_RUTH,
+  at the current state when VALID is set, so that consecutive half steps
+  share an evaluation.  G is scratch.
+*/
+typedef struct
+{
+  void ( *dqdt ) ( double t, double p[], double dq[], void *ctx );
+  void ( *dpdt ) ( double t, double q[], double dp[], void *ctx );
+  void *ctx;
+  int method;
+  int n;
+  int m;
+  int stage_num;
+  double w[7];
+  double t;
+  long int step_num;
+  long int eval_num;
+  int valid;
+  double *y;
+  double *q;
+  double *p;
+  double *f;
+  double *g;
+  double *work;
+} symp_stepper;
+
+void symp_advance ( symp_stepper *s, double t1, int n );
+symp_stepper *symp_create ( int method, void dqdt ( double t, double p[],
+  double dq[], void *ctx ), void dpdt ( double t, double q[], double dp[],
+  void *ctx ), void *ctx, int n, double t0, double q0[], double p0[] );
+void symp_destroy ( symp_stepper *s );
+char *symp_name ( int method );
+int symp_observe ( symp_stepper *s, double t1, int n, rk4_observer *obs );
+int symp_order ( int method );
+void symp_step ( symp_stepper *s, double dt );